@@ -95,7 +95,7 @@ print:
 	@echo $($(VAR))
 
 srcs.c := $(hpgmg-fe-y.c) $(hpgmg-fv-y.c)
-srcs.o := $(call srctoobj,$(srcs.c))
+srcs.o := $(patsubst %.c,%.o,$(filter $(OBJDIR)/%,$(srcs.c))) $(call srctoobj,$(srcs.c))
 srcs.d := $(srcs.o:%.o=%.d)
 # Tell make that srcs.d are all up to date.  Without this, the include
 # below has quadratic complexity, taking more than one second for a
@@ -1,7 +1,9 @@
 #ifndef _fefas_align_h
 #define _fefas_align_h
 
-#if defined(__AVX__) || defined(__xlc__)  // Assume these compilers support __attribute__((aligned(32)))
+#if defined(__AVX512F__)
+#  define _align __attribute__((aligned(64))) /* AVX-512 packed instructions need 64-byte alignment */
+#elif defined(__AVX__) || defined(__xlc__)  // Assume these compilers support __attribute__((aligned(32)))
 #  define _align __attribute__((aligned(32))) /* AVX packed instructions need 32-byte alignment */
 #elif defined(__GNUC__)
 #  define _align __attribute__((aligned(16))) /* SSE instructions need 16-byte alignment */
@@ -0,0 +1,36 @@
+#ifndef _fefas_omp_h
+#define _fefas_omp_h
+
+#include <petscsys.h>
+#if defined(_OPENMP)
+#  include <omp.h>
+#endif
+
+// Element loops run in OpenMP parallel regions when compiled with OpenMP (e.g., CFLAGS=-fopenmp).  Kernels that can be
+// called from those loops log flops through FELogFlops(), which updates PETSc's global counter atomically.
+#if defined(_OPENMP) && defined(PETSC_USE_LOG)
+static inline PetscErrorCode FELogFlops(PetscLogDouble n) {
+#pragma omp atomic
+  petsc_TotalFlops += PETSC_FLOPS_PER_OP*n;
+  return 0;
+}
+#else
+#  define FELogFlops(n) PetscLogFlops(n)
+#endif
+
+// An error inside a parallel loop cannot return: record it in err, skip the rest of this iteration, and check err once
+// the loop is done.  err must be a reduction(max:) variable of the loop.  Inside the loop it is the thread's private
+// copy, which OpenMP initializes to the smallest int rather than 0, so test ierr there, never err.
+#define CHKERRBATCH(ierr,err) if (PetscUnlikely(ierr)) {(err) = (ierr); continue;}
+
+// Number of threads for element loops.  Debug builds of PETSc keep a global function stack that is only safe to use
+// from several threads if PETSc was configured --with-threadsafety, so those run serially otherwise.
+static inline PetscInt FEGetMaxThreads(void) {
+#if defined(_OPENMP) && (!defined(PETSC_USE_DEBUG) || defined(PETSC_HAVE_THREADSAFETY))
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+#endif
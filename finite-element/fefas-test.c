@@ -3,6 +3,7 @@
 #include "pointwise.h"
 #include "op/fefas-op.h"
 #include <petscksp.h>
+#include <petsctime.h>
 #include <inttypes.h>
 
 typedef struct Options_private *Options;
@@ -479,6 +480,108 @@ PetscErrorCode TestOpDiagonal()
   PetscFunctionReturn(0);
 }
 
+// Check that the chunks of DMFEGetElementChunks() can be scattered concurrently, then compute the residual and the
+// diagonal with one thread and with -test_threads threads per process.  The element loops split the elements the same
+// way whatever the number of threads, so the results must agree bit for bit.
+PetscErrorCode TestOpThreads()
+{
+  PetscErrorCode ierr;
+  Grid grid;
+  Options opt;
+  Op op;
+  PetscInt fedegree,dof,threads = 4;
+  DM dm;
+  Vec U,F,R[2],Diag[2];
+  PetscBool sameR,sameDiag;
+#if defined(_OPENMP)
+  int maxthreads = omp_get_max_threads();
+#endif
+
+  PetscFunctionBegin;
+  ierr = OpCreateFromOptions(PETSC_COMM_WORLD,&op);CHKERRQ(ierr);
+  ierr = OpGetFEDegree(op,&fedegree);CHKERRQ(ierr);
+  ierr = OpGetDof(op,&dof);CHKERRQ(ierr);
+  ierr = OptionsParse("Finite Element FAS Test threaded element loops",&opt);CHKERRQ(ierr);
+  ierr = PetscOptionsBegin(PETSC_COMM_WORLD,NULL,"Threaded element loop options",NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-test_threads","Number of OpenMP threads to compare with one thread","",threads,&threads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  ierr = GridCreate(PETSC_COMM_WORLD,opt->M,opt->p,opt->cmax,&grid);CHKERRQ(ierr);
+  ierr = DMCreateFE(grid,fedegree,dof,&dm);CHKERRQ(ierr);
+  ierr = DMFESetUniformCoordinates(dm,opt->L);CHKERRQ(ierr);
+  ierr = OpSetUpGeometry(op,dm);CHKERRQ(ierr);
+
+  { // Chunks of one colour are scattered concurrently, so no two of them may contain a common node
+    const PetscInt nes[] = {1,2,4,8,16},P3 = (fedegree+1)*(fedegree+1)*(fedegree+1);
+    const PetscInt *elemoffset,*nodeoffset;
+    PetscInt nelem,nlocal,nshared = 0,*owner;
+    Vec Ul;
+
+    ierr = DMFEGetNumElements(dm,&nelem);CHKERRQ(ierr);
+    ierr = DMFEGetElementLayout(dm,&elemoffset,&nodeoffset,NULL);CHKERRQ(ierr);
+    ierr = DMGetLocalVector(dm,&Ul);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(Ul,&nlocal);CHKERRQ(ierr);
+    ierr = DMRestoreLocalVector(dm,&Ul);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nlocal,&owner);CHKERRQ(ierr);
+    for (size_t n=0; n<sizeof nes/sizeof nes[0]; n++) {
+      PetscInt nbatch,nchunks;
+      ierr = DMFEGetElementChunks(dm,nes[n],&nbatch,&nchunks);CHKERRQ(ierr);
+      for (PetscInt colour=0; colour<2; colour++) {
+        for (PetscInt i=0; i<nlocal; i++) owner[i] = -1;
+        for (PetscInt c=colour; c<nchunks; c+=2) {
+          for (PetscInt e=c*nbatch/nchunks*nes[n]; e<PetscMin((c+1)*nbatch/nchunks*nes[n],nelem); e++) {
+            for (PetscInt i=0; i<P3; i++) {
+              PetscInt node = elemoffset[e] + nodeoffset[i];
+              if (owner[node] >= 0 && owner[node] != c) nshared++;
+              owner[node] = c;
+            }
+          }
+        }
+      }
+    }
+    ierr = PetscFree(owner);CHKERRQ(ierr);
+    ierr = MPI_Allreduce(MPI_IN_PLACE,&nshared,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    if (nshared) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"Chunks of one colour share %D nodes\n",nshared);CHKERRQ(ierr);
+    } else {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"Chunks of one colour share no nodes\n");CHKERRQ(ierr);
+    }
+  }
+
+  ierr = DMCreateGlobalVector(dm,&U);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(dm,&F);CHKERRQ(ierr);
+  ierr = OpSolution(op,dm,U);CHKERRQ(ierr);
+  for (PetscInt t=0; t<2; t++) {
+#if defined(_OPENMP)
+    omp_set_num_threads(t ? threads : 1);
+#endif
+    ierr = DMCreateGlobalVector(dm,&R[t]);CHKERRQ(ierr);
+    ierr = DMCreateGlobalVector(dm,&Diag[t]);CHKERRQ(ierr);
+    ierr = OpForcing(op,dm,F);CHKERRQ(ierr);
+    ierr = OpApply(op,dm,U,R[t]);CHKERRQ(ierr);
+    ierr = VecAXPY(R[t],-1.,F);CHKERRQ(ierr);  // R <- A U - F
+    ierr = OpGetDiagonal(op,dm,Diag[t]);CHKERRQ(ierr);
+  }
+#if defined(_OPENMP)
+  omp_set_num_threads(maxthreads);
+#endif
+  ierr = VecEqual(R[0],R[1],&sameR);CHKERRQ(ierr);           // Compares the arrays with memcmp
+  ierr = VecEqual(Diag[0],Diag[1],&sameDiag);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Residual with threads %s serial\n",sameR ? "identical to" : "DIFFERS from");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Diagonal with threads %s serial\n",sameDiag ? "identical to" : "DIFFERS from");CHKERRQ(ierr);
+
+  for (PetscInt t=0; t<2; t++) {
+    ierr = VecDestroy(&R[t]);CHKERRQ(ierr);
+    ierr = VecDestroy(&Diag[t]);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&U);CHKERRQ(ierr);
+  ierr = VecDestroy(&F);CHKERRQ(ierr);
+  ierr = DMDestroy(&dm);CHKERRQ(ierr);
+  ierr = GridDestroy(&grid);CHKERRQ(ierr);
+  ierr = OpDestroy(&op);CHKERRQ(ierr);
+  ierr = PetscFree(opt);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode TestKSPSolve()
 {
   PetscErrorCode ierr;
@@ -558,3 +661,145 @@ PetscErrorCode TestSampler()
   ierr = PetscFree(gridsize);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
+
+// Compulsory memory traffic of one contraction: read x and the three matrices, read and write y.  The intermediate
+// stages stay in cache.
+static PetscLogDouble TensorBytes(PetscInt ne,PetscInt dof,PetscInt P,PetscInt Q,TensorMode tmode)
+{
+  PetscInt in = tmode == TENSOR_EVAL ? P : Q,out = tmode == TENSOR_EVAL ? Q : P;
+  return (PetscLogDouble)sizeof(PetscScalar)*dof*ne*(in*in*in + 2*out*out*out) + (PetscLogDouble)sizeof(PetscReal)*3*P*Q;
+}
+
+// Straight triple sum y[l,a,b,c] = R[a,i] S[b,j] T[c,k] x[l,i,j,k] (or its transpose) with matrices stored as in
+// TensorContract(), Q by P.  Deliberately shares nothing with tensor.c so that it can check the generic backend too.
+static void TensorContractDirect(PetscInt ne,PetscInt dof,PetscInt P,PetscInt Q,const PetscReal R[],const PetscReal S[],const PetscReal T[],TensorMode tmode,const PetscScalar x[],PetscScalar y[])
+{
+  PetscInt in = tmode == TENSOR_EVAL ? P : Q,out = tmode == TENSOR_EVAL ? Q : P;
+  for (PetscInt l=0; l<dof; l++) {
+    for (PetscInt a=0; a<out; a++) {
+      for (PetscInt b=0; b<out; b++) {
+        for (PetscInt c=0; c<out; c++) {
+          for (PetscInt e=0; e<ne; e++) {
+            PetscScalar sum = 0;
+            for (PetscInt i=0; i<in; i++) {
+              for (PetscInt j=0; j<in; j++) {
+                for (PetscInt k=0; k<in; k++) {
+                  PetscReal r = tmode == TENSOR_EVAL ? R[a*P+i] : R[i*P+a];
+                  PetscReal s = tmode == TENSOR_EVAL ? S[b*P+j] : S[j*P+b];
+                  PetscReal t = tmode == TENSOR_EVAL ? T[c*P+k] : T[k*P+c];
+                  sum += r*s*t*x[((l*in+i)*in+j)*in*ne+k*ne+e];
+                }
+              }
+            }
+            y[((l*out+a)*out+b)*out*ne+c*ne+e] = sum;
+          }
+        }
+      }
+    }
+  }
+}
+
+// Check every available TensorContract implementation against a direct evaluation and time it in isolation.  Besides
+// the P=Q shapes used by the operators, the check covers Q>P (-bench_qextra) with every number of fields.  With
+// -bench_reps 0, only the check is performed.
+PetscErrorCode TestTensorBench()
+{
+  PetscErrorCode ierr;
+  const char *const backends[] = {"generic","ref","fma","avx512","qpx"};
+  const char *const modes[] = {"eval","transpose"};
+  PetscInt nes[8] = {4,8,16},nne = 8,dofs[2] = {1,3},ndof = 2,degrees[2] = {1,2},ndegree = 2,qextras[2] = {0,1},nqextra = 2;
+  PetscInt reps = 10000,nchecked = 0,nfailed = 0;
+  PetscReal peak = 0,bandwidth = 0,tol = 1e-12;
+  PetscBool set;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsBegin(PETSC_COMM_WORLD,NULL,"Tensor contraction benchmark options",NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsIntArray("-bench_ne","Element batch sizes","",nes,&nne,&set);CHKERRQ(ierr);
+  if (!set) nne = 3;
+  ierr = PetscOptionsIntArray("-bench_dof","Number of fields","",dofs,&ndof,&set);CHKERRQ(ierr);
+  if (!set) ndof = 2;
+  ierr = PetscOptionsIntArray("-bench_degree","Finite element degrees","",degrees,&ndegree,&set);CHKERRQ(ierr);
+  if (!set) ndegree = 2;
+  ierr = PetscOptionsIntArray("-bench_qextra","Quadrature points in each direction beyond degree+1","",qextras,&nqextra,&set);CHKERRQ(ierr);
+  if (!set) nqextra = 2;
+  ierr = PetscOptionsInt("-bench_reps","Number of contractions to time (0 to only check)","",reps,&reps,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-bench_tol","Relative tolerance for agreement with direct evaluation","",tol,&tol,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-bench_peak","Peak floating point rate of one core in GF/s (for the roofline)","",peak,&peak,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-bench_bandwidth","Memory bandwidth available to one core in GB/s (for the roofline)","",bandwidth,&bandwidth,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+
+  if (reps > 0) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%-8s %4s %3s %2s %2s %-9s %10s %10s %6s %10s %8s%s\n","Backend","ne","dof","P","Q","Mode",
+                       "flops/call","bytes/call","F/B","ns/call","GF/s",peak > 0 && bandwidth > 0 ? "  %roofline" : "");CHKERRQ(ierr);
+  }
+  for (PetscInt dq=0; dq<ndegree*nqextra; dq++) {
+    PetscInt P = degrees[dq/nqextra]+1,Q = P+qextras[dq%nqextra],M3 = PetscMax(P*P*P,Q*Q*Q);
+    PetscReal R[Q*P],S[Q*P],T[Q*P];
+    for (PetscInt i=0; i<Q*P; i++) {   // Distinct matrices so that mixing up directions is detected
+      R[i] = 1./(i+2);
+      S[i] = (i%2 ? -1. : 1.)/(i+1);
+      T[i] = PetscSinReal(i+1.);
+    }
+    for (PetscInt n=0; n<nne; n++) {
+      PetscInt ne = nes[n];
+      for (PetscInt f=0; f<ndof; f++) {
+        PetscInt dof = dofs[f];
+        PetscScalar x[dof*M3*ne]_align,y[dof*M3*ne]_align,yref[2][dof*M3*ne]_align;
+
+        for (PetscInt i=0; i<dof*M3*ne; i++) x[i] = PetscCosReal(0.37*i);
+        for (PetscInt m=0; m<2; m++) {
+          ierr = PetscMemzero(yref[m],sizeof yref[m]);CHKERRQ(ierr);
+          TensorContractDirect(ne,dof,P,Q,R,S,T,m ? TENSOR_TRANSPOSE : TENSOR_EVAL,x,yref[m]);
+        }
+
+        for (size_t b=0; b<sizeof backends/sizeof backends[0]; b++) {
+          Tensor ten;
+          ierr = TensorCreateBackend(ne,dof,P,Q,backends[b],&ten);CHKERRQ(ierr);
+          if (!ten) continue;
+          for (PetscInt m=0; m<2; m++) {
+            TensorMode tmode = m ? TENSOR_TRANSPOSE : TENSOR_EVAL;
+            PetscLogDouble t0,t1,flops0,flops1,flops,bytes;
+            PetscReal err = 0,norm = 0;
+
+            ierr = PetscMemzero(y,sizeof y);CHKERRQ(ierr);
+            ierr = PetscGetFlops(&flops0);CHKERRQ(ierr);
+            ierr = TensorContract(ten,R,S,T,tmode,x,y);CHKERRQ(ierr);
+            ierr = PetscGetFlops(&flops1);CHKERRQ(ierr);
+            flops = flops1 - flops0;
+            bytes = TensorBytes(ne,dof,P,Q,tmode);
+            for (PetscInt i=0; i<dof*M3*ne; i++) {
+              err  = PetscMax(err,PetscAbsScalar(y[i] - yref[m][i]));
+              norm = PetscMax(norm,PetscAbsScalar(yref[m][i]));
+            }
+            nchecked++;
+            if (err > tol*norm) {
+              nfailed++;
+              ierr = PetscPrintf(PETSC_COMM_WORLD,"%s ne=%D dof=%D P=%D Q=%D %s: relative error %g\n",backends[b],ne,dof,P,Q,modes[m],(double)(err/norm));CHKERRQ(ierr);
+            }
+            if (reps <= 0) continue;
+
+            ierr = PetscTime(&t0);CHKERRQ(ierr);
+            for (PetscInt r=0; r<reps; r++) {
+              ierr = TensorContract(ten,R,S,T,tmode,x,y);CHKERRQ(ierr);
+            }
+            ierr = PetscTime(&t1);CHKERRQ(ierr);
+            ierr = PetscPrintf(PETSC_COMM_WORLD,"%-8s %4D %3D %2D %2D %-9s %10.0f %10.0f %6.2f %10.1f %8.2f",backends[b],ne,dof,P,Q,modes[m],
+                               flops,bytes,flops/bytes,(t1-t0)/reps*1e9,flops*reps/(t1-t0)*1e-9);CHKERRQ(ierr);
+            if (peak > 0 && bandwidth > 0) { // Attainable rate is limited by either the peak or streaming the compulsory bytes
+              PetscReal attainable = PetscMin(peak,flops/bytes*bandwidth);
+              ierr = PetscPrintf(PETSC_COMM_WORLD," %10.1f%%",100*flops*reps/(t1-t0)*1e-9/attainable);CHKERRQ(ierr);
+            }
+            ierr = PetscPrintf(PETSC_COMM_WORLD,"\n");CHKERRQ(ierr);
+          }
+          ierr = TensorDestroy(&ten);CHKERRQ(ierr);
+        }
+      }
+    }
+  }
+  if (nfailed) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%D of %D tensor contractions disagree with direct evaluation\n",nfailed,nchecked);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"All tensor contractions agree with direct evaluation\n");CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
@@ -10,8 +10,10 @@ PetscErrorCode TestFEInterp(void);
 PetscErrorCode TestFERestrict(void);
 PetscErrorCode TestOpApply(void);
 PetscErrorCode TestOpDiagonal(void);
+PetscErrorCode TestOpThreads(void);
 PetscErrorCode TestKSPSolve(void);
 PetscErrorCode TestSampler(void);
+PetscErrorCode TestTensorBench(void);
 PetscErrorCode RunMGV(void);
 PetscErrorCode RunFMG(void);
 PetscErrorCode RunSample(void);
@@ -32,8 +34,10 @@ static PetscErrorCode ActionParse(int argc,char *argv[],PetscErrorCode (**action
   ierr = PetscFunctionListAdd(&actionlist,"test-ferestrict",TestFERestrict);CHKERRQ(ierr);
   ierr = PetscFunctionListAdd(&actionlist,"test-opapply",TestOpApply);CHKERRQ(ierr);
   ierr = PetscFunctionListAdd(&actionlist,"test-opdiagonal",TestOpDiagonal);CHKERRQ(ierr);
+  ierr = PetscFunctionListAdd(&actionlist,"test-opthreads",TestOpThreads);CHKERRQ(ierr);
   ierr = PetscFunctionListAdd(&actionlist,"test-kspsolve",TestKSPSolve);CHKERRQ(ierr);
   ierr = PetscFunctionListAdd(&actionlist,"test-sampler",TestSampler);CHKERRQ(ierr);
+  ierr = PetscFunctionListAdd(&actionlist,"bench-tensor",TestTensorBench);CHKERRQ(ierr);
   ierr = PetscFunctionListAdd(&actionlist,"mgv",RunMGV);CHKERRQ(ierr);
   ierr = PetscFunctionListAdd(&actionlist,"fmg",RunFMG);CHKERRQ(ierr);
   ierr = PetscFunctionListAdd(&actionlist,"sample",RunSample);CHKERRQ(ierr);
@@ -4,6 +4,7 @@
 #include <petscdm.h>
 #include <stdint.h>
 #include "op/fefas-op.h"
+#include "fefas-omp.h"
 
 typedef struct Grid_private *Grid;
 
@@ -23,6 +24,8 @@ PetscErrorCode DMFEGetTensorEval(DM dm,PetscInt *P,PetscInt *Q,const PetscReal *
 PetscErrorCode DMFEGetNumElements(DM dm,PetscInt *nelems);
 PetscErrorCode DMFEExtractElements(DM dm,const PetscScalar *u,PetscInt elem,PetscInt ne,PetscScalar *y);
 PetscErrorCode DMFESetElements(DM dm,PetscScalar *u,PetscInt elem,PetscInt ne,InsertMode imode,DomainMode dmode,const PetscScalar *y);
+PetscErrorCode DMFEGetElementChunks(DM dm,PetscInt ne,PetscInt *nbatch,PetscInt *nchunks);
+PetscErrorCode DMFEGetElementLayout(DM dm,const PetscInt **elemoffset,const PetscInt **nodeoffset,const uint32_t **interior);
 PetscErrorCode DMFECoarsen(DM dm,DM *dmcoarse);
 PetscErrorCode DMFEInject(DM dm,Vec Uf,Vec Uc);
 PetscErrorCode DMFEInterpolate(DM dm,Vec Uc,Vec Uf);
@@ -116,6 +116,7 @@ PetscErrorCode MGCreate(Op op,DM dm,PetscInt nlevels,MG *newmg) {
       ierr = KSPSetInitialGuessNonzero(mg->ksp,PETSC_TRUE);CHKERRQ(ierr);
       ierr = KSPGetPC(mg->ksp,&pc);CHKERRQ(ierr);
       ierr = PCSetType(pc,PCJACOBI);CHKERRQ(ierr);
+      ierr = OpSetUpGeometry(op,mg->dm);CHKERRQ(ierr);
       ierr = OpGetMat(op,mg->dm,&A);CHKERRQ(ierr);
       ierr = KSPSetOperators(mg->ksp,A,A);CHKERRQ(ierr);
       ierr = MatDestroy(&A);CHKERRQ(ierr);
@@ -0,0 +1,186 @@
+#!/usr/bin/env python
+
+# Generate fully unrolled TensorContract kernels for every (ne,dof,P,Q) used by
+# the registered operators.  The operator sources are scanned for the element
+# batch size (#define NE), the polynomial degree (OpSetFEDegree) and the number
+# of fields (OpSetDof); coordinates (dof=3) are always needed.
+
+import re
+import itertools
+
+NE_RE = re.compile(r'#define NE (\d+)')
+DEGREE_RE = re.compile(r'OpSetFEDegree\(\w+,(\d+)\)')
+DOF_RE = re.compile(r'OpSetDof\(\w+,(\d+)\)')
+
+# Batch sizes that may be selected without an operator asking for them
+# (tests, tuning of NE).  Each back-end only handles multiples of its width.
+NE_DEFAULT = (4, 8, 16)
+
+class Backend(object):
+    def __init__(self, name, suffix, guard, width):
+        self.name, self.suffix, self.guard, self.width = name, suffix, guard, width
+
+class BackendRef(Backend):
+    def decl(self, var, expr):
+        return 'const PetscReal %s = %s;' % (var, expr)
+    def sum(self, terms, out, acc):
+        s = ' + '.join('%s*%s[%d][e]' % (m, a, i) for m, a, i in terms)
+        return '%s[%d][e] %s %s;' % (out[0], out[1], '+=' if acc else '=', s)
+
+class BackendSIMD(Backend):
+    def __init__(self, name, suffix, guard, width, vtype, prefix):
+        Backend.__init__(self, name, suffix, guard, width)
+        self.vtype, self.prefix = vtype, prefix
+    def decl(self, var, expr):
+        return 'const %s %s = %s_set1_pd(%s);' % (self.vtype, var, self.prefix, expr)
+    def load(self, a, i):
+        return '%s_load_pd(&%s[%d][e])' % (self.prefix, a, i)
+    def sum(self, terms, out, acc):
+        m, a, i = terms[0]
+        if acc:
+            s = '%s_fmadd_pd(%s,%s,%s)' % (self.prefix, m, self.load(a, i), self.load(*out))
+        else:
+            s = '%s_mul_pd(%s,%s)' % (self.prefix, m, self.load(a, i))
+        for m, a, i in terms[1:]:
+            s = '%s_fmadd_pd(%s,%s,%s)' % (self.prefix, m, self.load(a, i), s)
+        return '%s_store_pd(&%s[%d][e],%s);' % (self.prefix, out[0], out[1], s)
+
+# Ordered by preference: TensorSelect_Generated takes the first match.
+BACKENDS = [
+    BackendSIMD('avx512', 'AVX512', '__AVX512F__', 8, '__m512d', '_mm512'),
+    BackendSIMD('fma', 'FMA', '__AVX__', 4, '__m256d', '_mm256'),
+    BackendRef('ref', 'Ref', None, 1),
+    ]
+
+def scan(files):
+    nes, degrees, dofs = set(NE_DEFAULT), set(), set([3])
+    for src in files:
+        with open(src) as f:
+            text = f.read()
+        nes.update(int(n) for n in NE_RE.findall(text))
+        degrees.update(int(p) for p in DEGREE_RE.findall(text))
+        dofs.update(int(d) for d in DOF_RE.findall(text))
+    return sorted(nes), sorted(dofs), sorted(p+1 for p in degrees)
+
+def kernel_name(backend, ne, dof, P, Q):
+    return 'TensorContract_%s_%d_%d_%d_%d' % (backend.suffix, ne, dof, P, Q)
+
+def mode_body(backend, ne, dof, P, Q, transpose):
+    # After transposing, contract from p to q points and read the matrices as [p][q]
+    p, q = (Q, P) if transpose else (P, Q)
+    lines = []
+    def mat(name, a, i):
+        return '%s_%d_%d' % (name, a, i)
+    for name in 'RST':
+        for a in range(q):
+            for i in range(p):
+                idx = i*q + a if transpose else a*p + i
+                lines.append(backend.decl(mat(name, a, i), '%sf[%d]' % (name, idx)))
+    loop = 'for (PetscInt e=0; e<%d; e+=%d) {' % (ne, backend.width) if backend.width > 1 else 'for (PetscInt e=0; e<%d; e++) {' % ne
+
+    # u[l,a,j,k] = R[a,i] x[l,i,j,k]
+    lines.append(loop)
+    for l, a, jk in itertools.product(range(dof), range(q), range(p*p)):
+        terms = [(mat('R', a, i), 'x', l*p**3 + i*p*p + jk) for i in range(p)]
+        lines.append('  ' + backend.sum(terms, ('u', l*q*p*p + a*p*p + jk), False))
+    lines.append('}')
+
+    # v[l,a,b,k] = S[b,j] u[l,a,j,k]
+    lines.append(loop)
+    for l, a, b, k in itertools.product(range(dof), range(q), range(q), range(p)):
+        terms = [(mat('S', b, j), 'u', l*q*p*p + (a*p+j)*p + k) for j in range(p)]
+        lines.append('  ' + backend.sum(terms, ('v', l*q*q*p + (a*q+b)*p + k), False))
+    lines.append('}')
+
+    # y[l,a,b,c] += T[c,k] v[l,a,b,k]
+    lines.append(loop)
+    for l, ab, c in itertools.product(range(dof), range(q*q), range(q)):
+        terms = [(mat('T', c, k), 'v', l*q*q*p + ab*p + k) for k in range(p)]
+        lines.append('  ' + backend.sum(terms, ('y', l*q**3 + ab*q + c), True))
+    lines.append('}')
+
+    return """static inline void %(name)s_%(mode)s(const PetscReal Rf[],const PetscReal Sf[],const PetscReal Tf[],const PetscScalar xx[],PetscScalar yy[])
+{
+  const PetscScalar (*restrict x)[%(ne)d] = (const PetscScalar(*)[%(ne)d])xx;
+  PetscScalar       (*restrict y)[%(ne)d] = (PetscScalar(*)[%(ne)d])yy;
+  PetscScalar u[%(nu)d][%(ne)d]_align,v[%(nv)d][%(ne)d]_align;
+  %(body)s
+}
+""" % dict(name=kernel_name(backend, ne, dof, P, Q), mode='Transpose' if transpose else 'Eval',
+           ne=ne, nu=dof*q*p*p, nv=dof*q*q*p, body='\n  '.join(lines))
+
+def kernel(backend, ne, dof, P, Q):
+    name = kernel_name(backend, ne, dof, P, Q)
+    return """%(eval)s
+%(transpose)s
+static PetscErrorCode %(name)s(Tensor ten,const PetscReal Rf[],const PetscReal Sf[],const PetscReal Tf[],TensorMode tmode,const PetscScalar xx[],PetscScalar yy[])
+{
+
+  PetscFunctionBegin;
+  if (tmode == TENSOR_EVAL) {
+    %(name)s_Eval(Rf,Sf,Tf,xx,yy);
+    FELogFlops(%(flops_eval)d);
+  } else {
+    %(name)s_Transpose(Rf,Sf,Tf,xx,yy);
+    FELogFlops(%(flops_transpose)d);
+  }
+  PetscFunctionReturn(0);
+}
+""" % dict(name=name,
+           eval=mode_body(backend, ne, dof, P, Q, False),
+           transpose=mode_body(backend, ne, dof, P, Q, True),
+           flops_eval=dof*(Q*P**3 + Q*Q*P*P + Q**3*P)*ne*2,
+           flops_transpose=dof*(P*Q**3 + P*P*Q*Q + P**3*Q)*ne*2)
+
+def guarded(backend, text):
+    if backend.guard:
+        return '#ifdef %s\n%s#endif\n' % (backend.guard, text)
+    return text
+
+def gentensor(outname, files):
+    nes, dofs, Ps = scan(files)
+    kernels, table = [], []
+    for backend in BACKENDS:
+        variants = [(ne, dof, P, P) for ne in nes for dof in dofs for P in Ps if ne % backend.width == 0]
+        kernels.append(guarded(backend, ''.join(kernel(backend, *v) for v in variants)))
+        table.append(guarded(backend, ''.join('  {"%s",%d,%d,%d,%d,%s},\n' % ((backend.name,) + v + (kernel_name(backend, *v),)) for v in variants)))
+    with open(outname, 'w') as out:
+        out.write("""// Generated by gentensor.py; do not edit.
+#include "tensorimpl.h"
+
+#if defined(__AVX__) || defined(__AVX512F__)
+#  include <immintrin.h>
+#endif
+#if defined(__AVX__) && !defined(__FMA__)
+#  define _mm256_fmadd_pd(a,b,c) _mm256_add_pd(_mm256_mul_pd(a,b),c)
+#endif
+
+%(kernels)s
+static const struct {
+  const char *backend;
+  PetscInt ne,dof,P,Q;
+  TensorContractFunction Contract;
+} TensorKernels[] = {
+%(table)s};
+
+PetscErrorCode TensorSelect_Generated(Tensor ten,const char backend[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (size_t i=0; i<sizeof TensorKernels/sizeof TensorKernels[0]; i++) {
+    PetscBool match = PETSC_TRUE;
+    if (TensorKernels[i].ne != ten->ne || TensorKernels[i].dof != ten->dof || TensorKernels[i].P != ten->P || TensorKernels[i].Q != ten->Q) continue;
+    if (backend) {ierr = PetscStrcmp(backend,TensorKernels[i].backend,&match);CHKERRQ(ierr);}
+    if (!match) continue;
+    ten->Contract = TensorKernels[i].Contract;
+    ten->backend  = TensorKernels[i].backend;
+    break;
+  }
+  PetscFunctionReturn(0);
+}
+""" % dict(kernels='\n'.join(kernels), table=''.join(table)))
+
+if __name__ == '__main__':
+    import sys
+    gentensor(sys.argv[1], sys.argv[2:])
@@ -64,6 +64,11 @@ struct FE_private {
     PetscReal *interp;
     PetscReal *w3;
   } ref;
+  struct {              // Gather/scatter layout for fused element kernels, built on demand by DMFEGetElementLayout()
+    PetscInt *elem;     // Offset of the first node of each owned element in the local array
+    PetscInt *node;     // Offset of each of the P^3 element nodes relative to the first
+    uint32_t *interior; // Bit (ii*P+jj)*P+kk is set if that node is in the interior of the global domain
+  } layout;
 };
 
 static PetscInt Idx3(const PetscInt m[],PetscInt i,PetscInt j,PetscInt k) { return (i*m[1]+j)*m[2]+k; }
@@ -998,7 +1003,81 @@ PetscErrorCode DMFESetElements(DM dm,PetscScalar *u,PetscInt elem,PetscInt ne,In
       }
     }
   }
-  if (imode == ADD_VALUES) PetscLogFlops(fe->dof*P*P*P*(PetscMin(elem+ne,m[0]*m[1]*m[2])-elem));
+  if (imode == ADD_VALUES) FELogFlops(fe->dof*P*P*P*(PetscMin(elem+ne,m[0]*m[1]*m[2])-elem));
+  PetscFunctionReturn(0);
+}
+
+// Split the local elements, in batches of ne, into nchunks contiguous chunks for threaded element loops.  Chunk c holds
+// batches [c*nbatch/nchunks, (c+1)*nbatch/nchunks).  Every chunk spans more than a plane and a row of elements, so
+// chunks of the same parity share no nodes and can be scattered into a local vector concurrently: process the even
+// chunks in parallel, then the odd ones.  Small subdomains get two chunks and run serially.  The split depends only on
+// the subdomain, not on the number of threads, so every node receives its element contributions in the same order and
+// threaded results are bitwise identical to serial ones.
+PetscErrorCode DMFEGetElementChunks(DM dm,PetscInt ne,PetscInt *nbatch,PetscInt *nchunks)
+{
+  PetscErrorCode ierr;
+  FE fe;
+  const PetscInt *m;
+  PetscInt gap;
+
+  PetscFunctionBegin;
+  ierr = DMGetApplicationContext(dm,&fe);CHKERRQ(ierr);
+  m = fe->grid->m;
+  *nbatch = (m[0]*m[1]*m[2] + ne - 1) / ne;
+  gap = (m[1]*m[2] + m[2]) / ne + 1; // Batches separating two elements that cannot share a node
+  *nchunks = PetscMax(2,*nbatch / gap / 2 * 2); // As many even/odd pairs as keep every chunk at least gap batches long
+  PetscFunctionReturn(0);
+}
+
+// Precomputed layout for kernels that gather and scatter element values directly from the local array: the value of
+// node (ii,jj,kk) of element E (ordered as in DMFEExtractElements()) is u[elemoffset[E]+nodeoffset[(ii*P+jj)*P+kk]+d].
+// Bit (ii*P+jj)*P+kk of interior[E] marks the nodes that DMFESetElements() updates with DOMAIN_INTERIOR.
+PetscErrorCode DMFEGetElementLayout(DM dm,const PetscInt **elemoffset,const PetscInt **nodeoffset,const uint32_t **interior)
+{
+  PetscErrorCode ierr;
+  FE fe;
+
+  PetscFunctionBegin;
+  ierr = DMGetApplicationContext(dm,&fe);CHKERRQ(ierr);
+  if (!fe->layout.elem) {
+    const PetscInt *m = fe->grid->m,fedegree = fe->degree,P = fe->degree+1;
+    PetscInt gs[3],gM[3],E;
+
+    if (P*P*P > 32) SETERRQ1(fe->grid->comm,PETSC_ERR_SUP,"Interior mask limited to 32 nodes per element, P=%D",P);
+    for (PetscInt i=0; i<3; i++) {
+      gs[i] = fe->grid->s[i]*fedegree;
+      gM[i] = fe->grid->M[i]*fedegree+1; // global boundaries
+    }
+    ierr = PetscMalloc3(m[0]*m[1]*m[2],&fe->layout.elem,P*P*P,&fe->layout.node,m[0]*m[1]*m[2],&fe->layout.interior);CHKERRQ(ierr);
+    for (PetscInt ii=0; ii<P; ii++) {
+      for (PetscInt jj=0; jj<P; jj++) {
+        for (PetscInt kk=0; kk<P; kk++) fe->layout.node[(ii*P+jj)*P+kk] = FEIdxL(fe,ii,jj,kk)*fe->dof;
+      }
+    }
+    E = 0;
+    for (PetscInt i=0; i<m[0]; i++) {
+      for (PetscInt j=0; j<m[1]; j++) {
+        for (PetscInt k=0; k<m[2]; k++,E++) {
+          uint32_t mask = 0;
+          for (PetscInt ii=0; ii<P; ii++) {
+            for (PetscInt jj=0; jj<P; jj++) {
+              for (PetscInt kk=0; kk<P; kk++) {
+                PetscInt iu = i*fedegree+ii,ju = j*fedegree+jj,ku = k*fedegree+kk;
+                if ((0<gs[0]+iu && gs[0]+iu<gM[0]-1) && (0<gs[1]+ju && gs[1]+ju<gM[1]-1) && (0<gs[2]+ku && gs[2]+ku<gM[2]-1)) {
+                  mask |= (uint32_t)1 << ((ii*P+jj)*P+kk);
+                }
+              }
+            }
+          }
+          fe->layout.elem[E] = FEIdxLs(fe,i*fedegree,j*fedegree,k*fedegree)*fe->dof;
+          fe->layout.interior[E] = mask;
+        }
+      }
+    }
+  }
+  if (elemoffset) *elemoffset = fe->layout.elem;
+  if (nodeoffset) *nodeoffset = fe->layout.node;
+  if (interior)   *interior   = fe->layout.interior;
   PetscFunctionReturn(0);
 }
 
@@ -1016,6 +1095,7 @@ static PetscErrorCode FEDestroy(void **ctx)
   ierr = PetscSFDestroy(&fe->sfinjectLocal);CHKERRQ(ierr);
   ierr = DMDestroy(&fe->dmcoarse);CHKERRQ(ierr);
   ierr = PetscFree6(fe->ref.B,fe->ref.D,fe->ref.x,fe->ref.w,fe->ref.interp,fe->ref.w3);CHKERRQ(ierr);
+  ierr = PetscFree3(fe->layout.elem,fe->layout.node,fe->layout.interior);CHKERRQ(ierr);
   ierr = PetscFree(*ctx);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
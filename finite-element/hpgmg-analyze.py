@@ -1,4 +1,23 @@
+def parse_jsonfile(fname):
+    'Parse the report written by "hpgmg-fe sample -json fname"'
+    import json
+    with open(fname) as f:
+        report = json.load(f)
+    Time = []
+    Dofs = []
+    GFlops = []
+    MEqs = []
+    for sample in report['samples']:
+        for solve in sample['solves']:
+            Time.append(solve['seconds'])
+            Dofs.append(sample['equations'])
+            GFlops.append(solve['gflops'])
+            MEqs.append(solve['meqs'])
+    return Time, Dofs, GFlops, MEqs, report['hostname'], report['mpi_ranks']
+
 def parse_logfile(fname):
+    if fname.endswith('.json'):
+        return parse_jsonfile(fname)
     import re
     FP = r'([+-]?(?:\d+(?:\.\d*)?|\.\d+)(?:[eE][+-]?\d+)?)'
     PERFLINE = []
@@ -102,6 +121,6 @@ if __name__ == "__main__":
     parser.add_argument('-o', '--output', type=str, help='Output file')
     parser.add_argument('--loglog', action='store_true', help='Use logarithmic y axis (x is always logarithmic)')
     parser.add_argument('--xvar', type=str, choices='dof dofperprocess time', default='time')
-    parser.add_argument('logfiles', nargs='+', type=str, help='List of files to process, usually including -log_summary')
+    parser.add_argument('logfiles', nargs='+', type=str, help='List of files to process, usually including -log_summary (or JSON reports from -json)')
     args = parser.parse_args()
     plot(args)
@@ -1,3 +1,6 @@
+gentensor := $(call thisdir,gentensor.py)
+tensor-gen.c := $(OBJDIR)/tensor-gen.c
+
 hpgmg-fe-y.c += $(call thisdir, \
 	fefas.c \
 	fefas-test.c \
@@ -6,9 +9,14 @@ hpgmg-fe-y.c += $(call thisdir, \
 	memusage.c \
 	sampler.c \
 	tensor.c \
-	tensor-fma.c \
-	tensor-avx512.c \
 	tensor-qpx.c \
-	)
+	) $(tensor-gen.c)
 
 include $(call incsubdirs,op)
+
+# Kernels are generated for the (ne,dof,P,Q) requested by the operators in op/, so these rules must follow the
+# include above, which sets op-impls.c and HPGMG_FE_DIR
+$(tensor-gen.c) : $(gentensor) $(op-impls.c) | $$(@D)/.DIR
+	$(PYTHON) $(gentensor) $@ $(op-impls.c)
+
+$(OBJDIR)/tensor-gen.o : HPGMG_CPPFLAGS += -I$(HPGMG_FE_DIR)
@@ -5,10 +5,12 @@
 #include "../tensor.h"
 
 typedef struct Op_private *Op;
+typedef struct OpGeometry_private *OpGeometry;
 
 MPI_Comm OpComm(Op);
 PetscErrorCode OpCreateFromOptions(MPI_Comm,Op*);
 PetscErrorCode OpDestroy(Op*);
+PetscErrorCode OpGetType(Op,const char**);
 PetscErrorCode OpSetDof(Op,PetscInt);
 PetscErrorCode OpGetDof(Op,PetscInt*);
 PetscErrorCode OpSetFEDegree(Op,PetscInt);
@@ -22,6 +24,8 @@ typedef PetscErrorCode (*OpPointwiseElementFunction)(Op,PetscInt,PetscInt,const
 PetscErrorCode OpSetPointwiseElement(Op,OpPointwiseElementFunction,PetscInt);
 PetscErrorCode OpSetAffineOnly(Op op,PetscBool affine);
 PetscErrorCode OpGetAffineOnly(Op op,PetscBool *affine);
+PetscErrorCode OpSetStoreJacobian(Op op,PetscBool store);
+PetscErrorCode OpGetStoreJacobian(Op op,PetscBool *store);
 PetscErrorCode OpSetDestroy(Op,PetscErrorCode (*)(Op));
 PetscErrorCode OpRegister(const char name[],PetscErrorCode (*f)(Op));
 PetscErrorCode OpInitializePackage(void);
@@ -37,5 +41,8 @@ PetscErrorCode OpIntegrateNorms(Op op,DM dm,Vec U,PetscReal *normInfty,PetscReal
 PetscErrorCode OpGetDiagonal(Op op,DM dm,Vec Diag);
 PetscErrorCode OpGetMat(Op op,DM dm,Mat *shell);
 PetscErrorCode OpGetTensors(Op op,Tensor *TensorDOF,Tensor *Tensor3);
+PetscErrorCode OpSetUpGeometry(Op op,DM dm);
+PetscErrorCode OpGetGeometry(Op op,DM dm,OpGeometry *geom);
+PetscErrorCode OpGeometryGetElements(Op op,OpGeometry geom,DM dm,const PetscScalar x[],PetscInt elem,PetscScalar dxwork[],PetscScalar wdxdetwork[],PetscScalar **dx,PetscScalar **wdxdet);
 
 #endif
@@ -81,6 +81,7 @@ static PetscErrorCode OpApply_Poisson(Op op,DM dm,Vec U,Vec V,
   PetscScalar *v;
   const PetscReal *B,*D,*w3;
   Tensor Tensor1,Tensor3;
+  OpGeometry geom;
 
   PetscFunctionBegin;
   ierr = DMFEGetTensorEval(dm,&P,&Q,&B,&D,NULL,NULL,&w3);CHKERRQ(ierr);
@@ -94,6 +95,7 @@ static PetscErrorCode OpApply_Poisson(Op op,DM dm,Vec U,Vec V,
   ierr = DMGetCoordinateDM(dm,&dmx);CHKERRQ(ierr);
   ierr = DMGetCoordinatesLocal(dm,&X);CHKERRQ(ierr);
   ierr = DMFEGetNumElements(dm,&nelem);CHKERRQ(ierr);
+  ierr = OpGetGeometry(op,dm,&geom);CHKERRQ(ierr);
   ierr = DMGlobalToLocalBegin(dm,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
   ierr = DMGlobalToLocalEnd(dm,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
   ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
@@ -101,20 +103,25 @@ static PetscErrorCode OpApply_Poisson(Op op,DM dm,Vec U,Vec V,
   ierr = VecGetArray(Vl,&v);CHKERRQ(ierr);
 
   for (PetscInt e=0; e<nelem; e+=NE) {
-    PetscScalar ve[1*P3*NE]_align,dv[3][1][Q3][NE]_align,ue[1*P3*NE]_align,du[3][1][Q3][NE]_align,xe[3*P3*NE]_align,dx[3][3][Q3][NE]_align,wdxdet[Q3][NE]_align;
-
-    ierr = DMFEExtractElements(dmx,x,e,NE,xe);CHKERRQ(ierr);
-    ierr = PetscMemzero(dx,sizeof dx);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor3,D,B,B,TENSOR_EVAL,xe,dx[0][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor3,B,D,B,TENSOR_EVAL,xe,dx[1][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor3,B,B,D,TENSOR_EVAL,xe,dx[2][0][0]);CHKERRQ(ierr);
-    ierr = PointwiseJacobianInvert_QPX(NE,Q*Q*Q,w3,dx,wdxdet);CHKERRQ(ierr);
+    PetscScalar ve[1*P3*NE]_align,dv[3][1][Q3][NE]_align,ue[1*P3*NE]_align,du[3][1][Q3][NE]_align,xe[3*P3*NE]_align,dxwork[3][3][Q3][NE]_align,wdxdetwork[Q3][NE]_align;
+    PetscScalar *dx = dxwork[0][0][0],*wdxdet = wdxdetwork[0];
+
+    if (geom) {
+      ierr = OpGeometryGetElements(op,geom,dm,x,e,NULL,NULL,&dx,&wdxdet);CHKERRQ(ierr);
+    } else {
+      ierr = DMFEExtractElements(dmx,x,e,NE,xe);CHKERRQ(ierr);
+      ierr = PetscMemzero(dxwork,sizeof dxwork);CHKERRQ(ierr);
+      ierr = TensorContract(Tensor3,D,B,B,TENSOR_EVAL,xe,dxwork[0][0][0]);CHKERRQ(ierr);
+      ierr = TensorContract(Tensor3,B,D,B,TENSOR_EVAL,xe,dxwork[1][0][0]);CHKERRQ(ierr);
+      ierr = TensorContract(Tensor3,B,B,D,TENSOR_EVAL,xe,dxwork[2][0][0]);CHKERRQ(ierr);
+      ierr = PointwiseJacobianInvert_QPX(NE,Q*Q*Q,w3,dxwork,wdxdetwork);CHKERRQ(ierr);
+    }
     ierr = DMFEExtractElements(dm,u,e,NE,ue);CHKERRQ(ierr);
     ierr = PetscMemzero(du,sizeof du);CHKERRQ(ierr);
     ierr = TensorContract(Tensor1,D,B,B,TENSOR_EVAL,ue,du[0][0][0]);CHKERRQ(ierr);
     ierr = TensorContract(Tensor1,B,D,B,TENSOR_EVAL,ue,du[1][0][0]);CHKERRQ(ierr);
     ierr = TensorContract(Tensor1,B,B,D,TENSOR_EVAL,ue,du[2][0][0]);CHKERRQ(ierr);
-    ierr = PointwiseElement(op,NE,Q3,dx,wdxdet,du,dv);CHKERRQ(ierr);
+    ierr = PointwiseElement(op,NE,Q3,(PetscScalar(*)[3][Q3][NE])dx,(PetscReal(*)[NE])wdxdet,du,dv);CHKERRQ(ierr);
     ierr = PetscMemzero(ve,sizeof ve);CHKERRQ(ierr);
     ierr = TensorContract(Tensor1,D,B,B,TENSOR_TRANSPOSE,dv[0][0][0],ve);CHKERRQ(ierr);
     ierr = TensorContract(Tensor1,B,D,B,TENSOR_TRANSPOSE,dv[1][0][0],ve);CHKERRQ(ierr);
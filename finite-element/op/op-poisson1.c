@@ -95,7 +95,7 @@ static inline PetscErrorCode OpPointwiseElement_PoissonN(Op op,PetscInt ne,Petsc
       }
     }
   }
-  PetscLogFlops(Q3*ne*(5*3 + 0 + 6*3));
+  FELogFlops(Q3*ne*(5*3 + 0 + 6*3));
   return 0;
 }
 // Let the compiler specialize on known array sizes
@@ -110,51 +110,54 @@ static PetscErrorCode OpApply_Poisson(Op op,DM dm,Vec U,Vec V,
 {
   PetscErrorCode ierr;
   Vec X,Ul,Vl;
-  PetscInt nelem,P,Q,P3,Q3;
-  DM dmx;
+  PetscInt nbatch,nchunks,P,Q,P3,Q3;
   const PetscScalar *x,*u;
   PetscScalar *v;
-  const PetscReal *B,*D,*w3;
-  Tensor Tensor1,Tensor3;
+  const PetscReal *B,*D;
+  Tensor Tensor1;
+  OpGeometry geom;
 
   PetscFunctionBegin;
-  ierr = DMFEGetTensorEval(dm,&P,&Q,&B,&D,NULL,NULL,&w3);CHKERRQ(ierr);
+  ierr = DMFEGetTensorEval(dm,&P,&Q,&B,&D,NULL,NULL,NULL);CHKERRQ(ierr);
   P3 = P*P*P;
   Q3 = Q*Q*Q;
-  ierr = OpGetTensors(op,&Tensor1,&Tensor3);CHKERRQ(ierr);
+  ierr = OpGetTensors(op,&Tensor1,NULL);CHKERRQ(ierr);
 
   ierr = DMGetLocalVector(dm,&Ul);CHKERRQ(ierr);
   ierr = DMGetLocalVector(dm,&Vl);CHKERRQ(ierr);
   ierr = VecZeroEntries(Vl);CHKERRQ(ierr);
-  ierr = DMGetCoordinateDM(dm,&dmx);CHKERRQ(ierr);
   ierr = DMGetCoordinatesLocal(dm,&X);CHKERRQ(ierr);
-  ierr = DMFEGetNumElements(dm,&nelem);CHKERRQ(ierr);
+  ierr = DMFEGetElementChunks(dm,NE,&nbatch,&nchunks);CHKERRQ(ierr);
+  ierr = OpGetGeometry(op,dm,&geom);CHKERRQ(ierr);
   ierr = DMGlobalToLocalBegin(dm,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
   ierr = DMGlobalToLocalEnd(dm,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
   ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
   ierr = VecGetArrayRead(Ul,&u);CHKERRQ(ierr);
   ierr = VecGetArray(Vl,&v);CHKERRQ(ierr);
 
-  for (PetscInt e=0; e<nelem; e+=NE) {
-    PetscScalar ve[1*P3*NE]_align,dv[3][1][Q3][NE]_align,ue[1*P3*NE]_align,du[3][1][Q3][NE]_align,xe[3*P3*NE]_align,dx[3][3][Q3][NE]_align,wdxdet[Q3][NE]_align;
-
-    ierr = DMFEExtractElements(dmx,x,e,NE,xe);CHKERRQ(ierr);
-    ierr = PetscMemzero(dx,sizeof dx);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor3,D,B,B,TENSOR_EVAL,xe,dx[0][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor3,B,D,B,TENSOR_EVAL,xe,dx[1][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor3,B,B,D,TENSOR_EVAL,xe,dx[2][0][0]);CHKERRQ(ierr);
-    ierr = PointwiseJacobianInvert(NE,Q*Q*Q,w3,dx,wdxdet);CHKERRQ(ierr);
-    ierr = DMFEExtractElements(dm,u,e,NE,ue);CHKERRQ(ierr);
-    ierr = PetscMemzero(du,sizeof du);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,D,B,B,TENSOR_EVAL,ue,du[0][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,B,D,B,TENSOR_EVAL,ue,du[1][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,B,B,D,TENSOR_EVAL,ue,du[2][0][0]);CHKERRQ(ierr);
-    ierr = PointwiseElement(op,NE,Q3,dx,wdxdet,du,dv);CHKERRQ(ierr);
-    ierr = PetscMemzero(ve,sizeof ve);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,D,B,B,TENSOR_TRANSPOSE,dv[0][0][0],ve);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,B,D,B,TENSOR_TRANSPOSE,dv[1][0][0],ve);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,B,B,D,TENSOR_TRANSPOSE,dv[2][0][0],ve);CHKERRQ(ierr);
-    ierr = DMFESetElements(dm,v,e,NE,ADD_VALUES,DOMAIN_INTERIOR,ve);CHKERRQ(ierr);
+  for (PetscInt colour=0; colour<2; colour++) { // Chunks of one colour share no nodes
+    PetscErrorCode berr = 0;
+#pragma omp parallel for num_threads(FEGetMaxThreads()) reduction(max:berr)
+    for (PetscInt c=colour; c<nchunks; c+=2) {
+      for (PetscInt e=c*nbatch/nchunks*NE; e<(c+1)*nbatch/nchunks*NE; e+=NE) {
+        PetscErrorCode ierr = 0;
+        PetscScalar ve[1*P3*NE]_align,dv[3][1][Q3][NE]_align,ue[1*P3*NE]_align,du[3][1][Q3][NE]_align,dxwork[3*3*Q3*NE]_align,wdxdetwork[Q3*NE]_align,*dx,*wdxdet;
+
+        ierr = OpGeometryGetElements(op,geom,dm,x,e,dxwork,wdxdetwork,&dx,&wdxdet);CHKERRBATCH(ierr,berr);
+        ierr = DMFEExtractElements(dm,u,e,NE,ue);CHKERRBATCH(ierr,berr);
+        ierr = PetscMemzero(du,sizeof du);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,D,B,B,TENSOR_EVAL,ue,du[0][0][0]);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,B,D,B,TENSOR_EVAL,ue,du[1][0][0]);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,B,B,D,TENSOR_EVAL,ue,du[2][0][0]);CHKERRBATCH(ierr,berr);
+        ierr = PointwiseElement(op,NE,Q3,(PetscScalar(*)[3][Q3][NE])dx,(PetscReal(*)[NE])wdxdet,du,dv);CHKERRBATCH(ierr,berr);
+        ierr = PetscMemzero(ve,sizeof ve);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,D,B,B,TENSOR_TRANSPOSE,dv[0][0][0],ve);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,B,D,B,TENSOR_TRANSPOSE,dv[1][0][0],ve);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,B,B,D,TENSOR_TRANSPOSE,dv[2][0][0],ve);CHKERRBATCH(ierr,berr);
+        ierr = DMFESetElements(dm,v,e,NE,ADD_VALUES,DOMAIN_INTERIOR,ve);CHKERRBATCH(ierr,berr);
+      }
+    }
+    CHKERRQ(berr);
   }
   ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(Ul,&u);CHKERRQ(ierr);
@@ -176,7 +179,7 @@ static PetscErrorCode OpApply_Poisson2Affine(Op op,DM dm,Vec U,Vec V)
 {
   PetscErrorCode ierr;
   Vec Ul,Vl;
-  PetscInt nelem,P,Q,P3,Q3,Mglobal[3];
+  PetscInt nbatch,nchunks,P,Q,P3,Q3,Mglobal[3];
   PetscReal L[3];
   const PetscScalar *u;
   PetscScalar *v;
@@ -194,35 +197,164 @@ static PetscErrorCode OpApply_Poisson2Affine(Op op,DM dm,Vec U,Vec V)
   ierr = DMGetLocalVector(dm,&Ul);CHKERRQ(ierr);
   ierr = DMGetLocalVector(dm,&Vl);CHKERRQ(ierr);
   ierr = VecZeroEntries(Vl);CHKERRQ(ierr);
+  ierr = DMFEGetElementChunks(dm,NE,&nbatch,&nchunks);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(dm,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(dm,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(Ul,&u);CHKERRQ(ierr);
+  ierr = VecGetArray(Vl,&v);CHKERRQ(ierr);
+
+  for (PetscInt colour=0; colour<2; colour++) { // Chunks of one colour share no nodes
+    PetscErrorCode berr = 0;
+#pragma omp parallel for num_threads(FEGetMaxThreads()) reduction(max:berr)
+    for (PetscInt c=colour; c<nchunks; c+=2) {
+      for (PetscInt e=c*nbatch/nchunks*NE; e<(c+1)*nbatch/nchunks*NE; e+=NE) {
+        PetscErrorCode ierr = 0;
+        PetscScalar ve[1*P3*NE]_align,dv[3][1][Q3][NE]_align,ue[1*P3*NE]_align,du[3][1][Q3][NE]_align,dx[3],wdxdet[Q3];
+
+        for (PetscInt i=0; i<3; i++) dx[i] = 2.*Mglobal[i]/L[i];
+        for (PetscInt i=0; i<Q3; i++) wdxdet[i] = w3[i] / (dx[0]*dx[1]*dx[2]);
+        ierr = DMFEExtractElements(dm,u,e,NE,ue);CHKERRBATCH(ierr,berr);
+        ierr = PetscMemzero(du,sizeof du);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,D,B,B,TENSOR_EVAL,ue,du[0][0][0]);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,B,D,B,TENSOR_EVAL,ue,du[1][0][0]);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,B,B,D,TENSOR_EVAL,ue,du[2][0][0]);CHKERRBATCH(ierr,berr);
+        for (PetscInt i=0; i<Q3; i++) {
+          for (PetscInt j=0; j<3; j++) {
+            for (PetscInt l=0; l<NE; l++) {
+              dv[j][0][i][l] = wdxdet[i] * dx[j] * dx[j] * du[j][0][i][l];
+            }
+          }
+        }
+        ierr = PetscMemzero(ve,sizeof ve);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,D,B,B,TENSOR_TRANSPOSE,dv[0][0][0],ve);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,B,D,B,TENSOR_TRANSPOSE,dv[1][0][0],ve);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(Tensor1,B,B,D,TENSOR_TRANSPOSE,dv[2][0][0],ve);CHKERRBATCH(ierr,berr);
+        ierr = DMFESetElements(dm,v,e,NE,ADD_VALUES,DOMAIN_INTERIOR,ve);CHKERRBATCH(ierr,berr);
+      }
+    }
+    CHKERRQ(berr);
+  }
+  ierr = VecRestoreArrayRead(Ul,&u);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm,&Ul);CHKERRQ(ierr);
+  ierr = VecRestoreArray(Vl,&v);CHKERRQ(ierr);
+  ierr = VecZeroEntries(V);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalBegin(dm,Vl,ADD_VALUES,V);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalEnd(dm,Vl,ADD_VALUES,V);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm,&Vl);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+// One-dimensional contraction of a batch of Q2 elements along direction dir (0 is the slowest index), y = A x or, if
+// transpose, y = A^T x, accumulating into y if add.  Sizes are compile-time constants so the loops fully unroll.
+static inline void Contract1_Q2(const PetscReal A[3][3],PetscInt dir,PetscBool transpose,PetscBool add,const PetscScalar x[27][NE],PetscScalar y[27][NE]) {
+  const PetscInt stride = dir == 0 ? 9 : (dir == 1 ? 3 : 1);
+  for (PetscInt n=0; n<27; n++) {
+    const PetscInt a = (n/stride)%3,base = n - a*stride;
+    PetscScalar acc[NE]_align;
+    for (PetscInt l=0; l<NE; l++) acc[l] = add ? y[n][l] : 0;
+    for (PetscInt i=0; i<3; i++) {
+      const PetscReal c = transpose ? A[i][a] : A[a][i];
+      for (PetscInt l=0; l<NE; l++) acc[l] += c * x[base+i*stride][l];
+    }
+    for (PetscInt l=0; l<NE; l++) y[n][l] = acc[l];
+  }
+}
+
+// Fused Q2 apply: gathers each batch straight from the local array using the layout precomputed by
+// DMFEGetElementLayout(), evaluates the gradient with 8 shared one-dimensional contractions (instead of 9 independent
+// ones), applies the transpose the same way, and scatters the interior nodes through the precomputed mask.  All
+// intermediates of a batch (a few KiB) stay in L1.
+static PetscErrorCode OpApply_Poisson2Fused(Op op,DM dm,Vec U,Vec V)
+{
+  PetscErrorCode ierr;
+  Vec X,Ul,Vl;
+  PetscInt nelem,nbatch,nchunks,P,Q;
+  const PetscScalar *x,*u;
+  PetscScalar *v;
+  const PetscReal *Bf,*Df;
+  const PetscInt *elemoffset,*nodeoffset;
+  const uint32_t *interior;
+  PetscReal B[3][3],D[3][3];
+  OpGeometry geom;
+
+  PetscFunctionBegin;
+  ierr = DMFEGetTensorEval(dm,&P,&Q,&Bf,&Df,NULL,NULL,NULL);CHKERRQ(ierr);
+  if (P != 3 || Q != 3) SETERRQ2(PetscObjectComm((PetscObject)dm),PETSC_ERR_SUP,"Fused kernel requires P=Q=3, got P=%D Q=%D",P,Q);
+  for (PetscInt i=0; i<3; i++) {
+    for (PetscInt j=0; j<3; j++) {
+      B[i][j] = Bf[i*3+j];
+      D[i][j] = Df[i*3+j];
+    }
+  }
+  ierr = DMFEGetElementLayout(dm,&elemoffset,&nodeoffset,&interior);CHKERRQ(ierr);
+
+  ierr = DMGetLocalVector(dm,&Ul);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(dm,&Vl);CHKERRQ(ierr);
+  ierr = VecZeroEntries(Vl);CHKERRQ(ierr);
+  ierr = DMGetCoordinatesLocal(dm,&X);CHKERRQ(ierr);
   ierr = DMFEGetNumElements(dm,&nelem);CHKERRQ(ierr);
+  ierr = DMFEGetElementChunks(dm,NE,&nbatch,&nchunks);CHKERRQ(ierr);
+  ierr = OpGetGeometry(op,dm,&geom);CHKERRQ(ierr);
   ierr = DMGlobalToLocalBegin(dm,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
   ierr = DMGlobalToLocalEnd(dm,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
   ierr = VecGetArrayRead(Ul,&u);CHKERRQ(ierr);
   ierr = VecGetArray(Vl,&v);CHKERRQ(ierr);
 
-  for (PetscInt e=0; e<nelem; e+=NE) {
-    PetscScalar ve[1*P3*NE]_align,dv[3][1][Q3][NE]_align,ue[1*P3*NE]_align,du[3][1][Q3][NE]_align,dx[3],wdxdet[Q3];
-
-    for (PetscInt i=0; i<3; i++) dx[i] = 2.*Mglobal[i]/L[i];
-    for (PetscInt i=0; i<Q3; i++) wdxdet[i] = w3[i] / (dx[0]*dx[1]*dx[2]);
-    ierr = DMFEExtractElements(dm,u,e,NE,ue);CHKERRQ(ierr);
-    ierr = PetscMemzero(du,sizeof du);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,D,B,B,TENSOR_EVAL,ue,du[0][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,B,D,B,TENSOR_EVAL,ue,du[1][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,B,B,D,TENSOR_EVAL,ue,du[2][0][0]);CHKERRQ(ierr);
-    for (PetscInt i=0; i<Q3; i++) {
-      for (PetscInt j=0; j<3; j++) {
-        for (PetscInt l=0; l<NE; l++) {
-          dv[j][0][i][l] = wdxdet[i] * dx[j] * dx[j] * du[j][0][i][l];
+  for (PetscInt colour=0; colour<2; colour++) { // Chunks of one colour share no nodes
+    PetscErrorCode berr = 0;
+#pragma omp parallel for num_threads(FEGetMaxThreads()) reduction(max:berr)
+    for (PetscInt c=colour; c<nchunks; c+=2) {
+      for (PetscInt e=c*nbatch/nchunks*NE; e<(c+1)*nbatch/nchunks*NE; e+=NE) {
+        PetscErrorCode ierr = 0;
+        PetscScalar ue[27][NE]_align,ve[27][NE]_align,du[3][1][27][NE]_align,dv[3][1][27][NE]_align,t[3][27][NE]_align;
+        PetscScalar dxwork[3*3*27*NE]_align,wdxdetwork[27*NE]_align,*dx,*wdxdet;
+        PetscInt offset[NE],ne = PetscMin(NE,nelem-e);
+
+        for (PetscInt l=0; l<NE; l++) offset[l] = elemoffset[PetscMin(e+l,nelem-1)]; // Last element replicated to fill the batch
+        for (PetscInt i=0; i<27; i++) {
+          for (PetscInt l=0; l<NE; l++) ue[i][l] = u[offset[l]+nodeoffset[i]];
         }
+        ierr = OpGeometryGetElements(op,geom,dm,x,e,dxwork,wdxdetwork,&dx,&wdxdet);CHKERRBATCH(ierr,berr);
+
+        // du[0] = (D B B) u, du[1] = (B D B) u, du[2] = (B B D) u sharing the partial contractions
+        Contract1_Q2(B,0,PETSC_FALSE,PETSC_FALSE,ue,t[0]);         // B..
+        Contract1_Q2(D,0,PETSC_FALSE,PETSC_FALSE,ue,t[1]);         // D..
+        Contract1_Q2(B,1,PETSC_FALSE,PETSC_FALSE,t[1],t[2]);       // DB.
+        Contract1_Q2(B,2,PETSC_FALSE,PETSC_FALSE,t[2],du[0][0]);   // DBB
+        Contract1_Q2(D,1,PETSC_FALSE,PETSC_FALSE,t[0],t[1]);       // BD.
+        Contract1_Q2(B,2,PETSC_FALSE,PETSC_FALSE,t[1],du[1][0]);   // BDB
+        Contract1_Q2(B,1,PETSC_FALSE,PETSC_FALSE,t[0],t[2]);       // BB.
+        Contract1_Q2(D,2,PETSC_FALSE,PETSC_FALSE,t[2],du[2][0]);   // BBD
+
+        ierr = OpPointwiseElement_Poisson2(op,NE,27,(PetscScalar(*)[3][27][NE])dx,(PetscReal(*)[NE])wdxdet,du,dv);CHKERRBATCH(ierr,berr);
+
+        // ve = (D B B)^T dv[0] + (B D B)^T dv[1] + (B B D)^T dv[2], in the reverse order
+        Contract1_Q2(B,2,PETSC_TRUE,PETSC_FALSE,dv[0][0],t[0]);    // ..B
+        Contract1_Q2(B,1,PETSC_TRUE,PETSC_FALSE,t[0],t[1]);        // .BB
+        Contract1_Q2(B,2,PETSC_TRUE,PETSC_FALSE,dv[1][0],t[0]);    // ..B
+        Contract1_Q2(D,1,PETSC_TRUE,PETSC_FALSE,t[0],t[2]);        // .DB
+        Contract1_Q2(D,2,PETSC_TRUE,PETSC_FALSE,dv[2][0],t[0]);    // ..D
+        Contract1_Q2(B,1,PETSC_TRUE,PETSC_TRUE,t[0],t[2]);         // .DB + .BD
+        Contract1_Q2(D,0,PETSC_TRUE,PETSC_FALSE,t[1],ve);          // DBB
+        Contract1_Q2(B,0,PETSC_TRUE,PETSC_TRUE,t[2],ve);           // DBB + BDB + BBD
+        FELogFlops(16*27*3*2*NE);
+
+        for (PetscInt l=0; l<ne; l++) {
+          const uint32_t mask = interior[e+l];
+          PetscScalar *vl = &v[offset[l]];
+          if (mask == 0x7ffffff) {  // All 27 nodes interior
+            for (PetscInt i=0; i<27; i++) vl[nodeoffset[i]] += ve[i][l];
+          } else {
+            for (PetscInt i=0; i<27; i++) if (mask & ((uint32_t)1 << i)) vl[nodeoffset[i]] += ve[i][l];
+          }
+        }
+        FELogFlops(27*ne);
       }
     }
-    ierr = PetscMemzero(ve,sizeof ve);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,D,B,B,TENSOR_TRANSPOSE,dv[0][0][0],ve);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,B,D,B,TENSOR_TRANSPOSE,dv[1][0][0],ve);CHKERRQ(ierr);
-    ierr = TensorContract(Tensor1,B,B,D,TENSOR_TRANSPOSE,dv[2][0][0],ve);CHKERRQ(ierr);
-    ierr = DMFESetElements(dm,v,e,NE,ADD_VALUES,DOMAIN_INTERIOR,ve);CHKERRQ(ierr);
+    CHKERRQ(berr);
   }
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(Ul,&u);CHKERRQ(ierr);
   ierr = DMRestoreLocalVector(dm,&Ul);CHKERRQ(ierr);
   ierr = VecRestoreArray(Vl,&v);CHKERRQ(ierr);
@@ -293,6 +425,17 @@ PetscErrorCode OpCreate_Poisson2(Op op)
   ierr = OpSetPointwiseElement(op,(OpPointwiseElementFunction)OpPointwiseElement_Poisson2,NE);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
+PetscErrorCode OpCreate_Poisson2Fused(Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = OpCreate__Poisson(op);CHKERRQ(ierr);
+  ierr = OpSetFEDegree(op,2);CHKERRQ(ierr);
+  ierr = OpSetApply(op,OpApply_Poisson2Fused);CHKERRQ(ierr);
+  ierr = OpSetPointwiseElement(op,(OpPointwiseElementFunction)OpPointwiseElement_Poisson2,NE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 PetscErrorCode OpCreate_Poisson2Affine(Op op)
 {
   PetscErrorCode ierr;
@@ -7,14 +7,16 @@ PetscErrorCode OpRegisterAll_Generated(void);
 
 static PetscFunctionList OpList;
 static PetscBool OpPackageInitialized;
-static PetscLogEvent OP_Apply,OP_RestrictState,OP_RestrictResidual,OP_Interpolate,OP_Solution,OP_Forcing,OP_IntegrateNorms,OP_GetDiagonal;
+static PetscLogEvent OP_Apply,OP_RestrictState,OP_RestrictResidual,OP_Interpolate,OP_Solution,OP_Forcing,OP_IntegrateNorms,OP_GetDiagonal,OP_SetUpGeometry;
 
 struct Op_private {
   MPI_Comm comm;                /* Finest level comm (only for diagnostics at setup time) */
+  char type[256];               /* Name registered with OpRegister (-op_type) */
   PetscInt fedegree;
   PetscInt dof;
   PetscInt ne;                  /* Preferred number of elements over which to vectorize */
   PetscBool affineonly;
+  PetscBool storejacobian;      /* Cache geometric factors per level instead of recomputing them on every apply */
   Tensor   TensorDOF,Tensor3;
   PetscErrorCode (*Apply)(Op,DM,Vec,Vec);
   PetscErrorCode (*RestrictState)(Op,DM,Vec,Vec);
@@ -28,6 +30,10 @@ struct Op_private {
 };
 
 MPI_Comm OpComm(Op op) { return op->comm; }
+PetscErrorCode OpGetType(Op op,const char **type) {
+  *type = op->type;
+  return 0;
+}
 PetscErrorCode OpSetFEDegree(Op op,PetscInt degree) {
   op->fedegree = degree;
   return 0;
@@ -81,6 +87,129 @@ PetscErrorCode OpGetAffineOnly(Op op,PetscBool *affine) {
   *affine = op->affineonly;
   return 0;
 }
+PetscErrorCode OpSetStoreJacobian(Op op,PetscBool store) {
+  op->storejacobian = store;
+  return 0;
+}
+PetscErrorCode OpGetStoreJacobian(Op op,PetscBool *store) {
+  *store = op->storejacobian;
+  return 0;
+}
+
+// Inverse coordinate Jacobian dx[3][3][Q3][ne] and weighted determinant wdxdet[Q3][ne] for each batch of ne elements
+struct OpGeometry_private {
+  PetscInt ne,Q3,nbatch;
+  PetscScalar *dx;
+  PetscScalar *wdxdet;
+};
+
+static PetscErrorCode OpGeometryDestroy(void *ctx) {
+  PetscErrorCode ierr;
+  OpGeometry geom = (OpGeometry)ctx;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(geom->dx,geom->wdxdet);CHKERRQ(ierr);
+  ierr = PetscFree(geom);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+// Evaluate the geometric factors of elements elem:elem+ne from the local coordinate array x
+static PetscErrorCode OpGeometryCompute(Op op,DM dm,const PetscScalar x[],PetscInt elem,PetscScalar dx[],PetscScalar wdxdet[]) {
+  PetscErrorCode ierr;
+  DM dmx;
+  PetscInt P,Q,P3,Q3,ne = op->ne;
+  const PetscReal *B,*D,*w3;
+
+  PetscFunctionBegin;
+  ierr = DMFEGetTensorEval(dm,&P,&Q,&B,&D,NULL,NULL,&w3);CHKERRQ(ierr);
+  P3 = P*P*P;
+  Q3 = Q*Q*Q;
+  ierr = DMGetCoordinateDM(dm,&dmx);CHKERRQ(ierr);
+  {
+    PetscScalar xe[3*P3*ne]_align;
+
+    ierr = DMFEExtractElements(dmx,x,elem,ne,xe);CHKERRQ(ierr);
+    ierr = PetscMemzero(dx,3*3*Q3*ne*sizeof dx[0]);CHKERRQ(ierr);
+    ierr = TensorContract(op->Tensor3,D,B,B,TENSOR_EVAL,xe,&dx[0*3*Q3*ne]);CHKERRQ(ierr);
+    ierr = TensorContract(op->Tensor3,B,D,B,TENSOR_EVAL,xe,&dx[1*3*Q3*ne]);CHKERRQ(ierr);
+    ierr = TensorContract(op->Tensor3,B,B,D,TENSOR_EVAL,xe,&dx[2*3*Q3*ne]);CHKERRQ(ierr);
+    ierr = PointwiseJacobianInvert(ne,Q3,w3,(PetscScalar(*)[3][Q3][ne])dx,(PetscScalar(*)[ne])wdxdet);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+// With -op_store_jacobian, evaluate the geometric factors of every local element once and cache them on dm.  This
+// costs 10*Q^3 scalars per element and saves the coordinate extraction, three contractions, and the Jacobian inversion
+// otherwise repeated on every apply.  Call again if the coordinates of dm change.
+PetscErrorCode OpSetUpGeometry(Op op,DM dm) {
+  PetscErrorCode ierr;
+  PetscContainer container;
+  OpGeometry geom;
+  Vec X;
+  const PetscScalar *x;
+  PetscInt P,Q,nelem;
+  PetscErrorCode berr = 0;
+
+  PetscFunctionBegin;
+  if (!op->storejacobian || op->affineonly) PetscFunctionReturn(0);
+  ierr = PetscLogEventBegin(OP_SetUpGeometry,dm,0,0,0);CHKERRQ(ierr);
+  ierr = DMFEGetTensorEval(dm,&P,&Q,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  ierr = DMFEGetNumElements(dm,&nelem);CHKERRQ(ierr);
+  ierr = PetscNew(&geom);CHKERRQ(ierr);
+  geom->ne = op->ne;
+  geom->Q3 = Q*Q*Q;
+  geom->nbatch = (nelem + op->ne - 1) / op->ne;
+  ierr = PetscMalloc2(geom->nbatch*3*3*geom->Q3*geom->ne,&geom->dx,geom->nbatch*geom->Q3*geom->ne,&geom->wdxdet);CHKERRQ(ierr);
+  ierr = DMGetCoordinatesLocal(dm,&X);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+#pragma omp parallel for num_threads(FEGetMaxThreads()) reduction(max:berr)
+  for (PetscInt b=0; b<geom->nbatch; b++) {
+    PetscErrorCode ierr;
+    ierr = OpGeometryCompute(op,dm,x,b*geom->ne,&geom->dx[b*3*3*geom->Q3*geom->ne],&geom->wdxdet[b*geom->Q3*geom->ne]);CHKERRBATCH(ierr,berr);
+  }
+  CHKERRQ(berr);
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,geom);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,OpGeometryDestroy);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)dm,"OpGeometry",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(OP_SetUpGeometry,dm,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+// Returns the geometric factors cached on dm by OpSetUpGeometry(), or NULL if they must be recomputed
+PetscErrorCode OpGetGeometry(Op op,DM dm,OpGeometry *geom) {
+  PetscErrorCode ierr;
+  PetscContainer container;
+
+  PetscFunctionBegin;
+  *geom = NULL;
+  if (!op->storejacobian) PetscFunctionReturn(0);
+  ierr = PetscObjectQuery((PetscObject)dm,"OpGeometry",(PetscObject*)&container);CHKERRQ(ierr);
+  if (!container) PetscFunctionReturn(0);
+  ierr = PetscContainerGetPointer(container,(void**)geom);CHKERRQ(ierr);
+  if ((*geom)->ne != op->ne) SETERRQ2(PetscObjectComm((PetscObject)dm),PETSC_ERR_ARG_INCOMP,"Geometry cached for ne=%D, but operator uses ne=%D",(*geom)->ne,op->ne);
+  PetscFunctionReturn(0);
+}
+
+// Geometric factors of the batch of elements starting at elem (a multiple of ne), pointing into the cache if geom is
+// not NULL or else computed from the coordinates x into the workspace dxwork[3*3*Q3*ne] and wdxdetwork[Q3*ne].
+PetscErrorCode OpGeometryGetElements(Op op,OpGeometry geom,DM dm,const PetscScalar x[],PetscInt elem,PetscScalar dxwork[],PetscScalar wdxdetwork[],PetscScalar **dx,PetscScalar **wdxdet) {
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (geom) {
+    PetscInt b = elem / geom->ne;
+    *dx     = &geom->dx[b*3*3*geom->Q3*geom->ne];
+    *wdxdet = &geom->wdxdet[b*geom->Q3*geom->ne];
+    PetscFunctionReturn(0);
+  }
+  ierr = OpGeometryCompute(op,dm,x,elem,dxwork,wdxdetwork);CHKERRQ(ierr);
+  *dx     = dxwork;
+  *wdxdet = wdxdetwork;
+  PetscFunctionReturn(0);
+}
 
 PetscErrorCode OpSolution(Op op,DM dm,Vec U) {
   PetscErrorCode ierr;
@@ -115,13 +244,14 @@ PetscErrorCode OpForcing(Op op,DM dm,Vec F) {
   DM dmx;
   const PetscScalar *x;
   PetscScalar *f;
-  const PetscReal *B,*D,*w3;
+  const PetscReal *B,*D;
   PetscReal L[3];
-  PetscInt nelem,ne = op->ne,P,Q,P3,Q3;
+  PetscInt nbatch,nchunks,ne = op->ne,P,Q,P3,Q3;
+  OpGeometry geom;
 
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(OP_Forcing,dm,F,0,0);CHKERRQ(ierr);
-  ierr = DMFEGetTensorEval(dm,&P,&Q,&B,&D,NULL,NULL,&w3);CHKERRQ(ierr);
+  ierr = DMFEGetTensorEval(dm,&P,&Q,&B,&D,NULL,NULL,NULL);CHKERRQ(ierr);
   P3 = P*P*P;
   Q3 = Q*Q*Q;
 
@@ -129,34 +259,40 @@ PetscErrorCode OpForcing(Op op,DM dm,Vec F) {
   ierr = DMGetLocalVector(dm,&Floc);CHKERRQ(ierr);
   ierr = DMGetCoordinateDM(dm,&dmx);CHKERRQ(ierr);
   ierr = DMGetCoordinatesLocal(dm,&X);CHKERRQ(ierr);
-  ierr = DMFEGetNumElements(dm,&nelem);CHKERRQ(ierr);
+  ierr = DMFEGetElementChunks(dm,ne,&nbatch,&nchunks);CHKERRQ(ierr);
+  ierr = OpGetGeometry(op,dm,&geom);CHKERRQ(ierr);
   ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
   ierr = VecZeroEntries(Floc);CHKERRQ(ierr);
   ierr = VecGetArray(Floc,&f);CHKERRQ(ierr);
 
-  for (PetscInt e=0; e<nelem; e+=ne) {
-    PetscScalar fe[op->dof*P3*ne]_align,fq[op->dof][Q3][ne]_align,xe[3*P3*ne]_align,xq[3][Q3][ne]_align,dx[3][3][Q3][ne]_align,wdxdet[Q3][ne]_align;
-
-    ierr = DMFEExtractElements(dmx,x,e,ne,xe);CHKERRQ(ierr);
-    ierr = PetscMemzero(xq,sizeof xq);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,B,B,B,TENSOR_EVAL,xe,xq[0][0]);CHKERRQ(ierr);
-    ierr = PetscMemzero(dx,sizeof dx);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,D,B,B,TENSOR_EVAL,xe,dx[0][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,B,D,B,TENSOR_EVAL,xe,dx[1][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,B,B,D,TENSOR_EVAL,xe,dx[2][0][0]);CHKERRQ(ierr);
-    ierr = PointwiseJacobianInvert(ne,Q*Q*Q,w3,dx,wdxdet);CHKERRQ(ierr);
-
-    for (PetscInt i=0; i<Q3; i++) {
-      for (PetscInt l=0; l<ne; l++) {
-        PetscReal xx[] = {xq[0][i][l],xq[1][i][l],xq[2][i][l]};
-        PetscScalar fql[op->dof];
-        ierr = (op->PointwiseForcing)(op,xx,L,fql);CHKERRQ(ierr);
-        for (PetscInt d=0; d<op->dof; d++) fq[d][i][l] = wdxdet[i][l] * fql[d];
+  for (PetscInt colour=0; colour<2; colour++) { // Chunks of one colour share no nodes
+    PetscErrorCode berr = 0;
+#pragma omp parallel for num_threads(FEGetMaxThreads()) reduction(max:berr)
+    for (PetscInt c=colour; c<nchunks; c+=2) {
+      for (PetscInt e=c*nbatch/nchunks*ne; e<(c+1)*nbatch/nchunks*ne; e+=ne) {
+        PetscErrorCode ierr = 0;
+        PetscScalar fe[op->dof*P3*ne]_align,fq[op->dof][Q3][ne]_align,xe[3*P3*ne]_align,xq[3][Q3][ne]_align,dxwork[3*3*Q3*ne]_align,wdxdetwork[Q3*ne]_align,*dx,*wdxdet;
+
+        ierr = DMFEExtractElements(dmx,x,e,ne,xe);CHKERRBATCH(ierr,berr);
+        ierr = PetscMemzero(xq,sizeof xq);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(op->Tensor3,B,B,B,TENSOR_EVAL,xe,xq[0][0]);CHKERRBATCH(ierr,berr);
+        ierr = OpGeometryGetElements(op,geom,dm,x,e,dxwork,wdxdetwork,&dx,&wdxdet);CHKERRBATCH(ierr,berr);
+
+        for (PetscInt i=0; i<Q3 && !ierr; i++) {
+          for (PetscInt l=0; l<ne && !ierr; l++) {
+            PetscReal xx[] = {xq[0][i][l],xq[1][i][l],xq[2][i][l]};
+            PetscScalar fql[op->dof];
+            ierr = (op->PointwiseForcing)(op,xx,L,fql);
+            for (PetscInt d=0; d<op->dof; d++) fq[d][i][l] = wdxdet[i*ne+l] * fql[d];
+          }
+        }
+        CHKERRBATCH(ierr,berr);
+        ierr = PetscMemzero(fe,sizeof fe);CHKERRBATCH(ierr,berr);
+        ierr = TensorContract(op->TensorDOF,B,B,B,TENSOR_TRANSPOSE,fq[0][0],fe);CHKERRBATCH(ierr,berr);
+        ierr = DMFESetElements(dm,f,e,ne,ADD_VALUES,DOMAIN_INTERIOR,fe);CHKERRBATCH(ierr,berr);
       }
     }
-    ierr = PetscMemzero(fe,sizeof fe);CHKERRQ(ierr);
-    ierr = TensorContract(op->TensorDOF,B,B,B,TENSOR_TRANSPOSE,fq[0][0],fe);CHKERRQ(ierr);
-    ierr = DMFESetElements(dm,f,e,ne,ADD_VALUES,DOMAIN_INTERIOR,fe);CHKERRQ(ierr);
+    CHKERRQ(berr);
   }
   ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
   ierr = VecRestoreArray(Floc,&f);CHKERRQ(ierr);
@@ -174,14 +310,17 @@ PetscErrorCode OpIntegrateNorms(Op op,DM dm,Vec U,PetscReal *normInfty,PetscReal
   Vec X,Uloc;
   DM dmx;
   const PetscScalar *x,*u;
-  const PetscReal *B,*D,*w3;
+  const PetscReal *B,*D;
   PetscReal L[3];
   struct {PetscReal error,u;} sumInfty={},sum2={};
+  PetscReal errorInfty = 0,uInfty = 0,error2 = 0,u2 = 0;
   PetscInt nelem,ne = op->ne,P,Q,P3,Q3;
+  PetscErrorCode berr = 0;
+  OpGeometry geom;
 
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(OP_IntegrateNorms,dm,U,0,0);CHKERRQ(ierr);
-  ierr = DMFEGetTensorEval(dm,&P,&Q,&B,&D,NULL,NULL,&w3);CHKERRQ(ierr);
+  ierr = DMFEGetTensorEval(dm,&P,&Q,&B,&D,NULL,NULL,NULL);CHKERRQ(ierr);
   P3 = P*P*P;
   Q3 = Q*Q*Q;
 
@@ -192,41 +331,47 @@ PetscErrorCode OpIntegrateNorms(Op op,DM dm,Vec U,PetscReal *normInfty,PetscReal
   ierr = DMGlobalToLocalBegin(dm,U,INSERT_VALUES,Uloc);CHKERRQ(ierr);
   ierr = DMGlobalToLocalEnd(dm,U,INSERT_VALUES,Uloc);CHKERRQ(ierr);
   ierr = DMFEGetNumElements(dm,&nelem);CHKERRQ(ierr);
+  ierr = OpGetGeometry(op,dm,&geom);CHKERRQ(ierr);
   ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
   ierr = VecGetArrayRead(Uloc,&u);CHKERRQ(ierr);
 
+  // No scatter, so batches are independent; the partial norms are combined by the reduction
+#pragma omp parallel for num_threads(FEGetMaxThreads()) reduction(max:errorInfty,uInfty,berr) reduction(+:error2,u2)
   for (PetscInt e=0; e<nelem; e+=ne) {
-    PetscScalar ue[op->dof*P3*ne]_align,uq[op->dof][Q3][ne]_align,xe[3*P3*ne]_align,xq[3][Q3][ne]_align,dx[3][3][Q3][ne]_align,wdxdet[Q3][ne]_align;
-
-    ierr = DMFEExtractElements(dmx,x,e,ne,xe);CHKERRQ(ierr);
-    ierr = PetscMemzero(xq,sizeof xq);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,B,B,B,TENSOR_EVAL,xe,xq[0][0]);CHKERRQ(ierr);
-    ierr = PetscMemzero(dx,sizeof dx);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,D,B,B,TENSOR_EVAL,xe,dx[0][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,B,D,B,TENSOR_EVAL,xe,dx[1][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,B,B,D,TENSOR_EVAL,xe,dx[2][0][0]);CHKERRQ(ierr);
-    ierr = PointwiseJacobianInvert(ne,Q3,w3,dx,wdxdet);CHKERRQ(ierr);
-
-    ierr = DMFEExtractElements(dm,u,e,ne,ue);CHKERRQ(ierr);
-    ierr = PetscMemzero(uq,sizeof uq);CHKERRQ(ierr);
-    ierr = TensorContract(op->TensorDOF,B,B,B,TENSOR_EVAL,ue,uq[0][0]);CHKERRQ(ierr);
-
-    for (PetscInt i=0; i<Q3; i++) {
-      for (PetscInt l=0; l<ne; l++) {
+    PetscErrorCode ierr = 0;
+    PetscScalar ue[op->dof*P3*ne]_align,uq[op->dof][Q3][ne]_align,xe[3*P3*ne]_align,xq[3][Q3][ne]_align,dxwork[3*3*Q3*ne]_align,wdxdetwork[Q3*ne]_align,*dx,*wdxdet;
+
+    ierr = DMFEExtractElements(dmx,x,e,ne,xe);CHKERRBATCH(ierr,berr);
+    ierr = PetscMemzero(xq,sizeof xq);CHKERRBATCH(ierr,berr);
+    ierr = TensorContract(op->Tensor3,B,B,B,TENSOR_EVAL,xe,xq[0][0]);CHKERRBATCH(ierr,berr);
+    ierr = OpGeometryGetElements(op,geom,dm,x,e,dxwork,wdxdetwork,&dx,&wdxdet);CHKERRBATCH(ierr,berr);
+
+    ierr = DMFEExtractElements(dm,u,e,ne,ue);CHKERRBATCH(ierr,berr);
+    ierr = PetscMemzero(uq,sizeof uq);CHKERRBATCH(ierr,berr);
+    ierr = TensorContract(op->TensorDOF,B,B,B,TENSOR_EVAL,ue,uq[0][0]);CHKERRBATCH(ierr,berr);
+
+    for (PetscInt i=0; i<Q3 && !ierr; i++) {
+      for (PetscInt l=0; l<ne && !ierr; l++) {
         PetscReal xx[] = {xq[0][i][l],xq[1][i][l],xq[2][i][l]};
         PetscScalar uql[op->dof],fql[op->dof];
-        ierr = (op->PointwiseSolution)(op,xx,L,uql);CHKERRQ(ierr);
-        ierr = (op->PointwiseForcing)(op,xx,L,fql);CHKERRQ(ierr);
+        ierr = (op->PointwiseSolution)(op,xx,L,uql);
+        if (!ierr) ierr = (op->PointwiseForcing)(op,xx,L,fql);
         for (PetscInt d=0; d<op->dof; d++) {
           PetscReal error = uq[d][i][l] - uql[d];
-          sumInfty.error = PetscMax(sumInfty.error,PetscAbs(error));
-          sumInfty.u     = PetscMax(sumInfty.u    ,PetscAbs(uql[d]));
-          sum2.error    += PetscSqr(error) * wdxdet[i][l];
-          sum2.u        += PetscSqr(uql[d]) * wdxdet[i][l];
+          errorInfty = PetscMax(errorInfty,PetscAbs(error));
+          uInfty     = PetscMax(uInfty    ,PetscAbs(uql[d]));
+          error2    += PetscSqr(error) * wdxdet[i*ne+l];
+          u2        += PetscSqr(uql[d]) * wdxdet[i*ne+l];
         }
       }
     }
+    CHKERRBATCH(ierr,berr);
   }
+  CHKERRQ(berr);
+  sumInfty.error = errorInfty;
+  sumInfty.u     = uInfty;
+  sum2.error     = error2;
+  sum2.u         = u2;
   ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(Uloc,&u);CHKERRQ(ierr);
   ierr = DMRestoreLocalVector(dm,&Uloc);CHKERRQ(ierr);
@@ -252,54 +397,58 @@ PetscErrorCode OpApply(Op op,DM dm,Vec U,Vec F) {
 PetscErrorCode OpGetDiagonal(Op op,DM dm,Vec Diag) {
   PetscErrorCode ierr;
   Vec X,Vl;
-  PetscInt nelem,P,Q,P3,Q3,NE;
-  DM dmx;
+  PetscInt nbatch,nchunks,P,Q,P3,Q3,NE;
   const PetscScalar *x;
   PetscScalar *diag;
-  const PetscReal *B,*D,*w3;
+  const PetscReal *B,*D;
+  OpGeometry geom;
 
   PetscFunctionBegin;
   if (!op->PointwiseElement) SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_USER,"No PointwiseElement implemented, use OpSetPointwiseElement()");
   if (op->dof != 1) SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_SUP,"dof != 1");
   ierr = PetscLogEventBegin(OP_GetDiagonal,dm,Diag,0,0);CHKERRQ(ierr);
-  ierr = DMFEGetTensorEval(dm,&P,&Q,&B,&D,NULL,NULL,&w3);CHKERRQ(ierr);
+  ierr = DMFEGetTensorEval(dm,&P,&Q,&B,&D,NULL,NULL,NULL);CHKERRQ(ierr);
   P3 = P*P*P;
   Q3 = Q*Q*Q;
   NE = op->ne;
 
   ierr = DMGetLocalVector(dm,&Vl);CHKERRQ(ierr);
   ierr = VecZeroEntries(Vl);CHKERRQ(ierr);
-  ierr = DMGetCoordinateDM(dm,&dmx);CHKERRQ(ierr);
   ierr = DMGetCoordinatesLocal(dm,&X);CHKERRQ(ierr);
-  ierr = DMFEGetNumElements(dm,&nelem);CHKERRQ(ierr);
+  ierr = DMFEGetElementChunks(dm,NE,&nbatch,&nchunks);CHKERRQ(ierr);
+  ierr = OpGetGeometry(op,dm,&geom);CHKERRQ(ierr);
   ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
   ierr = VecGetArray(Vl,&diag);CHKERRQ(ierr);
 
-  for (PetscInt e=0; e<nelem; e+=NE) {
-    PetscScalar diage[1*P3*NE]_align,ve[1*P3*NE]_align,dv[3][1][Q3][NE]_align,ue[1*P3*NE]_align,du[3][1][Q3][NE]_align,xe[3*P3*NE]_align,dx[3][3][Q3][NE]_align,wdxdet[Q3][NE]_align;
-
-    ierr = DMFEExtractElements(dmx,x,e,NE,xe);CHKERRQ(ierr);
-    ierr = PetscMemzero(dx,sizeof dx);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,D,B,B,TENSOR_EVAL,xe,dx[0][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,B,D,B,TENSOR_EVAL,xe,dx[1][0][0]);CHKERRQ(ierr);
-    ierr = TensorContract(op->Tensor3,B,B,D,TENSOR_EVAL,xe,dx[2][0][0]);CHKERRQ(ierr);
-    ierr = PointwiseJacobianInvert(NE,Q*Q*Q,w3,dx,wdxdet);CHKERRQ(ierr);
-
-    for (PetscInt i=0; i<P3; i++) {
-      ierr = PetscMemzero(ue,sizeof ue);CHKERRQ(ierr);
-      for (PetscInt k=0; k<op->ne; k++) ue[i*NE+k] = 1;
-      ierr = PetscMemzero(du,sizeof du);CHKERRQ(ierr);
-      ierr = TensorContract(op->TensorDOF,D,B,B,TENSOR_EVAL,ue,du[0][0][0]);CHKERRQ(ierr);
-      ierr = TensorContract(op->TensorDOF,B,D,B,TENSOR_EVAL,ue,du[1][0][0]);CHKERRQ(ierr);
-      ierr = TensorContract(op->TensorDOF,B,B,D,TENSOR_EVAL,ue,du[2][0][0]);CHKERRQ(ierr);
-      ierr = (*op->PointwiseElement)(op,NE,Q3,dx[0][0][0],wdxdet[0],du[0][0][0],dv[0][0][0]);CHKERRQ(ierr);
-      ierr = PetscMemzero(ve,sizeof ve);CHKERRQ(ierr);
-      ierr = TensorContract(op->TensorDOF,D,B,B,TENSOR_TRANSPOSE,dv[0][0][0],ve);CHKERRQ(ierr);
-      ierr = TensorContract(op->TensorDOF,B,D,B,TENSOR_TRANSPOSE,dv[1][0][0],ve);CHKERRQ(ierr);
-      ierr = TensorContract(op->TensorDOF,B,B,D,TENSOR_TRANSPOSE,dv[2][0][0],ve);CHKERRQ(ierr);
-      for (PetscInt k=0; k<op->ne; k++) diage[i*NE+k] = ve[i*NE+k];
+  for (PetscInt colour=0; colour<2; colour++) { // Chunks of one colour share no nodes
+    PetscErrorCode berr = 0;
+#pragma omp parallel for num_threads(FEGetMaxThreads()) reduction(max:berr)
+    for (PetscInt c=colour; c<nchunks; c+=2) {
+      for (PetscInt e=c*nbatch/nchunks*NE; e<(c+1)*nbatch/nchunks*NE; e+=NE) {
+        PetscErrorCode ierr = 0;
+        PetscScalar diage[1*P3*NE]_align,ve[1*P3*NE]_align,dv[3][1][Q3][NE]_align,ue[1*P3*NE]_align,du[3][1][Q3][NE]_align,dxwork[3*3*Q3*NE]_align,wdxdetwork[Q3*NE]_align,*dx,*wdxdet;
+
+        ierr = OpGeometryGetElements(op,geom,dm,x,e,dxwork,wdxdetwork,&dx,&wdxdet);CHKERRBATCH(ierr,berr);
+
+        for (PetscInt i=0; i<P3 && !ierr; i++) {
+          ierr = PetscMemzero(ue,sizeof ue);CHKERRBATCH(ierr,berr);
+          for (PetscInt k=0; k<op->ne; k++) ue[i*NE+k] = 1;
+          ierr = PetscMemzero(du,sizeof du);CHKERRBATCH(ierr,berr);
+          ierr = TensorContract(op->TensorDOF,D,B,B,TENSOR_EVAL,ue,du[0][0][0]);CHKERRBATCH(ierr,berr);
+          ierr = TensorContract(op->TensorDOF,B,D,B,TENSOR_EVAL,ue,du[1][0][0]);CHKERRBATCH(ierr,berr);
+          ierr = TensorContract(op->TensorDOF,B,B,D,TENSOR_EVAL,ue,du[2][0][0]);CHKERRBATCH(ierr,berr);
+          ierr = (*op->PointwiseElement)(op,NE,Q3,dx,wdxdet,du[0][0][0],dv[0][0][0]);CHKERRBATCH(ierr,berr);
+          ierr = PetscMemzero(ve,sizeof ve);CHKERRBATCH(ierr,berr);
+          ierr = TensorContract(op->TensorDOF,D,B,B,TENSOR_TRANSPOSE,dv[0][0][0],ve);CHKERRBATCH(ierr,berr);
+          ierr = TensorContract(op->TensorDOF,B,D,B,TENSOR_TRANSPOSE,dv[1][0][0],ve);CHKERRBATCH(ierr,berr);
+          ierr = TensorContract(op->TensorDOF,B,B,D,TENSOR_TRANSPOSE,dv[2][0][0],ve);CHKERRBATCH(ierr,berr);
+          for (PetscInt k=0; k<op->ne; k++) diage[i*NE+k] = ve[i*NE+k];
+        }
+        if (ierr) continue;
+        ierr = DMFESetElements(dm,diag,e,NE,ADD_VALUES,DOMAIN_INTERIOR,diage);CHKERRBATCH(ierr,berr);
+      }
     }
-    ierr = DMFESetElements(dm,diag,e,NE,ADD_VALUES,DOMAIN_INTERIOR,diage);CHKERRQ(ierr);
+    CHKERRQ(berr);
   }
   ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
   ierr = VecRestoreArray(Vl,&diag);CHKERRQ(ierr);
@@ -432,8 +581,10 @@ PetscErrorCode OpCreateFromOptions(MPI_Comm comm,Op *op)
   ierr = OpSetDof(o,1);CHKERRQ(ierr);
   ierr = PetscOptionsBegin(comm,NULL,"Operator options",NULL);CHKERRQ(ierr);
   ierr = PetscOptionsFList("-op_type","Operator type","",OpList,opname,opname,sizeof opname,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-op_store_jacobian","Store geometric factors at quadrature points instead of recomputing them in each apply","OpSetStoreJacobian",o->storejacobian,&o->storejacobian,NULL);CHKERRQ(ierr);
   ierr = PetscFunctionListFind(OpList,opname,&f);CHKERRQ(ierr);
   if (!f) SETERRQ1(comm,PETSC_ERR_USER,"Operator type '%s' not found",opname);
+  ierr = PetscStrncpy(o->type,opname,sizeof o->type);CHKERRQ(ierr);
   ierr = (*f)(o);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
   ierr = TensorCreate(o->ne,o->dof,o->fedegree+1,o->fedegree+1,&o->TensorDOF);CHKERRQ(ierr);
@@ -492,6 +643,7 @@ PetscErrorCode OpInitializePackage()
   ierr = PetscLogEventRegister("OpSolution"      ,DM_CLASSID,&OP_Solution);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("OpIntegNorms"    ,DM_CLASSID,&OP_IntegrateNorms);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("OpGetDiagonal"   ,DM_CLASSID,&OP_GetDiagonal);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("OpSetUpGeometry" ,DM_CLASSID,&OP_SetUpGeometry);CHKERRQ(ierr);
   ierr = PetscRegisterFinalize(OpFinalizePackage);CHKERRQ(ierr);
   OpPackageInitialized = PETSC_TRUE;
   PetscFunctionReturn(0);
@@ -3,6 +3,7 @@
 
 #include <petscsys.h>
 #include "fefas-align.h"
+#include "fefas-omp.h"
 
 static PetscErrorCode PointwiseJacobianInvert(PetscInt ne,PetscInt Q,const PetscReal w[Q],PetscScalar dx[3][3][Q][ne],PetscScalar wdxdet[Q][ne])
 {
@@ -34,7 +35,7 @@ static PetscErrorCode PointwiseJacobianInvert(PetscInt ne,PetscInt Q,const Petsc
       wdxdet[i][e] =  det*w[i];
     }
   }
-  PetscLogFlops(Q*ne*(14 + 1/* division */ + 27 + 1));
+  FELogFlops(Q*ne*(14 + 1/* division */ + 27 + 1));
   return 0;
 }
 
@@ -129,7 +129,8 @@ static PetscErrorCode ReportMemoryUsage(MPI_Comm comm,PetscLogDouble memused,Pet
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode SampleOnGrid(MPI_Comm comm,Op op,const PetscInt M[3],const PetscInt smooth[2],PetscInt nrepeat,PetscLogDouble mintime,PetscLogDouble *memused,PetscLogDouble *memavail,PetscBool monitor) {
+// If json is not NULL, the sample is also written to it as a JSON object (rank 0 writes; see -json)
+static PetscErrorCode SampleOnGrid(MPI_Comm comm,Op op,const PetscInt M[3],const PetscInt smooth[2],PetscInt nrepeat,PetscLogDouble mintime,PetscLogDouble *memused,PetscLogDouble *memavail,PetscBool monitor,FILE *json) {
   PetscErrorCode ierr;
   PetscInt pgrid[3],cmax,fedegree,dof,nlevels,M_max;
   PetscMPIInt nranks;
@@ -180,6 +181,10 @@ static PetscErrorCode SampleOnGrid(MPI_Comm comm,Op op,const PetscInt M[3],const
 #endif
   PetscInt i = 0;
   PetscLogDouble sampletime = 0;
+  if (json) {
+    ierr = PetscFPrintf(comm,json,"    {\"grid\": [%D, %D, %D], \"processes\": [%D, %D, %D], \"levels\": %D, \"equations\": %.0f, \"solves\": [",
+                        M[0],M[1],M[2],pgrid[0],pgrid[1],pgrid[2],nlevels,(double)(M[0]*fedegree+1)*(M[1]*fedegree+1)*(M[2]*fedegree+1)*dof);CHKERRQ(ierr);
+  }
   while ( (i<nrepeat) || (sampletime < mintime) ) {
     PetscLogDouble t0,t1,elapsed,flops,eqs;
     ierr = VecZeroEntries(U);CHKERRQ(ierr);
@@ -194,12 +199,16 @@ static PetscErrorCode SampleOnGrid(MPI_Comm comm,Op op,const PetscInt M[3],const
     ierr = MPI_Allreduce(MPI_IN_PLACE,&flops,1,MPI_DOUBLE,MPI_SUM,comm);CHKERRQ(ierr);
     eqs = (double)(M[0]*fedegree+1)*(M[1]*fedegree+1)*(M[2]*fedegree+1)*dof;
     ierr = PetscPrintf(comm,"Q%D G[%5D%5D%5D] P[%3D%3D%3D] %10.3e s  %10f GF  %10f MEq/s\n",fedegree,M[0],M[1],M[2],pgrid[0],pgrid[1],pgrid[2],t1-t0,flops/elapsed*1e-9,eqs/elapsed*1e-6);CHKERRQ(ierr);
+    if (json) {
+      ierr = PetscFPrintf(comm,json,"%s\n      {\"seconds\": %e, \"gflops\": %f, \"meqs\": %f}",i?",":"",elapsed,flops/elapsed*1e-9,eqs/elapsed*1e-6);CHKERRQ(ierr);
+    }
     i++;
     sampletime += elapsed;
   }
 #ifdef USE_HPM
   HPM_Stop(eventname);
 #endif
+  if (json) {ierr = PetscFPrintf(comm,json,"\n    ]}");CHKERRQ(ierr);}
 
   if (memused) {ierr = MemoryGetUsage(memused,memavail);CHKERRQ(ierr);}
   ierr = MGDestroy(&mg);CHKERRQ(ierr);
@@ -210,15 +219,56 @@ static PetscErrorCode SampleOnGrid(MPI_Comm comm,Op op,const PetscInt M[3],const
   PetscFunctionReturn(0);
 }
 
+// Compile time options that select the kernels (see tensor*.c), as a JSON array
+static PetscErrorCode ReportBuildJSON(MPI_Comm comm,FILE *json) {
+  PetscErrorCode ierr;
+  const char *flags[] = {
+#ifdef __AVX__
+    "__AVX__",
+#endif
+#ifdef __FMA__
+    "__FMA__",
+#endif
+#ifdef __AVX512F__
+    "__AVX512F__",
+#endif
+#ifdef __bgq__
+    "__bgq__",
+#endif
+#ifdef USE_HPM
+    "USE_HPM",
+#endif
+#ifdef PETSC_USE_64BIT_INDICES
+    "PETSC_USE_64BIT_INDICES",
+#endif
+#ifdef PETSC_USE_DEBUG
+    "PETSC_USE_DEBUG",
+#endif
+    NULL
+  };
+
+  PetscFunctionBegin;
+  ierr = PetscFPrintf(comm,json,"{\"flags\": [");CHKERRQ(ierr);
+  for (PetscInt i=0; flags[i]; i++) {
+    ierr = PetscFPrintf(comm,json,"%s\"%s\"",i?", ":"",flags[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscFPrintf(comm,json,"], \"petsc_version\": \"%d.%d.%d\", \"sizeof_scalar\": %d}",PETSC_VERSION_MAJOR,PETSC_VERSION_MINOR,PETSC_VERSION_SUBMINOR,(int)sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode RunSample() {
   PetscErrorCode ierr;
   Op op;
-  PetscInt pgrid[3],smooth[2] = {3,1},two = 2,maxsamples = 6,repeat = 5,nsamples,(*gridsize)[3];
+  PetscInt pgrid[3],smooth[2] = {3,1},two = 2,maxsamples = 6,repeat = 5,nsamples,(*gridsize)[3],fedegree,dof;
   PetscReal local[2] = {100,10000};
   PetscReal mintime = 1;
   PetscLogDouble memused,memavail;
   PetscMPIInt nranks;
   MPI_Comm comm = PETSC_COMM_WORLD;
+  char jsonname[PETSC_MAX_PATH_LEN] = "",hostname[256];
+  PetscBool dojson = PETSC_FALSE,storejacobian;
+  FILE *json = NULL;
+  const char *optype;
 
   PetscFunctionBegin;
   ierr = PetscOptionsBegin(comm,NULL,"FMG Performance Sampler options",NULL);CHKERRQ(ierr);
@@ -229,6 +279,7 @@ PetscErrorCode RunSample() {
   ierr = PetscOptionsReal("-mintime","Minimum interval (in seconds) for repeatedly solving each problem size","",mintime,&mintime,NULL);CHKERRQ(ierr);
   two = 2;
   ierr = PetscOptionsIntArray("-smooth","V- and F-cycle pre,post smoothing","",smooth,&two,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsString("-json","Also write a machine-readable (JSON) report of the samples to this file","",jsonname,jsonname,sizeof jsonname,&dojson);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
 
   ierr = OpCreateFromOptions(comm,&op);CHKERRQ(ierr);
@@ -236,6 +287,9 @@ PetscErrorCode RunSample() {
   ierr = MPI_Comm_size(comm,&nranks);CHKERRQ(ierr);
   ierr = ProcessGridFindSquarest(nranks,pgrid);CHKERRQ(ierr);
   ierr = PetscPrintf(comm,"Finite Element FAS Performance Sampler on process grid [%D %D %D] = %d\n",pgrid[0],pgrid[1],pgrid[2],nranks);CHKERRQ(ierr);
+  ierr = OpGetStoreJacobian(op,&storejacobian);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"Geometric factors %s\n",storejacobian ? "stored per level (-op_store_jacobian)" : "recomputed in each apply");CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"Element loops use %D OpenMP thread(s) per MPI rank\n",FEGetMaxThreads());CHKERRQ(ierr);
 
   ierr = SampleGridRangeCreate(nranks,(PetscReal)local[0],(PetscReal)local[1],maxsamples,&nsamples,(PetscInt**)&gridsize);CHKERRQ(ierr);
 
@@ -243,15 +297,39 @@ PetscErrorCode RunSample() {
   ierr = ReportMemoryUsage(comm,memused,memavail);CHKERRQ(ierr);
 
   ierr = PetscPrintf(comm,"Small Test G[%5D%5D%5D]\n",gridsize[nsamples-1][0],gridsize[nsamples-1][1],gridsize[nsamples-1][2]);CHKERRQ(ierr);
-  ierr = SampleOnGrid(comm,op,gridsize[nsamples-1],smooth,1,0,NULL,NULL,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = SampleOnGrid(comm,op,gridsize[nsamples-1],smooth,1,0,NULL,NULL,PETSC_FALSE,NULL);CHKERRQ(ierr);
   ierr = PetscPrintf(comm,"Large Test G[%5D%5D%5D]\n",gridsize[0][0],gridsize[0][1],gridsize[0][2]);CHKERRQ(ierr);
-  ierr = SampleOnGrid(comm,op,gridsize[0],smooth,1,0,&memused,&memavail,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = SampleOnGrid(comm,op,gridsize[0],smooth,1,0,&memused,&memavail,PETSC_TRUE,NULL);CHKERRQ(ierr);
 
   ierr = ReportMemoryUsage(comm,memused,memavail);CHKERRQ(ierr);
 
+  if (dojson) {
+    ierr = MPI_Allreduce(MPI_IN_PLACE,&memused,1,MPI_DOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+    ierr = OpGetType(op,&optype);CHKERRQ(ierr);
+    ierr = OpGetFEDegree(op,&fedegree);CHKERRQ(ierr);
+    ierr = OpGetDof(op,&dof);CHKERRQ(ierr);
+    ierr = PetscFOpen(comm,jsonname,"w",&json);CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm,json,"{\n  \"benchmark\": \"hpgmg-fe\",\n  \"build\": ");CHKERRQ(ierr);
+    ierr = ReportBuildJSON(comm,json);CHKERRQ(ierr);
+    ierr = PetscGetHostName(hostname,sizeof hostname);CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm,json,",\n  \"hostname\": \"%s\"",hostname);CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm,json,",\n  \"mpi_ranks\": %d,\n  \"process_grid\": [%D, %D, %D],\n",nranks,pgrid[0],pgrid[1],pgrid[2]);CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm,json,"  \"op_type\": \"%s\",\n  \"fedegree\": %D,\n  \"dof\": %D,\n  \"smooth\": [%D, %D],\n",optype,fedegree,dof,smooth[0],smooth[1]);CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm,json,"  \"store_jacobian\": %s,\n",storejacobian ? "true" : "false");CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm,json,"  \"omp_threads\": %D,\n",FEGetMaxThreads());CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm,json,"  \"local\": [%g, %g],\n  \"repeat\": %D,\n  \"mintime\": %g,\n  \"max_memory_gb\": %f,\n",(double)local[0],(double)local[1],repeat,(double)mintime,memused*1e-9);CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm,json,"  \"samples\": [\n");CHKERRQ(ierr);
+  }
+
   ierr = PetscPrintf(comm,"Starting performance sampling\n");CHKERRQ(ierr);
   for (PetscInt i=nsamples-1; i>=0; i--) {
-    ierr = SampleOnGrid(comm,op,gridsize[i],smooth,repeat,mintime,NULL,NULL,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = SampleOnGrid(comm,op,gridsize[i],smooth,repeat,mintime,NULL,NULL,PETSC_FALSE,json);CHKERRQ(ierr);
+    if (json) {ierr = PetscFPrintf(comm,json,"%s\n",i?",":"");CHKERRQ(ierr);}
+  }
+
+  if (json) {
+    ierr = PetscFPrintf(comm,json,"  ]\n}\n");CHKERRQ(ierr);
+    ierr = PetscFClose(comm,json);CHKERRQ(ierr);
   }
 
   ierr = PetscFree(gridsize);CHKERRQ(ierr);
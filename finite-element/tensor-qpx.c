@@ -77,7 +77,7 @@
 	  Pragma(loopid(st_y_labC)) for (PetscInt c=0; c<Q; c++) vec_sta(y_labC[c],0,y[l][ab*Q+c]); \
 	}								\
       }									\
-      PetscLogFlops(dof*(Q*P*P*P+Q*Q*P*P+Q*Q*Q*P)*NE*2);		\
+      FELogFlops(dof*(Q*P*P*P+Q*Q*P*P+Q*Q*Q*P)*NE*2);		\
     }									\
     /* PetscFunctionReturn(0); */					\
   } while (0)
@@ -109,6 +109,7 @@ PetscErrorCode TensorSelect_QPX(Tensor ten) {
 #ifdef __bgq__
   if (ten->ne == 4) {
     PetscInt P = ten->P,Q = ten->Q;
+    TensorContractFunction prev = ten->Contract;
     switch (ten->dof) {
     case 1: // Scalar problems with Q1 or Q2 elements
       if (P == 2 && Q == 2)      ten->Contract = TensorContract_QPX_4_1_2_2;
@@ -119,6 +120,7 @@ PetscErrorCode TensorSelect_QPX(Tensor ten) {
       else if (P == 3 && Q == 3) ten->Contract = TensorContract_QPX_4_3_3_3;
       break;
     }
+    if (ten->Contract != prev) ten->backend = "qpx";
   }
 #endif
   PetscFunctionReturn(0);
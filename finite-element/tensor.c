@@ -8,7 +8,7 @@ static inline PetscErrorCode TensorContract_Inline(PetscInt ne,PetscInt dof,Pets
   {
     PetscReal R[Q][P],S[Q][P],T[Q][P];
     const PetscScalar (*restrict x)[P*P*P][ne]_align = (const PetscScalar(*)[P*P*P][ne])xx;
-    PetscScalar       (*restrict y)[P*P*P][ne]_align =       (PetscScalar(*)[Q*Q*Q][ne])yy;
+    PetscScalar       (*restrict y)[Q*Q*Q][ne]_align =       (PetscScalar(*)[Q*Q*Q][ne])yy;
     PetscScalar u[dof][Q*P*P][ne]_align,v[dof][Q*Q*P][ne]_align;
 
     for (PetscInt i=0; i<Q; i++) {
@@ -55,7 +55,7 @@ static inline PetscErrorCode TensorContract_Inline(PetscInt ne,PetscInt dof,Pets
         }
       }
     }
-    PetscLogFlops(dof*(Q*P*P*P+Q*Q*P*P+Q*Q*Q*P)*ne*2);
+    FELogFlops(dof*(Q*P*P*P+Q*Q*P*P+Q*Q*Q*P)*ne*2);
   }
   PetscFunctionReturn(0);
 }
@@ -65,25 +65,9 @@ static inline PetscErrorCode TensorContract_Ref(Tensor ten,const PetscReal Rf[],
   return TensorContract_Inline(ne,dof,P,Q,Rf,Sf,Tf,tmode,xx,yy);
 }
 
-static PetscErrorCode TensorContract_Ref_4_1_2_2(Tensor ten,const PetscReal Rf[],const PetscReal Sf[],const PetscReal Tf[],TensorMode tmode,const PetscScalar xx[],PetscScalar yy[]) {
-  return TensorContract_Inline(4,1,2,2,Rf,Sf,Tf,tmode,xx,yy);
-}
-static PetscErrorCode TensorContract_Ref_4_3_2_2(Tensor ten,const PetscReal Rf[],const PetscReal Sf[],const PetscReal Tf[],TensorMode tmode,const PetscScalar xx[],PetscScalar yy[]) {
-  return TensorContract_Inline(4,3,2,2,Rf,Sf,Tf,tmode,xx,yy);
-}
-static PetscErrorCode TensorContract_Ref_4_1_3_3(Tensor ten,const PetscReal Rf[],const PetscReal Sf[],const PetscReal Tf[],TensorMode tmode,const PetscScalar xx[],PetscScalar yy[]) {
-  return TensorContract_Inline(4,1,3,3,Rf,Sf,Tf,tmode,xx,yy);
-}
-static PetscErrorCode TensorContract_Ref_4_3_3_3(Tensor ten,const PetscReal Rf[],const PetscReal Sf[],const PetscReal Tf[],TensorMode tmode,const PetscScalar xx[],PetscScalar yy[]) {
-  return TensorContract_Inline(4,3,3,3,Rf,Sf,Tf,tmode,xx,yy);
-}
-
-PetscErrorCode TensorSelect_AVX(Tensor);
-PetscErrorCode TensorSelect_AVX512(Tensor);
-PetscErrorCode TensorSelect_QPX(Tensor);
-
-PetscErrorCode TensorCreate(PetscInt ne,PetscInt dof,PetscInt P,PetscInt Q,Tensor *ten) {
+PetscErrorCode TensorCreateBackend(PetscInt ne,PetscInt dof,PetscInt P,PetscInt Q,const char backend[],Tensor *ten) {
   Tensor t;
+  PetscBool match;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -92,26 +76,36 @@ PetscErrorCode TensorCreate(PetscInt ne,PetscInt dof,PetscInt P,PetscInt Q,Tenso
   t->dof = dof;
   t->P   = P;
   t->Q   = Q;
+  t->backend  = "generic";
   t->Contract = TensorContract_Ref;
-  if (ne == 4) {
-    switch (dof) {
-    case 1: // Scalar problems with Q1 or Q2 elements
-      if (P == 2 && Q == 2)      t->Contract = TensorContract_Ref_4_1_2_2;
-      else if (P == 3 && Q == 3) t->Contract = TensorContract_Ref_4_1_3_3;
-      break;
-    case 3: // Coordinates or elasticity
-      if (P == 2 && Q == 2)      t->Contract = TensorContract_Ref_4_3_2_2;
-      else if (P == 3 && Q == 3) t->Contract = TensorContract_Ref_4_3_3_3;
-      break;
-    }
+  if (!backend) {               // Best available: generated kernels, then hand-written QPX
+    ierr = TensorSelect_Generated(t,NULL);CHKERRQ(ierr);
+    ierr = TensorSelect_QPX(t);CHKERRQ(ierr);
+  } else {
+    ierr = PetscStrcmp(backend,"qpx",&match);CHKERRQ(ierr);
+    if (match) {ierr = TensorSelect_QPX(t);CHKERRQ(ierr);}
+    else {ierr = TensorSelect_Generated(t,backend);CHKERRQ(ierr);}
+    ierr = PetscStrcmp(backend,t->backend,&match);CHKERRQ(ierr);
+    if (!match) {ierr = PetscFree(t);CHKERRQ(ierr);}
   }
-  ierr = TensorSelect_AVX(t);CHKERRQ(ierr);
-  ierr = TensorSelect_AVX512(t);CHKERRQ(ierr);
-  ierr = TensorSelect_QPX(t);CHKERRQ(ierr);
   *ten = t;
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode TensorCreate(PetscInt ne,PetscInt dof,PetscInt P,PetscInt Q,Tensor *ten) {
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TensorCreateBackend(ne,dof,P,Q,NULL,ten);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode TensorGetBackend(Tensor ten,const char **backend) {
+  PetscFunctionBegin;
+  *backend = ten->backend;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode TensorDestroy(Tensor *ten) {
   PetscErrorCode ierr;
 
@@ -9,6 +9,8 @@ typedef enum {TENSOR_EVAL,TENSOR_TRANSPOSE} TensorMode;
 typedef struct Tensor_private *Tensor;
 
 PetscErrorCode TensorCreate(PetscInt ne,PetscInt dof,PetscInt P,PetscInt Q,Tensor *ten);
+PetscErrorCode TensorCreateBackend(PetscInt ne,PetscInt dof,PetscInt P,PetscInt Q,const char backend[],Tensor *ten);
+PetscErrorCode TensorGetBackend(Tensor ten,const char **backend);
 PetscErrorCode TensorDestroy(Tensor *ten);
 PetscErrorCode TensorContract(Tensor ten,const PetscReal Rf[],const PetscReal Sf[],const PetscReal Tf[],TensorMode tmode,const PetscScalar xx[],PetscScalar yy[]);
 
@@ -2,13 +2,20 @@
 #define _tensorimpl_h
 
 #include "tensor.h"
+#include "fefas-omp.h"
+
+typedef PetscErrorCode (*TensorContractFunction)(Tensor,const PetscReal Rf[],const PetscReal Sf[],const PetscReal Tf[],TensorMode tmode,const PetscScalar xx[],PetscScalar yy[]);
 
 struct Tensor_private {
   PetscInt ne;
   PetscInt dof;
   PetscInt P;
   PetscInt Q;
-  PetscErrorCode (*Contract)(Tensor,const PetscReal Rf[],const PetscReal Sf[],const PetscReal Tf[],TensorMode tmode,const PetscScalar xx[],PetscScalar yy[]);
+  const char *backend;          /* Name of the implementation chosen for Contract */
+  TensorContractFunction Contract;
 };
 
+PetscErrorCode TensorSelect_Generated(Tensor,const char[]);
+PetscErrorCode TensorSelect_QPX(Tensor);
+
 #endif
@@ -0,0 +1,12 @@
+#!/bin/sh
+
+test_description='Test tensor contraction kernels'
+
+. ./hpgmg-sharness.sh
+
+# Every Contract implementation available on this machine must agree with direct evaluation, including Q>P with dof>1.
+test_expect_stdout 'tensor kernels agree with direct evaluation' 1 'hpgmg-fe bench-tensor -bench_reps 0' '
+All tensor contractions agree with direct evaluation
+'
+
+test_done
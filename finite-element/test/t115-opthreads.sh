@@ -0,0 +1,40 @@
+#!/bin/sh
+
+test_description='Test threaded element loops against serial'
+
+. ./hpgmg-sharness.sh
+
+# Chunks of one colour must not share nodes.  The element loops split each subdomain into the same chunks whatever the
+# number of threads, so the residual and the diagonal computed with 4 threads must be bitwise identical to those
+# computed with 1 (trivially so without OpenMP).
+test_expect_stdout 'FE Poisson fedegree=1 threads serial' 1 'hpgmg-fe test-opthreads -op_type poisson1 -M 16,16,16 -test_threads 4' '
+Chunks of one colour share no nodes
+Residual with threads identical to serial
+Diagonal with threads identical to serial
+'
+
+test_expect_stdout 'FE Poisson fedegree=2 threads serial' 1 'hpgmg-fe test-opthreads -op_type poisson2 -M 16,16,16 -test_threads 4' '
+Chunks of one colour share no nodes
+Residual with threads identical to serial
+Diagonal with threads identical to serial
+'
+
+test_expect_stdout 'FE Poisson fedegree=2 threads parallel' 4 'hpgmg-fe test-opthreads -op_type poisson2 -M 16,16,32 -p 1,2,2 -test_threads 4' '
+Chunks of one colour share no nodes
+Residual with threads identical to serial
+Diagonal with threads identical to serial
+'
+
+test_expect_stdout 'FE Poisson fedegree=2 affine threads serial' 1 'hpgmg-fe test-opthreads -op_type poisson2affine -M 16,16,16 -test_threads 4' '
+Chunks of one colour share no nodes
+Residual with threads identical to serial
+Diagonal with threads identical to serial
+'
+
+test_expect_stdout 'FE Poisson fedegree=2 fused stored Jacobian threads parallel' 4 'hpgmg-fe test-opthreads -op_type poisson2fused -op_store_jacobian -M 16,16,32 -p 1,2,2 -test_threads 4' '
+Chunks of one colour share no nodes
+Residual with threads identical to serial
+Diagonal with threads identical to serial
+'
+
+test_done
@@ -17,4 +17,13 @@ V(4,3)  1: |e|_2/|u|_2 9.17e-03  |r|_2/|f|_2 8.27e-07
 V(4,3)  2: |e|_2/|u|_2 9.17e-03  |r|_2/|f|_2 5.54e-09
 '
 
+# The fused kernel, alone and with stored geometric factors, must reproduce the output of the reference operator
+test_expect_same_stdout 'FE Poisson FMG solve fedegree=2 fused serial' 1 'hpgmg-fe fmg -op_type poisson2fused -M 4,4,6 -smooth 4,3' 'hpgmg-fe fmg -op_type poisson2 -M 4,4,6 -smooth 4,3'
+
+test_expect_same_stdout 'FE Poisson FMG solve fedegree=2 fused parallel' 4 'hpgmg-fe fmg -op_type poisson2fused -M 4,4,6 -smooth 4,3 -p 1,2,2' 'hpgmg-fe fmg -op_type poisson2 -M 4,4,6 -smooth 4,3 -p 1,2,2'
+
+test_expect_same_stdout 'FE Poisson FMG solve fedegree=2 fused stored Jacobian parallel' 4 'hpgmg-fe fmg -op_type poisson2fused -op_store_jacobian -M 4,4,6 -smooth 4,3 -p 1,2,2' 'hpgmg-fe fmg -op_type poisson2 -M 4,4,6 -smooth 4,3 -p 1,2,2'
+
+test_expect_same_stdout 'FE Poisson operator fedegree=2 fused serial' 1 'hpgmg-fe test-opapply -op_type poisson2fused -M 8,8,12 -L 1,1,1 -poisson_solution sine' 'hpgmg-fe test-opapply -op_type poisson2 -M 8,8,12 -L 1,1,1 -poisson_solution sine'
+
 test_done
@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Samuel Williams
+// SWWilliams@lbl.gov
+// Lawrence Berkeley National Lab
+//------------------------------------------------------------------------------------------------------------------------------
+#if defined(USE_PERF_COUNTERS) && defined(__linux__)
+#define _GNU_SOURCE // syscall() is not part of c99
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+//------------------------------------------------------------------------------------------------------------------------------
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(USE_PERF_COUNTERS) && defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+//------------------------------------------------------------------------------------------------------------------------------
+#include "timers.h"
+#include "level.h"
+#include "counters.h"
+//------------------------------------------------------------------------------------------------------------------------------
+int    counters_available        = 0;
+double counters_stream_bandwidth = 0.0;
+#ifdef USE_PERF_COUNTERS
+static int    counters_threads = 0;
+static int  * counters_fd      = NULL; // counters_fd[thread*COUNTER_EVENTS+event] = each thread's event fds (-1 if not opened).  Cycles leads the group
+static int    counters_slot[COUNTER_EVENTS]; // position of each event in the group (or -1 if the event could not be opened)
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+#ifdef __linux__
+static int open_event(uint64_t config, int group_fd){
+  struct perf_event_attr attr;
+  memset(&attr,0,sizeof(attr));
+  attr.size           = sizeof(attr);
+  attr.type           = PERF_TYPE_HARDWARE;
+  attr.config         = config;
+  attr.read_format    = PERF_FORMAT_GROUP;
+  attr.exclude_kernel = 1; // user space only (permitted with perf_event_paranoid<=2)
+  attr.exclude_hv     = 1;
+  return( (int)syscall(SYS_perf_event_open,&attr,0,-1,group_fd,0) ); // this thread on any cpu
+}
+#endif
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// STREAM triad (a[] = b[] + s*c[]) on every thread of every process at once... i.e. the bandwidth each process can expect when the whole node is busy
+static double stream_triad(void){
+  uint64_t i,n = COUNTERS_STREAM_SIZE;
+  double *a = (double*)malloc(n*sizeof(double));
+  double *b = (double*)malloc(n*sizeof(double));
+  double *c = (double*)malloc(n*sizeof(double));
+  if( (a==NULL) || (b==NULL) || (c==NULL) ){fprintf(stderr,"malloc failed - stream_triad\n");exit(0);}
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+  #endif
+  for(i=0;i<n;i++){a[i]=0.0;b[i]=1.0;c[i]=2.0;} // first touch
+  double best = 1e30;
+  int trial;
+  for(trial=0;trial<5;trial++){
+    #ifdef USE_MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+    #endif
+    double _timeStart = getTime();
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for(i=0;i<n;i++){a[i] = b[i] + 3.0*c[i];}
+    double _time = getTime()-_timeStart;
+    if(_time<best)best=_time;
+  }
+  if(a[n/2]!=7.0)fprintf(stderr,"stream_triad failed validation\n");
+  free(a);free(b);free(c);
+  return( 3.0*sizeof(double)*(double)n/best );
+}
+#endif
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+void counters_init(void){
+  #ifdef USE_PERF_COUNTERS
+  int e,t;
+  uint64_t configs[COUNTER_EVENTS];
+  configs[COUNTER_CYCLES      ] = PERF_COUNT_HW_CPU_CYCLES;
+  configs[COUNTER_INSTRUCTIONS] = PERF_COUNT_HW_INSTRUCTIONS;
+  configs[COUNTER_LLC_MISSES  ] = PERF_COUNT_HW_CACHE_MISSES;
+  counters_threads = 1;
+  #ifdef _OPENMP
+  counters_threads = omp_get_max_threads();
+  #endif
+  counters_fd = (int*)malloc(counters_threads*COUNTER_EVENTS*sizeof(int));
+  if(counters_fd==NULL){fprintf(stderr,"malloc failed - counters_init\n");exit(0);}
+  for(t=0;t<counters_threads*COUNTER_EVENTS;t++)counters_fd[t]=-1;
+  int opened = 0;
+
+  #ifdef __linux__
+  // each thread opens (and thus counts) its own events.  The group is read from the master thread.  As OpenMP reuses the same threads for
+  // every parallel region (of the same size), these are the threads that execute the kernels...
+  int slots[COUNTER_EVENTS];for(e=0;e<COUNTER_EVENTS;e++)slots[e]=-1;
+  #ifdef _OPENMP
+  #pragma omp parallel private(e) reduction(+:opened)
+  #endif
+  {
+    int thread = 0;
+    #ifdef _OPENMP
+    thread = omp_get_thread_num();
+    #endif
+    int *fd = counters_fd + thread*COUNTER_EVENTS;
+    fd[COUNTER_CYCLES] = open_event(configs[COUNTER_CYCLES],-1);
+    if(fd[COUNTER_CYCLES]>=0){
+      int slot=1;
+      for(e=0;e<COUNTER_EVENTS;e++){
+        if(e==COUNTER_CYCLES){if(thread==0)slots[e]=0;continue;}
+        fd[e] = open_event(configs[e],fd[COUNTER_CYCLES]);
+        if(thread==0)slots[e] = (fd[e]>=0) ? slot : -1;
+        if(fd[e]>=0)slot++;
+      }
+      opened++;
+    }
+  }
+  for(e=0;e<COUNTER_EVENTS;e++)counters_slot[e] = (opened>0) ? slots[e] : -1;
+  #endif
+
+  int available = (opened==counters_threads);
+  #ifdef USE_MPI
+  MPI_Allreduce(&available,&counters_available,1,MPI_INT,MPI_MIN,MPI_COMM_WORLD);
+  #else
+  counters_available = available;
+  #endif
+
+  counters_stream_bandwidth = stream_triad();
+  double min_bandwidth = counters_stream_bandwidth;
+  #ifdef USE_MPI
+  MPI_Allreduce(&counters_stream_bandwidth,&min_bandwidth,1,MPI_DOUBLE,MPI_MIN,MPI_COMM_WORLD);
+  #endif
+  int my_rank = 0;
+  #ifdef USE_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD,&my_rank);
+  #endif
+  if(my_rank==0){
+    if(counters_available)fprintf(stdout,"Hardware counters (cycles, instructions, LLC misses) enabled on %d threads\n",counters_threads);
+                     else fprintf(stdout,"WARNING... hardware counters could not be opened on every thread (see /proc/sys/kernel/perf_event_paranoid).  Reporting STREAM only\n");
+    fprintf(stdout,"STREAM triad baseline %0.3f GB/s per process (min over processes %0.3f GB/s)\n",counters_stream_bandwidth/1e9,min_bandwidth/1e9);
+  }
+  #endif
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+void counters_finalize(void){
+  #ifdef USE_PERF_COUNTERS
+  int t;
+  #ifdef __linux__
+  for(t=0;t<counters_threads*COUNTER_EVENTS;t++)if(counters_fd[t]>=0)close(counters_fd[t]); // every event of the group is its own fd
+  #endif
+  free(counters_fd);
+  counters_fd        = NULL;
+  counters_threads   = 0;
+  counters_available = 0;
+  #endif
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+void counters_read(uint64_t *values){
+  int e;
+  for(e=0;e<COUNTER_EVENTS;e++)values[e]=0;
+  #if defined(USE_PERF_COUNTERS) && defined(__linux__)
+  if(!counters_available)return;
+  int t;
+  for(t=0;t<counters_threads;t++){
+    uint64_t group[1+COUNTER_EVENTS]; // {nr, values[nr]}
+    if(read(counters_fd[t*COUNTER_EVENTS+COUNTER_CYCLES],group,sizeof(group))<(ssize_t)sizeof(uint64_t))continue; // the leader reads the whole group
+    for(e=0;e<COUNTER_EVENTS;e++)if( (counters_slot[e]>=0) && ((uint64_t)counters_slot[e]<group[0]) )values[e] += group[1+counters_slot[e]];
+  }
+  #endif
+}
+
+
+void counters_accumulate(uint64_t *counters, uint64_t *start){
+  uint64_t now[COUNTER_EVENTS];
+  int e;
+  counters_read(now);
+  for(e=0;e<COUNTER_EVENTS;e++)counters[e] += now[e]-start[e];
+}
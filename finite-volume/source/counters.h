@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Samuel Williams
+// SWWilliams@lbl.gov
+// Lawrence Berkeley National Lab
+//------------------------------------------------------------------------------------------------------------------------------
+#ifndef COUNTERS_H
+#define COUNTERS_H
+//------------------------------------------------------------------------------------------------------------------------------
+// optional (-DUSE_PERF_COUNTERS) Linux perf_event_open() hardware counters.  Each OpenMP thread counts cycles, instructions, and
+// last level cache misses for itself.  A kernel brackets the same code it times with COUNTERS_START() and COUNTERS_STOP(level,kernel)
+// which attribute the difference (summed over threads) to level->counters[kernel][] (COUNTERS_RESTART() resumes after a pause in the
+// timer).  Regions are exclusive and must not nest... kernels call exchange_boundary() and apply_BCs() outside their region (or pause
+// it around them) and so e.g. smooth does not include the ghostZone counts.  Without USE_PERF_COUNTERS the macros vanish.
+//------------------------------------------------------------------------------------------------------------------------------
+#include <stdint.h>
+//------------------------------------------------------------------------------------------------------------------------------
+#ifndef COUNTERS_LINE_SIZE
+#define COUNTERS_LINE_SIZE 64 // bytes moved per last level cache miss
+#endif
+#ifndef COUNTERS_STREAM_SIZE
+#define COUNTERS_STREAM_SIZE (1<<22) // elements of each STREAM array (3x32MB in double)... must exceed the last level cache
+#endif
+//------------------------------------------------------------------------------------------------------------------------------
+extern int    counters_available;	// 1 if the hardware counters could be opened on every thread
+extern double counters_stream_bandwidth;// STREAM triad bandwidth (bytes/s) of this process measured by counters_init() while every process runs it
+void counters_init(void);		// collective (MPI_COMM_WORLD)... must be called after MPI_Init() and before any counters are read
+void counters_finalize(void);
+void counters_read(uint64_t *values);	// values[COUNTER_EVENTS] = counts summed over this process's threads
+void counters_accumulate(uint64_t *counters, uint64_t *start);
+//------------------------------------------------------------------------------------------------------------------------------
+#ifdef USE_PERF_COUNTERS
+#define COUNTERS_START()             uint64_t _countersStart[COUNTER_EVENTS];counters_read(_countersStart)
+#define COUNTERS_RESTART()           counters_read(_countersStart)
+#define COUNTERS_STOP(level,kernel)  counters_accumulate((level)->counters[kernel],_countersStart)
+#else
+#define COUNTERS_START()
+#define COUNTERS_RESTART()
+#define COUNTERS_STOP(level,kernel)
+#endif
+//------------------------------------------------------------------------------------------------------------------------------
+#endif
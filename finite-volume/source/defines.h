@@ -23,6 +23,14 @@
 //------------------------------------------------------------------------------------------------------------------
 #ifdef USE_L1JACOBI
 #define  VECTOR_L1INV       10 // cell centered relaxation parameter (e.g. inverse of the L1 norm of each row)
+#endif
+#if   defined(USE_MIXED_PRECISION) &&  defined(USE_L1JACOBI)
+#define  VECTOR_U_LO        11 // trailing part of the numerical solution (U+U_LO) maintained by iterative refinement
+#define VECTORS_RESERVED    12 // total number of vectors and the starting location for any auxillary bottom solver vectors
+#elif defined(USE_MIXED_PRECISION)
+#define  VECTOR_U_LO        10 // trailing part of the numerical solution (U+U_LO) maintained by iterative refinement
+#define VECTORS_RESERVED    11 // total number of vectors and the starting location for any auxillary bottom solver vectors
+#elif defined(USE_L1JACOBI)
 #define VECTORS_RESERVED    11 // total number of vectors and the starting location for any auxillary bottom solver vectors
 #else
 #define VECTORS_RESERVED    10 // total number of vectors and the starting location for any auxillary bottom solver vectors
@@ -44,6 +44,7 @@
 #include "defines.h"
 #include "level.h"
 #include "mg.h"
+#include "counters.h"
 #include "operators.h"
 #include "solvers.h"
 //------------------------------------------------------------------------------------------------------------------------------
@@ -99,6 +100,165 @@ void bench_hpgmg(mg_type *all_grids, int onLevel, double a, double b, double rto
 }
 
 
+//------------------------------------------------------------------------------------------------------------------------------
+// write the compile time options that affect performance as a JSON object (see -json)
+static void print_build_json(FILE *fp){
+  const char *flags[] = {
+    #ifdef USE_MPI
+    "USE_MPI",
+    #endif
+    #ifdef _OPENMP
+    "_OPENMP",
+    #endif
+    #ifdef USE_SUBCOMM
+    "USE_SUBCOMM",
+    #endif
+    #ifdef USE_FCYCLES
+    "USE_FCYCLES",
+    #endif
+    #ifdef USE_UCYCLES
+    "USE_UCYCLES",
+    #endif
+    #ifdef USE_HELMHOLTZ
+    "USE_HELMHOLTZ",
+    #endif
+    #ifdef USE_PERIODIC_BC
+    "USE_PERIODIC_BC",
+    #endif
+    #ifdef USE_MIXED_PRECISION
+    "USE_MIXED_PRECISION",
+    #endif
+    #ifdef USE_HUGEPAGES
+    "USE_HUGEPAGES",
+    #endif
+    #ifdef USE_MPI_THREAD_MULTIPLE
+    "USE_MPI_THREAD_MULTIPLE",
+    #endif
+    #ifdef USE_GSRB
+    "USE_GSRB",
+    #endif
+    #ifdef USE_CHEBY
+    "USE_CHEBY",
+    #endif
+    #ifdef USE_JACOBI
+    "USE_JACOBI",
+    #endif
+    #ifdef USE_L1JACOBI
+    "USE_L1JACOBI",
+    #endif
+    #ifdef USE_SYMGS
+    "USE_SYMGS",
+    #endif
+    #ifdef USE_BICGSTAB
+    "USE_BICGSTAB",
+    #endif
+    #ifdef USE_CG
+    "USE_CG",
+    #endif
+    #ifdef USE_PIPECG
+    "USE_PIPECG",
+    #endif
+    #ifdef USE_PIPEBICGSTAB
+    "USE_PIPEBICGSTAB",
+    #endif
+    #ifdef USE_CABICGSTAB
+    "USE_CABICGSTAB",
+    #endif
+    #ifdef USE_CACG
+    "USE_CACG",
+    #endif
+    #ifdef USE_NAIVE_INTERP
+    "USE_NAIVE_INTERP",
+    #endif
+    #ifdef USE_VBKJI_LAYOUT
+    "USE_VBKJI_LAYOUT",
+    #endif
+    #ifdef USE_BVKJI_LAYOUT
+    "USE_BVKJI_LAYOUT",
+    #endif
+    #ifdef USE_MAGIC_PADDING
+    "USE_MAGIC_PADDING",
+    #endif
+    #ifdef USE_PERF_COUNTERS
+    "USE_PERF_COUNTERS",
+    #endif
+    #ifdef USE_HPM
+    "USE_HPM",
+    #endif
+    #ifdef GSRB_FP
+    "GSRB_FP",
+    #endif
+    #ifdef GSRB_STRIDE2
+    "GSRB_STRIDE2",
+    #endif
+    #ifdef GSRB_BRANCH
+    "GSRB_BRANCH",
+    #endif
+    #ifdef UNLIMIT_FMG_ITERATIONS
+    "UNLIMIT_FMG_ITERATIONS",
+    #endif
+    #ifdef CALIBRATE_TIMER
+    "CALIBRATE_TIMER",
+    #endif
+    #ifdef __AVX2__
+    "__AVX2__",
+    #endif
+    #ifdef __AVX512F__
+    "__AVX512F__",
+    #endif
+    NULL
+  };
+  int f;
+  fprintf(fp,"{\"flags\": [");
+  for(f=0;flags[f]!=NULL;f++)fprintf(fp,"%s\"%s\"",(f>0) ? ", " : "",flags[f]);
+  fprintf(fp,"], \"sizeof_real_t\": %d, \"BLOCKCOPY_TILE\": [%d, %d, %d], \"stencil_radius\": %d",(int)sizeof(real_t),BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K,stencil_get_radius());
+  #ifdef __VERSION__
+  fprintf(fp,", \"compiler\": \"%s\"",__VERSION__);
+  #endif
+  fprintf(fp,"}");
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// predict the memory footprint (bytes on the most heavily loaded process) of the MG hierarchy MGBuild() would create from a fine grid of
+// (boxes_in_i x boxes_in_j x boxes_in_k) box_dim^3 boxes (see MGPlan() and MGEstimateMemory()).  If print, rank 0 also prints the per-level estimates
+static uint64_t predict_memory(int boxes_in_i, int boxes_in_j, int boxes_in_k, int box_dim, int ghosts, int bc, int num_tasks, int minCoarseDim, int print){
+  mg_plan_type plan[100];
+  uint64_t level_bytes[100];
+  int num_levels = MGPlan(plan,100,boxes_in_i,boxes_in_j,boxes_in_k,box_dim,ghosts,num_tasks,minCoarseDim);
+  uint64_t bytes = MGEstimateMemory(plan,num_levels,VECTORS_RESERVED,bc,level_bytes);
+  if(print){
+    int l;
+    fprintf(stdout,"\n\n===== Predicted memory footprint (per process) ==================================\n");
+    fprintf(stdout,"level        dimension   box_dim       boxes   processes   boxes/process           MB\n");
+    for(l=0;l<num_levels;l++){
+      char dim[32];
+      int64_t boxes = (int64_t)plan[l].boxes_in.i*plan[l].boxes_in.j*plan[l].boxes_in.k;
+      snprintf(dim,sizeof(dim),"%dx%dx%d",plan[l].box_dim*plan[l].boxes_in.i,plan[l].box_dim*plan[l].boxes_in.j,plan[l].box_dim*plan[l].boxes_in.k);
+      fprintf(stdout,"%5d %16s %9d %11ld %11d %15ld %12.3f\n",l,dim,plan[l].box_dim,(long)boxes,plan[l].nProcs,(long)((boxes+plan[l].nProcs-1)/plan[l].nProcs),level_bytes[l]/1048576.0);
+    }
+    fprintf(stdout,"total %82.3f\n",bytes/1048576.0);
+  }
+  return(bytes);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// a cheap lower bound on predict_memory()... the vectors of the most heavily loaded process on every level.  Used to prune the memory targeted search
+static uint64_t min_memory(int64_t boxes_in_i, int64_t boxes_in_j, int64_t boxes_in_k, int64_t box_dim, int ghosts, int num_tasks, int minCoarseDim){
+  mg_plan_type plan[100];
+  int num_levels = MGPlan(plan,100,boxes_in_i,boxes_in_j,boxes_in_k,box_dim,ghosts,num_tasks,minCoarseDim);
+  uint64_t bytes = 0;
+  int l;
+  for(l=0;l<num_levels;l++){
+    uint64_t boxes_per_process = ((uint64_t)plan[l].boxes_in.i*plan[l].boxes_in.j*plan[l].boxes_in.k+plan[l].nProcs-1)/plan[l].nProcs;
+    uint64_t box_volume = (uint64_t)(plan[l].box_dim+2*plan[l].box_ghosts)*(plan[l].box_dim+2*plan[l].box_ghosts)*(plan[l].box_dim+2*plan[l].box_ghosts);
+    bytes += boxes_per_process*VECTORS_RESERVED*box_volume*sizeof(real_t);
+  }
+  return(bytes);
+}
+
+
 //------------------------------------------------------------------------------------------------------------------------------
 int main(int argc, char **argv){
   int my_rank=0;
@@ -144,14 +304,76 @@ int main(int argc, char **argv){
   // parse the arguments...
   int     log2_box_dim           =  6; // 64^3
   int     target_boxes_per_rank  =  1;
-//int64_t target_memory_per_rank = -1; // not specified
+  int64_t target_memory_per_rank = -1; // not specified
   int64_t box_dim                = -1;
   int64_t boxes_in_i             = -1;
+  int64_t boxes_in_j             = -1;
+  int64_t boxes_in_k             = -1;
   int64_t target_boxes           = -1;
 
-  if(argc==3){
+  // strip out any optional '-option value' pairs (e.g. -smoother jacobi) leaving just the positional arguments...
+  const char *smoother_name      = NULL; // NULL selects the compile time default (e.g. -DUSE_GSRB)
+  const char *op_kernels_name    = NULL;
+  const char *bottom_solver_name = NULL;
+  const char *exchange_name      = NULL; // p2p, persistent, neighbor, or shm (see exchange_boundary())
+  int         autotune           =    0; // tune the smoother/blocking of each level and the bottom solver in MGBuild
+  int         box_ghosts         =   -1; // -1 selects stencil_get_radius().  Deeper ghost zones enable communication-avoiding smoothers (e.g. gsrb_ca)
+  const char *json_name          = NULL; // if specified, rank 0 also writes a machine-readable (JSON) report of the run to this file
+  int         dry_run            =    0; // print the predicted memory footprint of each level and exit without allocating anything
+  int arg,positional_args=1;
+  for(arg=1;arg<argc;arg++){
+         if( (strcmp(argv[arg],"-smoother")==0) && (arg+1<argc) ){smoother_name      = argv[++arg];}
+    else if( (strcmp(argv[arg],"-kernels" )==0) && (arg+1<argc) ){op_kernels_name    = argv[++arg];}
+    else if( (strcmp(argv[arg],"-bottom"  )==0) && (arg+1<argc) ){bottom_solver_name = argv[++arg];}
+    else if(  strcmp(argv[arg],"-autotune")==0                   ){autotune           = 1;}
+    else if( (strcmp(argv[arg],"-ghosts"  )==0) && (arg+1<argc) ){box_ghosts         = atoi(argv[++arg]);}
+    else if(  strcmp(argv[arg],"-fuse"    )==0                   ){fuse_interpolation = 1;}
+    else if(  strcmp(argv[arg],"-overlap" )==0                   ){overlap_exchange   = 1;}
+    else if( (strcmp(argv[arg],"-exchange")==0) && (arg+1<argc) ){exchange_name      = argv[++arg];}
+    else if( (strcmp(argv[arg],"-json"    )==0) && (arg+1<argc) ){json_name          = argv[++arg];}
+    else if(  strcmp(argv[arg],"-dryrun"  )==0                   ){dry_run            = 1;}
+    else{argv[positional_args++] = argv[arg];}
+  }
+  argc = positional_args;
+
+  // select the smoother, residual/apply_op kernels, and bottom solver all levels will be created with...
+  default_smoother      =       smoother_lookup(smoother_name     );
+  default_op_kernels    =     op_kernels_lookup(op_kernels_name   );
+  default_bottom_solver = IterativeSolver_Lookup(bottom_solver_name);
+  exchange_method       = exchange_method_lookup(exchange_name     );
+  if( (smoother_name==NULL) && (my_rank==0) && (strcmp(smoothers[default_smoother].name,smoother_default_name())!=0) ){
+    fprintf(stderr,"compile time smoother '%s' is not available for this operator... using '%s'\n",smoother_default_name(),smoothers[default_smoother].name);
+  }
+  if( (default_smoother<0) || (default_op_kernels<0) || (default_bottom_solver<0) || (exchange_method<0) ){
+    if(my_rank==0){
+      int k;
+      if(default_smoother     <0){fprintf(stderr,"unrecognized smoother '%s'... available smoothers are"          ,     smoother_name);for(k=0;k<     num_smoothers;k++)fprintf(stderr," %s",     smoothers[k].name);fprintf(stderr,"\n");}
+      if(default_op_kernels   <0){fprintf(stderr,"unrecognized kernels '%s'... available kernels are"              ,   op_kernels_name);for(k=0;k<    num_op_kernels;k++)fprintf(stderr," %s",    op_kernels[k].name);fprintf(stderr,"\n");}
+      if(default_bottom_solver<0){fprintf(stderr,"unrecognized bottom solver '%s'... available bottom solvers are",bottom_solver_name);for(k=0;k<num_bottom_solvers;k++)fprintf(stderr," %s",bottom_solvers[k].name);fprintf(stderr,"\n");}
+      if(exchange_method      <0){fprintf(stderr,"unrecognized exchange '%s'... available exchanges are"          ,     exchange_name);for(k=0;k<=EXCHANGE_SHM;k++)if(exchange_method_lookup(exchange_methods[k])==k)fprintf(stderr," %s",exchange_methods[k]);fprintf(stderr,"\n");}
+    }
+    #ifdef USE_MPI
+    MPI_Finalize();
+    #endif
+    exit(0);
+  }
+
+  #ifdef USE_PERIODIC_BC
+  int bc = BC_PERIODIC;
+  int minCoarseDim = 2; // avoid problems with black box calculation of D^{-1} for poisson with periodic BC's on a 1^3 grid
+  #else
+  int bc = BC_DIRICHLET;
+  int minCoarseDim = 1; // assumes you can drop order on the boundaries
+  #endif
+  int ghosts=stencil_get_radius();
+  if(box_ghosts>ghosts)ghosts=box_ghosts;
+
+  #ifndef MAX_COARSE_DIM
+  #define MAX_COARSE_DIM 11
+  #endif
+  if( (argc==3) || (argc==5) ){
              log2_box_dim=atoi(argv[1]);
-    target_boxes_per_rank=atoi(argv[2]);
+    target_boxes_per_rank=(argc==3) ? atoi(argv[2]) : 1;
 
     if(log2_box_dim>9){
       // NOTE, in order to use 32b int's for array indexing, box volumes must be less than 2^31 doubles
@@ -178,22 +400,43 @@ int main(int argc, char **argv){
       exit(0);
     }
 
-    #ifndef MAX_COARSE_DIM
-    #define MAX_COARSE_DIM 11
-    #endif
     box_dim=1<<log2_box_dim;
+    if(argc==5){ // explicit (rectahedral) domain of boxes_in_i x boxes_in_j x boxes_in_k boxes
+      boxes_in_i=atoi(argv[2]);
+      boxes_in_j=atoi(argv[3]);
+      boxes_in_k=atoi(argv[4]);
+      if( (boxes_in_i<1) || (boxes_in_j<1) || (boxes_in_k<1) ){
+        if(my_rank==0){fprintf(stderr,"boxes_in_i, boxes_in_j, and boxes_in_k must be at least 1\n");}
+        #ifdef USE_MPI
+        MPI_Finalize();
+        #endif
+        exit(0);
+      }
+    }else{
+    // search all possible problem sizes to find the acceptable (boxes_in_i,boxes_in_j,boxes_in_k) with the most boxes (ties favor the most cubical)
+    // The domain may be rectahedral (e.g. 2x1x1 boxes for 2 ranks) rather than wasting up to half the memory on the nearest cube, but
+    // its aspect ratio is limited to 2:1 and it must coarsen (all dimensions even) to no more than MAX_COARSE_DIM in every dimension.
     target_boxes = (int64_t)target_boxes_per_rank*(int64_t)num_tasks;
     boxes_in_i = -1;
-    int64_t bi;
-    for(bi=1;bi<1000;bi++){ // search all possible problem sizes to find acceptable boxes_in_i
-      int64_t total_boxes = bi*bi*bi;
+    int64_t bi,bj,bk;
+    for(bi=1;bi<1000;bi++){
+    for(bj=(bi+1)/2;bj<=bi;bj++){
+    for(bk=(bi+1)/2;bk<=bj;bk++){
+      int64_t total_boxes = bi*bj*bk;
       if(total_boxes<=target_boxes){
-        int64_t coarse_grid_dim = box_dim*bi;
-        while( (coarse_grid_dim%2) == 0){coarse_grid_dim=coarse_grid_dim/2;}
-        if(coarse_grid_dim<=MAX_COARSE_DIM){
-          boxes_in_i = bi;
+        int64_t coarse_grid_dim_i = box_dim*bi;
+        int64_t coarse_grid_dim_j = box_dim*bj;
+        int64_t coarse_grid_dim_k = box_dim*bk;
+        while( ((coarse_grid_dim_i|coarse_grid_dim_j|coarse_grid_dim_k)%2) == 0){coarse_grid_dim_i/=2;coarse_grid_dim_j/=2;coarse_grid_dim_k/=2;}
+        if( (coarse_grid_dim_i<=MAX_COARSE_DIM) && (coarse_grid_dim_j<=MAX_COARSE_DIM) && (coarse_grid_dim_k<=MAX_COARSE_DIM) ){
+          if( (boxes_in_i<1) || (total_boxes>boxes_in_i*boxes_in_j*boxes_in_k) || ((total_boxes==boxes_in_i*boxes_in_j*boxes_in_k)&&(bi-bk<boxes_in_i-boxes_in_k)) ){
+            boxes_in_i = bi;
+            boxes_in_j = bj;
+            boxes_in_k = bk;
+          }
         }
       }
+    }}}
     }
     if(boxes_in_i<1){
       if(my_rank==0){fprintf(stderr,"failed to find an acceptable problem size\n");}
@@ -202,9 +445,8 @@ int main(int argc, char **argv){
       #endif
       exit(0);
     }
-  } // argc==3
+  } // argc==3 or argc==5
 
-  #if 0
   else if(argc==2){ // interpret argv[1] as target_memory_per_rank
     char *ptr = argv[1];
     char *tmp;
@@ -229,14 +471,69 @@ int main(int argc, char **argv){
       #endif
       exit(0);
     }
-    // FIX, now search for an 'acceptable' box_dim and boxes_in_i constrained by target_memory_per_rank, num_tasks, and MAX_COARSE_DIM
+    // search for the box_dim and (boxes_in_i,boxes_in_j,boxes_in_k) with the most DOF whose predicted footprint fits in target_memory_per_rank.
+    // As above, the domain's aspect ratio is limited to 2:1 and it must coarsen to no more than MAX_COARSE_DIM in every dimension.
+    // Every process must own at least one box.  Ties favor larger boxes (less ghost zone overhead) and then the most cubical domain.
+    // Each prediction decomposes every level (O(num_tasks) work) and so rank 0 searches alone and broadcasts the result.  The footprint of the
+    // smallest domain with a given bi grows with bi and so the first bi that can't fit is bisected for (min_memory() bounds the interval).  Candidates
+    // are then visited largest first for each bi so that smaller ones are rejected by dof<best_dof, and min_memory() rejects the rest of the hopeless ones.
+    if(my_rank==0){
+    int64_t best_dof = 0;
+    for(log2_box_dim=4;log2_box_dim<=7;log2_box_dim++){
+      int64_t bd=1<<log2_box_dim;
+      if(bd<ghosts)continue;
+      int64_t bi,bj,bk;
+      int64_t bi_end=1; // first bi whose smallest domain (bi x (bi+1)/2 x (bi+1)/2) is too big
+      while( (bi_end<1000) && (min_memory(bi_end,(bi_end+1)/2,(bi_end+1)/2,bd,ghosts,num_tasks,minCoarseDim) <= (uint64_t)target_memory_per_rank) )bi_end++;
+      int64_t bi_fits=0; // last bi known to fit
+      while(bi_end-bi_fits>1){
+        bi = (bi_fits+bi_end)/2;
+        if(predict_memory(bi,(bi+1)/2,(bi+1)/2,bd,ghosts,bc,num_tasks,minCoarseDim,0) > (uint64_t)target_memory_per_rank)bi_end=bi;else bi_fits=bi;
+      }
+      for(bi=1;bi<bi_end;bi++){
+        for(bj=bi;bj>=(bi+1)/2;bj--){
+        for(bk=bj;bk>=(bi+1)/2;bk--){
+          int64_t total_boxes = bi*bj*bk;
+          int64_t dof = total_boxes*bd*bd*bd;
+          if( (total_boxes<num_tasks) || (dof<best_dof) )continue;
+          if( (dof==best_dof) && (bd==box_dim) && (bi-bk>=boxes_in_i-boxes_in_k) )continue;
+          int64_t coarse_grid_dim_i = bd*bi;
+          int64_t coarse_grid_dim_j = bd*bj;
+          int64_t coarse_grid_dim_k = bd*bk;
+          while( ((coarse_grid_dim_i|coarse_grid_dim_j|coarse_grid_dim_k)%2) == 0){coarse_grid_dim_i/=2;coarse_grid_dim_j/=2;coarse_grid_dim_k/=2;}
+          if( (coarse_grid_dim_i>MAX_COARSE_DIM) || (coarse_grid_dim_j>MAX_COARSE_DIM) || (coarse_grid_dim_k>MAX_COARSE_DIM) )continue;
+          if(min_memory(bi,bj,bk,bd,ghosts,num_tasks,minCoarseDim) > (uint64_t)target_memory_per_rank)continue;
+          if(predict_memory(bi,bj,bk,bd,ghosts,bc,num_tasks,minCoarseDim,0) > (uint64_t)target_memory_per_rank)continue;
+          best_dof   = dof;
+          box_dim    = bd;
+          boxes_in_i = bi;
+          boxes_in_j = bj;
+          boxes_in_k = bk;
+        }}
+      }
+    }
+    } // my_rank==0
+    #ifdef USE_MPI
+    int64_t selected[4] = {box_dim,boxes_in_i,boxes_in_j,boxes_in_k};
+    MPI_Bcast(selected,4,MPI_INT64_T,0,MPI_COMM_WORLD);
+    box_dim    = selected[0];
+    boxes_in_i = selected[1];
+    boxes_in_j = selected[2];
+    boxes_in_k = selected[3];
+    #endif
+    if(boxes_in_i<1){
+      if(my_rank==0){fprintf(stderr,"failed to find a problem size that fits in %0.3f MB per process\n",target_memory_per_rank/1048576.0);}
+      #ifdef USE_MPI
+      MPI_Finalize();
+      #endif
+      exit(0);
+    }
   } // argc==2
-  #endif
 
 
   else{
-    if(my_rank==0){fprintf(stderr,"usage: ./hpgmg-fv  [log2_box_dim]  [target_boxes_per_rank]\n");}
-                 //fprintf(stderr,"       ./hpgmg-fv  [target_memory_per_rank[MB,GB,TB]]\n");}
+    if(my_rank==0){fprintf(stderr,"usage: ./hpgmg-fv  [log2_box_dim]  [target_boxes_per_rank | boxes_in_i boxes_in_j boxes_in_k]  [-smoother name]  [-kernels name]  [-bottom name]  [-autotune]  [-ghosts n]  [-fuse]  [-overlap]  [-exchange name]  [-json file]  [-dryrun]\n");
+                   fprintf(stderr,"       ./hpgmg-fv  [target_memory_per_rank[MB,GB,TB]]  [options]\n");}
     #ifdef USE_MPI
     MPI_Finalize();
     #endif
@@ -246,6 +543,19 @@ int main(int argc, char **argv){
 
 
 
+  // report the predicted footprint (e.g. to size a run) and optionally stop before allocating anything...
+  if( (my_rank==0) && ((target_memory_per_rank>0) || dry_run) ){
+    if(target_memory_per_rank>0)fprintf(stdout,"target memory per process = %0.3f MB... selected %d x %d x %d boxes of %d^3\n",target_memory_per_rank/1048576.0,(int)boxes_in_i,(int)boxes_in_j,(int)boxes_in_k,(int)box_dim);
+    predict_memory(boxes_in_i,boxes_in_j,boxes_in_k,box_dim,ghosts,bc,num_tasks,minCoarseDim,1);
+  }
+  if(dry_run){
+    #ifdef USE_MPI
+    MPI_Finalize();
+    #endif
+    exit(0);
+  }
+
+
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
   if(my_rank==0){
   fprintf(stdout,"\n\n");
@@ -267,22 +577,38 @@ int main(int argc, char **argv){
   else                                                       fprintf(stdout,"got Unknown MPI Threading Model (%d)\n",actual_threading_model);
   #endif
   fprintf(stdout,"%d MPI Tasks of %d threads\n",num_tasks,OMP_Threads);
+  fprintf(stdout,"smoother=%s, kernels=%s, bottom solver=%s\n",smoothers[default_smoother].name,op_kernels[default_op_kernels].name,bottom_solvers[default_bottom_solver].name);
   fprintf(stdout,"\n\n===== Benchmark setup ==========================================================\n");
   }
 
+  FILE *json = NULL; // only rank 0 writes the report
+  if( (my_rank==0) && (json_name!=NULL) ){
+    json = fopen(json_name,"w");
+    if(json==NULL){fprintf(stderr,"could not open '%s' for the JSON report\n",json_name);
+      #ifdef USE_MPI
+      MPI_Abort(MPI_COMM_WORLD,0);
+      #endif
+      exit(0);
+    }
+  }
+
+
+  #ifdef USE_PERF_COUNTERS
+  counters_init(); // open the hardware counters on every thread and measure the STREAM baseline
+  #endif
+
 
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
   // create the fine level...
-  #ifdef USE_PERIODIC_BC
-  int bc = BC_PERIODIC;
-  int minCoarseDim = 2; // avoid problems with black box calculation of D^{-1} for poisson with periodic BC's on a 1^3 grid
-  #else
-  int bc = BC_DIRICHLET;
-  int minCoarseDim = 1; // assumes you can drop order on the boundaries
-  #endif
   level_type level_h;
-  int ghosts=stencil_get_radius();
-  create_level(&level_h,boxes_in_i,box_dim,ghosts,VECTORS_RESERVED,bc,my_rank,num_tasks);
+  if(ghosts>box_dim){
+    if(my_rank==0){fprintf(stderr,"box ghost zone depth (%d) must not exceed the box dimension (%d)\n",ghosts,(int)box_dim);}
+    #ifdef USE_MPI
+    MPI_Finalize();
+    #endif
+    exit(0);
+  }
+  create_level(&level_h,boxes_in_i,boxes_in_j,boxes_in_k,box_dim,ghosts,VECTORS_RESERVED,bc,my_rank,num_tasks);
   #ifdef USE_HELMHOLTZ
   double a=1.0;double b=1.0; // Helmholtz
   if(my_rank==0)fprintf(stdout,"  Creating Helmholtz (a=%f, b=%f) test problem\n",a,b);
@@ -290,7 +616,8 @@ int main(int argc, char **argv){
   double a=0.0;double b=1.0; // Poisson
   if(my_rank==0)fprintf(stdout,"  Creating Poisson (a=%f, b=%f) test problem\n",a,b);
   #endif
-  double h=1.0/( (double)boxes_in_i*(double)box_dim );  // [0,1]^3 problem
+  int64_t boxes_in_max = boxes_in_i;if(boxes_in_j>boxes_in_max)boxes_in_max=boxes_in_j;if(boxes_in_k>boxes_in_max)boxes_in_max=boxes_in_k;
+  double h=1.0/( (double)boxes_in_max*(double)box_dim ); // [0,1]^3 problem (or a rectahedral subset of it whose longest dimension is 1)
   initialize_problem(&level_h,h,a,b);                   // initialize VECTOR_ALPHA, VECTOR_BETA*, and VECTOR_F
   rebuild_operator(&level_h,NULL,a,b);                  // calculate Dinv and lambda_max
   if(level_h.boundary_condition.type == BC_PERIODIC){   // remove any constants from the RHS for periodic problems
@@ -306,6 +633,29 @@ int main(int argc, char **argv){
   // create the MG hierarchy...
   mg_type MG_h;
   MGBuild(&MG_h,&level_h,a,b,minCoarseDim);             // build the Multigrid Hierarchy 
+  if(autotune)MGAutotune(&MG_h,a,b);                    // pick the fastest smoother/blocking for each level and the fastest bottom solver
+  if(json){
+    fprintf(json,"{\n");
+    fprintf(json,"  \"benchmark\": \"hpgmg-fv\",\n");
+    fprintf(json,"  \"build\": ");print_build_json(json);fprintf(json,",\n");
+    fprintf(json,"  \"mpi_ranks\": %d,\n",num_tasks);
+    fprintf(json,"  \"omp_threads\": %d,\n",OMP_Threads);
+    fprintf(json,"  \"a\": ");MGPrintJSONNumber(json,"%0.15e",a);fprintf(json,",\n");
+    fprintf(json,"  \"b\": ");MGPrintJSONNumber(json,"%0.15e",b);fprintf(json,",\n");
+    fprintf(json,"  \"box_dim\": %d,\n",(int)box_dim);
+    fprintf(json,"  \"boxes_in_i\": %d,\n",(int)boxes_in_i);
+    fprintf(json,"  \"boxes_in_j\": %d,\n",(int)boxes_in_j);
+    fprintf(json,"  \"boxes_in_k\": %d,\n",(int)boxes_in_k);
+    fprintf(json,"  \"ghosts\": %d,\n",ghosts);
+    fprintf(json,"  \"boundary_condition\": \"%s\",\n",(bc==BC_PERIODIC) ? "periodic" : "dirichlet");
+    fprintf(json,"  \"smoother\": \"%s\",\n",smoothers[default_smoother].name);
+    fprintf(json,"  \"kernels\": \"%s\",\n",op_kernels[default_op_kernels].name);
+    fprintf(json,"  \"bottom_solver\": \"%s\",\n",bottom_solvers[default_bottom_solver].name);
+    fprintf(json,"  \"autotune\": %s,\n",autotune ? "true" : "false");
+    fprintf(json,"  \"fuse_interpolation\": %s,\n",fuse_interpolation ? "true" : "false");
+    fprintf(json,"  \"overlap_exchange\": %s,\n",overlap_exchange ? "true" : "false");
+    fprintf(json,"  \"exchange\": \"%s\"",exchange_methods[exchange_method]);
+  }
 
 
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -326,7 +676,9 @@ int main(int argc, char **argv){
     AverageSolveTime[l] = (double)MG_h.timers.MGSolve / (double)MG_h.MGSolves_performed;
     if(my_rank==0){fprintf(stdout,"\n\n===== Timing Breakdown =========================================================\n");}
     MGPrintTiming(&MG_h,l);
+    if(json){fprintf(json,"%s    ",(l==0) ? ",\n  \"timing\": [\n" : ",\n");MGPrintTimingJSON(&MG_h,l,json);}
   }
+  if(json){fprintf(json,"\n  ]");}
 
   if(my_rank==0){
     #ifdef CALIBRATE_TIMER
@@ -342,7 +694,15 @@ int main(int argc, char **argv){
       double seconds = SecondsPerCycle*(double)AverageSolveTime[l];
       double DOFs = DOF / seconds;
       fprintf(stdout,"  h=%0.15e  DOF=%0.15e  time=%0.6f  DOF/s=%0.3e  MPI=%d  OMP=%d\n",MG_h.levels[l]->h,DOF,seconds,DOFs,num_tasks,OMP_Threads);
+      if(json){
+        fprintf(json,"%s    {\"h\": ",(l==0) ? ",\n  \"performance\": [\n" : ",\n");MGPrintJSONNumber(json,"%0.15e",MG_h.levels[l]->h);
+        fprintf(json,", \"dof\": "           );MGPrintJSONNumber(json,"%0.15e",DOF    );
+        fprintf(json,", \"seconds\": "       );MGPrintJSONNumber(json,"%0.9e" ,seconds);
+        fprintf(json,", \"dof_per_second\": ");MGPrintJSONNumber(json,"%0.9e" ,DOFs   );
+        fprintf(json,"}");
+      }
     }
+    if(json){fprintf(json,"\n  ]");}
   }
 
   #endif // TEST_ERROR not defined
@@ -363,7 +723,15 @@ int main(int argc, char **argv){
      MGSolve(&MG_h,l,VECTOR_U,VECTOR_F,a,b,rtol);
     #endif
   }
-  richardson_error(&MG_h,0,VECTOR_U);
+  double error,order;
+  richardson_error(&MG_h,0,VECTOR_U,&error,&order);
+  if(json){
+    fprintf(json,",\n  \"richardson\": {\"h\": ");MGPrintJSONNumber(json,"%0.15e",MG_h.levels[0]->h);
+    fprintf(json,", \"error\": "                   );MGPrintJSONNumber(json,"%0.15e",error);
+    fprintf(json,", \"order\": "                   );MGPrintJSONNumber(json,"%0.6f" ,order);
+    fprintf(json,"}\n}\n");
+    fclose(json);
+  }
 
 
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -375,6 +743,9 @@ int main(int argc, char **argv){
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
   if(my_rank==0){fprintf(stdout,"\n\n===== Done =====================================================================\n");}
 
+  #ifdef USE_PERF_COUNTERS
+  counters_finalize();
+  #endif
   #ifdef USE_MPI
   #ifdef USE_HPM // IBM performance counters for BGQ...
   HPM_Print();
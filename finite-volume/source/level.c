@@ -3,11 +3,15 @@
 // SWWilliams@lbl.gov
 // Lawrence Berkeley National Lab
 //------------------------------------------------------------------------------------------------------------------------------
+#if defined(__linux__) || defined(USE_HUGEPAGES)
+#define _GNU_SOURCE // syscall(), posix_memalign(), mmap(MAP_ANONYMOUS), and madvise() are not part of c99
+#endif
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
+#include <sys/resource.h>
 //------------------------------------------------------------------------------------------------------------------------------
 #ifdef USE_MPI
 #include <mpi.h>
@@ -15,11 +19,19 @@
 #ifdef _OPENMP
 #include <omp.h>
 #endif
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#elif defined(USE_HUGEPAGES)
+#include <sys/mman.h>
+#endif
 //------------------------------------------------------------------------------------------------------------------------------
 #include "timers.h"
 #include "defines.h"
 #include "level.h"
 #include "operators.h"
+#include "solvers.h"
 //------------------------------------------------------------------------------------------------------------------------------
 void print_communicator(int printSendRecv, int rank, int level, communicator_type *comm){
   int i;
@@ -297,6 +309,41 @@ int decompose_level_zmort(int *rank_of_box, int boxes_in_i, int boxes_in_j, int
 //}
 
 
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// assign a process rank to each box of a boxes_in_i x boxes_in_j x boxes_in_k level (-1 denotes no box).  Every process calculates the same decomposition
+// without communicating and so this may also be used to predict the decomposition of a level that is never created (see MGEstimateMemory())
+void decompose_level(int *rank_of_box, int boxes_in_i, int boxes_in_j, int boxes_in_k, int num_ranks, int verbose){
+  int box;
+  for(box=0;box<boxes_in_i*boxes_in_j*boxes_in_k;box++){rank_of_box[box]=-1;}  // -1 denotes that there is no actual box assigned to this region
+  #ifdef DECOMPOSE_LEX
+  // lexicographical ordering... good load balance, potentially high bisection bandwidth requirements, bad surface:volume ratio when #boxes/proc is large
+  if(verbose){fprintf(stdout,"  Decomposing level via lexicographical ordering... ");fflush(stdout);}
+  decompose_level_lex(rank_of_box,boxes_in_i,boxes_in_j,boxes_in_k,num_ranks);
+  #elif DECOMPOSE_BISECTION_SPECIAL
+  // recursive partitioning by primes
+  if(verbose){fprintf(stdout,"  Decomposing level via partitioning by primes... ");fflush(stdout);}
+  decompose_level_bisection_special(rank_of_box,boxes_in_i,boxes_in_i*boxes_in_j,0,0,0,boxes_in_i,boxes_in_j,boxes_in_k,0,num_ranks);
+  #elif DECOMPOSE_BISECTION
+  // recursive bisection
+  if(verbose){fprintf(stdout,"  Decomposing level via recursive bisection... ");fflush(stdout);}
+  decompose_level_bisection(rank_of_box,boxes_in_i,boxes_in_i*boxes_in_j,0,0,0,boxes_in_i,boxes_in_j,boxes_in_k,num_ranks,0,boxes_in_i*boxes_in_j*boxes_in_k);
+  #else//#elif DECOMPOSE_ZMORT
+  if(verbose){fprintf(stdout,"  Decomposing level via Z-mort ordering... ");fflush(stdout);}
+  #if 0 // Z-Mort over a power of two bounding box skipping boxes outside the domain
+  int idim_padded=1;while(idim_padded<boxes_in_i)idim_padded*=2;
+  int jdim_padded=1;while(jdim_padded<boxes_in_j)jdim_padded*=2;
+  int kdim_padded=1;while(kdim_padded<boxes_in_k)kdim_padded*=2;
+  #else // Z-Mort over the valid domain wtih odd-sized base cases (i.e. zmort on 3x3)
+  int idim_padded=boxes_in_i;
+  int jdim_padded=boxes_in_j;
+  int kdim_padded=boxes_in_k;
+  #endif
+  decompose_level_zmort(rank_of_box,boxes_in_i,boxes_in_j,boxes_in_k,0,0,0,idim_padded,jdim_padded,kdim_padded,num_ranks,0,boxes_in_i*boxes_in_j*boxes_in_k);
+  #endif
+  if(verbose){fprintf(stdout,"done\n");fflush(stdout);}
+}
+
+
 //---------------------------------------------------------------------------------------------------------------------------------------------------
 void print_decomposition(level_type *level){
   if(level->my_rank!=0)return;
@@ -328,8 +375,8 @@ void print_decomposition(level_type *level){
 #endif
 void append_block_to_list(blockCopy_type ** blocks, int *allocated_blocks, int *num_blocks,
                           int dim_i, int dim_j, int dim_k,
-                          int  read_box, double*  read_ptr, int  read_i, int  read_j, int  read_k, int  read_jStride, int  read_kStride, int  read_scale,
-                          int write_box, double* write_ptr, int write_i, int write_j, int write_k, int write_jStride, int write_kStride, int write_scale,
+                          int  read_box, real_t*  read_ptr, int  read_i, int  read_j, int  read_k, int  read_jStride, int  read_kStride, int  read_scale,
+                          int write_box, real_t* write_ptr, int write_i, int write_j, int write_k, int write_jStride, int write_kStride, int write_scale,
                           int blockcopy_tile_i, int blockcopy_tile_j, int blockcopy_tile_k, 
                           int subtype
                          ){
@@ -561,6 +608,83 @@ void build_boundary_conditions(level_type *level, int shape){
   #endif
 }
 
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------
+// decode the direction sent (0..26) into the region of the sending box (send[], dim[]) and where it lands in the receiving box (recv[])
+static void ghost_region(int box_dim, int box_ghosts, int sendDir, int *send, int *dim, int *recv){
+  int d,delta[3];
+  delta[0] = ((sendDir % 3)  )-1;
+  delta[1] = ((sendDir % 9)/3)-1;
+  delta[2] = ((sendDir / 9)  )-1;
+  for(d=0;d<3;d++){
+    switch(delta[d]){ // direction relative to sender
+      case -1:send[d]=0;                  dim[d]=box_ghosts;recv[d]=  box_dim;   break;
+      case  0:send[d]=0;                  dim[d]=box_dim;   recv[d]=0;           break;
+      case  1:send[d]=box_dim-box_ghosts; dim[d]=box_ghosts;recv[d]=0-box_ghosts;break;
+    }
+  }
+}
+
+
+// box intersection algebra... the regions one box sends to one rank (faces, edges, and corners) frequently overlap (e.g. an edge is
+// a subset of the adjacent face).  If the bounding box of the regions is no larger than their sum, it is sent once (one pack block, 
+// one segment of the MPI buffer) and the receiver unpacks each ghost region from it.  Otherwise, each region is sent separately.
+// Both the sender and the receiver call this with the same (sorted) list of directions and thus agree on the layout of the MPI buffer.
+static int coalesce_ghost_regions(int box_dim, int box_ghosts, int numDirs, const int *dirs, int *lo, int *dim){
+  int n,d,send[3],sdim[3],recv[3],hi[3];
+  uint64_t volume=0;
+  for(n=0;n<numDirs;n++){
+    ghost_region(box_dim,box_ghosts,dirs[n],send,sdim,recv);
+    volume += (uint64_t)sdim[0]*sdim[1]*sdim[2];
+    for(d=0;d<3;d++){
+      if( (n==0) || (send[d]        < lo[d]) )lo[d] = send[d];
+      if( (n==0) || (send[d]+sdim[d]> hi[d]) )hi[d] = send[d]+sdim[d];
+    }
+  }
+  if(numDirs<2)return(0);
+  for(d=0;d<3;d++)dim[d]=hi[d]-lo[d];
+  return( (uint64_t)dim[0]*dim[1]*dim[2] <= volume );
+}
+
+
+// -exchange shm... rank is another process on my node whose vectors I can read directly
+static int shares_memory_with(level_type *level, int rank){
+  #ifdef USE_MPI
+  if( (level->node_rank!=NULL) && (rank>=0) && (rank!=level->my_rank) )return(level->node_rank[rank]!=MPI_UNDEFINED);
+  #endif
+  return(0);
+}
+
+
+// return the index in my_boxes[] of the shared box (mapped from another rank on my node) with global_box_id (append it if necessary)
+// Its vectors[] are bound once the owner allocates its vectors (see create_vectors_shared())
+static int shared_box(level_type *level, int global_box_id){
+  int s;
+  for(s=0;s<level->num_shared_boxes;s++)if(level->my_boxes[level->num_my_boxes+s].global_box_id==global_box_id)return(level->num_my_boxes+s);
+  level->my_boxes        = (box_type*)realloc(level->my_boxes,(level->num_my_boxes+s+1)*sizeof(box_type));
+  level->shared_box_rank = (     int*)realloc(level->shared_box_rank,                (s+1)*sizeof(     int));
+  if( (level->my_boxes==NULL) || (level->shared_box_rank==NULL) ){fprintf(stderr,"realloc failed - shared_box\n");exit(0);}
+  box_type *box = &level->my_boxes[level->num_my_boxes+s];
+  box->global_box_id = global_box_id;
+  box->low.i         = level->box_dim*( global_box_id %  level->boxes_in.i                                    );
+  box->low.j         = level->box_dim*((global_box_id /  level->boxes_in.i                   ) % level->boxes_in.j);
+  box->low.k         = level->box_dim*( global_box_id / (level->boxes_in.i*level->boxes_in.j)                    );
+  box->dim           = level->box_dim;
+  box->ghosts        = level->box_ghosts;
+  box->jStride       = level->box_jStride;
+  box->kStride       = level->box_kStride;
+  box->volume        = level->box_volume;
+  box->numVectors    = 0;
+  box->vectors       = NULL;
+  #ifdef USE_BVKJI_LAYOUT
+  box->fp_base       = NULL;
+  #endif
+  level->shared_box_rank[s] = level->rank_of_box[global_box_id];
+  level->num_shared_boxes++;
+  return(level->num_my_boxes+s);
+}
+
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------
 // create a mini program that packs data into MPI recv buffers, exchanges local data, and unpacks the MPI send buffers
 //   broadly speaking... 
@@ -615,9 +739,17 @@ void build_exchange_ghosts(level_type *level, int shape){
   level->exchange_ghosts[shape].allocated_blocks[0] = 0;
   level->exchange_ghosts[shape].allocated_blocks[1] = 0;
   level->exchange_ghosts[shape].allocated_blocks[2] = 0;
+  level->exchange_ghosts[shape].buffer_bytes        = 0;
   #ifdef USE_MPI
   level->exchange_ghosts[shape].requests            = NULL;
   level->exchange_ghosts[shape].status              = NULL;
+  level->exchange_ghosts[shape].persistent_requests = NULL;
+  level->exchange_ghosts[shape].neighbor_comm       = MPI_COMM_NULL;
+  level->exchange_ghosts[shape].neighbor_displs     = NULL;
+  level->exchange_ghosts[shape].neighbor_types      = NULL;
+  level->exchange_ghosts[shape].num_shared_ranks    = 0;
+  level->exchange_ghosts[shape].shared_ranks        = NULL;
+  level->exchange_ghosts[shape].shared_epoch        = 0;
   #endif
 
   int    n,CommunicateThisDir[27];for(n=0;n<27;n++)CommunicateThisDir[n] = faces[n] + edges[n] + corners[n];// to be safe, communicate everything
@@ -631,6 +763,9 @@ void build_exchange_ghosts(level_type *level, int shape){
   int stage;
   int _rank;
   int ghost,numGhosts,numGhostsRemote;
+  int numSharedRanks = 0; // -exchange shm... ranks on my node whose boxes I read directly or who read mine (with repeats)
+  int   *sharedRanks = (int*)malloc(2*26*level->num_my_boxes*sizeof(int)); // There are at most 26 neighbors per box (as sender and as receiver)
+  if( (level->num_my_boxes>0) && (sharedRanks==NULL) ){fprintf(stderr,"malloc failed - build_exchange_ghosts/sharedRanks\n");exit(0);}
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // traverse my list of boxes and create a lists of neighboring boxes and neighboring ranks
@@ -669,6 +804,7 @@ void build_exchange_ghosts(level_type *level, int shape){
         }
       }
       if(neighborBoxID>=0){
+      if( shares_memory_with(level,level->rank_of_box[neighborBoxID]) ){sharedRanks[numSharedRanks++]=level->rank_of_box[neighborBoxID];}else // the neighbor reads these ghosts directly from my box
       if( level->rank_of_box[neighborBoxID] != -1 ){
         ghostsToSend[numGhosts].sendRank  = level->my_rank;
         ghostsToSend[numGhosts].sendBoxID = myBoxID;
@@ -699,7 +835,7 @@ void build_exchange_ghosts(level_type *level, int shape){
   level->exchange_ghosts[shape].num_sends     =                  numSendRanks;
   level->exchange_ghosts[shape].send_ranks    =     (int*)malloc(numSendRanks*sizeof(int));
   level->exchange_ghosts[shape].send_sizes    =     (int*)malloc(numSendRanks*sizeof(int));
-  level->exchange_ghosts[shape].send_buffers  = (double**)malloc(numSendRanks*sizeof(double*));
+  level->exchange_ghosts[shape].send_buffers  = (real_t**)malloc(numSendRanks*sizeof(real_t*));
   if(numSendRanks>0){
   if(level->exchange_ghosts[shape].send_ranks  ==NULL){fprintf(stderr,"malloc failed - exchange_ghosts[%d].send_ranks\n",shape);exit(0);}
   if(level->exchange_ghosts[shape].send_sizes  ==NULL){fprintf(stderr,"malloc failed - exchange_ghosts[%d].send_sizes\n",shape);exit(0);}
@@ -717,104 +853,93 @@ void build_exchange_ghosts(level_type *level, int shape){
     int neighbor;
     for(neighbor=0;neighbor<numSendRanks;neighbor++){
       if(stage==1){
-             level->exchange_ghosts[shape].send_buffers[neighbor] = (double*)malloc(level->exchange_ghosts[shape].send_sizes[neighbor]*sizeof(double));
+             level->exchange_ghosts[shape].send_buffers[neighbor] = (real_t*)malloc(level->exchange_ghosts[shape].send_sizes[neighbor]*sizeof(real_t));
           if(level->exchange_ghosts[shape].send_sizes[neighbor]>0)
           if(level->exchange_ghosts[shape].send_buffers[neighbor]==NULL){fprintf(stderr,"malloc failed - exchange_ghosts[%d].send_buffers[neighbor]\n",shape);exit(0);}
-      memset(level->exchange_ghosts[shape].send_buffers[neighbor],                0,level->exchange_ghosts[shape].send_sizes[neighbor]*sizeof(double));
+      memset(level->exchange_ghosts[shape].send_buffers[neighbor],                0,level->exchange_ghosts[shape].send_sizes[neighbor]*sizeof(real_t));
+             level->exchange_ghosts[shape].buffer_bytes += (uint64_t)level->exchange_ghosts[shape].send_sizes[neighbor]*sizeof(real_t);
       }
       level->exchange_ghosts[shape].send_ranks[neighbor]=sendRanks[neighbor];
       level->exchange_ghosts[shape].send_sizes[neighbor]=0;
     }
-    for(ghost=0;ghost<numGhosts;ghost++){
-      int  dim_i=-1, dim_j=-1, dim_k=-1;
-      int send_i=-1,send_j=-1,send_k=-1;
-      int recv_i=-1,recv_j=-1,recv_k=-1;
-  
-      // decode ghostsToSend[ghost].sendDir (direction sent) into di/dj/dk 
-      int di = ((ghostsToSend[ghost].sendDir % 3)  )-1;
-      int dj = ((ghostsToSend[ghost].sendDir % 9)/3)-1;
-      int dk = ((ghostsToSend[ghost].sendDir / 9)  )-1;
-      switch(di){ // direction relative to sender
-        case -1:send_i=0;                               dim_i=level->box_ghosts;recv_i=  level->box_dim;   break;
-        case  0:send_i=0;                               dim_i=level->box_dim;   recv_i=0;                  break;
-        case  1:send_i=level->box_dim-level->box_ghosts;dim_i=level->box_ghosts;recv_i=0-level->box_ghosts;break;
-      }
-      switch(dj){ // direction relative to sender
-        case -1:send_j=0;                               dim_j=level->box_ghosts;recv_j=  level->box_dim;   break;
-        case  0:send_j=0;                               dim_j=level->box_dim;   recv_j=0;                  break;
-        case  1:send_j=level->box_dim-level->box_ghosts;dim_j=level->box_ghosts;recv_j=0-level->box_ghosts;break;
-      }
-      switch(dk){ // direction relative to sender
-        case -1:send_k=0;                               dim_k=level->box_ghosts;recv_k=  level->box_dim;   break;
-        case  0:send_k=0;                               dim_k=level->box_dim;   recv_k=0;                  break;
-        case  1:send_k=level->box_dim-level->box_ghosts;dim_k=level->box_ghosts;recv_k=0-level->box_ghosts;break;
-      }
- 
-      // determine if this ghost requires a pack or local exchange 
-      int LocalExchange; // 0 = pack list, 1 = local exchange list
-      if(ghostsToSend[ghost].recvRank != level->my_rank){
-        LocalExchange=0; // pack
+    int g0,g1,g;
+    for(g0=0;g0<numGhosts;g0=g1){
+      g1=g0;while( (g1<numGhosts) && (ghostsToSend[g1].sendBoxID==ghostsToSend[g0].sendBoxID) )g1++; // [g0,g1) are the ghosts sent by one box (sorted by direction)
+      for(ghost=g0;ghost<g1;ghost++){
+        int send[3],dim[3],recv[3];
+        ghost_region(level->box_dim,level->box_ghosts,ghostsToSend[ghost].sendDir,send,dim,recv);
+
+        if(ghostsToSend[ghost].recvRank == level->my_rank){ // append to the local exchange list...
+          if(stage==1)
+          append_block_to_list(&(level->exchange_ghosts[shape].blocks[1]),&(level->exchange_ghosts[shape].allocated_blocks[1]),&(level->exchange_ghosts[shape].num_blocks[1]),
+            /* dim.i         = */ dim[0],
+            /* dim.j         = */ dim[1],
+            /* dim.k         = */ dim[2],
+            /* read.box      = */ ghostsToSend[ghost].sendBox,
+            /* read.ptr      = */ NULL,
+            /* read.i        = */ send[0],
+            /* read.j        = */ send[1],
+            /* read.k        = */ send[2],
+            /* read.jStride  = */ level->my_boxes[ghostsToSend[ghost].sendBox].jStride,
+            /* read.kStride  = */ level->my_boxes[ghostsToSend[ghost].sendBox].kStride,
+            /* read.scale    = */ 1,
+            /* write.box     = */ ghostsToSend[ghost].recvBox,
+            /* write.ptr     = */ NULL,
+            /* write.i       = */ recv[0],
+            /* write.j       = */ recv[1],
+            /* write.k       = */ recv[2],
+            /* write.jStride = */ level->my_boxes[ghostsToSend[ghost].recvBox].jStride,
+            /* write.kStride = */ level->my_boxes[ghostsToSend[ghost].recvBox].kStride,
+            /* write.scale   = */ 1,
+            /* blockcopy_i   = */ BLOCKCOPY_TILE_I, // default
+            /* blockcopy_j   = */ 8, //BLOCKCOPY_TILE_J, // default
+            /* blockcopy_k   = */ 8, //BLOCKCOPY_TILE_K, // default
+            /* subtype       = */ 0  
+          );
+          continue;
+        }
+
+        // the first ghost this box sends to recvRank packs everything this box sends to recvRank...
+        int first=1;for(g=g0;g<ghost;g++)if(ghostsToSend[g].recvRank==ghostsToSend[ghost].recvRank)first=0;
+        if(!first)continue;
+        int dirs[26],numDirs=0;
+        for(g=ghost;g<g1;g++)if(ghostsToSend[g].recvRank==ghostsToSend[ghost].recvRank)dirs[numDirs++]=ghostsToSend[g].sendDir;
         neighbor=0;while(level->exchange_ghosts[shape].send_ranks[neighbor] != ghostsToSend[ghost].recvRank)neighbor++;
-      }else{
-        LocalExchange=1; // local
-        neighbor=-1;
-      }
-   
-      if(stage==1){ 
-      if(LocalExchange) // append to the local exchange list...
-      append_block_to_list(&(level->exchange_ghosts[shape].blocks[1]),&(level->exchange_ghosts[shape].allocated_blocks[1]),&(level->exchange_ghosts[shape].num_blocks[1]),
-        /* dim.i         = */ dim_i,
-        /* dim.j         = */ dim_j,
-        /* dim.k         = */ dim_k,
-        /* read.box      = */ ghostsToSend[ghost].sendBox,
-        /* read.ptr      = */ NULL,
-        /* read.i        = */ send_i,
-        /* read.j        = */ send_j,
-        /* read.k        = */ send_k,
-        /* read.jStride  = */ level->my_boxes[ghostsToSend[ghost].sendBox].jStride,
-        /* read.kStride  = */ level->my_boxes[ghostsToSend[ghost].sendBox].kStride,
-        /* read.scale    = */ 1,
-        /* write.box     = */ ghostsToSend[ghost].recvBox,
-        /* write.ptr     = */ NULL,
-        /* write.i       = */ recv_i,
-        /* write.j       = */ recv_j,
-        /* write.k       = */ recv_k,
-        /* write.jStride = */ level->my_boxes[ghostsToSend[ghost].recvBox].jStride,
-        /* write.kStride = */ level->my_boxes[ghostsToSend[ghost].recvBox].kStride,
-        /* write.scale   = */ 1,
-        /* blockcopy_i   = */ BLOCKCOPY_TILE_I, // default
-        /* blockcopy_j   = */ 8, //BLOCKCOPY_TILE_J, // default
-        /* blockcopy_k   = */ 8, //BLOCKCOPY_TILE_K, // default
-        /* subtype       = */ 0  
-      );
-      else // append to the MPI pack list...
-      append_block_to_list(&(level->exchange_ghosts[shape].blocks[0]),&(level->exchange_ghosts[shape].allocated_blocks[0]),&(level->exchange_ghosts[shape].num_blocks[0]),
-        /* dim.i         = */ dim_i,
-        /* dim.j         = */ dim_j,
-        /* dim.k         = */ dim_k,
-        /* read.box      = */ ghostsToSend[ghost].sendBox,
-        /* read.ptr      = */ NULL,
-        /* read.i        = */ send_i,
-        /* read.j        = */ send_j,
-        /* read.k        = */ send_k,
-        /* read.jStride  = */ level->my_boxes[ghostsToSend[ghost].sendBox].jStride,
-        /* read.kStride  = */ level->my_boxes[ghostsToSend[ghost].sendBox].kStride,
-        /* read.scale    = */ 1,
-        /* write.box     = */ -1,
-        /* write.ptr     = */ level->exchange_ghosts[shape].send_buffers[neighbor], // NOTE, 1. count _sizes, 2. allocate _buffers, 3. populate blocks
-        /* write.i       = */ level->exchange_ghosts[shape].send_sizes[neighbor], // current offset in the MPI send buffer
-        /* write.j       = */ 0,
-        /* write.k       = */ 0,
-        /* write.jStride = */ dim_i,       // contiguous block
-        /* write.kStride = */ dim_i*dim_j, // contiguous block
-        /* write.scale   = */ 1,
-        /* blockcopy_i   = */ BLOCKCOPY_TILE_I, // default
-        /* blockcopy_j   = */ 8, //BLOCKCOPY_TILE_J, // default
-        /* blockcopy_k   = */ 8, //BLOCKCOPY_TILE_K, // default
-        /* subtype       = */ 0  
-      );}
-      if(neighbor>=0)level->exchange_ghosts[shape].send_sizes[neighbor]+=dim_i*dim_j*dim_k;
-    } // ghost for-loop
+        int segment_lo[3],segment_dim[3];
+        int coalesce = coalesce_ghost_regions(level->box_dim,level->box_ghosts,numDirs,dirs,segment_lo,segment_dim);
+        int d;for(d=0;d<numDirs;d++){
+          if(!coalesce){ghost_region(level->box_dim,level->box_ghosts,dirs[d],segment_lo,segment_dim,recv);} // each region is its own segment of the MPI buffer
+          else if(d>0)break;                                                      // the bounding box is packed once
+          if(stage==1) // append to the MPI pack list...
+          append_block_to_list(&(level->exchange_ghosts[shape].blocks[0]),&(level->exchange_ghosts[shape].allocated_blocks[0]),&(level->exchange_ghosts[shape].num_blocks[0]),
+            /* dim.i         = */ segment_dim[0],
+            /* dim.j         = */ segment_dim[1],
+            /* dim.k         = */ segment_dim[2],
+            /* read.box      = */ ghostsToSend[ghost].sendBox,
+            /* read.ptr      = */ NULL,
+            /* read.i        = */ segment_lo[0],
+            /* read.j        = */ segment_lo[1],
+            /* read.k        = */ segment_lo[2],
+            /* read.jStride  = */ level->my_boxes[ghostsToSend[ghost].sendBox].jStride,
+            /* read.kStride  = */ level->my_boxes[ghostsToSend[ghost].sendBox].kStride,
+            /* read.scale    = */ 1,
+            /* write.box     = */ -1,
+            /* write.ptr     = */ level->exchange_ghosts[shape].send_buffers[neighbor], // NOTE, 1. count _sizes, 2. allocate _buffers, 3. populate blocks
+            /* write.i       = */ level->exchange_ghosts[shape].send_sizes[neighbor], // current offset in the MPI send buffer
+            /* write.j       = */ 0,
+            /* write.k       = */ 0,
+            /* write.jStride = */ segment_dim[0],                // contiguous block
+            /* write.kStride = */ segment_dim[0]*segment_dim[1], // contiguous block
+            /* write.scale   = */ 1,
+            /* blockcopy_i   = */ BLOCKCOPY_TILE_I, // default
+            /* blockcopy_j   = */ 8, //BLOCKCOPY_TILE_J, // default
+            /* blockcopy_k   = */ 8, //BLOCKCOPY_TILE_K, // default
+            /* subtype       = */ 0  
+          );
+          level->exchange_ghosts[shape].send_sizes[neighbor]+=segment_dim[0]*segment_dim[1]*segment_dim[2];
+        }
+      } // ghost for-loop
+    } // sendBox for-loop
   } // stage for-loop
 
 
@@ -861,6 +986,38 @@ void build_exchange_ghosts(level_type *level, int shape){
         }
       }
       if(neighborBoxID>=0){
+      if( shares_memory_with(level,level->rank_of_box[neighborBoxID]) ){
+        // the neighbor's box is mapped through the shared window... copy its ghosts directly (in the local list) rather than via MPI
+        int send[3],dim[3],recv[3];
+        int sendBox = shared_box(level,neighborBoxID);
+        ghost_region(level->box_dim,level->box_ghosts,26-dir,send,dim,recv);
+        append_block_to_list(&(level->exchange_ghosts[shape].blocks[1]),&(level->exchange_ghosts[shape].allocated_blocks[1]),&(level->exchange_ghosts[shape].num_blocks[1]),
+          /* dim.i         = */ dim[0],
+          /* dim.j         = */ dim[1],
+          /* dim.k         = */ dim[2],
+          /* read.box      = */ sendBox,
+          /* read.ptr      = */ NULL,
+          /* read.i        = */ send[0],
+          /* read.j        = */ send[1],
+          /* read.k        = */ send[2],
+          /* read.jStride  = */ level->my_boxes[sendBox].jStride,
+          /* read.kStride  = */ level->my_boxes[sendBox].kStride,
+          /* read.scale    = */ 1,
+          /* write.box     = */ recvBox,
+          /* write.ptr     = */ NULL,
+          /* write.i       = */ recv[0],
+          /* write.j       = */ recv[1],
+          /* write.k       = */ recv[2],
+          /* write.jStride = */ level->my_boxes[recvBox].jStride,
+          /* write.kStride = */ level->my_boxes[recvBox].kStride,
+          /* write.scale   = */ 1,
+          /* blockcopy_i   = */ BLOCKCOPY_TILE_I, // default
+          /* blockcopy_j   = */ 8, //BLOCKCOPY_TILE_J, // default
+          /* blockcopy_k   = */ 8, //BLOCKCOPY_TILE_K, // default
+          /* subtype       = */ 0  
+        );
+        sharedRanks[numSharedRanks++]=level->rank_of_box[neighborBoxID];
+      }else
       if( (level->rank_of_box[neighborBoxID] != -1) && (level->rank_of_box[neighborBoxID] != level->my_rank)  ){
         ghostsToRecv[numGhosts].sendRank  = level->rank_of_box[neighborBoxID];
         ghostsToRecv[numGhosts].sendBoxID = neighborBoxID;
@@ -886,7 +1043,7 @@ void build_exchange_ghosts(level_type *level, int shape){
   level->exchange_ghosts[shape].num_recvs     =                  numRecvRanks;
   level->exchange_ghosts[shape].recv_ranks    =     (int*)malloc(numRecvRanks*sizeof(int));
   level->exchange_ghosts[shape].recv_sizes    =     (int*)malloc(numRecvRanks*sizeof(int));
-  level->exchange_ghosts[shape].recv_buffers  = (double**)malloc(numRecvRanks*sizeof(double*));
+  level->exchange_ghosts[shape].recv_buffers  = (real_t**)malloc(numRecvRanks*sizeof(real_t*));
   if(numRecvRanks>0){
   if(level->exchange_ghosts[shape].recv_ranks  ==NULL){fprintf(stderr,"malloc failed - exchange_ghosts[%d].recv_ranks\n",shape);exit(0);}
   if(level->exchange_ghosts[shape].recv_sizes  ==NULL){fprintf(stderr,"malloc failed - exchange_ghosts[%d].recv_sizes\n",shape);exit(0);}
@@ -901,68 +1058,62 @@ void build_exchange_ghosts(level_type *level, int shape){
     int neighbor;
     for(neighbor=0;neighbor<numRecvRanks;neighbor++){
       if(stage==1){
-             level->exchange_ghosts[shape].recv_buffers[neighbor] = (double*)malloc(level->exchange_ghosts[shape].recv_sizes[neighbor]*sizeof(double));
+             level->exchange_ghosts[shape].recv_buffers[neighbor] = (real_t*)malloc(level->exchange_ghosts[shape].recv_sizes[neighbor]*sizeof(real_t));
           if(level->exchange_ghosts[shape].recv_sizes[neighbor]>0)
           if(level->exchange_ghosts[shape].recv_buffers[neighbor]==NULL){fprintf(stderr,"malloc failed - exchange_ghosts[%d].recv_buffers[neighbor]\n",shape);exit(0);}
-      memset(level->exchange_ghosts[shape].recv_buffers[neighbor],                0,level->exchange_ghosts[shape].recv_sizes[neighbor]*sizeof(double));
+      memset(level->exchange_ghosts[shape].recv_buffers[neighbor],                0,level->exchange_ghosts[shape].recv_sizes[neighbor]*sizeof(real_t));
+             level->exchange_ghosts[shape].buffer_bytes += (uint64_t)level->exchange_ghosts[shape].recv_sizes[neighbor]*sizeof(real_t);
       }
       level->exchange_ghosts[shape].recv_ranks[neighbor]=recvRanks[neighbor];
       level->exchange_ghosts[shape].recv_sizes[neighbor]=0;
     }
-    for(ghost=0;ghost<numGhosts;ghost++){
-      int  dim_i=-1, dim_j=-1, dim_k=-1;
-    //int send_i=-1,send_j=-1,send_k=-1;
-      int recv_i=-1,recv_j=-1,recv_k=-1;
-  
-      // decode ghostsToRecv[ghost].sendDir (direction sent) into di/dj/dk 
-      int di = ((ghostsToRecv[ghost].sendDir % 3)  )-1;
-      int dj = ((ghostsToRecv[ghost].sendDir % 9)/3)-1;
-      int dk = ((ghostsToRecv[ghost].sendDir / 9)  )-1;
-      switch(di){ // direction relative to sender
-        case -1:dim_i=level->box_ghosts;recv_i=  level->box_dim;   break;
-        case  0:dim_i=level->box_dim;   recv_i=0;                  break;
-        case  1:dim_i=level->box_ghosts;recv_i=0-level->box_ghosts;break;
-      }
-      switch(dj){ // direction relative to sender
-        case -1:dim_j=level->box_ghosts;recv_j=  level->box_dim;   break;
-        case  0:dim_j=level->box_dim;   recv_j=0;                  break;
-        case  1:dim_j=level->box_ghosts;recv_j=0-level->box_ghosts;break;
-      }
-      switch(dk){ // direction relative to sender
-        case -1:dim_k=level->box_ghosts;recv_k=  level->box_dim;   break;
-        case  0:dim_k=level->box_dim;   recv_k=0;                  break;
-        case  1:dim_k=level->box_ghosts;recv_k=0-level->box_ghosts;break;
-      }
- 
-      // determine if this ghost requires a pack or local exchange 
-      neighbor=0;while(level->exchange_ghosts[shape].recv_ranks[neighbor] != ghostsToRecv[ghost].sendRank)neighbor++;
-      if(stage==1)append_block_to_list(&(level->exchange_ghosts[shape].blocks[2]),&(level->exchange_ghosts[shape].allocated_blocks[2]),&(level->exchange_ghosts[shape].num_blocks[2]),
-      /*dim.i         = */ dim_i,
-      /*dim.j         = */ dim_j,
-      /*dim.k         = */ dim_k,
-      /*read.box      = */ -1,
-      /*read.ptr      = */ level->exchange_ghosts[shape].recv_buffers[neighbor], // NOTE, 1. count _sizes, 2. allocate _buffers, 3. populate blocks
-      /*read.i        = */ level->exchange_ghosts[shape].recv_sizes[neighbor], // current offset in the MPI recv buffer
-      /*read.j        = */ 0,
-      /*read.k        = */ 0,
-      /*read.jStride  = */ dim_i,       // contiguous block
-      /*read.kStride  = */ dim_i*dim_j, // contiguous block
-      /*read.scale    = */ 1,
-      /*write.box     = */ ghostsToRecv[ghost].recvBox,
-      /*write.ptr     = */ NULL,
-      /*write.i       = */ recv_i,
-      /*write.j       = */ recv_j,
-      /*write.k       = */ recv_k,
-      /*write.jStride = */ level->my_boxes[ghostsToRecv[ghost].recvBox].jStride,
-      /*write.kStride = */ level->my_boxes[ghostsToRecv[ghost].recvBox].kStride,
-      /*write.scale   = */ 1,
-      /* blockcopy_i  = */ BLOCKCOPY_TILE_I, // default
-      /* blockcopy_j  = */ 8, //BLOCKCOPY_TILE_J, // default
-      /* blockcopy_k  = */ 8, //BLOCKCOPY_TILE_K, // default
-      /* subtype      = */ 0  
-      );
-      if(neighbor>=0)level->exchange_ghosts[shape].recv_sizes[neighbor]+=dim_i*dim_j*dim_k;
-    } // ghost for-loop
+    int g0,g1,g;
+    for(g0=0;g0<numGhosts;g0=g1){
+      g1=g0;while( (g1<numGhosts) && (ghostsToRecv[g1].sendRank==ghostsToRecv[g0].sendRank) && (ghostsToRecv[g1].sendBoxID==ghostsToRecv[g0].sendBoxID) )g1++;
+      // [g0,g1) are the ghosts one remote box sends to me (sorted by direction)... mirror the sender's choice of segments
+      int dirs[26],numDirs=0;
+      for(g=g0;g<g1;g++)dirs[numDirs++]=ghostsToRecv[g].sendDir;
+      neighbor=0;while(level->exchange_ghosts[shape].recv_ranks[neighbor] != ghostsToRecv[g0].sendRank)neighbor++;
+      int segment_lo[3],segment_dim[3];
+      int coalesce = coalesce_ghost_regions(level->box_dim,level->box_ghosts,numDirs,dirs,segment_lo,segment_dim);
+      int segment_offset = level->exchange_ghosts[shape].recv_sizes[neighbor];
+      for(ghost=g0;ghost<g1;ghost++){
+        int send[3],dim[3],recv[3];
+        ghost_region(level->box_dim,level->box_ghosts,ghostsToRecv[ghost].sendDir,send,dim,recv);
+        if(!coalesce){ // each region is its own segment of the MPI buffer
+          segment_lo[0]=send[0];segment_lo[1]=send[1];segment_lo[2]=send[2];
+          segment_dim[0]=dim[0];segment_dim[1]=dim[1];segment_dim[2]=dim[2];
+          segment_offset = level->exchange_ghosts[shape].recv_sizes[neighbor];
+          level->exchange_ghosts[shape].recv_sizes[neighbor]+=dim[0]*dim[1]*dim[2];
+        }
+        if(stage==1)append_block_to_list(&(level->exchange_ghosts[shape].blocks[2]),&(level->exchange_ghosts[shape].allocated_blocks[2]),&(level->exchange_ghosts[shape].num_blocks[2]),
+        /*dim.i         = */ dim[0],
+        /*dim.j         = */ dim[1],
+        /*dim.k         = */ dim[2],
+        /*read.box      = */ -1,
+        /*read.ptr      = */ level->exchange_ghosts[shape].recv_buffers[neighbor], // NOTE, 1. count _sizes, 2. allocate _buffers, 3. populate blocks
+        /*read.i        = */ segment_offset + send[0]-segment_lo[0], // offset of this region within its segment of the MPI recv buffer
+        /*read.j        = */                  send[1]-segment_lo[1],
+        /*read.k        = */                  send[2]-segment_lo[2],
+        /*read.jStride  = */ segment_dim[0],                // contiguous segment
+        /*read.kStride  = */ segment_dim[0]*segment_dim[1], // contiguous segment
+        /*read.scale    = */ 1,
+        /*write.box     = */ ghostsToRecv[ghost].recvBox,
+        /*write.ptr     = */ NULL,
+        /*write.i       = */ recv[0],
+        /*write.j       = */ recv[1],
+        /*write.k       = */ recv[2],
+        /*write.jStride = */ level->my_boxes[ghostsToRecv[ghost].recvBox].jStride,
+        /*write.kStride = */ level->my_boxes[ghostsToRecv[ghost].recvBox].kStride,
+        /*write.scale   = */ 1,
+        /* blockcopy_i  = */ BLOCKCOPY_TILE_I, // default
+        /* blockcopy_j  = */ 8, //BLOCKCOPY_TILE_J, // default
+        /* blockcopy_k  = */ 8, //BLOCKCOPY_TILE_K, // default
+        /* subtype      = */ 0  
+        );
+      } // ghost for-loop
+      if(coalesce)level->exchange_ghosts[shape].recv_sizes[neighbor]+=segment_dim[0]*segment_dim[1]*segment_dim[2];
+    } // sendBox for-loop
   } // stage for-loop
 
 
@@ -983,6 +1134,75 @@ void build_exchange_ghosts(level_type *level, int shape){
   }
   #endif
 
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // -exchange shm... ranks that read each other's boxes must synchronize (pairwise) around the local copies (see exchange_boundary_begin())
+  // n.b. as the stencil shapes are symmetric, if I read a box of rank r then r reads one of mine and so r lists me too
+  #if defined(USE_MPI) && (MPI_VERSION>=3)
+  if(numSharedRanks>0){
+    qsort(sharedRanks,numSharedRanks,sizeof(int),qsortInt);
+    level->exchange_ghosts[shape].shared_ranks = (int*)malloc(numSharedRanks*sizeof(int));
+    if(level->exchange_ghosts[shape].shared_ranks==NULL){fprintf(stderr,"malloc failed - exchange_ghosts[%d].shared_ranks\n",shape);exit(0);}
+    for(n=0;n<numSharedRanks;n++)if( (n==0) || (sharedRanks[n]!=sharedRanks[n-1]) ){
+      level->exchange_ghosts[shape].shared_ranks[level->exchange_ghosts[shape].num_shared_ranks++] = level->node_rank[sharedRanks[n]];
+    }
+  }
+  #endif
+  free(sharedRanks);
+
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // the ranks, sizes, buffers, and tag of every message are now fixed.  Optionally bind them to MPI objects once rather than on every exchange...
+  #ifdef USE_MPI
+  int num_recvs = level->exchange_ghosts[shape].num_recvs;
+  int num_sends = level->exchange_ghosts[shape].num_sends;
+  if( (exchange_method==EXCHANGE_PERSISTENT) && (num_recvs+num_sends>0) ){
+    int my_tag = (level->tag<<4) | shape; // must match exchange_boundary()
+    level->exchange_ghosts[shape].persistent_requests = (MPI_Request*)malloc((num_recvs+num_sends)*sizeof(MPI_Request));
+    if(level->exchange_ghosts[shape].persistent_requests==NULL){fprintf(stderr,"malloc failed - exchange_ghosts[%d].persistent_requests\n",shape);exit(0);}
+    for(n=0;n<num_recvs;n++)MPI_Recv_init(level->exchange_ghosts[shape].recv_buffers[n],level->exchange_ghosts[shape].recv_sizes[n],MPI_REAL_T,level->exchange_ghosts[shape].recv_ranks[n],my_tag,MPI_COMM_WORLD,&level->exchange_ghosts[shape].persistent_requests[          n]);
+    for(n=0;n<num_sends;n++)MPI_Send_init(level->exchange_ghosts[shape].send_buffers[n],level->exchange_ghosts[shape].send_sizes[n],MPI_REAL_T,level->exchange_ghosts[shape].send_ranks[n],my_tag,MPI_COMM_WORLD,&level->exchange_ghosts[shape].persistent_requests[num_recvs+n]);
+  }
+  #if MPI_VERSION>=3
+  if(exchange_method==EXCHANGE_NEIGHBOR){
+    // a neighborhood collective must be called by every rank in its communicator, but ranks without boxes on this level never exchange.
+    // Thus, split off the ranks that communicate (collective on MPI_COMM_WORLD) and build the graph on that subset
+    MPI_Comm communicating;
+    MPI_Comm_split(MPI_COMM_WORLD,(num_recvs+num_sends>0) ? 0 : MPI_UNDEFINED,level->my_rank,&communicating);
+    if(communicating!=MPI_COMM_NULL){
+      int *sources      = (int*)malloc((num_recvs+1)*sizeof(int));
+      int *destinations = (int*)malloc((num_sends+1)*sizeof(int));
+      int *recv_weights = (int*)malloc((num_recvs+1)*sizeof(int)); // weight each edge by its message size (rather than MPI_UNWEIGHTED) so
+      int *send_weights = (int*)malloc((num_sends+1)*sizeof(int)); // the implementation may use it when placing/reordering ranks
+      if( (sources==NULL) || (destinations==NULL) || (recv_weights==NULL) || (send_weights==NULL) ){fprintf(stderr,"malloc failed - exchange_ghosts[%d] neighbor graph\n",shape);exit(0);}
+      for(n=0;n<num_recvs;n++)recv_weights[n] = level->exchange_ghosts[shape].recv_sizes[n];
+      for(n=0;n<num_sends;n++)send_weights[n] = level->exchange_ghosts[shape].send_sizes[n];
+      MPI_Group world_group,communicating_group;
+      MPI_Comm_group(MPI_COMM_WORLD,&world_group);
+      MPI_Comm_group(communicating,&communicating_group);
+      MPI_Group_translate_ranks(world_group,num_recvs,level->exchange_ghosts[shape].recv_ranks,communicating_group,sources     );
+      MPI_Group_translate_ranks(world_group,num_sends,level->exchange_ghosts[shape].send_ranks,communicating_group,destinations);
+      MPI_Dist_graph_create_adjacent(communicating,num_recvs,sources,recv_weights,num_sends,destinations,send_weights,MPI_INFO_NULL,0,&level->exchange_ghosts[shape].neighbor_comm);
+      MPI_Group_free(&communicating_group);
+      MPI_Group_free(&world_group);
+      MPI_Comm_free(&communicating);
+      free(sources);
+      free(destinations);
+      free(recv_weights);
+      free(send_weights);
+
+      // the buffers are separately allocated... describe each by its absolute address (MPI_BOTTOM+displacement) so alltoallw can address them in place
+      level->exchange_ghosts[shape].neighbor_displs = (MPI_Aint    *)malloc((num_recvs+num_sends)*sizeof(MPI_Aint    ));
+      level->exchange_ghosts[shape].neighbor_types  = (MPI_Datatype*)malloc((num_recvs+num_sends)*sizeof(MPI_Datatype));
+      if(level->exchange_ghosts[shape].neighbor_displs==NULL){fprintf(stderr,"malloc failed - exchange_ghosts[%d].neighbor_displs\n",shape);exit(0);}
+      if(level->exchange_ghosts[shape].neighbor_types ==NULL){fprintf(stderr,"malloc failed - exchange_ghosts[%d].neighbor_types\n",shape);exit(0);}
+      for(n=0;n<num_recvs;n++){MPI_Get_address(level->exchange_ghosts[shape].recv_buffers[n],&level->exchange_ghosts[shape].neighbor_displs[          n]);level->exchange_ghosts[shape].neighbor_types[          n]=MPI_REAL_T;}
+      for(n=0;n<num_sends;n++){MPI_Get_address(level->exchange_ghosts[shape].send_buffers[n],&level->exchange_ghosts[shape].neighbor_displs[num_recvs+n]);level->exchange_ghosts[shape].neighbor_types[num_recvs+n]=MPI_REAL_T;}
+    }
+  }
+  #endif
+  #endif
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   #ifdef BLOCK_SPATIAL_SORT
   // sort all the resultant blocks by box,k,j,i (good locality)
@@ -993,6 +1213,568 @@ void build_exchange_ghosts(level_type *level, int shape){
 }
 
 
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+#define GHOST_ALIGNMENT 512
+#define ARENA_ALIGNMENT  64
+// allocate FP data... with -DUSE_HUGEPAGES, allocations of at least one huge page are 2MB aligned and (on linux) advised to be backed by
+// transparent huge pages.  Smaller allocations (e.g. the boxes of coarse levels) are not padded to a huge page
+static void * malloc_fp(uint64_t malloc_size){
+  void * ptr = NULL;
+  #ifdef USE_HUGEPAGES
+  if(malloc_size >= (1<<21)){
+    if(posix_memalign(&ptr,1<<21,malloc_size))ptr=NULL; // 2MB aligned allocation
+    #ifdef MADV_HUGEPAGE
+    if(ptr)madvise(ptr,malloc_size & ~(uint64_t)((1<<21)-1),MADV_HUGEPAGE); // the whole huge pages (the tail is backed by base pages)
+    #endif
+    return(ptr);
+  }
+  #endif
+  ptr = malloc(malloc_size);
+  return(ptr);
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// an arena is a single (anonymous mmap) region from which the vectors of many levels are carved.  Memory is never returned to the arena.
+// Rather, the entire arena is released at once by destroy_arena()
+void create_arena(arena_type *arena, uint64_t size){
+  arena->size     = size;
+  arena->used     = 0;
+  arena->base     = NULL;
+  arena->map_base = NULL;
+  arena->map_size = 0;
+  if(size==0)return;
+  #ifdef MAP_ANONYMOUS
+  arena->map_size = (size + (1<<21)-1) & ~(uint64_t)((1<<21)-1); // round up to a whole number of huge pages
+  #ifdef USE_HUGEPAGES
+  arena->map_size += (1<<21); // slack to align the arena to a huge page
+  #endif
+  arena->map_base = mmap(NULL,arena->map_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if(arena->map_base==MAP_FAILED){fprintf(stderr,"mmap failed - create_arena (%llu bytes)\n",(unsigned long long)arena->map_size);exit(0);}
+  arena->base = (char*)arena->map_base;
+  #ifdef USE_HUGEPAGES
+  while( (uint64_t)arena->base & ((1<<21)-1) )arena->base+=4096;
+  #ifdef MADV_HUGEPAGE
+  madvise(arena->base,arena->map_size-(1<<21),MADV_HUGEPAGE);
+  #endif
+  #endif
+  #else
+  arena->map_base = malloc_fp(size);
+  if(arena->map_base==NULL){fprintf(stderr,"malloc failed - create_arena (%llu bytes)\n",(unsigned long long)size);exit(0);}
+  arena->base = (char*)arena->map_base;
+  #endif
+}
+
+
+// carve size bytes (ARENA_ALIGNMENT aligned) from the arena... returns NULL if the arena is exhausted
+void * arena_alloc(arena_type *arena, uint64_t size){
+  uint64_t used = (arena->used + ARENA_ALIGNMENT-1) & ~(uint64_t)(ARENA_ALIGNMENT-1);
+  if(used+size > arena->size)return(NULL);
+  arena->used = used+size;
+  return(arena->base+used);
+}
+
+
+// number of bytes that remain in the arena
+uint64_t arena_available(arena_type *arena){
+  uint64_t used = (arena->used + ARENA_ALIGNMENT-1) & ~(uint64_t)(ARENA_ALIGNMENT-1);
+  return( (used<arena->size) ? arena->size-used : 0 );
+}
+
+
+void destroy_arena(arena_type *arena){
+  if(arena->map_base==NULL)return;
+  #ifdef MAP_ANONYMOUS
+  munmap(arena->map_base,arena->map_size);
+  #else
+  free(arena->map_base);
+  #endif
+  arena->map_base = NULL;
+  arena->base     = NULL;
+  arena->size     = 0;
+  arena->used     = 0;
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// number of bytes create_vectors() will carve from an arena to allocate numVectors vectors on a level that has none (i.e. the size of the arena for that level)
+uint64_t vectors_arena_bytes(level_type *level, int numVectors){
+  #define ARENA_ROUNDUP(bytes) ( ((uint64_t)(bytes) + ARENA_ALIGNMENT-1) & ~(uint64_t)(ARENA_ALIGNMENT-1) )
+  uint64_t bytes = 0;
+  if(numVectors<=0)return(0);
+  #ifdef USE_BVKJI_LAYOUT
+  bytes += (uint64_t)level->num_my_boxes*ARENA_ROUNDUP( (uint64_t)numVectors*level->box_volume*sizeof(real_t) + GHOST_ALIGNMENT ); // fp_base
+  #endif
+  #ifdef USE_VBKJI_LAYOUT
+  bytes += (uint64_t)numVectors*ARENA_ROUNDUP( (uint64_t)level->num_my_boxes*level->box_volume*sizeof(real_t) + GHOST_ALIGNMENT ); // vectors_base[v]
+  #endif
+  bytes += (uint64_t)level->num_my_boxes*ARENA_ROUNDUP( numVectors*sizeof(real_t*) ); // my_boxes[].vectors
+  return(bytes);
+  #undef ARENA_ROUNDUP
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// calculate the (padded) pencil, plane, and volume of a box_dim^3 box with box_ghosts ghost zones
+static void calculate_box_strides(int box_dim, int box_ghosts, int *jStride, int *kStride, int *volume){
+  int pencil = box_dim+2*box_ghosts;
+  #ifdef USE_MAGIC_PADDING
+  // conceptually rectangular, but physically(in memory) non-rectangular box
+  *jStride =          pencil;while(*jStride % BOX_ALIGN_JSTRIDE)(*jStride)++; // pencil
+  *kStride = *jStride*pencil;while(*kStride % BOX_ALIGN_JSTRIDE)(*kStride)++; // plane alignment
+  while( *kStride %  512 <   96 )*kStride+=BOX_ALIGN_JSTRIDE; // pad planes to avoid conflicts in the L1 cache.
+                                                               // ensures the 5 planes of 4th order stencil hit different sets in a 32KB/8way cache
+  *volume  = *kStride*pencil;while(*volume  % BOX_ALIGN_JSTRIDE)(*volume )++; // volume
+  while( *volume  % 1024 != 568 )(*volume)++; // pad volumes to avoid conflicts in the L2 cache
+                                              // %1024==512 ensures volumes map to different L2 sets but the same L1 set
+                                              // +56 ensures volumes map to different L1 sets as well
+  #else
+  // default simply pads pencils/planes/volumes (resultant box is rectangular iff BOX_ALIGN_VOLUME==BOX_ALIGN_KSTRIDE==BOX_ALIGN_JSTRIDE)
+  *jStride =          pencil;while(*jStride % BOX_ALIGN_JSTRIDE)(*jStride)++; // pencil
+  *kStride = *jStride*pencil;while(*kStride % BOX_ALIGN_KSTRIDE)(*kStride)++; // plane
+  *volume  = *kStride*pencil;while(*volume  % BOX_ALIGN_VOLUME )(*volume )++; // volume
+  #endif
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// number of blocks append_block_to_list() tiles a dim_i x dim_j x dim_k region into
+int count_tiles(int dim_i, int dim_j, int dim_k, int tile_i, int tile_j, int tile_k){
+  if( (dim_i<=0) || (dim_j<=0) || (dim_k<=0) )return(0);
+  return( ((dim_i+tile_i-1)/tile_i)*((dim_j+tile_j-1)/tile_j)*((dim_k+tile_k-1)/tile_k) );
+}
+
+
+// bytes append_block_to_list() allocates for a list of num_blocks blocks (BLOCK_LIST_MIN_SIZE, then doubled as necessary)
+uint64_t block_list_bytes(uint64_t num_blocks){
+  uint64_t allocated = (num_blocks>0) ? BLOCK_LIST_MIN_SIZE : 0;
+  while(allocated<num_blocks)allocated*=2;
+  return(allocated*sizeof(blockCopy_type));
+}
+
+
+// bytes of a communicator's neighbor lists (ranks, sizes, and buffers) and requests for num_messages sends+recvs (see communicator_bytes())
+uint64_t communicator_message_bytes(int num_messages){
+  uint64_t bytes = (uint64_t)num_messages*(2*sizeof(int)+sizeof(real_t*));
+  #ifdef USE_MPI
+  bytes += (uint64_t)num_messages*(sizeof(MPI_Request)+sizeof(MPI_Status));
+  #endif
+  return(bytes);
+}
+
+
+// global id of the neighbor of box in direction (di,dj,dk) or -1 if it is outside a non-periodic domain
+static int neighbor_box_id(int boxes_in_i, int boxes_in_j, int boxes_in_k, int periodic, int box, int di, int dj, int dk){
+  int i = ( box %  boxes_in_i                            ) + di;
+  int j = ((box /  boxes_in_i             ) % boxes_in_j) + dj;
+  int k = ( box / (boxes_in_i*boxes_in_j)                ) + dk;
+  if(periodic){i=(i+boxes_in_i)%boxes_in_i;j=(j+boxes_in_j)%boxes_in_j;k=(k+boxes_in_k)%boxes_in_k;}
+  if( (i<0) || (i>=boxes_in_i) || (j<0) || (j>=boxes_in_j) || (k<0) || (k>=boxes_in_k) )return(-1);
+  return(i + j*boxes_in_i + k*boxes_in_i*boxes_in_j);
+}
+
+
+// analytically estimate the bytes of each category measure_level_memory() would report for the process rank (whose boxes are my_box_ids[num_my_boxes])
+// if create_level() followed by create_vectors(numVectors) were called with this decomposition (rank_of_box).  This mirrors the construction of my_blocks
+// and overlap_blocks (default blocking), the boundary conditions, and the ghost zone exchange (assuming -exchange p2p) including the capacity of each block
+// list.  The restriction and interpolation lists span two levels and are estimated by MGEstimateMemory().  Lazily allocated temporaries (MEMORY_FLUXES) are not included.
+void estimate_level_memory(int boxes_in_i, int boxes_in_j, int boxes_in_k, int box_dim, int box_ghosts, int domain_boundary_condition,
+                           const int *rank_of_box, int rank, const int *my_box_ids, int num_my_boxes, int numVectors, uint64_t *bytes){
+  int    faces[27] = {0,0,0,0,1,0,0,0,0,  0,1,0,1,0,1,0,1,0,  0,0,0,0,1,0,0,0,0};
+  int    edges[27] = {0,1,0,1,0,1,0,1,0,  1,0,1,0,0,0,1,0,1,  0,1,0,1,0,1,0,1,0};
+  int  corners[27] = {1,0,1,0,0,0,1,0,1,  0,0,0,0,0,0,0,0,0,  1,0,1,0,0,0,1,0,1};
+  int c,b,n,g,shape,dir,jStride,kStride,volume;
+  const int periodic = (domain_boundary_condition==BC_PERIODIC);
+  calculate_box_strides(box_dim,box_ghosts,&jStride,&kStride,&volume);
+  for(c=0;c<MEMORY_CATEGORIES;c++)bytes[c]=0;
+
+  // FP data and boxes (see measure_level_memory())...
+  if(numVectors>0){
+    #ifdef USE_BVKJI_LAYOUT
+    bytes[MEMORY_VECTORS] += (uint64_t)num_my_boxes*( (uint64_t)numVectors*volume*sizeof(real_t) + GHOST_ALIGNMENT );
+    #endif
+    #ifdef USE_VBKJI_LAYOUT
+    bytes[MEMORY_VECTORS] += (uint64_t)numVectors*( (uint64_t)num_my_boxes*volume*sizeof(real_t) + GHOST_ALIGNMENT );
+    bytes[MEMORY_VECTORS] += (uint64_t)numVectors*2*sizeof(real_t*);
+    #endif
+    bytes[MEMORY_VECTORS] += (uint64_t)num_my_boxes*numVectors*sizeof(real_t*);
+  }
+  bytes[MEMORY_BOXES] += (uint64_t)boxes_in_i*boxes_in_j*boxes_in_k*sizeof(int);
+  bytes[MEMORY_BOXES] += (uint64_t)num_my_boxes*sizeof(box_type);
+  if(num_my_boxes>0)bytes[MEMORY_REDBLACK] += 2*(uint64_t)kStride*sizeof(real_t)+256;
+
+  // my_blocks and overlap_blocks (see build_my_blocks() and build_overlap_blocks())...
+  uint64_t num_blocks=0,num_interior=0,num_shell=0;
+  for(b=0;b<num_my_boxes;b++){
+    int box = my_box_ids[b];
+    int bi = box%boxes_in_i,bj = (box/boxes_in_i)%boxes_in_j,bk = box/(boxes_in_i*boxes_in_j);
+    const int d = box_dim, gh = box_ghosts;
+    num_blocks += count_tiles(d,d,d,BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K);
+    int onBoundary = !periodic && ( (bi==0) || (bi==boxes_in_i-1) || (bj==0) || (bj==boxes_in_j-1) || (bk==0) || (bk==boxes_in_k-1) );
+    if( onBoundary || (d<=2*gh) ){
+      num_shell    += count_tiles(    d,     d,     d,BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K);
+    }else{
+      num_interior += count_tiles(d-2*gh,d-2*gh,d-2*gh,BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K);
+      num_shell    += count_tiles(    d,     d,    gh,BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K)*2;
+      num_shell    += count_tiles(    d,    gh,d-2*gh,BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K)*2;
+      num_shell    += count_tiles(   gh,d-2*gh,d-2*gh,BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K)*2;
+    }
+  }
+  bytes[MEMORY_BLOCKS] += block_list_bytes(num_blocks) + block_list_bytes(num_interior) + block_list_bytes(num_shell);
+
+  // boundary conditions (see build_boundary_conditions())...
+  if(!periodic)for(shape=0;shape<STENCIL_MAX_SHAPES;shape++){
+    int tile_i = (BLOCKCOPY_TILE_I < box_ghosts) ? box_ghosts : BLOCKCOPY_TILE_I;
+    int tile_j = (BLOCKCOPY_TILE_J < box_ghosts) ? box_ghosts : BLOCKCOPY_TILE_J;
+    int tile_k = (BLOCKCOPY_TILE_K < box_ghosts) ? box_ghosts : BLOCKCOPY_TILE_K;
+    num_blocks=0;
+    for(b=0;b<num_my_boxes;b++){
+    for(dir=0;dir<27;dir++){
+      if( (shape==STENCIL_SHAPE_STAR      ) && (edges[dir]||corners[dir]) )continue;
+      if( (shape==STENCIL_SHAPE_NO_CORNERS) && (           corners[dir]) )continue;
+      if( (dir==13) || (neighbor_box_id(boxes_in_i,boxes_in_j,boxes_in_k,0,my_box_ids[b],(dir%3)-1,((dir%9)/3)-1,(dir/9)-1)>=0) )continue;
+      int send[3],dim[3],recv[3];
+      ghost_region(box_dim,box_ghosts,dir,send,dim,recv);
+      num_blocks += count_tiles(dim[0],dim[1],dim[2],tile_i,tile_j,tile_k);
+    }}
+    bytes[MEMORY_BLOCKS] += block_list_bytes(num_blocks);
+  }
+
+  // ghost zone exchange (see build_exchange_ghosts())...
+  int *ids   = (int*)malloc((26*num_my_boxes+1)*sizeof(int)); // remote neighbor boxes
+  int *ranks = (int*)malloc((26*num_my_boxes+1)*sizeof(int)); // remote neighbor ranks
+  if( (ids==NULL) || (ranks==NULL) ){fprintf(stderr,"malloc failed - estimate_level_memory\n");exit(0);}
+  for(shape=0;shape<STENCIL_MAX_SHAPES;shape++){
+    int CommunicateThisDir[27];
+    for(dir=0;dir<27;dir++)switch(shape){
+      case STENCIL_SHAPE_BOX:       CommunicateThisDir[dir] = faces[dir] + edges[dir] + corners[dir];break;
+      case STENCIL_SHAPE_STAR:      CommunicateThisDir[dir] = faces[dir]                            ;break;
+      case STENCIL_SHAPE_NO_CORNERS:CommunicateThisDir[dir] = faces[dir] + edges[dir]               ;break;
+    }
+    uint64_t blocks[3] = {0,0,0};
+    uint64_t buffer_bytes = 0;
+    int num_ids=0,num_ranks=0;
+    for(b=0;b<num_my_boxes;b++){
+      int dirs[26],dir_rank[26],numDirs=0;
+      for(dir=0;dir<27;dir++)if(CommunicateThisDir[dir]){
+        int nid = neighbor_box_id(boxes_in_i,boxes_in_j,boxes_in_k,periodic,my_box_ids[b],(dir%3)-1,((dir%9)/3)-1,(dir/9)-1);
+        if( (nid<0) || (rank_of_box[nid]<0) )continue;
+        int send[3],dim[3],recv[3];
+        ghost_region(box_dim,box_ghosts,dir,send,dim,recv);
+        if(rank_of_box[nid]==rank){blocks[1] += count_tiles(dim[0],dim[1],dim[2],BLOCKCOPY_TILE_I,8,8);continue;} // local
+        blocks[2] += count_tiles(dim[0],dim[1],dim[2],BLOCKCOPY_TILE_I,8,8); // unpack (the ghost region I receive from nid has the same shape)
+        ids[num_ids++] = nid;
+        ranks[num_ranks++] = rank_of_box[nid];
+        dirs[numDirs] = dir;dir_rank[numDirs++] = rank_of_box[nid];
+      }
+      // pack... everything this box sends to one rank is either coalesced into its bounding box or sent region by region
+      for(n=0;n<numDirs;n++){
+        int first=1;for(g=0;g<n;g++)if(dir_rank[g]==dir_rank[n])first=0;
+        if(!first)continue;
+        int group[26],numGroup=0,lo[3],dim[3];
+        for(g=n;g<numDirs;g++)if(dir_rank[g]==dir_rank[n])group[numGroup++]=dirs[g];
+        if(coalesce_ghost_regions(box_dim,box_ghosts,numGroup,group,lo,dim)){
+          blocks[0]    += count_tiles(dim[0],dim[1],dim[2],BLOCKCOPY_TILE_I,8,8);
+          buffer_bytes += (uint64_t)dim[0]*dim[1]*dim[2]*sizeof(real_t);
+        }else for(g=0;g<numGroup;g++){
+          int send[3],recv[3];
+          ghost_region(box_dim,box_ghosts,group[g],send,dim,recv);
+          blocks[0]    += count_tiles(dim[0],dim[1],dim[2],BLOCKCOPY_TILE_I,8,8);
+          buffer_bytes += (uint64_t)dim[0]*dim[1]*dim[2]*sizeof(real_t);
+        }
+      }
+    }
+    // recv buffers... each remote neighboring box sends me its (possibly coalesced) regions adjacent to any of my boxes
+    qsort(ids,num_ids,sizeof(int),qsortInt);
+    for(n=0;n<num_ids;n++)if( (n==0) || (ids[n]!=ids[n-1]) ){
+      int group[26],numGroup=0,lo[3],dim[3];
+      for(dir=0;dir<27;dir++)if(CommunicateThisDir[dir]){
+        int nid = neighbor_box_id(boxes_in_i,boxes_in_j,boxes_in_k,periodic,ids[n],(dir%3)-1,((dir%9)/3)-1,(dir/9)-1);
+        if( (nid>=0) && (rank_of_box[nid]==rank) )group[numGroup++]=dir;
+      }
+      if(coalesce_ghost_regions(box_dim,box_ghosts,numGroup,group,lo,dim)){
+        buffer_bytes += (uint64_t)dim[0]*dim[1]*dim[2]*sizeof(real_t);
+      }else for(g=0;g<numGroup;g++){
+        int send[3],recv[3];
+        ghost_region(box_dim,box_ghosts,group[g],send,dim,recv);
+        buffer_bytes += (uint64_t)dim[0]*dim[1]*dim[2]*sizeof(real_t);
+      }
+    }
+    // neighboring ranks (every rank I send to also sends to me)...
+    qsort(ranks,num_ranks,sizeof(int),qsortInt);
+    int num_neighbors=0;for(n=0;n<num_ranks;n++)if( (n==0) || (ranks[n]!=ranks[n-1]) )num_neighbors++;
+    bytes[MEMORY_BLOCKS ] += block_list_bytes(blocks[0]) + block_list_bytes(blocks[1]) + block_list_bytes(blocks[2]);
+    bytes[MEMORY_BUFFERS] += buffer_bytes + communicator_message_bytes(2*num_neighbors);
+  }
+  free(ids);
+  free(ranks);
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// initialize the portion of one box's vector (dst) that corresponds to block by copying it from src (if not NULL) or zeroing it
+// The kernels thread over my_blocks with schedule(static,1) (see PRAGMA_THREAD_ACROSS_BLOCKS) and thus block b is always operated on by thread b%num_threads.
+// By calling this with the same mapping, each page is first touched (and thus placed on the NUMA node of) the thread that will use it.
+// Blocks on the faces of a box also initialize the adjacent ghost zones and padding so that the union of blocks covers [0,box_volume) exactly once.
+static inline void first_touch_block(level_type *level, blockCopy_type *block, real_t * __restrict__ dst, const real_t * __restrict__ src){
+  const int     dim = level->box_dim;
+  const int  ghosts = level->box_ghosts;
+  const int jStride = level->box_jStride;
+  const int kStride = level->box_kStride;
+  const int  volume = level->box_volume;
+  int ilo = block->read.i;int ihi = ilo+block->dim.i;
+  int jlo = block->read.j;int jhi = jlo+block->dim.j;
+  int klo = block->read.k;int khi = klo+block->dim.k;
+  // extend the block's [lo,hi) to the beginning/end of pencils/planes/volume if it touches a face of the box...
+  int ilo_ofs = (ilo==0) ? 0 : ilo+ghosts;int ihi_ofs = (ihi==dim) ?                     jStride : ihi+ghosts;
+  int jlo_row = (jlo==0) ? 0 : jlo+ghosts;int jhi_row = (jhi==dim) ? (kStride+jStride-1)/jStride : jhi+ghosts;
+  int klo_pln = (klo==0) ? 0 : klo+ghosts;int khi_pln = (khi==dim) ? ( volume+kStride-1)/kStride : khi+ghosts;
+  int i,j,k;
+  for(k=klo_pln;k<khi_pln;k++){
+  for(j=jlo_row;j<jhi_row;j++){
+    int lo = k*kStride + j*jStride + ilo_ofs;
+    int hi = k*kStride + j*jStride + ihi_ofs;
+    if(hi>(k+1)*kStride)hi=(k+1)*kStride; // the last pencil in a padded plane may be partial
+    if(hi>volume       )hi=volume;        // as may the last plane in a padded volume
+    if(src){for(i=lo;i<hi;i++)dst[i]=src[i];}
+       else{for(i=lo;i<hi;i++)dst[i]=0.0;}
+  }}
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// sample the NUMA node of the pages of each block (one page per plane per vector) and compare it to the NUMA node of the thread that operates on that block
+// returns the fraction (across all processes) of sampled pages that are local to the thread that uses them or -1.0 if this can't be determined (e.g. not linux)
+// n.b. unless threads are bound (e.g. OMP_PROC_BIND=true), they may migrate and this is merely a snapshot
+double numa_locality(level_type *level){
+  double local   = 0.0;
+  double sampled = 0.0;
+  #if defined(__linux__) && defined(SYS_move_pages) && defined(SYS_getcpu)
+  int block;
+  #ifdef _OPENMP
+  #pragma omp parallel for if(level->num_my_blocks>1) schedule(static,1) reduction(+:local,sampled)
+  #endif
+  for(block=0;block<level->num_my_blocks;block++){
+    unsigned int cpu,node;
+    void *pages[256];
+    int  status[256];
+    int n=0,p,v,k;
+    if(syscall(SYS_getcpu,&cpu,&node,NULL))continue;
+    box_type *box = &(level->my_boxes[level->my_blocks[block].read.box]);
+    for(v=0;v<level->numVectors;v++){
+    for(k=0;k<level->my_blocks[block].dim.k;k++){
+      pages[n++] = (void*)( box->vectors[v] + box->ghosts*(1+box->jStride+box->kStride) + level->my_blocks[block].read.i
+                                            + level->my_blocks[block].read.j*box->jStride + (level->my_blocks[block].read.k+k)*box->kStride );
+      if( (n==256) || ( (v==level->numVectors-1) && (k==level->my_blocks[block].dim.k-1) ) ){
+        if(syscall(SYS_move_pages,0,(unsigned long)n,pages,NULL,status,0)==0){ // with nodes==NULL, move_pages() merely reports the node of each page
+          for(p=0;p<n;p++)if(status[p]>=0){sampled++;if(status[p]==(int)node)local++;}
+        }
+        n=0;
+      }
+    }}
+  }
+  #endif
+  #ifdef USE_MPI
+  double send[2] = {local,sampled};
+  double recv[2];
+  MPI_Allreduce(send,recv,2,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+  local   = recv[0];
+  sampled = recv[1];
+  #endif
+  if(sampled==0.0)return(-1.0);
+  return(local/sampled);
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// bytes allocated by this process for a communicator's MPI buffers, neighbor lists, and requests (its blocks are counted by measure_level_memory())
+static uint64_t communicator_bytes(communicator_type *comm){
+  uint64_t bytes = comm->buffer_bytes;
+  bytes += communicator_message_bytes(comm->num_sends+comm->num_recvs); // ranks, sizes, buffers, and requests
+  #ifdef USE_MPI
+  if(comm->persistent_requests)bytes += (uint64_t)(comm->num_sends+comm->num_recvs)*sizeof(MPI_Request);
+  if(comm->neighbor_displs    )bytes += (uint64_t)(comm->num_sends+comm->num_recvs)*(sizeof(MPI_Aint)+sizeof(MPI_Datatype));
+  #endif
+  return(bytes);
+}
+
+static uint64_t communicator_block_bytes(communicator_type *comm){
+  return( (uint64_t)(comm->allocated_blocks[0]+comm->allocated_blocks[1]+comm->allocated_blocks[2])*sizeof(blockCopy_type) );
+}
+
+
+// measure the memory this process has allocated for this level in each category (bytes[MEMORY_CATEGORIES]).  Rather than instrumenting
+// malloc, the sizes are recovered from the level's data structures (i.e. allocated, not merely used, lengths) and thus include padding
+// and alignment slack but not the allocator's or MPI's own overheads.
+void measure_level_memory(level_type *level, uint64_t *bytes){
+  int c,shape,r;
+  for(c=0;c<MEMORY_CATEGORIES;c++)bytes[c]=0;
+
+  // FP data...
+  if(level->numVectors>0){
+    #ifdef USE_MPI
+    if(level->shared_vectors!=MPI_WIN_NULL){
+      bytes[MEMORY_VECTORS] += (uint64_t)level->num_my_boxes*(sizeof(uint64_t) + (uint64_t)level->numVectors*level->box_volume*sizeof(real_t) + GHOST_ALIGNMENT); // see create_vectors_shared()
+    }else
+    #endif
+    {
+      #ifdef USE_BVKJI_LAYOUT
+      bytes[MEMORY_VECTORS] += (uint64_t)level->num_my_boxes*( (uint64_t)level->numVectors*level->box_volume*sizeof(real_t) + GHOST_ALIGNMENT );
+      #endif
+      #ifdef USE_VBKJI_LAYOUT
+      bytes[MEMORY_VECTORS] += (uint64_t)level->numVectors*( (uint64_t)level->num_my_boxes*level->box_volume*sizeof(real_t) + GHOST_ALIGNMENT );
+      bytes[MEMORY_VECTORS] += (uint64_t)level->numVectors*2*sizeof(real_t*); // vectors[] and vectors_base[]
+      #endif
+    }
+    bytes[MEMORY_VECTORS] += (uint64_t)(level->num_my_boxes+level->num_shared_boxes)*level->numVectors*sizeof(real_t*); // my_boxes[].vectors
+  }
+
+  // boxes...
+  bytes[MEMORY_BOXES] += (uint64_t)level->boxes_in.i*level->boxes_in.j*level->boxes_in.k*sizeof(int); // rank_of_box
+  bytes[MEMORY_BOXES] += (uint64_t)(level->num_my_boxes+level->num_shared_boxes)*sizeof(box_type);
+  bytes[MEMORY_BOXES] += (uint64_t)level->num_shared_boxes*sizeof(int); // shared_box_rank
+  #ifdef USE_MPI
+  if(level->node_rank)bytes[MEMORY_BOXES] += (uint64_t)level->num_ranks*sizeof(int);
+  #endif
+
+  // blocks...
+  bytes[MEMORY_BLOCKS] += (uint64_t)level->allocated_blocks*sizeof(blockCopy_type);
+  bytes[MEMORY_BLOCKS] += (uint64_t)(level->allocated_overlap_blocks[0]+level->allocated_overlap_blocks[1])*sizeof(blockCopy_type);
+  for(shape=0;shape<STENCIL_MAX_SHAPES;shape++){
+    bytes[MEMORY_BLOCKS] += (uint64_t)level->boundary_condition.allocated_blocks[shape]*sizeof(blockCopy_type);
+    bytes[MEMORY_BLOCKS] += communicator_block_bytes(&level->exchange_ghosts[shape]);
+  }
+  for(r=0;r<4;r++)
+  bytes[MEMORY_BLOCKS] += communicator_block_bytes(&level->restriction[r]);
+  bytes[MEMORY_BLOCKS] += communicator_block_bytes(&level->interpolation);
+
+  // MPI buffers...
+  for(shape=0;shape<STENCIL_MAX_SHAPES;shape++)
+  bytes[MEMORY_BUFFERS] += communicator_bytes(&level->exchange_ghosts[shape]);
+  for(r=0;r<4;r++)
+  bytes[MEMORY_BUFFERS] += communicator_bytes(&level->restriction[r]);
+  bytes[MEMORY_BUFFERS] += communicator_bytes(&level->interpolation);
+
+  // Red/Black masks and flux temporaries...
+  if(level->RedBlack_base)bytes[MEMORY_REDBLACK] += 2*(uint64_t)level->box_kStride*sizeof(real_t)+256;
+  if(level->fluxes       )bytes[MEMORY_FLUXES  ] += 4*(uint64_t)level->num_threads*(BLOCKCOPY_TILE_J+2)*level->box_jStride*sizeof(double);
+  if(level->pair_x       )bytes[MEMORY_FLUXES  ] +=   (uint64_t)level->num_threads*level->box_volume*sizeof(double);
+}
+
+
+// peak resident set size of this process in bytes (0 if unknown)
+uint64_t high_water_mark(void){
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF,&usage))return(0);
+  #ifdef __APPLE__
+  return( (uint64_t)usage.ru_maxrss ); // bytes
+  #else
+  return( (uint64_t)usage.ru_maxrss*1024 ); // kilobytes
+  #endif
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// calculate the size (including padding) of each box and build the list of boxes I own (vectors are allocated by create_vectors())
+static void create_boxes(level_type *level){
+  // calculate the size of each box...
+  calculate_box_strides(level->box_dim,level->box_ghosts,&level->box_jStride,&level->box_kStride,&level->box_volume);
+
+
+  // build the list of boxes...
+  int box=0;
+  int i,j,k;
+  for(k=0;k<level->boxes_in.k;k++){
+  for(j=0;j<level->boxes_in.j;j++){
+  for(i=0;i<level->boxes_in.i;i++){
+    int jStride = level->boxes_in.i;
+    int kStride = level->boxes_in.i*level->boxes_in.j;
+    int b=i + j*jStride + k*kStride;
+    if(level->rank_of_box[b]==level->my_rank){
+      level->my_boxes[box].numVectors = 0;
+      level->my_boxes[box].dim        = level->box_dim;
+      level->my_boxes[box].ghosts     = level->box_ghosts;
+      level->my_boxes[box].jStride    = level->box_jStride;
+      level->my_boxes[box].kStride    = level->box_kStride;
+      level->my_boxes[box].volume     = level->box_volume;
+      level->my_boxes[box].low.i      = i*level->box_dim;
+      level->my_boxes[box].low.j      = j*level->box_dim;
+      level->my_boxes[box].low.k      = k*level->box_dim;
+      level->my_boxes[box].global_box_id = b;
+      box++;
+  }}}}
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// -exchange shm... allocate the vectors (in the [box][vector] layout) from an MPI-3 shared window so other ranks on the node may read them directly.
+// My segment of the window is [offset of each box's vectors[0]][box 0][box 1]...  The offsets are published in the segment itself so that,
+// after a barrier, every rank can bind the vectors[] of its shared boxes (see shared_box()).  Collective over MPI_COMM_NODE.
+#if defined(USE_MPI) && (MPI_VERSION>=3) && defined(USE_BVKJI_LAYOUT)
+static void create_vectors_shared(level_type *level, int numVectors){
+  int old_numVectors = level->numVectors;
+  MPI_Win old_window = level->shared_vectors;
+  int box,v,block,s,b;
+
+  uint64_t box_bytes = (uint64_t)numVectors*level->box_volume*sizeof(real_t) + GHOST_ALIGNMENT;
+  MPI_Aint segment_bytes = level->num_my_boxes*(sizeof(uint64_t)+box_bytes);
+  char *segment = NULL;
+  MPI_Win_allocate_shared(segment_bytes,1,MPI_INFO_NULL,level->MPI_COMM_NODE,&segment,&level->shared_vectors);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK,level->shared_vectors); // passive target epoch for MPI_Win_sync() (see exchange_boundary_begin())
+  uint64_t *offsets = (uint64_t*)segment;
+
+  real_t ** old_vectors0 = (real_t**)malloc(level->num_my_boxes*sizeof(real_t*)); // save pointer to old vector[0] pointer for future copying
+  if((level->num_my_boxes>0)&&(old_vectors0==NULL)){fprintf(stderr,"malloc failed - create_vectors_shared/old_vectors0\n");exit(0);}
+  for(box=0;box<level->num_my_boxes;box++){
+    old_vectors0[box] = (old_numVectors>0) ? level->my_boxes[box].vectors[0] : NULL;
+    real_t * fp_base_aligned = (real_t*)(segment + level->num_my_boxes*sizeof(uint64_t) + box*box_bytes);
+    while( (uint64_t)(fp_base_aligned+level->box_ghosts*(1+level->box_jStride+level->box_kStride)) & (GHOST_ALIGNMENT-1) ){fp_base_aligned++;} // align first *non-ghost* zone element of first component to GHOST_ALIGNMENT bytes
+    offsets[box] = (uint64_t)((char*)fp_base_aligned - segment);
+    level->my_boxes[box].fp_base = NULL; // released with the window
+    level->my_boxes[box].numVectors = numVectors;
+    if(old_numVectors>0)free(level->my_boxes[box].vectors);
+    level->my_boxes[box].vectors = (real_t**)malloc(numVectors*sizeof(real_t*));
+    if(level->my_boxes[box].vectors==NULL){fprintf(stderr,"malloc failed - level->my_boxes[box].vectors\n");exit(0);}
+    for(v=0;v<numVectors;v++){level->my_boxes[box].vectors[v] = fp_base_aligned + (uint64_t)level->box_volume*v;}
+  }
+  // init (copy old vectors if present, zero the rest) with the kernels' block->thread mapping...
+  #ifdef _OPENMP
+  #pragma omp parallel for private(box,v) if(level->num_my_blocks>1) schedule(static,1)
+  #endif
+  for(block=0;block<level->num_my_blocks;block++){
+    box = level->my_blocks[block].read.box;
+    for(v=0;v<numVectors;v++){
+      first_touch_block(level,&level->my_blocks[block],level->my_boxes[box].vectors[v],(v<old_numVectors) ? old_vectors0[box]+(uint64_t)level->box_volume*v : NULL);
+    }
+  }
+  free(old_vectors0);
+  if(old_window!=MPI_WIN_NULL){MPI_Win_unlock_all(old_window);MPI_Win_free(&old_window);}
+
+  // wait for every rank on the node to publish its offsets[] and then bind my shared boxes...
+  MPI_Win_sync(level->shared_vectors);
+  MPI_Barrier(level->MPI_COMM_NODE);
+  MPI_Win_sync(level->shared_vectors);
+  for(s=0;s<level->num_shared_boxes;s++){
+    box_type *shared = &level->my_boxes[level->num_my_boxes+s];
+    int owner = level->shared_box_rank[s];
+    int owner_box=0;for(b=0;b<shared->global_box_id;b++)if(level->rank_of_box[b]==owner)owner_box++; // index of this box in the owner's my_boxes[] (see create_boxes())
+    MPI_Aint owner_bytes;
+    int owner_disp_unit;
+    char *owner_segment;
+    MPI_Win_shared_query(level->shared_vectors,level->node_rank[owner],&owner_bytes,&owner_disp_unit,&owner_segment);
+    real_t *owner_vectors0 = (real_t*)(owner_segment + ((uint64_t*)owner_segment)[owner_box]);
+    if(shared->vectors)free(shared->vectors);
+    shared->vectors = (real_t**)malloc(numVectors*sizeof(real_t*));
+    if(shared->vectors==NULL){fprintf(stderr,"malloc failed - shared box vectors\n");exit(0);}
+    for(v=0;v<numVectors;v++){shared->vectors[v] = owner_vectors0 + (uint64_t)level->box_volume*v;}
+    shared->numVectors = numVectors;
+  }
+  level->arena      = NULL; // the window replaces any arena
+  level->numVectors = numVectors;
+}
+#endif
+
+
 //---------------------------------------------------------------------------------------------------------------------------------------------------
 // create the pointers in level_type to the contiguous vector FP data (useful for bulk copies to/from accelerators)
 // create the pointers in each box to their respective segment of the level's vector FP data (useful for box-relative operators)
@@ -1000,78 +1782,66 @@ void build_exchange_ghosts(level_type *level, int shape){
 void create_vectors(level_type *level, int numVectors){
   int old_numVectors = level->numVectors;
   if(numVectors <= level->numVectors)return; // already have enough space
-
-  // calculate the size of each box...
-  #ifdef USE_MAGIC_PADDING
-  // conceptually rectangular, but physically(in memory) non-rectangular box
-  level->box_jStride =                    (level->box_dim+2*level->box_ghosts);while(level->box_jStride % BOX_ALIGN_JSTRIDE)level->box_jStride++; // pencil
-  level->box_kStride = level->box_jStride*(level->box_dim+2*level->box_ghosts);while(level->box_kStride % BOX_ALIGN_JSTRIDE)level->box_kStride++; // plane alignment
-  while( level->box_kStride      %  512 <   96 )level->box_kStride+=BOX_ALIGN_JSTRIDE; // pad planes to avoid conflicts in the L1 cache.
-                                                                                       // ensures the 5 planes of 4th order stencil hit different sets in a 32KB/8way cache
-  level->box_volume  = level->box_kStride*(level->box_dim+2*level->box_ghosts);while(level->box_volume  % BOX_ALIGN_JSTRIDE)level->box_volume++;  // volume
-  while( level->box_volume       % 1024 != 568 )level->box_volume++; // pad volumes to avoid conflicts in the L2 cache
-                                                                     // %1024==512 ensures volumes map to different L2 sets but the same L1 set
-                                                                     // +56 ensures volumes map to different L1 sets as well
-  #else
-  // default simply pads pencils/planes/volumes (resultant box is rectangular iff BOX_ALIGN_VOLUME==BOX_ALIGN_KSTRIDE==BOX_ALIGN_JSTRIDE)
-  level->box_jStride =                    (level->box_dim+2*level->box_ghosts);while(level->box_jStride % BOX_ALIGN_JSTRIDE)level->box_jStride++; // pencil
-  level->box_kStride = level->box_jStride*(level->box_dim+2*level->box_ghosts);while(level->box_kStride % BOX_ALIGN_KSTRIDE)level->box_kStride++; // plane
-  level->box_volume  = level->box_kStride*(level->box_dim+2*level->box_ghosts);while(level->box_volume  % BOX_ALIGN_VOLUME )level->box_volume++;  // volume
+  #if defined(USE_MPI) && (MPI_VERSION>=3) && defined(USE_BVKJI_LAYOUT)
+  if(level->MPI_COMM_NODE!=MPI_COMM_NULL){create_vectors_shared(level,numVectors);return;}
   #endif
 
+  // vectors are carved from the level's arena (see MGBuild()) if they fit.  Otherwise, they (and any subsequent growth) revert to the heap
+  int box,v,block;
+  int old_in_arena = (level->arena!=NULL) && (old_numVectors>0);
+  if( (level->arena!=NULL) && (arena_available(level->arena) < vectors_arena_bytes(level,numVectors)) )level->arena=NULL;
+  for(box=0;box<level->num_my_boxes;box++){level->my_boxes[box].numVectors = numVectors;}
 
-  int box,v;
-  uint64_t ofs;
-  #define GHOST_ALIGNMENT 512
+  // the first touch of the FP data is performed with the same block->thread mapping as the kernels (see first_touch_block())
+  // Thus, the list of blocks (create_level()) must exist before any vectors are allocated.
 
 
   #ifdef USE_BVKJI_LAYOUT
   // [box][vector][k][j][i] data layout where boxes (including all vectors) are individually allocated
+  real_t ** old_fp_base  = (real_t**)malloc(level->num_my_boxes*sizeof(real_t*));
+  real_t ** old_vectors0 = (real_t**)malloc(level->num_my_boxes*sizeof(real_t*)); // save pointer to old vector[0] pointer for future copying
+  if((level->num_my_boxes>0)&&((old_fp_base==NULL)||(old_vectors0==NULL))){fprintf(stderr,"malloc failed - create_vectors/old_fp_base\n");exit(0);}
   for(box=0;box<level->num_my_boxes;box++){
     // save old pointer to FP data...
-    double * old_fp_base = level->my_boxes[box].fp_base;
+    old_fp_base[box]  = (old_numVectors>0) ? level->my_boxes[box].fp_base : NULL;
+    old_vectors0[box] = (old_numVectors>0) ? level->my_boxes[box].vectors[0] : NULL;
     // allocate 4D FP array...
-    uint64_t malloc_size = (uint64_t)numVectors*level->box_volume*sizeof(double) + GHOST_ALIGNMENT;
-    level->my_boxes[box].fp_base = (double*)malloc(malloc_size);
-    //posix_memalign((void**)&(level->my_boxes[box].fp_base),1<<21,malloc_size); // 2MB aligned allocation
+    uint64_t malloc_size = (uint64_t)numVectors*level->box_volume*sizeof(real_t) + GHOST_ALIGNMENT;
+    level->my_boxes[box].fp_base = (real_t*)( (level->arena!=NULL) ? arena_alloc(level->arena,malloc_size) : malloc_fp(malloc_size) );
     if((numVectors>0)&&(level->my_boxes[box].fp_base==NULL)){fprintf(stderr,"malloc failed - level->my_boxes[box].fp_base\n");exit(0);}
-    double * fp_base_aligned = level->my_boxes[box].fp_base;
+    real_t * fp_base_aligned = level->my_boxes[box].fp_base;
     while( (uint64_t)(fp_base_aligned+level->box_ghosts*(1+level->box_jStride+level->box_kStride)) & (GHOST_ALIGNMENT-1) ){fp_base_aligned++;} // align first *non-ghost* zone element of first component to GHOST_ALIGNMENT bytes
-    // init ...
-    #ifdef _OPENMP
-    #pragma omp parallel for
-    #endif
-    for(ofs=0;ofs<(uint64_t)numVectors*level->box_volume;ofs++){level->my_boxes[box].fp_base[ofs]=0.0;} // FIX... NOT NUMA-aware !!!
     // setup vectors...
-    double * old_vectors0; // save pointer to old vector[0] pointer for future copying
-    if(old_numVectors>0){
-      old_vectors0 = level->my_boxes[box].vectors[0]; // save pointer to old vector[0] pointer for future copying
-      free(level->my_boxes[box].vectors); // free previously allocated vector array
-    }
-    level->my_boxes[box].vectors = (double **)malloc(numVectors*sizeof(double*)); // allocate
+    if((old_numVectors>0)&&(!old_in_arena))free(level->my_boxes[box].vectors); // free previously allocated vector array
+    level->my_boxes[box].vectors = (real_t **)( (level->arena!=NULL) ? arena_alloc(level->arena,numVectors*sizeof(real_t*)) : malloc(numVectors*sizeof(real_t*)) ); // allocate
     if((old_numVectors>0)&&(level->my_boxes[box].vectors==NULL)){fprintf(stderr,"malloc failed - level->my_boxes[box].vectors\n");exit(0);}
     for(v=0;v<numVectors;v++){level->my_boxes[box].vectors[v] = fp_base_aligned + (uint64_t)level->box_volume*v;} // setup vector pointers
-    // copy old vectors (if present) ...
-    if(old_numVectors>0){ 
-      #ifdef _OPENMP
-      #pragma omp parallel for
-      #endif
-      for(ofs=0;ofs<(uint64_t)old_numVectors*level->box_volume;ofs++){level->my_boxes[box].vectors[0][ofs] = old_vectors0[ofs];} // FIX... NOT NUMA-aware !!!
-      if(old_fp_base)free(old_fp_base); // free old FP data
+  }
+  // init (copy old vectors if present, zero the rest) with the kernels' block->thread mapping...
+  #ifdef _OPENMP
+  #pragma omp parallel for private(v) if(level->num_my_blocks>1) schedule(static,1)
+  #endif
+  for(block=0;block<level->num_my_blocks;block++){
+    box = level->my_blocks[block].read.box;
+    for(v=0;v<numVectors;v++){
+      first_touch_block(level,&level->my_blocks[block],level->my_boxes[box].vectors[v],(v<old_numVectors) ? old_vectors0[box]+(uint64_t)level->box_volume*v : NULL);
     }
   }
+  if(!old_in_arena)for(box=0;box<level->num_my_boxes;box++){if(old_fp_base[box])free(old_fp_base[box]);} // free old FP data
+  free(old_fp_base);
+  free(old_vectors0);
   #endif
 
 
   #ifdef USE_VBKJI_LAYOUT
   // [vector][box][k][j][i] data layout where vectors (across all boxes) are individually allocated
-  double ** old_vectors      = level->vectors;
-  double ** old_vectors_base = level->vectors_base;
+  real_t ** old_vectors      = level->vectors;
+  real_t ** old_vectors_base = level->vectors_base;
   if(numVectors > old_numVectors){
     // allocate an array of pointers which point to the union of boxes for each vector
     // NOTE, this requires just one copyin per vector to an accelerator rather than requiring one copyin per box per vector
-    level->vectors      = (double **)malloc(numVectors*sizeof(double*));
-    level->vectors_base = (double **)malloc(numVectors*sizeof(double*));
+    level->vectors      = (real_t **)malloc(numVectors*sizeof(real_t*));
+    level->vectors_base = (real_t **)malloc(numVectors*sizeof(real_t*));
   }
   for(v=0;v<numVectors;v++){
     if(v<old_numVectors){
@@ -1080,24 +1850,27 @@ void create_vectors(level_type *level, int numVectors){
       level->vectors[v]      = old_vectors[v];
     }else{
       // allocate
-      uint64_t malloc_size = (uint64_t)level->num_my_boxes*level->box_volume*sizeof(double) + GHOST_ALIGNMENT;
-      level->vectors_base[v] = (double*)malloc(malloc_size);
-      //posix_memalign((void**)&(level->vectors_base[v]),1<<21,malloc_size); // 2MB aligned allocation
+      uint64_t malloc_size = (uint64_t)level->num_my_boxes*level->box_volume*sizeof(real_t) + GHOST_ALIGNMENT;
+      level->vectors_base[v] = (real_t*)( (level->arena!=NULL) ? arena_alloc(level->arena,malloc_size) : malloc_fp(malloc_size) );
       if((numVectors>0)&&(level->vectors_base[v]==NULL)){fprintf(stderr,"malloc failed - level->vectors_base[v]\n");exit(0);}
-      double * fp_base_aligned = level->vectors_base[v];
+      real_t * fp_base_aligned = level->vectors_base[v];
       while( (uint64_t)(fp_base_aligned+level->box_ghosts*(1+level->box_jStride+level->box_kStride)) & (GHOST_ALIGNMENT-1) ){fp_base_aligned++;} // align first *non-ghost* zone element of first component to GHOST_ALIGNMENT bytes
       level->vectors[v] = fp_base_aligned;
-      // init
-      #ifdef _OPENMP
-      #pragma omp parallel for
-      #endif
-      for(ofs=0;ofs<(uint64_t)level->num_my_boxes*level->box_volume;ofs++){level->vectors_base[v][ofs]=0.0;} // FIX... NOT NUMA-aware !!!
+    }
+  }
+  // init new vectors with the kernels' block->thread mapping...
+  #ifdef _OPENMP
+  #pragma omp parallel for private(v) if(level->num_my_blocks>1) schedule(static,1)
+  #endif
+  for(block=0;block<level->num_my_blocks;block++){
+    for(v=old_numVectors;v<numVectors;v++){
+      first_touch_block(level,&level->my_blocks[block],level->vectors[v] + (uint64_t)level->box_volume*level->my_blocks[block].read.box,NULL);
     }
   }
   // setup vector pointers for each box...
   for(box=0;box<level->num_my_boxes;box++){ // setup pointer to vector v for all boxes
-    if(old_numVectors>0)free(level->my_boxes[box].vectors); // free previously allocated vector array
-    level->my_boxes[box].vectors = (double **)malloc(numVectors*sizeof(double*)); // allocate
+    if((old_numVectors>0)&&(!old_in_arena))free(level->my_boxes[box].vectors); // free previously allocated vector array
+    level->my_boxes[box].vectors = (real_t **)( (level->arena!=NULL) ? arena_alloc(level->arena,numVectors*sizeof(real_t*)) : malloc(numVectors*sizeof(real_t*)) ); // allocate
     if((old_numVectors>0)&&(level->my_boxes[box].vectors==NULL)){fprintf(stderr,"malloc failed - level->my_boxes[box].vectors\n");exit(0);}
     for(v=0;v<numVectors;v++){level->my_boxes[box].vectors[v] = level->vectors[v] + (uint64_t)level->box_volume*box;} // setup pointer to vector v
   }
@@ -1108,46 +1881,128 @@ void create_vectors(level_type *level, int numVectors){
   #endif
 
 
-  // build the list of boxes...
-  box=0;
-  int i,j,k;
-  for(k=0;k<level->boxes_in.k;k++){
-  for(j=0;j<level->boxes_in.j;j++){
-  for(i=0;i<level->boxes_in.i;i++){
-    int jStride = level->boxes_in.i;
-    int kStride = level->boxes_in.i*level->boxes_in.j;
-    int b=i + j*jStride + k*kStride;
-    if(level->rank_of_box[b]==level->my_rank){
-      level->my_boxes[box].numVectors = numVectors;
-      level->my_boxes[box].dim        = level->box_dim;
-      level->my_boxes[box].ghosts     = level->box_ghosts;
-      level->my_boxes[box].jStride    = level->box_jStride;
-      level->my_boxes[box].kStride    = level->box_kStride;
-      level->my_boxes[box].volume     = level->box_volume;
-      level->my_boxes[box].low.i      = i*level->box_dim;
-      level->my_boxes[box].low.j      = j*level->box_dim;
-      level->my_boxes[box].low.k      = k*level->box_dim;
-      level->my_boxes[box].global_box_id = b;
-      box++;
-  }}}}
-
   // level now has created/initialized vector FP data
   level->numVectors = numVectors;
 }
 
 
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// append a region of box to overlap_blocks[list] using the level's blocking
+static void append_overlap_region(level_type *level, int list, int box, int i, int j, int k, int dim_i, int dim_j, int dim_k){
+  if( (dim_i<=0) || (dim_j<=0) || (dim_k<=0) )return;
+  append_block_to_list(&(level->overlap_blocks[list]),&(level->allocated_overlap_blocks[list]),&(level->num_overlap_blocks[list]),
+    /* dim.i         = */ dim_i,
+    /* dim.j         = */ dim_j,
+    /* dim.k         = */ dim_k,
+    /* read.box      = */ box,
+    /* read.ptr      = */ NULL,
+    /* read.i        = */ i,
+    /* read.j        = */ j,
+    /* read.k        = */ k,
+    /* read.jStride  = */ level->my_boxes[box].jStride,
+    /* read.kStride  = */ level->my_boxes[box].kStride,
+    /* read.scale    = */ 1,
+    /* write.box     = */ box,
+    /* write.ptr     = */ NULL,
+    /* write.i       = */ i,
+    /* write.j       = */ j,
+    /* write.k       = */ k,
+    /* write.jStride = */ level->my_boxes[box].jStride,
+    /* write.kStride = */ level->my_boxes[box].kStride,
+    /* write.scale   = */ 1,
+    /* blockcopy_i   = */ level->blocking.i,
+    /* blockcopy_j   = */ level->blocking.j,
+    /* blockcopy_k   = */ level->blocking.k,
+    /* subtype       = */ 0  
+  );
+}
+
+
+// split each box into an interior (cells at least box_ghosts from the box's faces and thus independent of the ghost zones) and a shell.
+// Boxes on the domain boundary (non-periodic) are placed entirely in the shell list as their BC's read (and in-place smoothers would overwrite) interior cells.
+static void build_overlap_blocks(level_type *level){
+  int box;
+  const int g = level->box_ghosts;
+  level->num_overlap_blocks[0] = 0;
+  level->num_overlap_blocks[1] = 0;
+  for(box=0;box<level->num_my_boxes;box++){
+    const int d = level->my_boxes[box].dim;
+    int onBoundary = 0;
+    if(level->boundary_condition.type != BC_PERIODIC){
+      if( (level->my_boxes[box].low.i==0) || (level->my_boxes[box].low.i+d==level->dim.i) )onBoundary=1;
+      if( (level->my_boxes[box].low.j==0) || (level->my_boxes[box].low.j+d==level->dim.j) )onBoundary=1;
+      if( (level->my_boxes[box].low.k==0) || (level->my_boxes[box].low.k+d==level->dim.k) )onBoundary=1;
+    }
+    if( onBoundary || (d<=2*g) ){
+      append_overlap_region(level,1,box,  0,  0,  0,    d,    d,    d);
+    }else{
+      append_overlap_region(level,0,box,  g,  g,  g,d-2*g,d-2*g,d-2*g); // interior
+      append_overlap_region(level,1,box,  0,  0,  0,    d,    d,    g); // k-low  slab
+      append_overlap_region(level,1,box,  0,  0,d-g,    d,    d,    g); // k-high slab
+      append_overlap_region(level,1,box,  0,  0,  g,    d,    g,d-2*g); // j-low  slab
+      append_overlap_region(level,1,box,  0,d-g,  g,    d,    g,d-2*g); // j-high slab
+      append_overlap_region(level,1,box,  0,  g,  g,    g,d-2*g,d-2*g); // i-low  slab
+      append_overlap_region(level,1,box,d-g,  g,  g,    g,d-2*g,d-2*g); // i-high slab
+    }
+  }
+}
+
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------
+// (re)build the list of blocks (tiles) this level's kernels thread over by decomposing each of my_boxes into tile_i x tile_j x tile_k tiles (and the overlap lists)
+// the existing allocation is reused so this may be called again (e.g. by an autotuner) to change the blocking of a level
+void build_my_blocks(level_type *level, int tile_i, int tile_j, int tile_k){
+  int box;
+  level->num_my_blocks = 0;
+  level->blocking.i    = tile_i;
+  level->blocking.j    = tile_j;
+  level->blocking.k    = tile_k;
+  for(box=0;box<level->num_my_boxes;box++){
+    append_block_to_list(&(level->my_blocks),&(level->allocated_blocks),&(level->num_my_blocks),
+      /* dim.i         = */ level->my_boxes[box].dim,
+      /* dim.j         = */ level->my_boxes[box].dim,
+      /* dim.k         = */ level->my_boxes[box].dim,
+      /* read.box      = */ box,
+      /* read.ptr      = */ NULL,
+      /* read.i        = */ 0,
+      /* read.j        = */ 0,
+      /* read.k        = */ 0,
+      /* read.jStride  = */ level->my_boxes[box].jStride,
+      /* read.kStride  = */ level->my_boxes[box].kStride,
+      /* read.scale    = */ 1,
+      /* write.box     = */ box,
+      /* write.ptr     = */ NULL,
+      /* write.i       = */ 0,
+      /* write.j       = */ 0,
+      /* write.k       = */ 0,
+      /* write.jStride = */ level->my_boxes[box].jStride,
+      /* write.kStride = */ level->my_boxes[box].kStride,
+      /* write.scale   = */ 1,
+      /* blockcopy_i   = */ tile_i,
+      /* blockcopy_j   = */ tile_j,
+      /* blockcopy_k   = */ tile_k,
+      /* subtype       = */ 0  
+    );
+  }
+
+  build_overlap_blocks(level);
+}
+
+
 //---------------------------------------------------------------------------------------------------------------------------------------------------
 // create a level by populating the basic data structure, distribute boxes within the level among processes, allocate memory, and create any auxilliaries
 // box_ghosts must be >= stencil_get_radius()
 // numVectors represents an estimate of the number of vectors needed in this level.  Additional vectors can be added via subsequent calls to create_vectors()
-void create_level(level_type *level, int boxes_in_i, int box_dim, int box_ghosts, int numVectors, int domain_boundary_condition, int my_rank, int num_ranks){
+void create_level(level_type *level, int boxes_in_i, int boxes_in_j, int boxes_in_k, int box_dim, int box_ghosts, int numVectors, int domain_boundary_condition, int my_rank, int num_ranks){
   int box;
-  int TotalBoxes = boxes_in_i*boxes_in_i*boxes_in_i;
+  int TotalBoxes = boxes_in_i*boxes_in_j*boxes_in_k;
 
   if(my_rank==0){
   //if(domain_boundary_condition==BC_DIRICHLET)fprintf(stdout,"\nattempting to create a %d^3 level (with Dirichlet BC) using a %d^3 grid of %d^3 boxes and %d tasks...\n",box_dim*boxes_in_i,boxes_in_i,box_dim,num_ranks);
   //if(domain_boundary_condition==BC_PERIODIC )fprintf(stdout,"\nattempting to create a %d^3 level (with Periodic BC) using a %d^3 grid of %d^3 boxes and %d tasks...\n", box_dim*boxes_in_i,boxes_in_i,box_dim,num_ranks);
+    if( (boxes_in_i==boxes_in_j) && (boxes_in_i==boxes_in_k) )
                                                fprintf(stdout,"\nattempting to create a %d^3 level from %d x %d^3 boxes distributed among %d tasks...\n", box_dim*boxes_in_i,TotalBoxes,box_dim,num_ranks);
+    else                                       fprintf(stdout,"\nattempting to create a %dx%dx%d level from %d x %d^3 boxes distributed among %d tasks...\n", box_dim*boxes_in_i,box_dim*boxes_in_j,box_dim*boxes_in_k,TotalBoxes,box_dim,num_ranks);
     if(domain_boundary_condition==BC_DIRICHLET)fprintf(stdout,"  boundary condition = BC_DIRICHLET\n");
     if(domain_boundary_condition==BC_PERIODIC )fprintf(stdout,"  boundary condition = BC_PERIODIC\n");
     
@@ -1178,8 +2033,8 @@ void create_level(level_type *level, int boxes_in_i, int box_dim, int box_ghosts
   level->vectors        = NULL; // pointers to individual vectors
   #endif
   level->boxes_in.i     = boxes_in_i;
-  level->boxes_in.j     = boxes_in_i;
-  level->boxes_in.k     = boxes_in_i;
+  level->boxes_in.j     = boxes_in_j;
+  level->boxes_in.k     = boxes_in_k;
   level->dim.i          = box_dim*level->boxes_in.i;
   level->dim.j          = box_dim*level->boxes_in.j;
   level->dim.k          = box_dim*level->boxes_in.k;
@@ -1192,43 +2047,39 @@ void create_level(level_type *level, int boxes_in_i, int box_dim, int box_ghosts
   level->my_blocks        = NULL;
   level->num_my_blocks    = 0;
   level->allocated_blocks = 0;
+  level->overlap_blocks[0] = NULL;
+  level->overlap_blocks[1] = NULL;
+  level->num_overlap_blocks[0] = 0;
+  level->num_overlap_blocks[1] = 0;
+  level->allocated_overlap_blocks[0] = 0;
+  level->allocated_overlap_blocks[1] = 0;
+  level->interpolation_coarse_box = NULL;
   level->tag              = log2(level->dim.i);
+  level->num_shared_boxes = 0;
+  level->shared_box_rank  = NULL;
+  #ifdef USE_MPI
+  level->MPI_COMM_NODE    = MPI_COMM_NULL;
+  level->node_rank        = NULL;
+  level->shared_vectors   = MPI_WIN_NULL;
+  level->shared_epochs    = MPI_WIN_NULL;
+  level->node_epochs      = NULL;
+  #endif
   level->fluxes           = NULL;
+  level->pair_x           = NULL;
+  memset(level->memory,0,sizeof(level->memory));
+  memset(level->counters,0,sizeof(level->counters));
+  level->smoother         = default_smoother;
+  level->op_kernels       = default_op_kernels;
+  level->bottom_solver    = default_bottom_solver;
 
 
   // allocate 3D array of integers to hold the MPI rank of the corresponding box and initialize to -1 (unassigned)
      level->rank_of_box = (int*)malloc(level->boxes_in.i*level->boxes_in.j*level->boxes_in.k*sizeof(int));
   if(level->rank_of_box==NULL){fprintf(stderr,"malloc of level->rank_of_box failed\n");exit(0);}
-  for(box=0;box<level->boxes_in.i*level->boxes_in.j*level->boxes_in.k;box++){level->rank_of_box[box]=-1;}  // -1 denotes that there is no actual box assigned to this region
 
 
   // parallelize the level (i.e. assign a process rank to each box)...
-  #ifdef DECOMPOSE_LEX
-  // lexicographical ordering... good load balance, potentially high bisection bandwidth requirements, bad surface:volume ratio when #boxes/proc is large
-  if(my_rank==0){fprintf(stdout,"  Decomposing level via lexicographical ordering... ");fflush(stdout);}
-  decompose_level_lex(level->rank_of_box,level->boxes_in.i,level->boxes_in.j,level->boxes_in.k,num_ranks);
-  #elif DECOMPOSE_BISECTION_SPECIAL
-  // recursive partitioning by primes
-  if(my_rank==0){fprintf(stdout,"  Decomposing level via partitioning by primes... ");fflush(stdout);}
-  decompose_level_bisection_special(level->rank_of_box,level->boxes_in.i,level->boxes_in.i*level->boxes_in.j,0,0,0,level->boxes_in.i,level->boxes_in.j,level->boxes_in.k,0,num_ranks);
-  #elif DECOMPOSE_BISECTION
-  // recursive bisection
-  if(my_rank==0){fprintf(stdout,"  Decomposing level via recursive bisection... ");fflush(stdout);}
-  decompose_level_bisection(level->rank_of_box,level->boxes_in.i,level->boxes_in.i*level->boxes_in.j,0,0,0,level->boxes_in.i,level->boxes_in.j,level->boxes_in.k,num_ranks,0,level->boxes_in.i*level->boxes_in.j*level->boxes_in.k);
-  #else//#elif DECOMPOSE_ZMORT
-  if(my_rank==0){fprintf(stdout,"  Decomposing level via Z-mort ordering... ");fflush(stdout);}
-  #if 0 // Z-Mort over a power of two bounding box skipping boxes outside the domain
-  int idim_padded=1;while(idim_padded<level->boxes_in.i)idim_padded*=2;
-  int jdim_padded=1;while(jdim_padded<level->boxes_in.j)jdim_padded*=2;
-  int kdim_padded=1;while(kdim_padded<level->boxes_in.k)kdim_padded*=2;
-  #else // Z-Mort over the valid domain wtih odd-sized base cases (i.e. zmort on 3x3)
-  int idim_padded=level->boxes_in.i;
-  int jdim_padded=level->boxes_in.j;
-  int kdim_padded=level->boxes_in.k;
-  #endif
-  decompose_level_zmort(level->rank_of_box,level->boxes_in.i,level->boxes_in.j,level->boxes_in.k,0,0,0,idim_padded,jdim_padded,kdim_padded,num_ranks,0,level->boxes_in.i*level->boxes_in.j*level->boxes_in.k);
-  #endif
-  if(my_rank==0){fprintf(stdout,"done\n");fflush(stdout);}
+  decompose_level(level->rank_of_box,level->boxes_in.i,level->boxes_in.j,level->boxes_in.k,num_ranks,(my_rank==0));
 //print_decomposition(level);// for debug purposes only
 
 
@@ -1239,39 +2090,68 @@ void create_level(level_type *level, int boxes_in_i, int box_dim, int box_ghosts
   if((level->num_my_boxes>0)&&(level->my_boxes==NULL)){fprintf(stderr,"malloc failed - create_level/level->my_boxes\n");exit(0);}
 
 
-  // allocate flattened vector FP data and create pointers...
-  if(my_rank==0){fprintf(stdout,"  Allocating vectors... ");fflush(stdout);}
-  create_vectors(level,numVectors);
-  if(my_rank==0){fprintf(stdout,"done\n");fflush(stdout);}
+  // calculate the size of each box and build the list of boxes I own...
+  create_boxes(level);
 
 
   // Build and auxilarlly data structure that flattens boxes into blocks...
-  for(box=0;box<level->num_my_boxes;box++){
-    append_block_to_list(&(level->my_blocks),&(level->allocated_blocks),&(level->num_my_blocks),
-      /* dim.i         = */ level->my_boxes[box].dim,
-      /* dim.j         = */ level->my_boxes[box].dim,
-      /* dim.k         = */ level->my_boxes[box].dim,
-      /* read.box      = */ box,
-      /* read.ptr      = */ NULL,
-      /* read.i        = */ 0,
-      /* read.j        = */ 0,
-      /* read.k        = */ 0,
-      /* read.jStride  = */ level->my_boxes[box].jStride,
-      /* read.kStride  = */ level->my_boxes[box].kStride,
-      /* read.scale    = */ 1,
-      /* write.box     = */ box,
-      /* write.ptr     = */ NULL,
-      /* write.i       = */ 0,
-      /* write.j       = */ 0,
-      /* write.k       = */ 0,
-      /* write.jStride = */ level->my_boxes[box].jStride,
-      /* write.kStride = */ level->my_boxes[box].kStride,
-      /* write.scale   = */ 1,
-      /* blockcopy_i   = */ BLOCKCOPY_TILE_I,
-      /* blockcopy_j   = */ BLOCKCOPY_TILE_J,
-      /* blockcopy_k   = */ BLOCKCOPY_TILE_K,
-      /* subtype       = */ 0  
-    );
+  build_my_blocks(level,BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K);
+
+
+  // -exchange shm... find the ranks on my node (their boxes are mapped as shared boxes by build_exchange_ghosts())
+  #if defined(USE_MPI) && (MPI_VERSION>=3)
+  if(exchange_method==EXCHANGE_SHM){
+    MPI_Comm_split_type(MPI_COMM_WORLD,MPI_COMM_TYPE_SHARED,my_rank,MPI_INFO_NULL,&level->MPI_COMM_NODE);
+    int r,*ranks = (int*)malloc(num_ranks*sizeof(int));
+    level->node_rank = (int*)malloc(num_ranks*sizeof(int));
+    if( (ranks==NULL) || (level->node_rank==NULL) ){fprintf(stderr,"malloc failed - create_level/node_rank\n");exit(0);}
+    for(r=0;r<num_ranks;r++)ranks[r]=r;
+    MPI_Group world_group,node_group;
+    MPI_Comm_group(MPI_COMM_WORLD,&world_group);
+    MPI_Comm_group(level->MPI_COMM_NODE,&node_group);
+    MPI_Group_translate_ranks(world_group,num_ranks,ranks,node_group,level->node_rank);
+    MPI_Group_free(&node_group);
+    MPI_Group_free(&world_group);
+    free(ranks);
+
+    // ... and allocate the epochs through which neighboring ranks synchronize the direct copies (see shm_sync())
+    int node_size;
+    MPI_Comm_size(level->MPI_COMM_NODE,&node_size);
+    char *epochs = NULL;
+    MPI_Win_allocate_shared(SHM_EPOCHS_BYTES,1,MPI_INFO_NULL,level->MPI_COMM_NODE,&epochs,&level->shared_epochs);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK,level->shared_epochs); // passive target epoch for MPI_Win_sync()
+    memset(epochs,0,SHM_EPOCHS_BYTES);
+    level->node_epochs = (volatile uint64_t**)malloc(node_size*sizeof(uint64_t*));
+    if(level->node_epochs==NULL){fprintf(stderr,"malloc failed - create_level/node_epochs\n");exit(0);}
+    for(r=0;r<node_size;r++){
+      MPI_Aint r_bytes;
+      int r_disp_unit;
+      char *r_epochs;
+      MPI_Win_shared_query(level->shared_epochs,r,&r_bytes,&r_disp_unit,&r_epochs);
+      level->node_epochs[r] = (volatile uint64_t*)r_epochs;
+    }
+    MPI_Win_sync(level->shared_epochs);
+    MPI_Barrier(level->MPI_COMM_NODE); // every rank has zeroed its epochs
+    MPI_Win_sync(level->shared_epochs);
+  }
+  #endif
+
+
+  // create mini program for each stencil shape to perform a ghost zone exchange...
+  // n.b. before the vectors are allocated so that -exchange shm knows which boxes of other ranks to map (see create_vectors_shared())
+  int shape;
+  for(shape=0;shape<STENCIL_MAX_SHAPES;shape++)build_exchange_ghosts(    level,shape);
+
+
+  // allocate flattened vector FP data and create pointers...
+  // n.b. if numVectors==0, allocation is deferred (e.g. MGBuild() allocates the vectors of all coarse levels from one arena)
+  level->arena = NULL;
+  if(numVectors>0){
+    if(my_rank==0){fprintf(stdout,"  Allocating vectors... ");fflush(stdout);}
+    create_vectors(level,numVectors);
+    if(my_rank==0){fprintf(stdout,"done\n");fflush(stdout);}
+    double locality = numa_locality(level);
+    if((my_rank==0)&&(locality>=0.0)){fprintf(stdout,"  NUMA locality... %5.1f%% of pages are on the node of the thread that owns them\n",100.0*locality);fflush(stdout);}
   }
 
 
@@ -1282,7 +2162,7 @@ void create_level(level_type *level, int boxes_in_i, int box_dim, int box_ghosts
     int i,j;
     int kStride = level->my_boxes[0].kStride;
     int jStride = level->my_boxes[0].jStride;
-    level->RedBlack_base = (double*)malloc(2*kStride*sizeof(double)+256); // used for free()
+    level->RedBlack_base = (real_t*)malloc(2*kStride*sizeof(real_t)+256); // used for free()
     level->RedBlack_FP   = level->RedBlack_base; // aligned version
     // align first *non-ghost* zone element to a 64-Byte boundary...
     while( (uint64_t)(level->RedBlack_FP + level->box_ghosts*(1+level->box_jStride)) & 0x3f ){level->RedBlack_FP++;}
@@ -1306,9 +2186,6 @@ void create_level(level_type *level, int boxes_in_i, int box_dim, int box_ghosts
   }
 
 
-  int shape;
-  // create mini program for each stencil shape to perform a ghost zone exchange...
-  for(shape=0;shape<STENCIL_MAX_SHAPES;shape++)build_exchange_ghosts(    level,shape);
   // create mini program for each stencil shape to perform a boundary condition...
   for(shape=0;shape<STENCIL_MAX_SHAPES;shape++)build_boundary_conditions(level,shape);
 
@@ -1370,6 +2247,7 @@ void reset_level_timers(level_type *level){
   level->timers.ghostZone_wait          = 0;
   level->timers.collectives             = 0;
   level->timers.Total                   = 0;
+  memset(level->counters,0,sizeof(level->counters));
   // solver events information...
   level->Krylov_iterations              = 0;
   level->CAKrylov_formations_of_G       = 0;
@@ -1381,22 +2259,46 @@ void reset_level_timers(level_type *level){
 // n.b. in some cases a malloc was used as the basis for an array of pointers.  As such free(x[0])
 void destroy_level(level_type *level){
   int i,j;
-  if(level->my_rank==0){fprintf(stdout,"attempting to free the %5d^3 level... ",level->dim.i);fflush(stdout);}
+  if(level->my_rank==0){
+    if( (level->dim.i==level->dim.j) && (level->dim.i==level->dim.k) )fprintf(stdout,"attempting to free the %5d^3 level... ",level->dim.i);
+    else                                                              fprintf(stdout,"attempting to free the %dx%dx%d level... ",level->dim.i,level->dim.j,level->dim.k);
+    fflush(stdout);
+  }
 
-  // box ...
+  // box ... (vectors carved from an arena are released with the arena)
+  if(level->arena==NULL){
   for(i=0;i<level->num_my_boxes;i++)if(level->my_boxes[i].vectors)free(level->my_boxes[i].vectors);
   #ifdef USE_BVKJI_LAYOUT
   for(i=0;i<level->num_my_boxes;i++)if(level->my_boxes[i].fp_base)free(level->my_boxes[i].fp_base);
   #endif
+  }
+
+  // shared boxes (their FP data belongs to other ranks) and the shared window...
+  for(i=0;i<level->num_shared_boxes;i++)if(level->my_boxes[level->num_my_boxes+i].vectors)free(level->my_boxes[level->num_my_boxes+i].vectors);
+  if(level->shared_box_rank)free(level->shared_box_rank);
+  #if defined(USE_MPI) && (MPI_VERSION>=3)
+  if(level->shared_vectors!=MPI_WIN_NULL){MPI_Win_unlock_all(level->shared_vectors);MPI_Win_free(&level->shared_vectors);}
+  if(level->shared_epochs !=MPI_WIN_NULL){MPI_Win_unlock_all(level->shared_epochs );MPI_Win_free(&level->shared_epochs );}
+  if(level->node_epochs)free((void*)level->node_epochs);
+  #endif
+  #ifdef USE_MPI
+  if(level->MPI_COMM_NODE !=MPI_COMM_NULL)MPI_Comm_free(&level->MPI_COMM_NODE);
+  if(level->node_rank)free(level->node_rank);
+  #endif
 
   // misc ...
   if(level->rank_of_box )free(level->rank_of_box);
   if(level->my_boxes    )free(level->my_boxes);
   if(level->my_blocks   )free(level->my_blocks);
+  if(level->overlap_blocks[0])free(level->overlap_blocks[0]);
+  if(level->overlap_blocks[1])free(level->overlap_blocks[1]);
+  if(level->interpolation_coarse_box)free(level->interpolation_coarse_box);
+  if(level->pair_x)free(level->pair_x);
   if(level->RedBlack_base)free(level->RedBlack_base);
 
   // FP vector data...
   #ifdef USE_VBKJI_LAYOUT
+  if(level->arena==NULL)
   for(i=0;i<level->numVectors;i++)if(level->vectors_base[i])free(level->vectors_base[i]);
                                   if(level->vectors_base   )free(level->vectors_base   );
                                   if(level->vectors        )free(level->vectors        );
@@ -1427,6 +2329,14 @@ void destroy_level(level_type *level){
     #ifdef USE_MPI
     if(level->exchange_ghosts[i].requests    )free(level->exchange_ghosts[i].requests    );
     if(level->exchange_ghosts[i].status      )free(level->exchange_ghosts[i].status      );
+    if(level->exchange_ghosts[i].persistent_requests){
+      for(j=0;j<level->exchange_ghosts[i].num_recvs+level->exchange_ghosts[i].num_sends;j++)MPI_Request_free(&level->exchange_ghosts[i].persistent_requests[j]);
+      free(level->exchange_ghosts[i].persistent_requests);
+    }
+    if(level->exchange_ghosts[i].neighbor_comm!=MPI_COMM_NULL)MPI_Comm_free(&level->exchange_ghosts[i].neighbor_comm);
+    if(level->exchange_ghosts[i].shared_ranks   )free(level->exchange_ghosts[i].shared_ranks   );
+    if(level->exchange_ghosts[i].neighbor_displs)free(level->exchange_ghosts[i].neighbor_displs);
+    if(level->exchange_ghosts[i].neighbor_types )free(level->exchange_ghosts[i].neighbor_types );
     #endif
   }
 
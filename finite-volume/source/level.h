@@ -57,11 +57,58 @@
 #if !defined(USE_BVKJI_LAYOUT) && !defined(USE_VBKJI_LAYOUT)
 #error You must specify either USE_BVKJI_LAYOUT or USE_VBKJI_LAYOUT
 #endif
+//------------------------------------------------------------------------------------------------------------------------------
+// precision in which vectors (and MPI buffers) are stored.  Regardless, kernels calculate in double precision.
+// -DUSE_MIXED_PRECISION stores vectors in single precision (halving memory and MPI traffic) and MGSolve uses iterative refinement
+// (see MGSolve()) to attain a double precision solution.
+#ifdef USE_MIXED_PRECISION
+typedef float  real_t;
+#define MPI_REAL_T MPI_FLOAT
+#else
+typedef double real_t;
+#define MPI_REAL_T MPI_DOUBLE
+#endif
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+typedef struct {
+  char   *              base;	// first usable byte of the arena
+  uint64_t              size;	// usable bytes
+  uint64_t              used;	// bytes carved so far (never returned until destroy_arena())
+  void   *          map_base;	// pointer used for mmap/munmap (or malloc/free)
+  uint64_t          map_size;	//
+} arena_type;
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// categories of memory measured (per level, per process) by measure_level_memory()
+#define MEMORY_VECTORS     0	// FP data for all vectors (including the pointers to each vector in each box)
+#define MEMORY_BOXES       1	// rank_of_box[], my_boxes[] (including -exchange shm's shared boxes), and node_rank[]
+#define MEMORY_BLOCKS      2	// blockCopy lists... my_blocks, overlap_blocks, boundary conditions, exchange, restriction, and interpolation
+#define MEMORY_BUFFERS     3	// MPI send/recv buffers, neighbor lists, and requests of the exchange, restriction, and interpolation
+#define MEMORY_REDBLACK    4	// Red/Black masks
+#define MEMORY_FLUXES      5	// per-thread temporaries (fluxes of operators.test/gsrb.flux.c and residual_pair()'s copy of x)
+#define MEMORY_CATEGORIES  6
+//------------------------------------------------------------------------------------------------------------------------------
+// kernels and events attributed by the optional (-DUSE_PERF_COUNTERS) hardware counters (see counters.h)
+#define COUNTED_SMOOTH         0
+#define COUNTED_RESIDUAL       1	// including the residual of the fused residual_restriction
+#define COUNTED_APPLY_OP       2
+#define COUNTED_RESTRICTION    3
+#define COUNTED_INTERPOLATION  4	// including the interpolation of the fused interpolation_smooth
+#define COUNTED_GHOSTZONE      5
+#define COUNTED_KERNELS        6
+#define COUNTER_CYCLES         0
+#define COUNTER_INSTRUCTIONS   1
+#define COUNTER_LLC_MISSES     2
+#define COUNTER_EVENTS         3
+
+
 //------------------------------------------------------------------------------------------------------------------------------
 typedef struct {
   int subtype;			// e.g. used to calculate normal to domain for BC's
   struct {int i, j, k;}dim;	// dimensions of the block to copy
-  struct {int box, i, j, k, jStride, kStride;double * __restrict__ ptr;}read,write;
+  struct {int box, i, j, k, jStride, kStride;real_t * __restrict__ ptr;}read,write;
   // coordinates in the read grid to extract data, 
   // coordinates in the write grid to insert data
   // if read/write.box<0, then use write/read.ptr, otherwise use boxes[box].vectors[id]
@@ -69,6 +116,14 @@ typedef struct {
 } __attribute__((aligned(64))) blockCopy_type;
 
 
+//------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------
+// -exchange shm... each rank publishes, per stencil shape, the last exchange in which its boxes were ready to be read (SHM_READY) and the
+// last in which it finished reading its neighbors' boxes (SHM_DONE).  Each counter has its own cache line of node_epochs[node rank][]
+#define SHM_READY 0
+#define SHM_DONE  1
+#define SHM_EPOCH(flag,shape) ((((flag)*STENCIL_MAX_SHAPES)+(shape))*8)
+#define SHM_EPOCHS_BYTES      (2*STENCIL_MAX_SHAPES*8*sizeof(uint64_t))
 //------------------------------------------------------------------------------------------------------------------------------
 typedef struct {
     int                           num_recvs;	//   number of neighbors by type
@@ -77,14 +132,23 @@ typedef struct {
     int     * __restrict__       send_ranks;	//   MPI rank of each neighbor...          send_ranks[neighbor]
     int     * __restrict__       recv_sizes;	//   size of each MPI recv buffer...       recv_sizes[neighbor]
     int     * __restrict__       send_sizes;	//   size of each MPI send buffer...       send_sizes[neighbor]
-    double ** __restrict__     recv_buffers;	//   MPI recv buffer for each neighbor...  recv_buffers[neighbor][ recv_sizes[neighbor] ]
-    double ** __restrict__     send_buffers;	//   MPI send buffer for each neighbor...  send_buffers[neighbor][ send_sizes[neighbor] ]
+    real_t ** __restrict__     recv_buffers;	//   MPI recv buffer for each neighbor...  recv_buffers[neighbor][ recv_sizes[neighbor] ]
+    real_t ** __restrict__     send_buffers;	//   MPI send buffer for each neighbor...  send_buffers[neighbor][ send_sizes[neighbor] ]
     int                 allocated_blocks[3];	//   number of blocks allocated (not necessarily used) each list...
     int                       num_blocks[3];	//   number of blocks in each list...        num_blocks[pack,local,unpack]
     blockCopy_type *              blocks[3];	//   list of block copies...                     blocks[pack,local,unpack]
+    uint64_t                   buffer_bytes;	//   bytes allocated for the MPI send and recv buffers (see measure_level_memory())
     #ifdef USE_MPI
     MPI_Request * __restrict__     requests;
     MPI_Status  * __restrict__       status;
+    MPI_Request *      persistent_requests;	//   [recvs,sends] created once by MPI_Recv_init/MPI_Send_init (or NULL)     see -exchange persistent
+    MPI_Comm                  neighbor_comm;	//   distributed graph (recv_ranks -> me -> send_ranks) (or MPI_COMM_NULL) see -exchange neighbor
+    MPI_Request            neighbor_request;	//   the in flight MPI_Ineighbor_alltoallw
+    MPI_Aint *             neighbor_displs;	//   [recvs,sends] absolute address of each buffer (i.e. relative to MPI_BOTTOM)
+    MPI_Datatype *          neighbor_types;	//   [recvs,sends] MPI_REAL_T
+    int                    num_shared_ranks;	//   ranks on my node whose boxes I read or who read mine (see -exchange shm)
+    int     *                  shared_ranks;	//   their rank in MPI_COMM_NODE...          shared_ranks[num_shared_ranks]
+    uint64_t                   shared_epoch;	//   number of exchanges performed through the shared window (see shm_sync())
     #endif
 } communicator_type;
 
@@ -97,9 +161,9 @@ typedef struct {
   int                                ghosts;	// ghost zone depth
   int                jStride,kStride,volume;	// useful for offsets
   int                            numVectors;	//
-  double   ** __restrict__          vectors;	// vectors[c] = pointer to 3D array for vector c for one box
+  real_t   ** __restrict__          vectors;	// vectors[c] = pointer to 3D array for vector c for one box
   #ifdef USE_BVKJI_LAYOUT
-  double    * __restrict__          fp_base;	//              pointer to 4D array for FP data for one box
+  real_t    * __restrict__          fp_base;	//              pointer to 4D array for FP data for one box
   #endif
 } box_type;
 
@@ -114,6 +178,7 @@ typedef struct {
   int box_ghosts;				// ghost zone depth for each box
   int box_jStride,box_kStride,box_volume;	// useful for offsets
   int numVectors;				// number of vectors stored in each box
+  arena_type * arena;				// if not NULL, the vectors of this level were carved from this arena (e.g. MGBuild's) and are freed with it
   int tag;					// tag each level uniquely... FIX... replace with sub commuicator
   struct {int i, j, k;}boxes_in;		// total number of boxes in i,j,k across this level
   struct {int i, j, k;}dim;			// global dimensions at this level (NOTE: dim.i == boxes_in.i * box_dim)
@@ -121,17 +186,23 @@ typedef struct {
   int * rank_of_box;				// 3D array containing rank of each box.  i-major ordering
   int    num_my_boxes;				//           number of boxes owned by this rank
   box_type * my_boxes;				// pointer to array of boxes owned by this rank
+  int num_shared_boxes;				// -exchange shm... my_boxes[num_my_boxes+s] are boxes of other ranks on this node mapped through shared_vectors
+  int * shared_box_rank;			//                  shared_box_rank[s] = MPI rank that owns my_boxes[num_my_boxes+s]
 
   // create flattened FP data... useful for CUDA/OpenMP4/OpenACC when you want to copy an entire vector to/from an accelerator
   #ifdef USE_VBKJI_LAYOUT
-  double   ** __restrict__          vectors;	// vectors[v][box][k][j][i] = pointer to 5D array for vector v encompasing all boxes on this process... 
-  double   ** __restrict__     vectors_base;	//                            pointer used for malloc/free.  allocated (before shifting for alignment) vectors[].
+  real_t   ** __restrict__          vectors;	// vectors[v][box][k][j][i] = pointer to 5D array for vector v encompasing all boxes on this process... 
+  real_t   ** __restrict__     vectors_base;	//                            pointer used for malloc/free.  allocated (before shifting for alignment) vectors[].
   #endif
-//double    * __restrict__          fp_base;    // pointer used for malloc/free.  vectors[v] are shifted from this for alignment
+//real_t    * __restrict__          fp_base;    // pointer used for malloc/free.  vectors[v] are shifted from this for alignment
 
+  struct {int i, j, k;}blocking;		// tile size used to decompose my_boxes into my_blocks
   int       allocated_blocks;			//       number of blocks allocated by this rank (note, this represents a flattening of the box/cell hierarchy to facilitate threading)
   int          num_my_blocks;			//       number of blocks     owned by this rank (note, this represents a flattening of the box/cell hierarchy to facilitate threading)
   blockCopy_type * my_blocks;			// pointer to array of blocks owned by this rank (note, this represents a flattening of the box/cell hierarchy to facilitate threading)
+  int allocated_overlap_blocks[2];		// my_blocks split for overlapping computation with the ghost zone exchange (same tiling)...
+  int       num_overlap_blocks[2];		//   [0] = interior of boxes that need no BC's (computable while the exchange is in flight)
+  blockCopy_type * overlap_blocks[2];		//   [1] = the shell of those boxes plus all boxes on the domain boundary (computed after the exchange and BC's)
 
   struct {
     int                type;			// BC_PERIODIC or BC_DIRICHLET
@@ -143,16 +214,29 @@ typedef struct {
   communicator_type exchange_ghosts[STENCIL_MAX_SHAPES];// mini program that performs a neighbor ghost zone exchange for [shape]
   communicator_type restriction[4];			// mini program that performs restriction and agglomeration for [0=cell centered, 1=i-face, 2=j-face, 3-k-face]
   communicator_type interpolation;			// mini program that performs interpolation and dissemination...
+  int interpolation_is_local;			// interpolation from the next coarser level requires no MPI on any process
+  int * interpolation_coarse_box;		// if interpolation_is_local, the index in the next coarser level's my_boxes[] of the box containing each of my boxes
   #ifdef USE_MPI
   MPI_Comm MPI_COMM_ALLREDUCE;			// MPI sub communicator for just the ranks that have boxes on this level or any subsequent level... 
+  MPI_Comm MPI_COMM_NODE;			// -exchange shm... the ranks that share this node's memory (or MPI_COMM_NULL)
+  int * node_rank;				//                  node_rank[rank] = rank in MPI_COMM_NODE or MPI_UNDEFINED
+  MPI_Win shared_vectors;			//                  shared window the vectors of this level are carved from (or MPI_WIN_NULL)
+  MPI_Win shared_epochs;			//                  shared window of every node rank's exchange epochs (or MPI_WIN_NULL)
+  volatile uint64_t ** node_epochs;		//                  node_epochs[node rank] = that rank's segment of shared_epochs (see SHM_EPOCH())
   #endif
   double dominant_eigenvalue_of_DinvA;		// estimate on the dominate eigenvalue of D^{-1}A
   int must_subtract_mean;			// e.g. Poisson with Periodic BC's
-  double    * __restrict__ RedBlack_base;       // allocated pointer... will be aligned for the first non ghost zone element
-  double    * __restrict__ RedBlack_FP;	        // Red/Black Mask (i.e. 0.0 or 1.0) for even/odd planes (2*kStride).  
+  real_t    * __restrict__ RedBlack_base;       // allocated pointer... will be aligned for the first non ghost zone element
+  real_t    * __restrict__ RedBlack_FP;	        // Red/Black Mask (i.e. 0.0 or 1.0) for even/odd planes (2*kStride).  
+
+  int smoother;					// index into smoothers[]      (see operators.h) used by smooth() on this level
+  int op_kernels;				// index into op_kernels[]     (see operators.h) used by residual() and apply_op() on this level
+  int bottom_solver;				// index into bottom_solvers[] (see solvers.h)   used by IterativeSolver() on this level
 
   int num_threads;
   double    * __restrict__ fluxes;		// temporary array used to hold the flux values used by FV operators
+  double    * __restrict__ pair_x;		// -DUSE_MIXED_PRECISION... per-thread double precision copy of a box's x (see residual_pair())
+  uint64_t memory[MEMORY_CATEGORIES];		// bytes allocated for this level in each category (max over processes) as of the last MGMeasureMemory()
 
   // statistics information...
   struct {
@@ -190,6 +274,7 @@ typedef struct {
     double   collectives;
     double         Total;
   }timers;
+  uint64_t counters[COUNTED_KERNELS][COUNTER_EVENTS]; // hardware counters (summed over threads) of each kernel (see counters.h)
   int Krylov_iterations;        // total number of bottom solver iterations
   int CAKrylov_formations_of_G; // i.e. [G,g] = [P,R]^T[P,R,rt]
   int vcycles_from_this_level;  // number of vcycles performed that were initiated from this level
@@ -197,15 +282,30 @@ typedef struct {
 
 
 //------------------------------------------------------------------------------------------------------------------------------
-void create_level(level_type *level, int boxes_in_i, int box_dim, int box_ghosts, int numVectors, int domain_boundary_condition, int my_rank, int num_ranks);
+void create_level(level_type *level, int boxes_in_i, int boxes_in_j, int boxes_in_k, int box_dim, int box_ghosts, int numVectors, int domain_boundary_condition, int my_rank, int num_ranks);
 void destroy_level(level_type *level);
 void create_vectors(level_type *level, int numVectors);
+uint64_t vectors_arena_bytes(level_type *level, int numVectors);
+void decompose_level(int *rank_of_box, int boxes_in_i, int boxes_in_j, int boxes_in_k, int num_ranks, int verbose);
+void estimate_level_memory(int boxes_in_i, int boxes_in_j, int boxes_in_k, int box_dim, int box_ghosts, int domain_boundary_condition,
+                           const int *rank_of_box, int rank, const int *my_box_ids, int num_my_boxes, int numVectors, uint64_t *bytes);
+int count_tiles(int dim_i, int dim_j, int dim_k, int tile_i, int tile_j, int tile_k);
+uint64_t block_list_bytes(uint64_t num_blocks);
+uint64_t communicator_message_bytes(int num_messages);
+double numa_locality(level_type *level);
+void measure_level_memory(level_type *level, uint64_t *bytes);
+uint64_t high_water_mark(void);
+void create_arena(arena_type *arena, uint64_t size);
+void * arena_alloc(arena_type *arena, uint64_t size);
+uint64_t arena_available(arena_type *arena);
+void destroy_arena(arena_type *arena);
 void reset_level_timers(level_type *level);
+void build_my_blocks(level_type *level, int tile_i, int tile_j, int tile_k);
 int qsortInt(const void *a, const void *b);
 void append_block_to_list(blockCopy_type ** blocks, int *allocated_blocks, int *num_blocks,
                           int dim_i, int dim_j, int dim_k,
-                          int  read_box, double*  read_ptr, int  read_i, int  read_j, int  read_k, int  read_jStride, int  read_kStride, int  read_scale,
-                          int write_box, double* write_ptr, int write_i, int write_j, int write_k, int write_jStride, int write_kStride, int write_scale,
+                          int  read_box, real_t*  read_ptr, int  read_i, int  read_j, int  read_k, int  read_jStride, int  read_kStride, int  read_scale,
+                          int write_box, real_t* write_ptr, int write_i, int write_j, int write_k, int write_jStride, int write_kStride, int write_scale,
                           int my_blockcopy_tile_i, int my_blockcopy_tile_j, int my_blockcopy_tile_k,
                           int subtype
                          );
@@ -3,6 +3,7 @@ hpgmg-fv-y.c += $(call thisdir, \
 	level.c \
 	operators.fv4.c \
 	mg.c \
+	counters.c \
 	solvers.c \
 	hpgmg-fv.c \
 	)
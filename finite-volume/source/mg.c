@@ -23,6 +23,7 @@
 #include "operators.h"
 #include "solvers.h"
 #include "mg.h"
+#include "counters.h"
 //------------------------------------------------------------------------------------------------------------------------------
 // structs/routines used to construct the restriction and prolognation lists and ensure a convention on how data is ordered within an MPI buffer
 typedef struct {
@@ -53,6 +54,7 @@ int qsortRP(const void *a, const void*b){
 // print out average time per solve and then decompose by function and level
 // note, in FMG, some levels are accessed more frequently.  This routine only prints time per solve in that level
 void MGPrintTiming(mg_type *all_grids, int fromLevel){
+  MGMeasureMemory(all_grids); // collective
   if(all_grids->my_rank!=0)return;
   int level,num_levels = all_grids->num_levels;
   #ifdef CALIBRATE_TIMER
@@ -66,8 +68,16 @@ void MGPrintTiming(mg_type *all_grids, int fromLevel){
   double time,total;
           printf("\n\n");
           printf("level                     ");for(level=fromLevel;level<(num_levels  );level++){printf("%12d ",level-fromLevel);}printf("\n");
-          printf("level dimension           ");for(level=fromLevel;level<(num_levels  );level++){printf("%10d^3 ",all_grids->levels[level]->dim.i  );}printf("\n");
-          printf("box dimension             ");for(level=fromLevel;level<(num_levels  );level++){printf("%10d^3 ",all_grids->levels[level]->box_dim);}printf("       total\n");
+          printf("level dimension           ");for(level=fromLevel;level<(num_levels  );level++){level_type *L=all_grids->levels[level];char dim[32];
+                                                                                                 if( (L->dim.i==L->dim.j) && (L->dim.i==L->dim.k) )printf("%10d^3 ",L->dim.i);
+                                                                                                 else{snprintf(dim,sizeof(dim),"%dx%dx%d",L->dim.i,L->dim.j,L->dim.k);printf("%12s ",dim);}}printf("\n");
+          printf("box dimension             ");for(level=fromLevel;level<(num_levels  );level++){printf("%10d^3 ",all_grids->levels[level]->box_dim);}printf("\n");
+          printf("smoother                  ");for(level=fromLevel;level<(num_levels  );level++){printf("%12s ",smoothers[all_grids->levels[level]->smoother].name);}printf("\n");
+          printf("blocking                  ");for(level=fromLevel;level<(num_levels  );level++){level_type *L=all_grids->levels[level];char tile[32];
+                                                                                                 snprintf(tile,sizeof(tile),"%dx%dx%d",(L->blocking.i<L->box_dim) ? L->blocking.i : L->box_dim,
+                                                                                                                                        (L->blocking.j<L->box_dim) ? L->blocking.j : L->box_dim,
+                                                                                                                                        (L->blocking.k<L->box_dim) ? L->blocking.k : L->box_dim);
+                                                                                                 printf("%12s ",tile);}printf("       total\n");
   total=0;printf("------------------        ");for(level=fromLevel;level<(num_levels+1);level++){printf("------------ ");}printf("\n");
   total=0;printf("smooth                    ");for(level=fromLevel;level<(num_levels  );level++){time=scale*(double)all_grids->levels[level]->timers.smooth;               total+=time;printf("%12.6f ",time);}printf("%12.6f\n",total);
   total=0;printf("residual                  ");for(level=fromLevel;level<(num_levels  );level++){time=scale*(double)all_grids->levels[level]->timers.residual;             total+=time;printf("%12.6f ",time);}printf("%12.6f\n",total);
@@ -108,18 +118,171 @@ void MGPrintTiming(mg_type *all_grids, int fromLevel){
   total=0;printf("------------------        ");for(level=fromLevel;level<(num_levels+1);level++){printf("------------ ");}printf("\n");
   total=0;printf("Total by level            ");for(level=fromLevel;level<(num_levels  );level++){time=scale*(double)all_grids->levels[level]->timers.Total;                total+=time;printf("%12.6f ",time);}printf("%12.6f\n",total);
 
+  // memory (MB per process, max over processes) by category and level...
+  double MB,category_MB[MEMORY_CATEGORIES];
+  const char *category_name[MEMORY_CATEGORIES] = {"  vectors                 ",
+                                                  "  boxes                   ",
+                                                  "  block lists             ",
+                                                  "  MPI buffers             ",
+                                                  "  Red/Black masks         ",
+                                                  "  fluxes                  "};
+  int c;
+  printf("\n");
+          printf("Memory (MB per process)\n");
+  for(c=0;c<MEMORY_CATEGORIES;c++){
+    category_MB[c]=0;for(level=fromLevel;level<num_levels;level++)category_MB[c]+=all_grids->levels[level]->memory[c];
+    if( (c==MEMORY_FLUXES) && (category_MB[c]==0) )continue; // only the operators.test/ flux kernels and residual_pair() use temporaries
+  total=0;printf("%s",category_name[c]);      for(level=fromLevel;level<(num_levels  );level++){MB=all_grids->levels[level]->memory[c]/1048576.0;                                total+=MB;  printf("%12.3f ",MB);  }printf("%12.3f\n",total);
+  }
+  total=0;printf("------------------        ");for(level=fromLevel;level<(num_levels+1);level++){printf("------------ ");}printf("\n");
+  total=0;printf("Memory by level           ");for(level=fromLevel;level<(num_levels  );level++){MB=0;for(c=0;c<MEMORY_CATEGORIES;c++)MB+=all_grids->levels[level]->memory[c]/1048576.0;total+=MB;  printf("%12.3f ",MB);  }printf("%12.3f\n",total);
+
+  #ifdef USE_PERF_COUNTERS
+  // hardware counters (per solve) and the bandwidth each kernel attained (LLC misses x COUNTERS_LINE_SIZE bytes over its time) relative to STREAM...
+  if(counters_available){
+  const char *kernel_name[COUNTED_KERNELS] = {"smooth","residual","applyOp","Restriction","Interpolation","Ghost Zone Exchange"};
+  double count,bytes,seconds,cycles_total,instructions_total,bytes_total,seconds_total;
+  int k;
+  printf("\n");
+          printf("Counters (per solve)      ");for(level=fromLevel;level<(num_levels  );level++){printf("             ");}printf("\n");
+  for(k=0;k<COUNTED_KERNELS;k++){
+    #define KERNEL_SECONDS(L) ( scale*(double)( (k==COUNTED_SMOOTH       ) ? (L)->timers.smooth              : \
+                                                (k==COUNTED_RESIDUAL     ) ? (L)->timers.residual            : \
+                                                (k==COUNTED_APPLY_OP     ) ? (L)->timers.apply_op            : \
+                                                (k==COUNTED_RESTRICTION  ) ? (L)->timers.restriction_total   : \
+                                                (k==COUNTED_INTERPOLATION) ? (L)->timers.interpolation_total : \
+                                                                             (L)->timers.ghostZone_total     ) )
+    printf("%s\n",kernel_name[k]);
+    cycles_total=0;printf("  cycles (x1e6)           ");for(level=fromLevel;level<(num_levels  );level++){count=all_grids->levels[level]->counters[k][COUNTER_CYCLES]/(double)all_grids->MGSolves_performed;cycles_total+=count;printf("%12.3f ",count/1e6);}printf("%12.3f\n",cycles_total/1e6);
+    instructions_total=0;
+                   printf("  IPC                     ");for(level=fromLevel;level<(num_levels  );level++){level_type *L=all_grids->levels[level];instructions_total+=L->counters[k][COUNTER_INSTRUCTIONS]/(double)all_grids->MGSolves_performed;
+                                                                                                 printf("%12.3f ",(L->counters[k][COUNTER_CYCLES]>0) ? (double)L->counters[k][COUNTER_INSTRUCTIONS]/(double)L->counters[k][COUNTER_CYCLES] : 0.0);}
+                                                                                                 printf("%12.3f\n",(cycles_total>0) ? instructions_total/cycles_total : 0.0);
+    bytes_total=0;seconds_total=0;
+                   printf("  GB/s                    ");for(level=fromLevel;level<(num_levels  );level++){level_type *L=all_grids->levels[level];bytes=COUNTERS_LINE_SIZE*(double)L->counters[k][COUNTER_LLC_MISSES]/(double)all_grids->MGSolves_performed;
+                                                                                                 seconds=KERNEL_SECONDS(L);bytes_total+=bytes;seconds_total+=seconds;printf("%12.3f ",(seconds>0) ? bytes/seconds/1e9 : 0.0);}
+                                                                                                 printf("%12.3f\n",(seconds_total>0) ? bytes_total/seconds_total/1e9 : 0.0);
+                   printf("  %% of STREAM             ");for(level=fromLevel;level<(num_levels  );level++){level_type *L=all_grids->levels[level];bytes=COUNTERS_LINE_SIZE*(double)L->counters[k][COUNTER_LLC_MISSES]/(double)all_grids->MGSolves_performed;
+                                                                                                 seconds=KERNEL_SECONDS(L);printf("%11.1f%% ",(seconds>0) ? 100.0*bytes/seconds/counters_stream_bandwidth : 0.0);}
+                                                                                                 printf("%11.1f%%\n",(seconds_total>0) ? 100.0*bytes_total/seconds_total/counters_stream_bandwidth : 0.0);
+    #undef KERNEL_SECONDS
+  }
+  }
+  #endif
+
   printf("\n");
   printf( "   Total time in MGBuild  %12.6f seconds\n",SecondsPerCycle*(double)all_grids->timers.MGBuild);
   printf( "   Total time in MGSolve  %12.6f seconds\n",scale*(double)all_grids->timers.MGSolve);
+  if(all_grids->high_water_mark>0)
+  printf( "  Process high water mark  %12.3f MB\n",all_grids->high_water_mark/1048576.0);
   printf( "      number of v-cycles  %12d\n"  ,all_grids->levels[fromLevel]->vcycles_from_this_level/all_grids->MGSolves_performed);
+  printf( "           Bottom solver  %12s\n"  ,bottom_solvers[all_grids->levels[num_levels-1]->bottom_solver].name);
   printf( "Bottom solver iterations  %12d\n"  ,all_grids->levels[num_levels-1]->Krylov_iterations/all_grids->MGSolves_performed);
-  #if defined(USE_CABICGSTAB) || defined(USE_CACG)
+  if(all_grids->levels[num_levels-1]->CAKrylov_formations_of_G>0) // i.e. CABiCGStab or CACG were used as the bottom solver
   printf( "     formations of G[][]  %12d\n"  ,all_grids->levels[num_levels-1]->CAKrylov_formations_of_G/all_grids->MGSolves_performed);
-  #endif
   printf("\n\n");fflush(stdout);
 }
 
 
+//----------------------------------------------------------------------------------------------------------------------------------------------------
+// JSON has no representation for inf/nan... write them as null
+void MGPrintJSONNumber(FILE *fp, const char *format, double x){
+  if(isfinite(x))fprintf(fp,format,x);
+            else fprintf(fp,"null");
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------
+// write the same information as MGPrintTiming() as a JSON object (e.g. for regression dashboards)
+// times are per MGSolve, levels[] is indexed relative to fromLevel.  Only rank 0 writes (fp may be NULL on other ranks)
+void MGPrintTimingJSON(mg_type *all_grids, int fromLevel, FILE *fp){
+  if(all_grids->my_rank!=0)return;
+  if(fp==NULL)return;
+  int level,num_levels = all_grids->num_levels;
+  #ifdef CALIBRATE_TIMER
+  double _timeStart=getTime();sleep(1);double _timeEnd=getTime();
+  double SecondsPerCycle = (double)1.0/(double)(_timeEnd-_timeStart);
+  #else
+  double SecondsPerCycle = 1.0;
+  #endif
+  double scale = SecondsPerCycle/(double)all_grids->MGSolves_performed; // average time per MGSolve
+
+  fprintf(fp,"{\n");
+  fprintf(fp,"      \"levels\": [\n");
+  for(level=fromLevel;level<num_levels;level++){
+    level_type *L = all_grids->levels[level];
+    fprintf(fp,"        {\"level\": %d, \"dim\": %d, \"dims\": [%d, %d, %d], \"box_dim\": %d, \"smoother\": \"%s\", \"kernels\": \"%s\", \"blocking\": [%d, %d, %d],\n",level-fromLevel,L->dim.i,L->dim.i,L->dim.j,L->dim.k,L->box_dim,
+                                  smoothers[L->smoother].name,op_kernels[L->op_kernels].name,
+                                  (L->blocking.i<L->box_dim) ? L->blocking.i : L->box_dim,
+                                  (L->blocking.j<L->box_dim) ? L->blocking.j : L->box_dim,
+                                  (L->blocking.k<L->box_dim) ? L->blocking.k : L->box_dim);
+    fprintf(fp,"         \"timers\": {");
+    #define JSON_TIMER(t,sep) {fprintf(fp,"\"" #t "\": ");MGPrintJSONNumber(fp,"%0.9e",scale*(double)L->timers.t);fputs(sep,fp);}
+    JSON_TIMER(smooth,", ");JSON_TIMER(residual,", ");JSON_TIMER(apply_op,", ");JSON_TIMER(blas1,", ");JSON_TIMER(blas3,", ");JSON_TIMER(boundary_conditions,",\n                    ");
+    JSON_TIMER(restriction_total  ,", ");JSON_TIMER(restriction_local  ,", ");JSON_TIMER(restriction_pack  ,", ");JSON_TIMER(restriction_unpack  ,", ");
+    JSON_TIMER(restriction_send   ,", ");JSON_TIMER(restriction_recv   ,", ");JSON_TIMER(restriction_wait  ,",\n                    ");
+    JSON_TIMER(interpolation_total,", ");JSON_TIMER(interpolation_local,", ");JSON_TIMER(interpolation_pack,", ");JSON_TIMER(interpolation_unpack,", ");
+    JSON_TIMER(interpolation_send ,", ");JSON_TIMER(interpolation_recv ,", ");JSON_TIMER(interpolation_wait,",\n                    ");
+    JSON_TIMER(ghostZone_total    ,", ");JSON_TIMER(ghostZone_local    ,", ");JSON_TIMER(ghostZone_pack    ,", ");JSON_TIMER(ghostZone_unpack    ,", ");
+    JSON_TIMER(ghostZone_send     ,", ");JSON_TIMER(ghostZone_recv     ,", ");JSON_TIMER(ghostZone_wait    ,",\n                    ");
+    JSON_TIMER(collectives,", ");JSON_TIMER(Total,"");
+    #undef JSON_TIMER
+    fprintf(fp,"},\n");
+    fprintf(fp,"         \"memory\": {\"vectors\": %llu, \"boxes\": %llu, \"blocks\": %llu, \"buffers\": %llu, \"redblack\": %llu, \"fluxes\": %llu}",
+                                  (unsigned long long)L->memory[MEMORY_VECTORS],(unsigned long long)L->memory[MEMORY_BOXES  ],(unsigned long long)L->memory[MEMORY_BLOCKS],
+                                  (unsigned long long)L->memory[MEMORY_BUFFERS],(unsigned long long)L->memory[MEMORY_REDBLACK],(unsigned long long)L->memory[MEMORY_FLUXES]);
+    #ifdef USE_PERF_COUNTERS
+    if(counters_available){
+      int k;
+      const char *kernel_name[COUNTED_KERNELS] = {"smooth","residual","apply_op","restriction","interpolation","ghostZone"};
+      fprintf(fp,",\n         \"counters\": {");
+      for(k=0;k<COUNTED_KERNELS;k++){
+        fprintf(fp,"\"%s\": {\"cycles\": ",kernel_name[k]);MGPrintJSONNumber(fp,"%0.6e",L->counters[k][COUNTER_CYCLES      ]/(double)all_grids->MGSolves_performed);
+        fprintf(fp,", \"instructions\": "            );MGPrintJSONNumber(fp,"%0.6e",L->counters[k][COUNTER_INSTRUCTIONS]/(double)all_grids->MGSolves_performed);
+        fprintf(fp,", \"llc_misses\": "              );MGPrintJSONNumber(fp,"%0.6e",L->counters[k][COUNTER_LLC_MISSES  ]/(double)all_grids->MGSolves_performed);
+        fprintf(fp,"}%s",(k<COUNTED_KERNELS-1) ? ",\n                      " : "}");
+      }
+    }
+    #endif
+    fprintf(fp,"}%s\n",(level<num_levels-1) ? "," : "");
+  }
+  fprintf(fp,"      ],\n");
+  fprintf(fp,"      \"MGBuild\": ");MGPrintJSONNumber(fp,"%0.9e",SecondsPerCycle*(double)all_grids->timers.MGBuild);fprintf(fp,",\n");
+  fprintf(fp,"      \"MGSolve\": ");MGPrintJSONNumber(fp,"%0.9e",scale*(double)all_grids->timers.MGSolve);fprintf(fp,",\n");
+  fprintf(fp,"      \"high_water_mark\": %llu,\n",(unsigned long long)all_grids->high_water_mark);
+  #ifdef USE_PERF_COUNTERS
+  fprintf(fp,"      \"stream_bandwidth\": ");MGPrintJSONNumber(fp,"%0.6e",counters_stream_bandwidth);fprintf(fp,",\n");
+  #endif
+  fprintf(fp,"      \"vcycles\": %d,\n",all_grids->levels[fromLevel]->vcycles_from_this_level/all_grids->MGSolves_performed);
+  fprintf(fp,"      \"bottom_solver\": \"%s\",\n",bottom_solvers[all_grids->levels[num_levels-1]->bottom_solver].name);
+  fprintf(fp,"      \"bottom_solver_iterations\": %d,\n",all_grids->levels[num_levels-1]->Krylov_iterations/all_grids->MGSolves_performed);
+  fprintf(fp,"      \"formations_of_G\": %d\n",all_grids->levels[num_levels-1]->CAKrylov_formations_of_G/all_grids->MGSolves_performed);
+  fprintf(fp,"    }");
+  fflush(fp);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------
+// measure the memory allocated for each level (see measure_level_memory()) and the process high water mark.  Each is the max over processes.
+// Collective over MPI_COMM_WORLD
+void MGMeasureMemory(mg_type *all_grids){
+  int level;
+  for(level=0;level<all_grids->num_levels;level++)measure_level_memory(all_grids->levels[level],all_grids->levels[level]->memory);
+  all_grids->high_water_mark = high_water_mark();
+  #ifdef USE_MPI
+  for(level=0;level<all_grids->num_levels;level++){
+    unsigned long long send[MEMORY_CATEGORIES],recv[MEMORY_CATEGORIES];int c;
+    for(c=0;c<MEMORY_CATEGORIES;c++)send[c]=all_grids->levels[level]->memory[c];
+    MPI_Allreduce(send,recv,MEMORY_CATEGORIES,MPI_UNSIGNED_LONG_LONG,MPI_MAX,MPI_COMM_WORLD);
+    for(c=0;c<MEMORY_CATEGORIES;c++)all_grids->levels[level]->memory[c]=recv[c];
+  }
+  unsigned long long send_hwm=all_grids->high_water_mark,recv_hwm;
+  MPI_Allreduce(&send_hwm,&recv_hwm,1,MPI_UNSIGNED_LONG_LONG,MPI_MAX,MPI_COMM_WORLD);
+  all_grids->high_water_mark = recv_hwm;
+  #endif
+}
+
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------
 // zeros all timers within this MG hierarchy
 void MGResetTimers(mg_type *all_grids){
@@ -159,9 +322,17 @@ void build_interpolation(mg_type *all_grids){
   all_grids->levels[level]->interpolation.allocated_blocks[0] = 0;
   all_grids->levels[level]->interpolation.allocated_blocks[1] = 0;
   all_grids->levels[level]->interpolation.allocated_blocks[2] = 0;
+  all_grids->levels[level]->interpolation.buffer_bytes        = 0;
   #ifdef USE_MPI
   all_grids->levels[level]->interpolation.requests            = NULL;
   all_grids->levels[level]->interpolation.status              = NULL;
+  all_grids->levels[level]->interpolation.persistent_requests = NULL;
+  all_grids->levels[level]->interpolation.neighbor_comm       = MPI_COMM_NULL;
+  all_grids->levels[level]->interpolation.neighbor_displs     = NULL;
+  all_grids->levels[level]->interpolation.neighbor_types      = NULL;
+  all_grids->levels[level]->interpolation.num_shared_ranks    = 0;
+  all_grids->levels[level]->interpolation.shared_ranks        = NULL;
+  all_grids->levels[level]->interpolation.shared_epoch        = 0;
   #endif
 
 
@@ -220,7 +391,7 @@ void build_interpolation(mg_type *all_grids){
     all_grids->levels[level]->interpolation.num_sends     =                         numFineRanks;
     all_grids->levels[level]->interpolation.send_ranks    =            (int*)malloc(numFineRanks*sizeof(int));
     all_grids->levels[level]->interpolation.send_sizes    =            (int*)malloc(numFineRanks*sizeof(int));
-    all_grids->levels[level]->interpolation.send_buffers  =        (double**)malloc(numFineRanks*sizeof(double*));
+    all_grids->levels[level]->interpolation.send_buffers  =        (real_t**)malloc(numFineRanks*sizeof(real_t*));
     if(numFineRanks>0){
     if(all_grids->levels[level]->interpolation.send_ranks  ==NULL){fprintf(stderr,"malloc failed - all_grids->levels[%d]->interpolation.send_ranks\n",level);exit(0);}
     if(all_grids->levels[level]->interpolation.send_sizes  ==NULL){fprintf(stderr,"malloc failed - all_grids->levels[%d]->interpolation.send_sizes\n",level);exit(0);}
@@ -228,11 +399,12 @@ void build_interpolation(mg_type *all_grids){
     }
 
     int elementSize = all_grids->levels[level-1]->box_dim*all_grids->levels[level-1]->box_dim*all_grids->levels[level-1]->box_dim;
-    double * all_send_buffers = (double*)malloc(numFineBoxesRemote*elementSize*sizeof(double));
+    real_t * all_send_buffers = (real_t*)malloc(numFineBoxesRemote*elementSize*sizeof(real_t));
           if(numFineBoxesRemote*elementSize>0)
           if(all_send_buffers==NULL){fprintf(stderr,"malloc failed - interpolation/all_send_buffers\n");exit(0);}
-                      memset(all_send_buffers,0,numFineBoxesRemote*elementSize*sizeof(double)); // DO NOT DELETE... you must initialize to 0 to avoid getting something like 0.0*NaN and corrupting the solve
-    //printf("level=%d, rank=%2d, send_buffers=%6d\n",level,all_grids->my_rank,numFineBoxesRemote*elementSize*sizeof(double));
+                      memset(all_send_buffers,0,numFineBoxesRemote*elementSize*sizeof(real_t)); // DO NOT DELETE... you must initialize to 0 to avoid getting something like 0.0*NaN and corrupting the solve
+    all_grids->levels[level]->interpolation.buffer_bytes += (uint64_t)numFineBoxesRemote*elementSize*sizeof(real_t);
+    //printf("level=%d, rank=%2d, send_buffers=%6d\n",level,all_grids->my_rank,numFineBoxesRemote*elementSize*sizeof(real_t));
 
     // for each neighbor, construct the pack list and allocate the MPI send buffer... 
     for(neighbor=0;neighbor<numFineRanks;neighbor++){
@@ -353,7 +525,7 @@ void build_interpolation(mg_type *all_grids){
     all_grids->levels[level]->interpolation.num_recvs     =                         numCoarseRanks;
     all_grids->levels[level]->interpolation.recv_ranks    =            (int*)malloc(numCoarseRanks*sizeof(int));
     all_grids->levels[level]->interpolation.recv_sizes    =            (int*)malloc(numCoarseRanks*sizeof(int));
-    all_grids->levels[level]->interpolation.recv_buffers  =        (double**)malloc(numCoarseRanks*sizeof(double*));
+    all_grids->levels[level]->interpolation.recv_buffers  =        (real_t**)malloc(numCoarseRanks*sizeof(real_t*));
     if(numCoarseRanks>0){
     if(all_grids->levels[level]->interpolation.recv_ranks  ==NULL){fprintf(stderr,"malloc failed - all_grids->levels[%d]->interpolation.recv_ranks\n",level);exit(0);}
     if(all_grids->levels[level]->interpolation.recv_sizes  ==NULL){fprintf(stderr,"malloc failed - all_grids->levels[%d]->interpolation.recv_sizes\n",level);exit(0);}
@@ -361,11 +533,12 @@ void build_interpolation(mg_type *all_grids){
     }
 
     int elementSize = all_grids->levels[level]->box_dim*all_grids->levels[level]->box_dim*all_grids->levels[level]->box_dim;
-    double * all_recv_buffers = (double*)malloc(numCoarseBoxes*elementSize*sizeof(double)); 
+    real_t * all_recv_buffers = (real_t*)malloc(numCoarseBoxes*elementSize*sizeof(real_t)); 
           if(numCoarseBoxes*elementSize>0)
           if(all_recv_buffers==NULL){fprintf(stderr,"malloc failed - interpolation/all_recv_buffers\n");exit(0);}
-                      memset(all_recv_buffers,0,numCoarseBoxes*elementSize*sizeof(double)); // DO NOT DELETE... you must initialize to 0 to avoid getting something like 0.0*NaN and corrupting the solve
-    //printf("level=%d, rank=%2d, recv_buffers=%6d\n",level,all_grids->my_rank,numCoarseBoxes*elementSize*sizeof(double));
+                      memset(all_recv_buffers,0,numCoarseBoxes*elementSize*sizeof(real_t)); // DO NOT DELETE... you must initialize to 0 to avoid getting something like 0.0*NaN and corrupting the solve
+    all_grids->levels[level]->interpolation.buffer_bytes += (uint64_t)numCoarseBoxes*elementSize*sizeof(real_t);
+    //printf("level=%d, rank=%2d, recv_buffers=%6d\n",level,all_grids->my_rank,numCoarseBoxes*elementSize*sizeof(real_t));
 
     // for each neighbor, construct the unpack list and allocate the MPI recv buffer... 
     for(neighbor=0;neighbor<numCoarseRanks;neighbor++){
@@ -428,6 +601,44 @@ void build_interpolation(mg_type *all_grids){
     }
   }
   #endif
+
+
+  // determine whether interpolation to each level is free of MPI on every process (fused interpolation/smoothers must agree on whether to exchange)
+  for(level=0;level<all_grids->num_levels;level++){
+    int local = 0;
+    if(level<all_grids->num_levels-1){
+      local = (all_grids->levels[level+1]->interpolation.num_blocks[0]==0) &&
+              (all_grids->levels[level  ]->interpolation.num_blocks[2]==0) ;
+    }
+    #ifdef USE_MPI
+    int local_send = local;
+    MPI_Allreduce(&local_send,&local,1,MPI_INT,MPI_MIN,MPI_COMM_WORLD);
+    #endif
+    all_grids->levels[level]->interpolation_is_local = local;
+  }
+
+
+  // when interpolation is local, record the coarse box containing each fine box (used by fused interpolation/smoothers on every v-cycle)
+  for(level=0;level<all_grids->num_levels-1;level++){
+    level_type *level_f = all_grids->levels[level  ];
+    level_type *level_c = all_grids->levels[level+1];
+    level_f->interpolation_coarse_box = NULL;
+    if(!level_f->interpolation_is_local)continue;
+    int numCoarseBoxes = level_c->boxes_in.i*level_c->boxes_in.j*level_c->boxes_in.k;
+    int *localCoarseBox = (int*)malloc(numCoarseBoxes*sizeof(int)); // global_box_id -> index in level_c->my_boxes[] (or -1)
+    level_f->interpolation_coarse_box = (int*)malloc(level_f->num_my_boxes*sizeof(int));
+    if( (localCoarseBox==NULL) || ((level_f->num_my_boxes>0) && (level_f->interpolation_coarse_box==NULL)) ){fprintf(stderr,"malloc failed - build_interpolation/interpolation_coarse_box\n");exit(0);}
+    int b;
+    for(b=0;b<numCoarseBoxes;b++)localCoarseBox[b] = -1;
+    for(b=0;b<level_c->num_my_boxes;b++)localCoarseBox[level_c->my_boxes[b].global_box_id] = b;
+    for(b=0;b<level_f->num_my_boxes;b++){
+      int coarseBox_i = (level_f->my_boxes[b].low.i/2) / level_c->box_dim;
+      int coarseBox_j = (level_f->my_boxes[b].low.j/2) / level_c->box_dim;
+      int coarseBox_k = (level_f->my_boxes[b].low.k/2) / level_c->box_dim;
+      level_f->interpolation_coarse_box[b] = localCoarseBox[coarseBox_i + coarseBox_j*level_c->boxes_in.i + coarseBox_k*level_c->boxes_in.i*level_c->boxes_in.j];
+    }
+    free(localCoarseBox);
+  }
 }
 
 
@@ -459,9 +670,17 @@ void build_restriction(mg_type *all_grids, int restrictionType){
   all_grids->levels[level]->restriction[restrictionType].num_blocks[0]       = 0; // number of unpack/insert operations  = number of boxes on level+1 that I don't own and restrict to 
   all_grids->levels[level]->restriction[restrictionType].num_blocks[1]       = 0; // number of unpack/insert operations  = number of boxes on level+1 that I own and restrict to
   all_grids->levels[level]->restriction[restrictionType].num_blocks[2]       = 0; // number of unpack/insert operations  = number of boxes on level-1 that I don't own that restrict to me
+  all_grids->levels[level]->restriction[restrictionType].buffer_bytes        = 0;
   #ifdef USE_MPI
   all_grids->levels[level]->restriction[restrictionType].requests            = NULL;
   all_grids->levels[level]->restriction[restrictionType].status              = NULL;
+  all_grids->levels[level]->restriction[restrictionType].persistent_requests = NULL;
+  all_grids->levels[level]->restriction[restrictionType].neighbor_comm       = MPI_COMM_NULL;
+  all_grids->levels[level]->restriction[restrictionType].neighbor_displs     = NULL;
+  all_grids->levels[level]->restriction[restrictionType].neighbor_types      = NULL;
+  all_grids->levels[level]->restriction[restrictionType].num_shared_ranks    = 0;
+  all_grids->levels[level]->restriction[restrictionType].shared_ranks        = NULL;
+  all_grids->levels[level]->restriction[restrictionType].shared_epoch        = 0;
   #endif
 
 
@@ -517,7 +736,7 @@ void build_restriction(mg_type *all_grids, int restrictionType){
     all_grids->levels[level]->restriction[restrictionType].num_sends     =                         numCoarseRanks;
     all_grids->levels[level]->restriction[restrictionType].send_ranks    =            (int*)malloc(numCoarseRanks*sizeof(int));
     all_grids->levels[level]->restriction[restrictionType].send_sizes    =            (int*)malloc(numCoarseRanks*sizeof(int));
-    all_grids->levels[level]->restriction[restrictionType].send_buffers  =        (double**)malloc(numCoarseRanks*sizeof(double*));
+    all_grids->levels[level]->restriction[restrictionType].send_buffers  =        (real_t**)malloc(numCoarseRanks*sizeof(real_t*));
     if(numCoarseRanks>0){
     if(all_grids->levels[level]->restriction[restrictionType].send_ranks  ==NULL){fprintf(stderr,"malloc failed - all_grids->levels[%d]->restriction[restrictionType].send_ranks\n",level);exit(0);}
     if(all_grids->levels[level]->restriction[restrictionType].send_sizes  ==NULL){fprintf(stderr,"malloc failed - all_grids->levels[%d]->restriction[restrictionType].send_sizes\n",level);exit(0);}
@@ -544,10 +763,11 @@ void build_restriction(mg_type *all_grids, int restrictionType){
     }
     elementSize = restrict_dim_i*restrict_dim_j*restrict_dim_k;
    
-    double * all_send_buffers = (double*)malloc(numCoarseBoxes*elementSize*sizeof(double));
+    real_t * all_send_buffers = (real_t*)malloc(numCoarseBoxes*elementSize*sizeof(real_t));
           if(numCoarseBoxes*elementSize>0)
           if(all_send_buffers==NULL){fprintf(stderr,"malloc failed - restriction/all_send_buffers\n");exit(0);}
-                      memset(all_send_buffers,0,numCoarseBoxes*elementSize*sizeof(double)); // DO NOT DELETE... you must initialize to 0 to avoid getting something like 0.0*NaN and corrupting the solve
+                      memset(all_send_buffers,0,numCoarseBoxes*elementSize*sizeof(real_t)); // DO NOT DELETE... you must initialize to 0 to avoid getting something like 0.0*NaN and corrupting the solve
+    all_grids->levels[level]->restriction[restrictionType].buffer_bytes += (uint64_t)numCoarseBoxes*elementSize*sizeof(real_t);
 
     // for each neighbor, construct the pack list and allocate the MPI send buffer... 
     for(neighbor=0;neighbor<numCoarseRanks;neighbor++){
@@ -684,7 +904,7 @@ void build_restriction(mg_type *all_grids, int restrictionType){
     all_grids->levels[level]->restriction[restrictionType].num_recvs     =                         numFineRanks;
     all_grids->levels[level]->restriction[restrictionType].recv_ranks    =            (int*)malloc(numFineRanks*sizeof(int));
     all_grids->levels[level]->restriction[restrictionType].recv_sizes    =            (int*)malloc(numFineRanks*sizeof(int));
-    all_grids->levels[level]->restriction[restrictionType].recv_buffers  =        (double**)malloc(numFineRanks*sizeof(double*));
+    all_grids->levels[level]->restriction[restrictionType].recv_buffers  =        (real_t**)malloc(numFineRanks*sizeof(real_t*));
     if(numFineRanks>0){
     if(all_grids->levels[level]->restriction[restrictionType].recv_ranks  ==NULL){fprintf(stderr,"malloc failed - all_grids->levels[%d]->restriction[restrictionType].recv_ranks  \n",level);exit(0);}
     if(all_grids->levels[level]->restriction[restrictionType].recv_sizes  ==NULL){fprintf(stderr,"malloc failed - all_grids->levels[%d]->restriction[restrictionType].recv_sizes  \n",level);exit(0);}
@@ -711,11 +931,12 @@ void build_restriction(mg_type *all_grids, int restrictionType){
     }
     elementSize = restrict_dim_i*restrict_dim_j*restrict_dim_k;
 
-    double * all_recv_buffers = (double*)malloc(numFineBoxesRemote*elementSize*sizeof(double));
+    real_t * all_recv_buffers = (real_t*)malloc(numFineBoxesRemote*elementSize*sizeof(real_t));
           if(numFineBoxesRemote*elementSize>0)
           if(all_recv_buffers==NULL){fprintf(stderr,"malloc failed - restriction/all_recv_buffers\n");exit(0);}
-                      memset(all_recv_buffers,0,numFineBoxesRemote*elementSize*sizeof(double)); // DO NOT DELETE... you must initialize to 0 to avoid getting something like 0.0*NaN and corrupting the solve
-    //printf("level=%d, rank=%2d, recv_buffers=%6d\n",level,all_grids->my_rank,numFineBoxesRemote*elementSize*sizeof(double));
+                      memset(all_recv_buffers,0,numFineBoxesRemote*elementSize*sizeof(real_t)); // DO NOT DELETE... you must initialize to 0 to avoid getting something like 0.0*NaN and corrupting the solve
+    all_grids->levels[level]->restriction[restrictionType].buffer_bytes += (uint64_t)numFineBoxesRemote*elementSize*sizeof(real_t);
+    //printf("level=%d, rank=%2d, recv_buffers=%6d\n",level,all_grids->my_rank,numFineBoxesRemote*elementSize*sizeof(real_t));
 
     // for each neighbor, construct the unpack list and allocate the MPI recv buffer... 
     for(neighbor=0;neighbor<numFineRanks;neighbor++){
@@ -785,138 +1006,369 @@ void build_restriction(mg_type *all_grids, int restrictionType){
 
 
 //------------------------------------------------------------------------------------------------------------------------------
-// given a fine grid input, build a hiearchy of MG levels
-// level 0 simply points to fine_grid.  All other levels are created
-// rebuild the restriction/interpolation lists for each coarse grid level
-// rebuild the operator on each coarse grid level
-// add extra vectors to the coarse grid once here instead of on every call to the coarse grid solve
-// NOTE, this routine presumes the fine_grid domain is cubical... fine_grid->dim.i==fine_grid->dim.j==fine_grid->dim.k
-// NOTE, as this function is not timed, it has not been optimzied for performance
-void MGBuild(mg_type *all_grids, level_type *fine_grid, double a, double b, int minCoarseGridDim){
-  int  maxLevels=100; // i.e. maximum problem size is (2^100)^3
+// calculate the structure of every level of the v-cycle MGBuild() will create from a fine grid of (boxes_in_i x boxes_in_j x boxes_in_k) box_dim^3 boxes
+// distributed among num_ranks processes.  plan[0] is the fine grid.  Returns the number of levels (at most maxLevels)
+// NOTE, boxes are cubical, but the fine grid domain may be rectahedral (i.e. boxes_in_i, boxes_in_j, and boxes_in_k may differ).
+//       Every level coarsens all three dimensions by 2 and so preserves the aspect ratio of the fine grid.
+// NOTE, this allocates nothing and so may be used to predict the footprint of a problem (see MGEstimateMemory())
+int MGPlan(mg_plan_type *plan, int maxLevels, int fine_boxes_in_i, int fine_boxes_in_j, int fine_boxes_in_k, int fine_box_dim, int fine_box_ghosts, int num_ranks, int minCoarseGridDim){
   int     nProcs[100];
-  int      dim_i[100];
+  int    dim_min[100]; // smallest of dim.i, dim.j, and dim.k
   int boxes_in_i[100];
+  int boxes_in_j[100];
+  int boxes_in_k[100];
   int    box_dim[100];
   int box_ghosts[100];
-  all_grids->my_rank = fine_grid->my_rank;
-  all_grids->timers.MGBuild = 0;
-  double _timeStartMGBuild = getTime();
+  if(maxLevels>100)maxLevels=100; // i.e. maximum problem size is (2^100)^3
 
   // calculate how deep we can make the v-cycle...
   int level=1;
-                             int coarse_dim = fine_grid->dim.i;
-//if(fine_grid->dim.j<coarse_dim)coarse_dim = fine_grid->dim.j;
-//if(fine_grid->dim.k<coarse_dim)coarse_dim = fine_grid->dim.k;
-  while( (coarse_dim>=2*minCoarseGridDim) && ((coarse_dim&0x1)==0) ){ // grid dimension is even and big enough...
+  int coarse_dim_i = fine_boxes_in_i*fine_box_dim;
+  int coarse_dim_j = fine_boxes_in_j*fine_box_dim;
+  int coarse_dim_k = fine_boxes_in_k*fine_box_dim;
+                             int coarse_dim = coarse_dim_i;
+  if(coarse_dim_j<coarse_dim)coarse_dim = coarse_dim_j;
+  if(coarse_dim_k<coarse_dim)coarse_dim = coarse_dim_k;
+     dim_min[0] = coarse_dim;
+  while( (coarse_dim>=2*minCoarseGridDim) && (((coarse_dim_i|coarse_dim_j|coarse_dim_k)&0x1)==0) ){ // every grid dimension is even and big enough...
     level++;
-    coarse_dim = coarse_dim / 2;
+    coarse_dim   = coarse_dim   / 2;
+    coarse_dim_i = coarse_dim_i / 2;
+    coarse_dim_j = coarse_dim_j / 2;
+    coarse_dim_k = coarse_dim_k / 2;
   }if(level<maxLevels)maxLevels=level;
 
-      nProcs[0] = fine_grid->num_ranks;
-       dim_i[0] = fine_grid->dim.i;
-  boxes_in_i[0] = fine_grid->boxes_in.i;
-     box_dim[0] = fine_grid->box_dim;
-  box_ghosts[0] = fine_grid->box_ghosts;
-
-  // build the list of levels...
-  all_grids->levels = (level_type**)malloc(maxLevels*sizeof(level_type*));
-  if(all_grids->levels == NULL){fprintf(stderr,"malloc failed - MGBuild/all_grids->levels\n");exit(0);}
-  all_grids->num_levels=1;
-  all_grids->levels[0] = fine_grid;
+      nProcs[0] = num_ranks;
+  boxes_in_i[0] = fine_boxes_in_i;
+  boxes_in_j[0] = fine_boxes_in_j;
+  boxes_in_k[0] = fine_boxes_in_k;
+     box_dim[0] = fine_box_dim;
+  box_ghosts[0] = fine_box_ghosts;
+  int num_levels=1;
 
 
   // build a table to guide the construction of the v-cycle...
   int doRestrict=1;if(maxLevels<2)doRestrict=0; // i.e. can't restrict if there is only one level !!!
   #ifdef USE_UCYCLES
   while(doRestrict){
-    level = all_grids->num_levels;
+    level = num_levels;
     doRestrict=0;
     if( (box_dim[level-1] % 2 == 0) ){
           nProcs[level] =     nProcs[level-1];
-           dim_i[level] =      dim_i[level-1]/2;
+         dim_min[level] =    dim_min[level-1]/2;
          box_dim[level] =    box_dim[level-1]/2;
       boxes_in_i[level] = boxes_in_i[level-1];
+      boxes_in_j[level] = boxes_in_j[level-1];
+      boxes_in_k[level] = boxes_in_k[level-1];
       box_ghosts[level] = box_ghosts[level-1];
              doRestrict = 1;
     }
     if(box_dim[level] < box_ghosts[level])doRestrict=0;
-    if(dim_i[level]<minCoarseGridDim)doRestrict=0;
-    if(doRestrict)all_grids->num_levels++;
+    if(dim_min[level]<minCoarseGridDim)doRestrict=0;
+    if(doRestrict)num_levels++;
   }
   #else // TRUE V-Cycle...
   while(doRestrict){
-    level = all_grids->num_levels;
+    level = num_levels;
     doRestrict=0;
     int fine_box_dim    =    box_dim[level-1];
     int fine_nProcs     =     nProcs[level-1];
-    int fine_dim_i      =      dim_i[level-1];
+    int fine_dim_min    =    dim_min[level-1];
     int fine_boxes_in_i = boxes_in_i[level-1];
+    int fine_boxes_in_j = boxes_in_j[level-1];
+    int fine_boxes_in_k = boxes_in_k[level-1];
+    int fine_dim_i      = fine_boxes_in_i*fine_box_dim;
+    int fine_dim_j      = fine_boxes_in_j*fine_box_dim;
+    int fine_dim_k      = fine_boxes_in_k*fine_box_dim;
+    // agglomerating everything leaves boxes of dimension fine_dim_min/2 (i.e. one box on a cubical domain)
+    int domain_is_tiled_by_dim_min = ( (fine_dim_i%fine_dim_min==0) && (fine_dim_j%fine_dim_min==0) && (fine_dim_k%fine_dim_min==0) );
+    int agglomerated_boxes = domain_is_tiled_by_dim_min ? (fine_dim_i/fine_dim_min)*(fine_dim_j/fine_dim_min)*(fine_dim_k/fine_dim_min) : 0;
     if( (fine_box_dim % 2 == 0) && (fine_box_dim > MG_AGGLOMERATION_START) && ((fine_box_dim/2)>=stencil_get_radius()) ){ // Boxes are too big to agglomerate
           nProcs[level] = fine_nProcs;
-           dim_i[level] = fine_dim_i/2;
+         dim_min[level] = fine_dim_min/2;
          box_dim[level] = fine_box_dim/2; // FIX, verify its not less than the stencil radius
       boxes_in_i[level] = fine_boxes_in_i;
+      boxes_in_j[level] = fine_boxes_in_j;
+      boxes_in_k[level] = fine_boxes_in_k;
       box_ghosts[level] = box_ghosts[level-1];
              doRestrict = 1;
     }else
-    if( (fine_boxes_in_i % 2 == 0) && ((fine_box_dim)>=stencil_get_radius()) ){ // 8:1 box agglomeration
+    if( (fine_boxes_in_i % 2 == 0) && (fine_boxes_in_j % 2 == 0) && (fine_boxes_in_k % 2 == 0) && ((fine_box_dim)>=stencil_get_radius()) ){ // 8:1 box agglomeration
           nProcs[level] = fine_nProcs;
-           dim_i[level] = fine_dim_i/2;
+         dim_min[level] = fine_dim_min/2;
          box_dim[level] = fine_box_dim;
       boxes_in_i[level] = fine_boxes_in_i/2;
+      boxes_in_j[level] = fine_boxes_in_j/2;
+      boxes_in_k[level] = fine_boxes_in_k/2;
       box_ghosts[level] = box_ghosts[level-1];
              doRestrict = 1;
     }else
-    if( (coarse_dim != 1) && (fine_dim_i == 2*coarse_dim) && ((fine_dim_i/2)>=stencil_get_radius()) ){ // agglomerate everything
-          nProcs[level] = 1;
-           dim_i[level] = fine_dim_i/2;
-         box_dim[level] = fine_dim_i/2; // FIX, verify its not less than the stencil radius
-      boxes_in_i[level] = 1;
+    if( (coarse_dim != 1) && (fine_dim_min == 2*coarse_dim) && ((fine_dim_min/2)>=stencil_get_radius()) && domain_is_tiled_by_dim_min ){ // agglomerate everything
+          nProcs[level] = agglomerated_boxes<fine_nProcs ? agglomerated_boxes : fine_nProcs;
+         dim_min[level] = fine_dim_min/2;
+         box_dim[level] = fine_dim_min/2; // FIX, verify its not less than the stencil radius
+      boxes_in_i[level] = fine_dim_i/fine_dim_min;
+      boxes_in_j[level] = fine_dim_j/fine_dim_min;
+      boxes_in_k[level] = fine_dim_k/fine_dim_min;
       box_ghosts[level] = box_ghosts[level-1];
              doRestrict = 1;
     }else
-    if( (coarse_dim != 1) && (fine_dim_i == 4*coarse_dim) && ((fine_box_dim/2)>=stencil_get_radius()) ){ // restrict box dimension, and run on fewer ranks
+    if( (coarse_dim != 1) && (fine_dim_min == 4*coarse_dim) && ((fine_box_dim/2)>=stencil_get_radius()) ){ // restrict box dimension, and run on fewer ranks
           nProcs[level] = coarse_dim<fine_nProcs ? coarse_dim : fine_nProcs;
-           dim_i[level] = fine_dim_i/2;
+         dim_min[level] = fine_dim_min/2;
          box_dim[level] = fine_box_dim/2; // FIX, verify its not less than the stencil radius
       boxes_in_i[level] = fine_boxes_in_i;
+      boxes_in_j[level] = fine_boxes_in_j;
+      boxes_in_k[level] = fine_boxes_in_k;
       box_ghosts[level] = box_ghosts[level-1];
              doRestrict = 1;
     }else
-    if( (coarse_dim != 1) && (fine_dim_i == 8*coarse_dim) && ((fine_box_dim/2)>=stencil_get_radius()) ){ // restrict box dimension, and run on fewer ranks
+    if( (coarse_dim != 1) && (fine_dim_min == 8*coarse_dim) && ((fine_box_dim/2)>=stencil_get_radius()) ){ // restrict box dimension, and run on fewer ranks
           nProcs[level] = coarse_dim*coarse_dim<fine_nProcs ? coarse_dim*coarse_dim : fine_nProcs;
-           dim_i[level] = fine_dim_i/2;
+         dim_min[level] = fine_dim_min/2;
          box_dim[level] = fine_box_dim/2; // FIX, verify its not less than the stencil radius
       boxes_in_i[level] = fine_boxes_in_i;
+      boxes_in_j[level] = fine_boxes_in_j;
+      boxes_in_k[level] = fine_boxes_in_k;
       box_ghosts[level] = box_ghosts[level-1];
              doRestrict = 1;
     }else
     if( (fine_box_dim % 2 == 0) && ((fine_box_dim/2)>=stencil_get_radius()) ){ // restrict box dimension, and run on the same number of ranks
           nProcs[level] = fine_nProcs;
-           dim_i[level] = fine_dim_i/2;
+         dim_min[level] = fine_dim_min/2;
          box_dim[level] = fine_box_dim/2; // FIX, verify its not less than the stencil radius
       boxes_in_i[level] = fine_boxes_in_i;
+      boxes_in_j[level] = fine_boxes_in_j;
+      boxes_in_k[level] = fine_boxes_in_k;
       box_ghosts[level] = box_ghosts[level-1];
              doRestrict = 1;
     }
-    if(dim_i[level]<minCoarseGridDim)doRestrict=0;
-    if(doRestrict)all_grids->num_levels++;
+    if(dim_min[level]<minCoarseGridDim)doRestrict=0;
+    if(doRestrict)num_levels++;
   }
   #endif
 
 
-  // now build all the coarsened levels...
+
+  for(level=0;level<num_levels;level++){
+    plan[level].nProcs     =     nProcs[level];
+    plan[level].box_dim    =    box_dim[level];
+    plan[level].box_ghosts = box_ghosts[level];
+    plan[level].boxes_in.i = boxes_in_i[level];
+    plan[level].boxes_in.j = boxes_in_j[level];
+    plan[level].boxes_in.k = boxes_in_k[level];
+  }
+  return(num_levels);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// sort list[n] and return the number of distinct values
+static int count_distinct(int *list, int n){
+  int i,distinct=0;
+  qsort(list,n,sizeof(int),qsortInt);
+  for(i=0;i<n;i++)if( (i==0) || (list[i]!=list[i-1]) )distinct++;
+  return(distinct);
+}
+
+
+// the boxes of process rank on level of the decomposition predicted by MGEstimateMemory()
+#define ESTIMATE_MY_BOXES(level,rank)     (box_of_rank[level]+first_box_of_rank[level][rank])
+#define ESTIMATE_NUM_MY_BOXES(level,rank) (first_box_of_rank[level][(rank)+1]-first_box_of_rank[level][rank])
+
+// analytically estimate the restriction[4] and interpolation lists and MPI buffers of process rank on level (see build_restriction() and build_interpolation())
+// These span level and its neighbors and thus depend on the decomposition of all three (rank_of_box[]).  They are added to bytes[MEMORY_BLOCKS/BUFFERS]
+static void estimate_intergrid_memory(mg_plan_type *plan, int num_levels, int level, int **rank_of_box, int **box_of_rank, int **first_box_of_rank, int rank, uint64_t *bytes){
+  int t,b,n,f,c;
+  const int *my_boxes = ESTIMATE_MY_BOXES(level,rank);
+  int    num_my_boxes = ESTIMATE_NUM_MY_BOXES(level,rank);
+  uint64_t blocks[5][3] = {{0}}; // restriction[0..3] and interpolation (pack, local, unpack)
+  uint64_t buffer_bytes = 0;
+  int num_messages = 0;
+  int children = 1; // fine boxes per coarse box
+  if(level>0)children = (plan[level-1].boxes_in.i/plan[level].boxes_in.i)*(plan[level-1].boxes_in.j/plan[level].boxes_in.j)*(plan[level-1].boxes_in.k/plan[level].boxes_in.k);
+  int *ranks = (int*)malloc(((uint64_t)num_my_boxes*children+1)*sizeof(int));
+  if(ranks==NULL){fprintf(stderr,"malloc failed - estimate_intergrid_memory\n");exit(0);}
+
+  // restriction to level+1 (pack and local) and interpolation from level+1 (unpack)...
+  if(level<num_levels-1){
+    mg_plan_type *fine = &plan[level],*coarse = &plan[level+1];
+    int rdim[4][3] = {{fine->box_dim/2,fine->box_dim/2,fine->box_dim/2},{fine->box_dim/2+1,fine->box_dim/2,fine->box_dim/2},
+                      {fine->box_dim/2,fine->box_dim/2+1,fine->box_dim/2},{fine->box_dim/2,fine->box_dim/2,fine->box_dim/2+1}};
+    for(t=0;t<=4;t++){
+      for(n=0,b=0;b<num_my_boxes;b++){
+        f = my_boxes[b];
+        c =  (( f %  fine->boxes_in.i                                   )*coarse->boxes_in.i/fine->boxes_in.i)
+          +  (((f /  fine->boxes_in.i                 ) % fine->boxes_in.j)*coarse->boxes_in.j/fine->boxes_in.j)*coarse->boxes_in.i
+          +  (( f / (fine->boxes_in.i*fine->boxes_in.j)                    )*coarse->boxes_in.k/fine->boxes_in.k)*coarse->boxes_in.i*coarse->boxes_in.j;
+        int remote = (rank_of_box[level+1][c]!=rank);
+        if(remote)ranks[n++] = rank_of_box[level+1][c];
+        if(t<4){ // n.b. the restriction send buffer has room for every coarse box (including local ones)
+          buffer_bytes += (uint64_t)rdim[t][0]*rdim[t][1]*rdim[t][2]*sizeof(real_t);
+          blocks[t][remote ? 0 : 1] += count_tiles(rdim[t][0],rdim[t][1],rdim[t][2],BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K);
+        }else if(remote){
+          buffer_bytes += (uint64_t)fine->box_dim*fine->box_dim*fine->box_dim*sizeof(real_t);
+          blocks[t][2] += count_tiles(fine->box_dim,fine->box_dim,fine->box_dim,BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K);
+        }
+      }
+      num_messages += count_distinct(ranks,n);
+    }
+  }
+
+  // restriction from level-1 (unpack) and interpolation to level-1 (pack and local)...
+  if(level>0){
+    mg_plan_type *fine = &plan[level-1],*coarse = &plan[level];
+    int ri = fine->boxes_in.i/coarse->boxes_in.i;
+    int rj = fine->boxes_in.j/coarse->boxes_in.j;
+    int rk = fine->boxes_in.k/coarse->boxes_in.k;
+    int rdim[4][3] = {{fine->box_dim/2,fine->box_dim/2,fine->box_dim/2},{fine->box_dim/2+1,fine->box_dim/2,fine->box_dim/2},
+                      {fine->box_dim/2,fine->box_dim/2+1,fine->box_dim/2},{fine->box_dim/2,fine->box_dim/2,fine->box_dim/2+1}};
+    for(t=0;t<=4;t++){
+      for(n=0,b=0;b<num_my_boxes;b++){
+        c = my_boxes[b];
+        int ci = c%coarse->boxes_in.i,cj = (c/coarse->boxes_in.i)%coarse->boxes_in.j,ck = c/(coarse->boxes_in.i*coarse->boxes_in.j);
+        int bi,bj,bk;
+        for(bk=0;bk<rk;bk++){
+        for(bj=0;bj<rj;bj++){
+        for(bi=0;bi<ri;bi++){
+          f = (ri*ci+bi) + (rj*cj+bj)*fine->boxes_in.i + (rk*ck+bk)*fine->boxes_in.i*fine->boxes_in.j;
+          int remote = (rank_of_box[level-1][f]!=rank);
+          if(remote)ranks[n++] = rank_of_box[level-1][f];
+          if(t<4){
+            if(remote){
+              buffer_bytes += (uint64_t)rdim[t][0]*rdim[t][1]*rdim[t][2]*sizeof(real_t);
+              blocks[t][2] += count_tiles(rdim[t][0],rdim[t][1],rdim[t][2],BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K);
+            }
+          }else{
+            if(remote)buffer_bytes += (uint64_t)fine->box_dim*fine->box_dim*fine->box_dim*sizeof(real_t);
+            blocks[t][remote ? 0 : 1] += count_tiles(fine->box_dim/2,fine->box_dim/2,fine->box_dim/2,BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K);
+          }
+        }}}
+      }
+      num_messages += count_distinct(ranks,n);
+    }
+  }
+  free(ranks);
+
+  for(t=0;t<=4;t++)bytes[MEMORY_BLOCKS] += block_list_bytes(blocks[t][0]) + block_list_bytes(blocks[t][1]) + block_list_bytes(blocks[t][2]);
+  bytes[MEMORY_BUFFERS] += buffer_bytes + communicator_message_bytes(num_messages);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// analytically estimate the memory MGBuild() would allocate for the hierarchy described by plan (see MGPlan()) with numVectors vectors on every level
+// (the bottom level also reserves space for the largest bottom solver as MGBuild() does).  Each level is decomposed as create_level() would and the
+// lists and buffers of every process are counted.  As MGMeasureMemory() reports, the estimate for each level is the sum over categories of the largest
+// value of that category on any process (assuming -exchange p2p and the default blocking).  If level_bytes is not NULL, level_bytes[l] receives the estimate for level l.
+uint64_t MGEstimateMemory(mg_plan_type *plan, int num_levels, int numVectors, int domain_boundary_condition, uint64_t *level_bytes){
+  int level,s,r,b,c;
+  int bottomVectors = 0;
+  for(s=0;s<num_bottom_solvers;s++)if(bottom_solvers[s].num_vectors>bottomVectors)bottomVectors=bottom_solvers[s].num_vectors;
+
+  // decompose every level and bucket its boxes by rank...
+  int *rank_of_box[100],*box_of_rank[100],*first_box_of_rank[100];
+  for(level=0;level<num_levels;level++){
+    int boxes = plan[level].boxes_in.i*plan[level].boxes_in.j*plan[level].boxes_in.k;
+          rank_of_box[level] = (int*)malloc( boxes                 *sizeof(int));
+          box_of_rank[level] = (int*)malloc( boxes                 *sizeof(int));
+    first_box_of_rank[level] = (int*)calloc((plan[level].nProcs+1),sizeof(int));
+    if( (rank_of_box[level]==NULL) || (box_of_rank[level]==NULL) || (first_box_of_rank[level]==NULL) ){fprintf(stderr,"malloc failed - MGEstimateMemory\n");exit(0);}
+    decompose_level(rank_of_box[level],plan[level].boxes_in.i,plan[level].boxes_in.j,plan[level].boxes_in.k,plan[level].nProcs,0);
+    for(b=0;b<boxes;b++)if(rank_of_box[level][b]>=0)first_box_of_rank[level][rank_of_box[level][b]+1]++;
+    for(r=0;r<plan[level].nProcs;r++)first_box_of_rank[level][r+1]+=first_box_of_rank[level][r];
+    int *next = (int*)malloc(plan[level].nProcs*sizeof(int));
+    if(next==NULL){fprintf(stderr,"malloc failed - MGEstimateMemory\n");exit(0);}
+    for(r=0;r<plan[level].nProcs;r++)next[r]=first_box_of_rank[level][r];
+    for(b=0;b<boxes;b++)if(rank_of_box[level][b]>=0)box_of_rank[level][next[rank_of_box[level][b]]++]=b; // ascending global_box_id as in create_boxes()
+    free(next);
+  }
+
+  uint64_t total = 0;
+  for(level=0;level<num_levels;level++){
+    uint64_t max_bytes[MEMORY_CATEGORIES] = {0};
+    for(r=0;r<plan[level].nProcs;r++){
+      uint64_t bytes[MEMORY_CATEGORIES];
+      estimate_level_memory(plan[level].boxes_in.i,plan[level].boxes_in.j,plan[level].boxes_in.k,plan[level].box_dim,plan[level].box_ghosts,domain_boundary_condition,
+                            rank_of_box[level],r,ESTIMATE_MY_BOXES(level,r),ESTIMATE_NUM_MY_BOXES(level,r),(level==num_levels-1) ? numVectors+bottomVectors : numVectors,bytes);
+      estimate_intergrid_memory(plan,num_levels,level,rank_of_box,box_of_rank,first_box_of_rank,r,bytes);
+      for(c=0;c<MEMORY_CATEGORIES;c++)if(bytes[c]>max_bytes[c])max_bytes[c]=bytes[c];
+    }
+    uint64_t bytes = 0;
+    for(c=0;c<MEMORY_CATEGORIES;c++)bytes+=max_bytes[c];
+    if(level_bytes)level_bytes[level]=bytes;
+    total += bytes;
+  }
+
+  for(level=0;level<num_levels;level++){
+    free(rank_of_box[level]);
+    free(box_of_rank[level]);
+    free(first_box_of_rank[level]);
+  }
+  return(total);
+}
+#undef ESTIMATE_MY_BOXES
+#undef ESTIMATE_NUM_MY_BOXES
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// given a fine grid input, build a hiearchy of MG levels
+// level 0 simply points to fine_grid.  All other levels are created (see MGPlan())
+// rebuild the restriction/interpolation lists for each coarse grid level
+// rebuild the operator on each coarse grid level
+// add extra vectors to the coarse grid once here instead of on every call to the coarse grid solve
+// NOTE, as this function is not timed, it has not been optimzied for performance
+void MGBuild(mg_type *all_grids, level_type *fine_grid, double a, double b, int minCoarseGridDim){
+  int level;
+  mg_plan_type plan[100];
+  all_grids->my_rank = fine_grid->my_rank;
+  all_grids->timers.MGBuild = 0;
+  all_grids->high_water_mark = 0;
+  double _timeStartMGBuild = getTime();
+
+  // build the list of levels...
+  int num_levels = MGPlan(plan,100,fine_grid->boxes_in.i,fine_grid->boxes_in.j,fine_grid->boxes_in.k,fine_grid->box_dim,fine_grid->box_ghosts,fine_grid->num_ranks,minCoarseGridDim);
+  all_grids->levels = (level_type**)malloc(num_levels*sizeof(level_type*));
+  if(all_grids->levels == NULL){fprintf(stderr,"malloc failed - MGBuild/all_grids->levels\n");exit(0);}
+  all_grids->num_levels=num_levels;
+  all_grids->levels[0] = fine_grid;
+
+
+  // now build all the coarsened levels... their vectors are allocated below (once the number of boxes each process owns on every level is known)
   for(level=1;level<all_grids->num_levels;level++){
     all_grids->levels[level] = (level_type*)malloc(sizeof(level_type));
     if(all_grids->levels[level] == NULL){fprintf(stderr,"malloc failed - MGBuild/doRestrict\n");exit(0);}
-    create_level(all_grids->levels[level],boxes_in_i[level],box_dim[level],box_ghosts[level],all_grids->levels[level-1]->numVectors,all_grids->levels[level-1]->boundary_condition.type,all_grids->levels[level-1]->my_rank,nProcs[level]);
+    create_level(all_grids->levels[level],plan[level].boxes_in.i,plan[level].boxes_in.j,plan[level].boxes_in.k,plan[level].box_dim,plan[level].box_ghosts,0,all_grids->levels[level-1]->boundary_condition.type,all_grids->levels[level-1]->my_rank,plan[level].nProcs);
     all_grids->levels[level]->h = 2.0*all_grids->levels[level-1]->h;
   }
 
 
-  // bottom solver (level = all_grids->num_levels-1) gets extra vectors...
-  create_vectors(all_grids->levels[all_grids->num_levels-1],all_grids->levels[all_grids->num_levels-1]->numVectors + IterativeSolver_NumVectors() );
+  // coarsened levels have as many vectors as the fine grid.  The bottom solver (level = all_grids->num_levels-1) gets extra vectors.
+  // As the bottom solver may be changed after MGBuild (e.g. MGAutotune), reserve enough for any of them rather than growing (copying) later.
+  int s,numVectors[100] = {0};
+  int bottomVectors = 0;
+  for(s=0;s<num_bottom_solvers;s++)if(bottom_solvers[s].num_vectors>bottomVectors)bottomVectors=bottom_solvers[s].num_vectors;
+  for(level=0;level<all_grids->num_levels;level++){
+    if(level==all_grids->num_levels-1)numVectors[level] = fine_grid->numVectors + bottomVectors; // bottom level
+                                 else numVectors[level] = fine_grid->numVectors;
+  }
+
+
+  // allocate the vectors of all coarsened levels from a single arena...
+  uint64_t arena_size = 0;
+  for(level=1;level<all_grids->num_levels;level++)arena_size += vectors_arena_bytes(all_grids->levels[level],numVectors[level]);
+  if(exchange_method==EXCHANGE_SHM)arena_size=0; // the vectors of each level are carved from its own shared window instead (see create_vectors())
+  if(all_grids->my_rank==0){fprintf(stdout,"\n  Allocating vectors for %d coarse levels (%0.3f MB on process 0)... ",all_grids->num_levels-1,arena_size/1048576.0);fflush(stdout);}
+  create_arena(&all_grids->arena,arena_size);
+  for(level=1;level<all_grids->num_levels;level++){
+    all_grids->levels[level]->arena = &all_grids->arena;
+    create_vectors(all_grids->levels[level],numVectors[level]);
+  }
+  create_vectors(all_grids->levels[0],numVectors[0]); // only grows the fine grid if it is also the bottom level
+  if(all_grids->my_rank==0){fprintf(stdout,"done\n");fflush(stdout);}
+  for(level=1;level<all_grids->num_levels;level++){
+    double locality = numa_locality(all_grids->levels[level]);
+    if((all_grids->my_rank==0)&&(locality>=0.0)){fprintf(stdout,"  NUMA locality (level %d)... %5.1f%% of pages are on the node of the thread that owns them\n",level,100.0*locality);fflush(stdout);}
+  }
 
 
   // build the restriction and interpolation communicators...
@@ -970,6 +1422,191 @@ void MGBuild(mg_type *all_grids, level_type *fine_grid, double a, double b, int
 }
 
 
+//------------------------------------------------------------------------------------------------------------------------------
+// autotune the hierarchy from the bottom up so that every level is measured with the choices already made for the coarser ones.
+// on each level, time every registered smoother with a handful of candidate tilings and keep the fastest tiling for that smoother.
+// as a cheap smoother may be a weak one, smoothers are then compared by the time the v-cycle from that level takes to reduce the residual
+// (i.e. time per cycle over the log of the reduction per cycle) rather than by the time per smooth.
+// then time every registered residual/apply_op implementation (op_kernels[]) with the chosen tiling and keep the fastest.
+// on the bottom level, the smoother is only used by the 'smooth' bottom solver so every bottom solver (and, for 'smooth', every smoother)
+// is instead timed to the bottom solver's tolerance.
+// Timings are max-reduced across MPI_COMM_WORLD so that every process makes the same choice.
+// note, this clobbers VECTOR_E, VECTOR_F_MINUS_AV, and VECTOR_TEMP and resets the level timers
+static double MGAutotune_MaxTime(double time){
+  #ifdef USE_MPI
+  double send = time;
+  MPI_Allreduce(&send,&time,1,MPI_DOUBLE,MPI_MAX,MPI_COMM_WORLD);
+  #endif
+  return(time);
+}
+
+// seconds per e-fold reduction of the residual of Ae=0 (from a random e) by v-cycles starting on this level
+static double MGAutotune_VCycles(mg_type *all_grids, int level, double a, double b){
+  level_type *L = all_grids->levels[level];
+  if(!L->active)return(MGAutotune_MaxTime(0.0)); // no boxes on this level... defer to the processes that have them
+  random_vector(L,VECTOR_E);
+  if(L->must_subtract_mean==1){double mean_of_e = mean(L,VECTOR_E);shift_vector(L,VECTOR_E,VECTOR_E,-mean_of_e);}
+  zero_vector(L,VECTOR_F_MINUS_AV);
+  MGVCycle(all_grids,VECTOR_E,VECTOR_F_MINUS_AV,a,b,level); // warm up (and damp the highest frequencies of the random initial error)
+  residual(L,VECTOR_TEMP,VECTOR_E,VECTOR_F_MINUS_AV,a,b);
+  double norm_of_r0 = norm(L,VECTOR_TEMP);
+  double _timeStart = getTime();
+  int trial;for(trial=0;trial<MG_AUTOTUNE_TRIALS;trial++){
+    MGVCycle(all_grids,VECTOR_E,VECTOR_F_MINUS_AV,a,b,level);
+  }
+  double time = (getTime()-_timeStart)/MG_AUTOTUNE_TRIALS;
+  residual(L,VECTOR_TEMP,VECTOR_E,VECTOR_F_MINUS_AV,a,b);
+  double norm_of_r = norm(L,VECTOR_TEMP);
+  double rate = pow(norm_of_r/norm_of_r0,1.0/MG_AUTOTUNE_TRIALS); // average reduction per v-cycle
+  if(norm_of_r0==0.0)rate=0.0;
+  if(!(rate<1.0))return(MGAutotune_MaxTime(1e30)); // stalled or diverged
+  if(rate==0.0)return(MGAutotune_MaxTime(time));
+  return(MGAutotune_MaxTime(time/-log(rate)));
+}
+
+// seconds per bottom solve (to MG_DEFAULT_BOTTOM_NORM) with the current bottom solver and smoother
+static double MGAutotune_BottomSolve(level_type *bottom, double a, double b){
+  random_vector(bottom,VECTOR_F_MINUS_AV);
+  if(bottom->must_subtract_mean==1){double mean_of_r = mean(bottom,VECTOR_F_MINUS_AV);shift_vector(bottom,VECTOR_F_MINUS_AV,VECTOR_F_MINUS_AV,-mean_of_r);}
+  double _timeStart = getTime();
+  int trial;for(trial=0;trial<MG_AUTOTUNE_TRIALS;trial++){
+    zero_vector(bottom,VECTOR_E);
+    IterativeSolver(bottom,VECTOR_E,VECTOR_F_MINUS_AV,a,b,MG_DEFAULT_BOTTOM_NORM);
+  }
+  return(MGAutotune_MaxTime( (getTime()-_timeStart)/MG_AUTOTUNE_TRIALS ));
+}
+
+void MGAutotune(mg_type *all_grids, double a, double b){
+  int level,s,t,tt;
+  double _timeStartAutotune = getTime();
+  int tiles[][3] = { // candidate tilings (i x j x k)... the first is the compile time default
+    {BLOCKCOPY_TILE_I,BLOCKCOPY_TILE_J,BLOCKCOPY_TILE_K},
+    {           10000,               4,               4},
+    {           10000,               8,               8},
+    {           10000,              16,              16},
+    {           10000,              32,              32},
+    {           10000,           10000,           10000}, // i.e. one block per box
+  };
+  int num_tiles = sizeof(tiles)/sizeof(tiles[0]);
+  int    *smoother_tile = (int   *)malloc(num_smoothers*sizeof(int   ));
+  double *smoother_time = (double*)malloc(num_smoothers*sizeof(double));
+  if( (smoother_tile==NULL) || (smoother_time==NULL) ){fprintf(stderr,"malloc failed - MGAutotune\n");exit(0);}
+
+  if(all_grids->my_rank==0){fprintf(stdout,"\n");}
+  for(level=all_grids->num_levels-1;level>=0;level--){
+    level_type *L = all_grids->levels[level];
+    int is_bottom = (level==all_grids->num_levels-1);
+    if(all_grids->my_rank==0){fprintf(stdout,"  Autotuning level %d... ",level);fflush(stdout);}
+    int first_smoother = is_bottom ? L->smoother   : 0;             // the bottom level's smoother is chosen with the bottom solver
+    int  last_smoother = is_bottom ? L->smoother+1 : num_smoothers;
+    for(s=first_smoother;s<last_smoother;s++){smoother_tile[s]=0;smoother_time[s]=1e30;}
+    for(t=0;t<num_tiles;t++){
+      // skip tilings that are equivalent to one already tried once clamped to the box dimension...
+      int duplicate=0;
+      for(tt=0;tt<t;tt++){
+        int d,same=1;
+        for(d=0;d<3;d++){
+          int tile_tt = (tiles[tt][d]<L->box_dim) ? tiles[tt][d] : L->box_dim;
+          int tile_t  = (tiles[t ][d]<L->box_dim) ? tiles[t ][d] : L->box_dim;
+          if(tile_tt!=tile_t)same=0;
+        }
+        if(same)duplicate=1;
+      }
+      if(duplicate)continue;
+      build_my_blocks(L,tiles[t][0],tiles[t][1],tiles[t][2]);
+      for(s=first_smoother;s<last_smoother;s++){
+        L->smoother = s;
+        random_vector(L,VECTOR_E);
+        zero_vector(L,VECTOR_F_MINUS_AV);
+        smooth(L,VECTOR_E,VECTOR_F_MINUS_AV,a,b); // warm up
+        double _timeStart = getTime();
+        int trial;for(trial=0;trial<MG_AUTOTUNE_TRIALS;trial++){
+          smooth(L,VECTOR_E,VECTOR_F_MINUS_AV,a,b);
+        }
+        double time = MGAutotune_MaxTime( (getTime()-_timeStart)/MG_AUTOTUNE_TRIALS );
+        if(time<smoother_time[s]){smoother_time[s]=time;smoother_tile[s]=t;}
+      }
+    }
+
+    // compare the smoothers (each with its fastest tiling) by the time the v-cycle takes to reduce the residual...
+    int best_smoother = first_smoother;
+    double best_vcycle_time = 1e30;
+    if(!is_bottom){
+      for(s=0;s<num_smoothers;s++){
+        L->smoother = s;
+        build_my_blocks(L,tiles[smoother_tile[s]][0],tiles[smoother_tile[s]][1],tiles[smoother_tile[s]][2]);
+        double time = MGAutotune_VCycles(all_grids,level,a,b);
+        if(time<best_vcycle_time){best_vcycle_time=time;best_smoother=s;}
+      }
+    }
+    L->smoother = best_smoother;
+    build_my_blocks(L,tiles[smoother_tile[best_smoother]][0],tiles[smoother_tile[best_smoother]][1],tiles[smoother_tile[best_smoother]][2]);
+
+    // with the chosen tiling, time every registered residual/apply_op implementation (e.g. hand vectorized) against the generic one...
+    int best_kernels = L->op_kernels;
+    double best_residual_time = 1e30;
+    double generic_residual_time = 0.0;
+    for(s=0;s<num_op_kernels;s++){
+      L->op_kernels = s;
+      random_vector(L,VECTOR_E);
+      random_vector(L,VECTOR_F_MINUS_AV);
+      residual(L,VECTOR_TEMP,VECTOR_E,VECTOR_F_MINUS_AV,a,b); // warm up
+      double _timeStart = getTime();
+      int trial;for(trial=0;trial<MG_AUTOTUNE_TRIALS;trial++){
+        residual(L,VECTOR_TEMP,VECTOR_E,VECTOR_F_MINUS_AV,a,b);
+      }
+      double time = MGAutotune_MaxTime( (getTime()-_timeStart)/MG_AUTOTUNE_TRIALS );
+      if(s==0)generic_residual_time=time;
+      if(time<best_residual_time){best_residual_time=time;best_kernels=s;}
+    }
+    L->op_kernels = best_kernels;
+
+    // bottom solver (and, for the 'smooth' bottom solver, the smoother... any smoother uses the tiling chosen above)...
+    // n.b. MGBuild allocated enough vectors on the bottom level for any bottom solver
+    int best_solver = L->bottom_solver;
+    double best_bottom_time = 1e30;
+    if(is_bottom){
+      for(s=0;s<num_bottom_solvers;s++){
+        L->bottom_solver = s;
+        if(bottom_solvers[s].solve==SmoothSolver){
+          for(t=0;t<num_smoothers;t++){
+            L->smoother = t;
+            double time = MGAutotune_BottomSolve(L,a,b);
+            if(time<best_bottom_time){best_bottom_time=time;best_solver=s;best_smoother=t;}
+          }
+          L->smoother = first_smoother;
+        }else{
+          double time = MGAutotune_BottomSolve(L,a,b);
+          if(time<best_bottom_time){best_bottom_time=time;best_solver=s;best_smoother=first_smoother;}
+        }
+      }
+      L->bottom_solver = best_solver;
+      L->smoother      = best_smoother;
+    }
+
+    if(all_grids->my_rank==0){
+      fprintf(stdout,"smoother=%s, blocking=%dx%dx%d",smoothers[L->smoother].name,
+                     (L->blocking.i<L->box_dim) ? L->blocking.i : L->box_dim,
+                     (L->blocking.j<L->box_dim) ? L->blocking.j : L->box_dim,
+                     (L->blocking.k<L->box_dim) ? L->blocking.k : L->box_dim);
+      if(!is_bottom)fprintf(stdout," (%0.6f seconds per smooth, %0.6f seconds per e-fold reduction)",smoother_time[L->smoother],best_vcycle_time);
+      fprintf(stdout,", kernels=%s (%0.6f seconds per residual; generic=%0.6f)",op_kernels[L->op_kernels].name,best_residual_time,generic_residual_time);
+      if( is_bottom)fprintf(stdout,", bottom solver=%s (%0.6f seconds per solve)",bottom_solvers[L->bottom_solver].name,best_bottom_time);
+      fprintf(stdout,"\n");fflush(stdout);
+    }
+  }
+  free(smoother_tile);
+  free(smoother_time);
+
+  for(level=0;level<all_grids->num_levels;level++){
+    reset_level_timers(all_grids->levels[level]);
+    all_grids->levels[level]->Krylov_iterations        = 0;
+    all_grids->levels[level]->CAKrylov_formations_of_G = 0;
+  }
+  all_grids->timers.MGBuild += (double)(getTime()-_timeStartAutotune);
+}
+
+
 //------------------------------------------------------------------------------------------------------------------------------
 // deallocate all memory created in the MG hierarchy
 // WARNING, this will free the fine_grid level as well (FIX?)
@@ -1033,13 +1670,18 @@ void MGDestroy(mg_type *all_grids){
   for(level=all_grids->num_levels-1;level>0;level--){
     destroy_level(all_grids->levels[level]);
   }
+  // all of their vectors are released at once...
+  destroy_arena(&all_grids->arena);
   if(all_grids->levels)free(all_grids->levels);
+  // the split-phase reductions' MPI datatypes and op are shared by all levels...
+  dots_destroy();
 }
 
 
 //------------------------------------------------------------------------------------------------------------------------------
 // perform a richardson error analysis to infer the order of the operator/solver
-void richardson_error(mg_type *all_grids, int levelh, int u_id){
+// the estimated error and order are also returned in *error and *order (if not NULL)
+void richardson_error(mg_type *all_grids, int levelh, int u_id, double *error, double *order){
   // in FV...
   // +-------+   +---+---+   +-------+   +-------+
   // |       |   | a | b |   |       |   |a+b+c+d|
@@ -1057,6 +1699,8 @@ void richardson_error(mg_type *all_grids, int levelh, int u_id){
   if(all_grids->my_rank==0){fprintf(stdout,"  h=%0.15e  ||error||=%0.15e\n",all_grids->levels[levelh]->h,norm_of_u2h_minus_uh);fflush(stdout);}
   // log( ||u^4h - R u^2h|| / ||u^2h - R u^h|| ) / log(2) is an estimate of the order of the method (e.g. 4th order)
   if(all_grids->my_rank==0){fprintf(stdout,"  order=%0.3f\n",log(norm_of_u4h_minus_u2h / norm_of_u2h_minus_uh) / log(2) );fflush(stdout);}
+  if(error)*error = norm_of_u2h_minus_uh;
+  if(order)*order = log(norm_of_u4h_minus_u2h / norm_of_u2h_minus_uh) / log(2);
 }
 
 
@@ -1075,10 +1719,9 @@ void MGVCycle(mg_type *all_grids, int e_id, int R_id, double a, double b, int le
 
   // down...
   _LevelStart = getTime();
-       smooth(all_grids->levels[level  ],e_id,R_id,a,b);
-     residual(all_grids->levels[level  ],VECTOR_TEMP,e_id,R_id,a,b);
-  restriction(all_grids->levels[level+1],R_id,all_grids->levels[level],VECTOR_TEMP,RESTRICT_CELL);
-  zero_vector(all_grids->levels[level+1],e_id);
+                smooth(all_grids->levels[level  ],e_id,R_id,a,b);
+  residual_restriction(all_grids->levels[level+1],R_id,all_grids->levels[level],e_id,R_id,a,b); // fused residual+restriction (no fine grid residual)
+           zero_vector(all_grids->levels[level+1],e_id);
   all_grids->levels[level]->timers.Total += (double)(getTime()-_LevelStart);
 
   // recursion...
@@ -1086,8 +1729,7 @@ void MGVCycle(mg_type *all_grids, int e_id, int R_id, double a, double b, int le
 
   // up...
   _LevelStart = getTime();
-  interpolation_vcycle(all_grids->levels[level  ],e_id,1.0,all_grids->levels[level+1],e_id);
-                smooth(all_grids->levels[level  ],e_id,R_id,a,b);
+  interpolation_smooth(all_grids->levels[level  ],e_id,all_grids->levels[level+1],e_id,R_id,a,b); // e_f += P*e_c, then smooth
 
   all_grids->levels[level]->timers.Total += (double)(getTime()-_LevelStart);
 }
@@ -1099,7 +1741,11 @@ void MGSolve(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, doub
   all_grids->MGSolves_performed++;
   if(!all_grids->levels[onLevel]->active)return;
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+  #ifdef USE_MIXED_PRECISION
+  int e_id = VECTOR_E; // iterative refinement... solve for a correction and accumulate it into u=(u_id,VECTOR_U_LO)
+  #else
   int e_id = u_id; // __u FIX
+  #endif
   int R_id = VECTOR_F_MINUS_AV;
   int v;
   int maxVCycles = 20;
@@ -1122,6 +1768,11 @@ void MGSolve(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, doub
   // make initial guess for e (=0) and setup the RHS
    zero_vector(all_grids->levels[onLevel],e_id);                  // ee = 0
   scale_vector(all_grids->levels[onLevel],R_id,1.0,F_id);         // R_id = F_id
+  #ifdef USE_MIXED_PRECISION
+   zero_vector(all_grids->levels[onLevel],u_id);                  // u = 0
+   zero_vector(all_grids->levels[onLevel],VECTOR_U_LO);
+  double rel_of_residual = 1.0;
+  #endif
 
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
   // now do v-cycles to calculate the correction...
@@ -1130,6 +1781,9 @@ void MGSolve(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, doub
     all_grids->levels[level]->vcycles_from_this_level++;
 
     // do the v-cycle...
+    #ifdef USE_MIXED_PRECISION
+    if(v>0)zero_vector(all_grids->levels[level],e_id);
+    #endif
     MGVCycle(all_grids,e_id,R_id,a,b,level);
 
     // now calculate the norm of the residual...
@@ -1138,8 +1792,18 @@ void MGSolve(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, doub
       double average_value_of_e = mean(all_grids->levels[level],e_id);
       shift_vector(all_grids->levels[level],e_id,e_id,-average_value_of_e);
     }
+    #ifdef USE_MIXED_PRECISION
+    // u += e... u_id absorbs the correction until it is as accurate as single precision will allow.  Thereafter, u_id is frozen 
+    // and corrections accumulate in VECTOR_U_LO (were u_id to continue changing, so too would the rounding of its boundary conditions)
+    if(rel_of_residual > MG_MIXED_PRECISION_RTOL)add_vectors(all_grids->levels[level],u_id,1.0,u_id,1.0,e_id);
+                                            else add_vectors(all_grids->levels[level],VECTOR_U_LO,1.0,VECTOR_U_LO,1.0,e_id);
+    residual_pair(all_grids->levels[level],R_id,u_id,VECTOR_U_LO,F_id,a,b);  // R = F-A(u+u_lo) calculated in double
+    double norm_of_residual = norm(all_grids->levels[level],R_id);
+    rel_of_residual = norm_of_residual/norm_of_F;
+    #else
     residual(all_grids->levels[level],VECTOR_TEMP,e_id,F_id,a,b);
     double norm_of_residual = norm(all_grids->levels[level],VECTOR_TEMP);
+    #endif
     double _timeNorm = getTime();
     all_grids->levels[level]->timers.Total += (double)(_timeNorm-_timeStart);
     if(all_grids->levels[level]->my_rank==0){
@@ -1149,6 +1813,9 @@ void MGSolve(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, doub
     }
     if(norm_of_residual/norm_of_F < rtol)break;
   } // maxVCycles
+  #ifdef USE_MIXED_PRECISION
+  add_vectors(all_grids->levels[onLevel],u_id,1.0,u_id,1.0,VECTOR_U_LO); // fold the trailing part back into the solution
+  #endif
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
   all_grids->timers.MGSolve += (double)(getTime()-_timeStartMGSolve);
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -1232,23 +1899,46 @@ void FMGSolve(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, dou
 
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
   // now do the post-F V-cycles
+  #ifdef USE_MIXED_PRECISION
+  double rel_of_residual = 1.0;
+  #endif
   for(v=-1;v<maxVCycles;v++){
     int level = onLevel;
 
+    #ifdef USE_MIXED_PRECISION
+    // after the f-cycle, switch to iterative refinement... each v-cycle solves for a correction (c_id) to u=(u_id,VECTOR_U_LO)
+    int c_id = (v>=0) ? VECTOR_E : e_id;
+    if(v<0)zero_vector(all_grids->levels[level],VECTOR_U_LO);
+       else{zero_vector(all_grids->levels[level],c_id);}
+    #else
+    int c_id = e_id;
+    #endif
+
     // do the v-cycle...
     if(v>=0){
     all_grids->levels[level]->vcycles_from_this_level++;
-    MGVCycle(all_grids,e_id,R_id,a,b,level);
+    MGVCycle(all_grids,c_id,R_id,a,b,level);
     }
 
     // now calculate the norm of the residual...
     double _timeStart = getTime();
     if(all_grids->levels[level]->must_subtract_mean == 1){
-      double average_value_of_e = mean(all_grids->levels[level],e_id);
-      shift_vector(all_grids->levels[level],e_id,e_id,-average_value_of_e);
+      double average_value_of_e = mean(all_grids->levels[level],c_id);
+      shift_vector(all_grids->levels[level],c_id,c_id,-average_value_of_e);
+    }
+    #ifdef USE_MIXED_PRECISION
+    // u += c... as in MGSolve, u_id is frozen once it is as accurate as single precision will allow
+    if(v>=0){
+      if(rel_of_residual > MG_MIXED_PRECISION_RTOL)add_vectors(all_grids->levels[level],e_id,1.0,e_id,1.0,c_id);
+                                              else add_vectors(all_grids->levels[level],VECTOR_U_LO,1.0,VECTOR_U_LO,1.0,c_id);
     }
+    residual_pair(all_grids->levels[level],R_id,e_id,VECTOR_U_LO,F_id,a,b);  // R = F-A(u+u_lo) calculated in double
+    double norm_of_residual = norm(all_grids->levels[level],R_id);
+    rel_of_residual = norm_of_residual/norm_of_F;
+    #else
     residual(all_grids->levels[level],VECTOR_TEMP,e_id,F_id,a,b);
     double norm_of_residual = norm(all_grids->levels[level],VECTOR_TEMP);
+    #endif
     double _timeNorm = getTime();
     all_grids->levels[level]->timers.Total += (double)(_timeNorm-_timeStart);
     if(all_grids->levels[level]->my_rank==0){
@@ -1260,6 +1950,9 @@ void FMGSolve(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, dou
   }
 
 
+  #ifdef USE_MIXED_PRECISION
+  add_vectors(all_grids->levels[onLevel],u_id,1.0,u_id,1.0,VECTOR_U_LO); // fold the trailing part back into the solution
+  #endif
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
   all_grids->timers.MGSolve += (double)(getTime()-_timeStartMGSolve);
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -1305,6 +1998,10 @@ void FMGSolve2(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, do
   double _LevelStart = getTime();
   double norm_of_F = norm(all_grids->levels[onLevel],F_id);           // ||F||
               zero_vector(all_grids->levels[onLevel],u_id);           // intial guess of u=0
+  #ifdef USE_MIXED_PRECISION
+              zero_vector(all_grids->levels[onLevel],VECTOR_U_LO);
+  double rel_of_residual = 1.0;
+  #endif
              scale_vector(all_grids->levels[onLevel],R_id,1.0,F_id);  // R_id = F-Au = F-0 = F_id
   all_grids->levels[onLevel]->timers.Total += (double)(getTime()-_LevelStart);
 
@@ -1345,13 +2042,26 @@ void FMGSolve2(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, do
 
     // correct current solution and calculate residual (new RHS)...
     _LevelStart = getTime();
+    #ifdef USE_MIXED_PRECISION
+    if(all_grids->levels[onLevel]->must_subtract_mean == 1){
+      double average_value_of_e = mean(all_grids->levels[onLevel],e_id);
+      shift_vector(all_grids->levels[onLevel],e_id,e_id,-average_value_of_e);
+    }
+    if(rel_of_residual > MG_MIXED_PRECISION_RTOL)add_vectors(all_grids->levels[onLevel],u_id,1.0,u_id,1.0,e_id); // u = u+e
+                                            else add_vectors(all_grids->levels[onLevel],VECTOR_U_LO,1.0,VECTOR_U_LO,1.0,e_id);
+    residual_pair(all_grids->levels[onLevel],R_id,u_id,VECTOR_U_LO,F_id,a,b);
+    #else
     add_vectors(all_grids->levels[onLevel],u_id,1.0,u_id,1.0,e_id); // u = u+e
     if(all_grids->levels[onLevel]->must_subtract_mean == 1){
       double average_value_of_u = mean(all_grids->levels[onLevel],u_id);
       shift_vector(all_grids->levels[onLevel],u_id,u_id,-average_value_of_u);
     }
     residual(all_grids->levels[onLevel],R_id,u_id,F_id,a,b);
+    #endif
     double norm_of_residual = norm(all_grids->levels[onLevel],R_id);
+    #ifdef USE_MIXED_PRECISION
+    rel_of_residual = norm_of_residual/norm_of_F;
+    #endif
     all_grids->levels[onLevel]->timers.Total += (double)(getTime()-_LevelStart);
 
     // test convergence...
@@ -1364,6 +2074,9 @@ void FMGSolve2(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, do
 
   } // F-cycle
 
+  #ifdef USE_MIXED_PRECISION
+  add_vectors(all_grids->levels[onLevel],u_id,1.0,u_id,1.0,VECTOR_U_LO); // fold the trailing part back into the solution
+  #endif
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
   all_grids->timers.MGSolve += (double)(getTime()-_timeStartMGSolve);
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -15,33 +15,54 @@
 #ifndef MG_AGGLOMERATION_START
 #define MG_AGGLOMERATION_START  8 // i.e. start the distributed v-cycle when boxes are smaller than 8^3
 #endif
+#ifndef MG_AUTOTUNE_TRIALS
+#define MG_AUTOTUNE_TRIALS      4 // number of timed smooths (or bottom solves) per candidate in MGAutotune()
+#endif
 #ifndef MG_DEFAULT_BOTTOM_NORM
 #define MG_DEFAULT_BOTTOM_NORM  1e-3
 #endif
+#ifndef MG_MIXED_PRECISION_RTOL
+#define MG_MIXED_PRECISION_RTOL 1e-4 // with -DUSE_MIXED_PRECISION, u_id is frozen (corrections accumulate in VECTOR_U_LO) once ||r||/||f|| is below this
+#endif
 //------------------------------------------------------------------------------------------------------------------------------
 typedef struct {
   int num_ranks;	// total number of MPI ranks for MPI_COMM_WORLD
   int my_rank;		// my MPI rank for MPI_COMM_WORLD
   int       num_levels;	// depth of the v-cycle
   level_type ** levels;	// array of pointers to levels
+  arena_type     arena;	// vectors of all coarsened levels (levels[1..num_levels-1]) are carved from this
 
   struct {
     double MGBuild; // total time spent building the coefficients...
     double MGSolve; // total time spent in MGSolve
   }timers;
   int MGSolves_performed;
+  uint64_t high_water_mark;	// peak resident set size (max over processes) as of the last MGMeasureMemory()
 } mg_type;
 
 
+typedef struct {
+  int nProcs;			// number of processes the level is distributed among
+  int box_dim;			// dimension of each cubical box
+  int box_ghosts;		// ghost zone depth of each box
+  struct {int i, j, k;}boxes_in;// number of boxes in i,j,k across the level
+} mg_plan_type;			// structure of one level of the v-cycle (see MGPlan())
 //------------------------------------------------------------------------------------------------------------------------------
+int            MGPlan(mg_plan_type *plan, int maxLevels, int fine_boxes_in_i, int fine_boxes_in_j, int fine_boxes_in_k, int fine_box_dim, int fine_box_ghosts, int num_ranks, int minCoarseGridDim);
+uint64_t MGEstimateMemory(mg_plan_type *plan, int num_levels, int numVectors, int domain_boundary_condition, uint64_t *level_bytes);
 void          MGBuild(mg_type *all_grids, level_type *fine_grid, double a, double b, int minCoarseGridDim);
+void       MGAutotune(mg_type *all_grids, double a, double b);
+void         MGVCycle(mg_type *all_grids, int e_id, int R_id, double a, double b, int level); // one v-cycle for A e = R starting on level
 void          MGSolve(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, double b, double rtol);
 void         FMGSolve(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, double b, double rtol);
 void        FMGSolve2(mg_type *all_grids, int onLevel, int u_id, int F_id, double a, double b, double rtol);
 void            MGPCG(mg_type *all_grids, int onLevel, int x_id, int F_id, double a, double b, double rtol);
 void        MGDestroy(mg_type *all_grids);
 void    MGPrintTiming(mg_type *all_grids, int fromLevel);
+void MGPrintTimingJSON(mg_type *all_grids, int fromLevel, FILE *fp);
+void MGPrintJSONNumber(FILE *fp, const char *format, double x);
 void    MGResetTimers(mg_type *all_grids);
-void richardson_error(mg_type *all_grids, int levelh, int u_id);
+void  MGMeasureMemory(mg_type *all_grids);
+void richardson_error(mg_type *all_grids, int levelh, int u_id, double *error, double *order);
 //------------------------------------------------------------------------------------------------------------------------------
 #endif
@@ -17,6 +17,7 @@
 #include "defines.h"
 #include "level.h"
 #include "operators.h"
+#include "counters.h"
 //------------------------------------------------------------------------------------------------------------------------------
 #define MyPragma(a) _Pragma(#a)
 //------------------------------------------------------------------------------------------------------------------------------
@@ -117,31 +118,43 @@ void rebuild_operator(level_type * level, level_type *fromLevel, double a, doubl
 
 
 //------------------------------------------------------------------------------------------------------------------------------
-#ifdef  USE_GSRB
-#warning GSRB is not recommended for the 27pt operator
+// every smoother is compiled under its own name and registered in smoothers[] (see operators/registry.c)
+// NOTE, GSRB is not recommended for the 27pt operator
 #define GSRB_OOP
 #define NUM_SMOOTHS      2 // RBRB
+#define smooth(...) smooth_gsrb(__VA_ARGS__)
 #include "operators/gsrb.c"
-#elif   USE_CHEBY
+#undef  smooth
+#undef  NUM_SMOOTHS
 #define NUM_SMOOTHS      1
 #define CHEBYSHEV_DEGREE 4 // i.e. one degree-4 polynomial smoother
+#define smooth(...) smooth_chebyshev(__VA_ARGS__)
 #include "operators/chebyshev.c"
-#elif   USE_JACOBI
+#undef  smooth
+#undef  NUM_SMOOTHS
 #define NUM_SMOOTHS      6
+#define smooth(...) smooth_jacobi(__VA_ARGS__)
 #include "operators/jacobi.c"
-#else
-#error You must compile with either -DUSE_GSRB, -DUSE_CHEBY, or -DUSE_JACOBI
-#endif
+#undef  smooth
+#undef  NUM_SMOOTHS
+#define residual(...) residual_generic(__VA_ARGS__)
 #include "operators/residual.c"
+#undef  residual
+#define apply_op(...) apply_op_generic(__VA_ARGS__)
 #include "operators/apply_op.c"
+#undef  apply_op
 #include "operators/rebuild.c"
 //------------------------------------------------------------------------------------------------------------------------------
 #include "operators/blockCopy.c"
 #include "operators/misc.c"
+#include "operators/residual_pair.c"
 #include "operators/exchange_boundary.c"
 #include "operators/boundary_fd.c" // 27pt uses cell centered, not cell averaged
 //#include "operators/boundary_fv.c"
 #include "operators/restriction.c"
+#define residual_restriction(...) residual_restriction_generic(__VA_ARGS__)
+#include "operators/residual_restriction.c"
+#undef  residual_restriction
 #include "operators/interpolation_p2.c"
 //#include "operators/interpolation_v2.c"
 //------------------------------------------------------------------------------------------------------------------------------
@@ -152,3 +165,13 @@ void interpolation_fcycle(level_type * level_f, int id_f, double prescale_f, lev
 //------------------------------------------------------------------------------------------------------------------------------
 #include "operators/problem.p6.c"
 //------------------------------------------------------------------------------------------------------------------------------
+smoother_type smoothers[] = {
+  {.name="gsrb"    ,.smooth=smooth_gsrb     },
+  {.name="cheby"   ,.smooth=smooth_chebyshev},
+  {.name="jacobi"  ,.smooth=smooth_jacobi   },
+};
+op_kernels_type op_kernels[] = {
+  {.name="generic" ,.residual=residual_generic,.apply_op=apply_op_generic,.residual_restriction=residual_restriction_generic},
+};
+#include "operators/registry.c"
+//------------------------------------------------------------------------------------------------------------------------------
@@ -17,6 +17,7 @@
 #include "defines.h"
 #include "level.h"
 #include "operators.h"
+#include "counters.h"
 //------------------------------------------------------------------------------------------------------------------------------
 #define STENCIL_VARIABLE_COEFFICIENT
 //------------------------------------------------------------------------------------------------------------------------------
@@ -134,13 +135,13 @@ void rebuild_operator(level_type * level, level_type *fromLevel, double a, doubl
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
     double h2inv = 1.0/(level->h*level->h);
-    double * __restrict__ alpha  = level->my_boxes[box].vectors[VECTOR_ALPHA ] + ghosts*(1+jStride+kStride);
-    double * __restrict__ beta_i = level->my_boxes[box].vectors[VECTOR_BETA_I] + ghosts*(1+jStride+kStride);
-    double * __restrict__ beta_j = level->my_boxes[box].vectors[VECTOR_BETA_J] + ghosts*(1+jStride+kStride);
-    double * __restrict__ beta_k = level->my_boxes[box].vectors[VECTOR_BETA_K] + ghosts*(1+jStride+kStride);
-    double * __restrict__   Dinv = level->my_boxes[box].vectors[VECTOR_DINV  ] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ alpha  = level->my_boxes[box].vectors[VECTOR_ALPHA ] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ beta_i = level->my_boxes[box].vectors[VECTOR_BETA_I] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ beta_j = level->my_boxes[box].vectors[VECTOR_BETA_J] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ beta_k = level->my_boxes[box].vectors[VECTOR_BETA_K] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__   Dinv = level->my_boxes[box].vectors[VECTOR_DINV  ] + ghosts*(1+jStride+kStride);
     #ifdef VECTOR_L1INV
-    double * __restrict__  L1inv = level->my_boxes[box].vectors[VECTOR_L1INV ] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__  L1inv = level->my_boxes[box].vectors[VECTOR_L1INV ] + ghosts*(1+jStride+kStride);
     #endif
     double block_eigenvalue = -1e9;
 
@@ -244,27 +245,39 @@ void rebuild_operator(level_type * level, level_type *fromLevel, double a, doubl
 
 
 //------------------------------------------------------------------------------------------------------------------------------
-#ifdef  USE_GSRB
+// every smoother is compiled under its own name and registered in smoothers[] (see operators/registry.c)
 #define NUM_SMOOTHS      2 // RBRB
+#define smooth(...) smooth_gsrb(__VA_ARGS__)
 #include "operators/gsrb.c"
-#elif   USE_CHEBY
+#undef  smooth
+#undef  NUM_SMOOTHS
 #define NUM_SMOOTHS      1
 #define CHEBYSHEV_DEGREE 4 // i.e. one degree-4 polynomial smoother
+#define smooth(...) smooth_chebyshev(__VA_ARGS__)
 #include "operators/chebyshev.c"
-#elif   USE_JACOBI
+#undef  smooth
+#undef  NUM_SMOOTHS
 #define NUM_SMOOTHS      6
+#define smooth(...) smooth_jacobi(__VA_ARGS__)
 #include "operators/jacobi.c"
-#else
-#error You must compile with either -DUSE_GSRB, -DUSE_CHEBY, or -DUSE_JACOBI
-#endif
+#undef  smooth
+#undef  NUM_SMOOTHS
+#define residual(...) residual_generic(__VA_ARGS__)
 #include "operators/residual.c"
+#undef  residual
+#define apply_op(...) apply_op_generic(__VA_ARGS__)
 #include "operators/apply_op.c"
+#undef  apply_op
 //------------------------------------------------------------------------------------------------------------------------------
 #include "operators/blockCopy.c"
 #include "operators/misc.c"
+#include "operators/residual_pair.c"
 #include "operators/exchange_boundary.c"
 #include "operators/boundary_fd.c"
 #include "operators/restriction.c"
+#define residual_restriction(...) residual_restriction_generic(__VA_ARGS__)
+#include "operators/residual_restriction.c"
+#undef  residual_restriction
 #include "operators/interpolation_p0.c"
 #include "operators/interpolation_p1.c"
 //------------------------------------------------------------------------------------------------------------------------------
@@ -273,3 +286,13 @@ void interpolation_fcycle(level_type * level_f, int id_f, double prescale_f, lev
 //------------------------------------------------------------------------------------------------------------------------------
 #include "operators/problem.p6.c"
 //------------------------------------------------------------------------------------------------------------------------------
+smoother_type smoothers[] = {
+  {.name="gsrb"    ,.smooth=smooth_gsrb     },
+  {.name="cheby"   ,.smooth=smooth_chebyshev},
+  {.name="jacobi"  ,.smooth=smooth_jacobi   },
+};
+op_kernels_type op_kernels[] = {
+  {.name="generic" ,.residual=residual_generic,.apply_op=apply_op_generic,.residual_restriction=residual_restriction_generic},
+};
+#include "operators/registry.c"
+//------------------------------------------------------------------------------------------------------------------------------
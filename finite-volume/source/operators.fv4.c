@@ -17,6 +17,7 @@
 #include "defines.h"
 #include "level.h"
 #include "operators.h"
+#include "counters.h"
 //------------------------------------------------------------------------------------------------------------------------------
 #define STENCIL_VARIABLE_COEFFICIENT
 //------------------------------------------------------------------------------------------------------------------------------
@@ -161,6 +162,13 @@ void rebuild_operator(level_type * level, level_type *fromLevel, double a, doubl
   exchange_boundary(level,VECTOR_BETA_J,STENCIL_SHAPE_BOX);
   exchange_boundary(level,VECTOR_BETA_K,STENCIL_SHAPE_BOX);
 
+  // communication-avoiding smoothers (deep ghost zones) need the neighbors' betas just beyond the domain boundary
+  if(level->box_ghosts>stencil_get_radius()){
+    exchange_boundary_layer(level,VECTOR_BETA_I);
+    exchange_boundary_layer(level,VECTOR_BETA_J);
+    exchange_boundary_layer(level,VECTOR_BETA_K);
+  }
+
   // black box rebuild of D^{-1}, l1^{-1}, dominant eigenvalue, ...
   rebuild_operator_blackbox(level,a,b,4);
 
@@ -170,35 +178,80 @@ void rebuild_operator(level_type * level, level_type *fromLevel, double a, doubl
 
 
 //------------------------------------------------------------------------------------------------------------------------------
-#ifdef  USE_GSRB
+// every smoother is compiled under its own name and registered in smoothers[] (see operators/registry.c)
 #define GSRB_OOP
 #define NUM_SMOOTHS      3 // RBRBRB
+#define smooth(...) smooth_gsrb(__VA_ARGS__)
 #include "operators/gsrb.c"
-#elif   USE_CHEBY
-#warning The Chebyshev smoother is currently underperforming for 4th order.  Please use -DUSE_GSRB or -DUSE_JACOBI
+#undef  smooth
+#undef  NUM_SMOOTHS
+#define NUM_SMOOTHS      3 // RBRBRB, but with several sweeps per (deep) ghost zone exchange
+#define smooth(...) smooth_gsrb_ca(__VA_ARGS__)
+#include "operators/gsrb_ca.c"
+#undef  smooth
+#undef  NUM_SMOOTHS
+// NOTE, the Chebyshev smoother is currently underperforming for 4th order.  Please use GSRB or Jacobi
 #define NUM_SMOOTHS      1
 #define CHEBYSHEV_DEGREE 6 // i.e. one degree-6 polynomial smoother
+#define smooth(...) smooth_chebyshev(__VA_ARGS__)
 #include "operators/chebyshev.c"
-#elif   USE_JACOBI
+#undef  smooth
+#undef  NUM_SMOOTHS
 #define NUM_SMOOTHS      6
+#define smooth(...) smooth_jacobi(__VA_ARGS__)
 #include "operators/jacobi.c"
-#else
-#error You must compile with either -DUSE_GSRB, -DUSE_CHEBY, or -DUSE_JACOBI
-#endif
+#undef  smooth
+#undef  NUM_SMOOTHS
+#define residual(...) residual_generic(__VA_ARGS__)
 #include "operators/residual.c"
+#undef  residual
+#define apply_op(...) apply_op_generic(__VA_ARGS__)
 #include "operators/apply_op.c"
+#undef  apply_op
 #include "operators/rebuild.c"
 //------------------------------------------------------------------------------------------------------------------------------
 #include "operators/blockCopy.c"
 #include "operators/misc.c"
+#include "operators/residual_pair.c"
 #include "operators/exchange_boundary.c"
 #include "operators/boundary_fv.c"
 #include "operators/restriction.c"
+#define residual_restriction(...) residual_restriction_generic(__VA_ARGS__)
+#include "operators/residual_restriction.c"
+#undef  residual_restriction
 #include "operators/interpolation_v2.c"
 #include "operators/interpolation_v4.c"
+#define interpolation_smooth(...) interpolation_smooth_gsrb(__VA_ARGS__)
+#include "operators/gsrb_interpolation.c"
+#undef  interpolation_smooth
+//------------------------------------------------------------------------------------------------------------------------------
+// hand vectorized (AVX2 or AVX-512) smoother, residual, and apply_op... selected at compile time (e.g. -march=native)
+#if defined(__AVX2__) && defined(STENCIL_VARIABLE_COEFFICIENT) && !defined(USE_MIXED_PRECISION)
+#define FV4_AVX
+#define NUM_SMOOTHS      3 // RBRBRB
+#include "operators/fv4_avx.c"
+#undef  NUM_SMOOTHS
+#endif
 //------------------------------------------------------------------------------------------------------------------------------
 void interpolation_vcycle(level_type * level_f, int id_f, double prescale_f, level_type *level_c, int id_c){interpolation_v2(level_f,id_f,prescale_f,level_c,id_c);}
 void interpolation_fcycle(level_type * level_f, int id_f, double prescale_f, level_type *level_c, int id_c){interpolation_v4(level_f,id_f,prescale_f,level_c,id_c);}
 //------------------------------------------------------------------------------------------------------------------------------
 #include "operators/problem.fv.c"
 //------------------------------------------------------------------------------------------------------------------------------
+smoother_type smoothers[] = {
+  {.name="gsrb"    ,.smooth=smooth_gsrb     ,.interpolation_smooth=interpolation_smooth_gsrb},
+  {.name="gsrb_ca" ,.smooth=smooth_gsrb_ca  },
+  {.name="cheby"   ,.smooth=smooth_chebyshev},
+  {.name="jacobi"  ,.smooth=smooth_jacobi   },
+  #ifdef FV4_AVX
+  {.name="gsrb_" FV4_AVX_NAME,.smooth=smooth_gsrb_avx},
+  #endif
+};
+op_kernels_type op_kernels[] = {
+  {.name="generic" ,.residual=residual_generic,.apply_op=apply_op_generic,.residual_restriction=residual_restriction_generic},
+  #ifdef FV4_AVX
+  {.name=FV4_AVX_NAME,.residual=residual_avx,.apply_op=apply_op_avx,.residual_restriction=residual_restriction_generic},
+  #endif
+};
+#include "operators/registry.c"
+//------------------------------------------------------------------------------------------------------------------------------
@@ -16,21 +16,82 @@ int stencil_get_shape();
 //------------------------------------------------------------------------------------------------------------------------------
   void                  apply_op(level_type * level, int Ax_id,  int x_id, double a, double b);
   void                  residual(level_type * level, int res_id, int x_id, int rhs_id, double a, double b);
+  void      residual_restriction(level_type * level_c, int R_id, level_type *level_f, int x_id, int rhs_id, double a, double b); // R_c = restriction(rhs_f-Ax_f)
+  #ifdef USE_MIXED_PRECISION
+  void             residual_pair(level_type * level, int res_id, int x_hi_id, int x_lo_id, int rhs_id, double a, double b); // res = rhs-A(x_hi+x_lo)
+  #endif
   void                    smooth(level_type * level, int phi_id, int rhs_id, double a, double b);
   void          rebuild_operator(level_type * level, level_type *fromLevel, double a, double b);
   void rebuild_operator_blackbox(level_type * level, double a, double b, int colors_in_each_dim);
+//------------------------------------------------------------------------------------------------------------------------------
+// Every smoother and residual/apply_op implementation compiled into the operator is registered in a table.
+// smooth(), residual(), and apply_op() dispatch through level->smoother and level->op_kernels which index into these tables.
+typedef struct {
+  const char * name;
+  void (*smooth  )(level_type * level, int phi_id, int rhs_id, double a, double b);
+  void (*interpolation_smooth)(level_type * level_f, int phi_id, level_type * level_c, int e_id, int rhs_id, double a, double b); // NULL if not fused
+} smoother_type;
+
+typedef struct {
+  const char * name;
+  void (*residual)(level_type * level, int res_id, int x_id, int rhs_id, double a, double b);
+  void (*apply_op)(level_type * level, int Ax_id,  int x_id, double a, double b);
+  void (*residual_restriction)(level_type * level_c, int R_id, level_type *level_f, int x_id, int rhs_id, double a, double b); // NULL if not fused
+} op_kernels_type;
+
+extern smoother_type   smoothers[];
+extern int         num_smoothers;
+extern int      default_smoother;     // smoother assigned to newly created levels
+extern int  fuse_interpolation;       // if set, the v-cycle fuses interpolation with the first smoothing sweep (when the smoother supports it)
+extern int    overlap_exchange;       // if set, residual(), apply_op(), and gsrb compute the interior of boxes while the ghost zone exchange is in flight
+extern int     exchange_method;       // how exchange_boundary() communicates... one of EXCHANGE_*, fixed before the levels are created
+extern const char *exchange_methods[];
+#define EXCHANGE_P2P        0         // MPI_Irecv/MPI_Isend posted on every exchange
+#define EXCHANGE_PERSISTENT 1         // persistent requests created by build_exchange_ghosts() and MPI_Startall'd on every exchange
+#define EXCHANGE_NEIGHBOR   2         // one MPI_Ineighbor_alltoallw on a distributed graph communicator created by build_exchange_ghosts() (MPI-3)
+#define EXCHANGE_SHM        3         // vectors live in an MPI-3 shared window and ranks on the same node copy each other's ghost zones directly
+extern op_kernels_type op_kernels[];
+extern int         num_op_kernels;
+extern int      default_op_kernels;   // residual/apply_op kernels assigned to newly created levels
+   int           smoother_lookup(const char *name); // returns the index of name in smoothers[]  (NULL selects the compile time default, or smoothers[0] if this operator lacks it) or -1 if not found
+const char *   smoother_default_name(void);       // name of the smoother selected at compile time (-DUSE_CHEBY, -DUSE_SYMGS, ...)
+   int         op_kernels_lookup(const char *name); // returns the index of name in op_kernels[] (NULL selects the compile time default) or -1 if not found
+   int    exchange_method_lookup(const char *name); // returns the EXCHANGE_* named name (NULL selects p2p) or -1 if not found or not supported by this MPI/build
 //------------------------------------------------------------------------------------------------------------------------------
   void               restriction(level_type * level_c, int id_c, level_type *level_f, int id_f, int restrictionType);
   void      interpolation_vcycle(level_type * level_f, int id_f, double prescale_f, level_type *level_c, int id_c); // interpolation used inside a v-cycle
+  void      interpolation_smooth(level_type * level_f, int phi_id, level_type *level_c, int e_id, int rhs_id, double a, double b); // phi_f += P*e_c, then smooth
   void      interpolation_fcycle(level_type * level_f, int id_f, double prescale_f, level_type *level_c, int id_c); // interpolation used in the f-cycle to create a new initial guess for the next finner v-cycle
 //------------------------------------------------------------------------------------------------------------------------------
   void         exchange_boundary(level_type * level, int id_a, int shape);
+  void   exchange_boundary_begin(level_type * level, int id_a, int shape); // split-phase exchange... Irecv/pack/Isend/local
+  void     exchange_boundary_end(level_type * level, int id_a, int shape); // split-phase exchange... Waitall/unpack
+   int   exchange_boundary_phase(level_type * level, int x_id, int shape, int phase, blockCopy_type **blocks); // exchange/BC's for phase 0/1 and the blocks to compute
   void              apply_BCs_p1(level_type * level, int x_id, int shape); // piecewise (cell centered) linear
   void              apply_BCs_p2(level_type * level, int x_id, int shape); // piecewise (cell centered) quadratic
   void              apply_BCs_v1(level_type * level, int x_id, int shape); // volumetric linear
   void              apply_BCs_v2(level_type * level, int x_id, int shape); // volumetric quadratic
   void              apply_BCs_v4(level_type * level, int x_id, int shape); // volumetric quartic
   void         extrapolate_betas(level_type * level);
+  void   exchange_boundary_layer(level_type * level, int id);
+//------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------
+// split-phase (nonblocking) dot products and max norm... all are reduced with a single allreduce (see misc.c)
+#define REDUCTION_MAX_DOTS 8
+typedef struct {
+  int num_dots;					// number of dot products
+  int has_norm;					// value[num_dots] is a max norm
+  double value[REDUCTION_MAX_DOTS+1];		// local values until dots_finish(), then the global values
+  double  send[REDUCTION_MAX_DOTS+1];		// send buffer (must persist until dots_finish())
+  #ifdef USE_MPI
+  MPI_Request request;
+  #endif
+} reduction_type;
+  void                dots_start(level_type * level, reduction_type * reduction, int num_dots, const int *id_a, const int *id_b, int norm_id); // norm_id<0 means no norm
+  void               dots_finish(level_type * level, reduction_type * reduction);
+  void              dots_destroy(void); // frees the MPI datatypes/op used by dots_start() (see MGDestroy())
+  void                 dot_start(level_type * level, reduction_type * reduction, int id_a, int id_b);
+double                dot_finish(level_type * level, reduction_type * reduction);
 //------------------------------------------------------------------------------------------------------------------------------
 double                       dot(level_type * level, int id_a, int id_b);
 double                      norm(level_type * level, int id_a);
@@ -17,6 +17,7 @@
 #include "defines.h"
 #include "level.h"
 #include "operators.h"
+#include "counters.h"
 //------------------------------------------------------------------------------------------------------------------------------
 #define STENCIL_VARIABLE_COEFFICIENT
 //------------------------------------------------------------------------------------------------------------------------------
@@ -173,33 +174,48 @@ void rebuild_operator(level_type * level, level_type *fromLevel, double a, doubl
 
 
 //------------------------------------------------------------------------------------------------------------------------------
-#ifdef  USE_GSRB
+// every smoother is compiled under its own name and registered in smoothers[] (see operators/registry.c)
 #define GSRB_OOP
 #define NUM_SMOOTHS      3 // RBRBRB
+#define smooth(...) smooth_gsrb(__VA_ARGS__)
 #include "operators.test/gsrb.ompsimd.c"
-#elif   USE_CHEBY
-#warning The Chebyshev smoother is currently underperforming for 4th order.  Please use -DUSE_GSRB or -DUSE_JACOBI
+#undef  smooth
+#undef  NUM_SMOOTHS
+// NOTE, the Chebyshev smoother is currently underperforming for 4th order.  Please use GSRB or Jacobi
 #define NUM_SMOOTHS      1
 #define CHEBYSHEV_DEGREE 6 // i.e. one degree-6 polynomial smoother
+#define smooth(...) smooth_chebyshev(__VA_ARGS__)
 #include "operators/chebyshev.c"
-#elif   USE_JACOBI
+#undef  smooth
+#undef  NUM_SMOOTHS
 #define NUM_SMOOTHS      6
+#define smooth(...) smooth_jacobi(__VA_ARGS__)
 #include "operators/jacobi.c"
-#elif   USE_L1JACOBI
+#undef  smooth
+#undef  NUM_SMOOTHS
+#ifdef  USE_L1JACOBI // VECTOR_L1INV is only allocated with -DUSE_L1JACOBI
 #define NUM_SMOOTHS      6
+#define smooth(...) smooth_l1jacobi(__VA_ARGS__)
 #include "operators.test/l1jacobi.c"
-#elif   USE_SYMGS
+#undef  smooth
+#undef  NUM_SMOOTHS
+#endif
 #define NUM_SMOOTHS      2 // FBFB
+#define smooth(...) smooth_symgs(__VA_ARGS__)
 #include "operators.test/symgs.c"
-#else
-#error You must compile with either -DUSE_GSRB, -DUSE_CHEBY, -DUSE_JACOBI, -DUSE_L1JACOBI, or -DUSE_SYMGS
-#endif
+#undef  smooth
+#undef  NUM_SMOOTHS
+#define residual(...) residual_ompsimd(__VA_ARGS__)
 #include "operators.test/residual.ompsimd.c"
+#undef  residual
+#define apply_op(...) apply_op_generic(__VA_ARGS__)
 #include "operators/apply_op.c"
+#undef  apply_op
 #include "operators/rebuild.c"
 //------------------------------------------------------------------------------------------------------------------------------
 #include "operators/blockCopy.c"
 #include "operators/misc.c"
+#include "operators/residual_pair.c"
 #include "operators/exchange_boundary.c"
 #include "operators/boundary_fv.c"
 #include "operators/restriction.c"
@@ -211,3 +227,17 @@ void interpolation_fcycle(level_type * level_f, int id_f, double prescale_f, lev
 //------------------------------------------------------------------------------------------------------------------------------
 #include "operators/problem.fv.c"
 //------------------------------------------------------------------------------------------------------------------------------
+smoother_type smoothers[] = {
+  {.name="gsrb"    ,.smooth=smooth_gsrb     },
+  {.name="cheby"   ,.smooth=smooth_chebyshev},
+  {.name="jacobi"  ,.smooth=smooth_jacobi   },
+  #ifdef USE_L1JACOBI
+  {.name="l1jacobi",.smooth=smooth_l1jacobi },
+  #endif
+  {.name="symgs"   ,.smooth=smooth_symgs    },
+};
+op_kernels_type op_kernels[] = {
+  {.name="ompsimd" ,.residual=residual_ompsimd,.apply_op=apply_op_generic,.residual_restriction=NULL},
+};
+#include "operators/registry.c"
+//------------------------------------------------------------------------------------------------------------------------------
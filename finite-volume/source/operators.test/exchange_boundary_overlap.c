@@ -33,7 +33,7 @@ void exchange_boundary(level_type * level, int id, int shape){
     for(n=0;n<level->exchange_ghosts[shape].num_recvs;n++){
       MPI_Irecv(level->exchange_ghosts[shape].recv_buffers[n],
                 level->exchange_ghosts[shape].recv_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level->exchange_ghosts[shape].recv_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
@@ -66,7 +66,7 @@ void exchange_boundary(level_type * level, int id, int shape){
     for(n=0;n<level->exchange_ghosts[shape].num_sends;n++){
       MPI_Isend(level->exchange_ghosts[shape].send_buffers[n],
                 level->exchange_ghosts[shape].send_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level->exchange_ghosts[shape].send_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
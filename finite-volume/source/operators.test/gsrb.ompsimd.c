@@ -40,22 +40,22 @@ void smooth(level_type * level, int x_id, int rhs_id, const double a, const doub
       //const int kStride = level->my_boxes[box].kStride;
 
       const int offset = ghosts*(1+jStride+kStride) + (jlo*jStride + klo*kStride); // offset from first ghost zone to first element this block operates on
-      const double * __restrict__ rhs      = level->my_boxes[box].vectors[       rhs_id] + offset;
-      const double * __restrict__ alpha    = level->my_boxes[box].vectors[VECTOR_ALPHA ] + offset;
-      const double * __restrict__ beta_i   = level->my_boxes[box].vectors[VECTOR_BETA_I] + offset;
-      const double * __restrict__ beta_j   = level->my_boxes[box].vectors[VECTOR_BETA_J] + offset;
-      const double * __restrict__ beta_k   = level->my_boxes[box].vectors[VECTOR_BETA_K] + offset;
-      const double * __restrict__ Dinv     = level->my_boxes[box].vectors[VECTOR_DINV  ] + offset;
+      const real_t * __restrict__ rhs      = level->my_boxes[box].vectors[       rhs_id] + offset;
+      const real_t * __restrict__ alpha    = level->my_boxes[box].vectors[VECTOR_ALPHA ] + offset;
+      const real_t * __restrict__ beta_i   = level->my_boxes[box].vectors[VECTOR_BETA_I] + offset;
+      const real_t * __restrict__ beta_j   = level->my_boxes[box].vectors[VECTOR_BETA_J] + offset;
+      const real_t * __restrict__ beta_k   = level->my_boxes[box].vectors[VECTOR_BETA_K] + offset;
+      const real_t * __restrict__ Dinv     = level->my_boxes[box].vectors[VECTOR_DINV  ] + offset;
       #ifdef GSRB_OOP
-      const double * __restrict__ x_n;
-            double * __restrict__ x_np1;
+      const real_t * __restrict__ x_n;
+            real_t * __restrict__ x_np1;
                      if((s&1)==0){x_n      = level->my_boxes[box].vectors[         x_id] + offset;
                                   x_np1    = level->my_boxes[box].vectors[VECTOR_TEMP  ] + offset;}
                              else{x_n      = level->my_boxes[box].vectors[VECTOR_TEMP  ] + offset;
                                   x_np1    = level->my_boxes[box].vectors[         x_id] + offset;}
       #else
-      const double * __restrict__ x_n      = level->my_boxes[box].vectors[         x_id] + offset;
-            double * __restrict__ x_np1    = level->my_boxes[box].vectors[         x_id] + offset;
+      const real_t * __restrict__ x_n      = level->my_boxes[box].vectors[         x_id] + offset;
+            real_t * __restrict__ x_np1    = level->my_boxes[box].vectors[         x_id] + offset;
       #endif
 
       #ifdef __INTEL_COMPILER
@@ -92,7 +92,7 @@ void smooth(level_type * level, int x_id, int rhs_id, const double a, const doub
       const int color000 = (level->my_boxes[box].low.i^level->my_boxes[box].low.j^level->my_boxes[box].low.k^jlo^klo^s)&1;  // is element 000 red or black on *THIS* sweep
       for(k=0;k<kdim;k++){
       for(j=0;j<jdim;j++){
-        const double * __restrict__ RedBlack = level->RedBlack_FP + ghosts*(1+jStride) + jStride*((j^k^color000)&1);// exploit pencil symmetry (only need two pencils, not two planes == low cache pressure)
+        const real_t * __restrict__ RedBlack = level->RedBlack_FP + ghosts*(1+jStride) + jStride*((j^k^color000)&1);// exploit pencil symmetry (only need two pencils, not two planes == low cache pressure)
         #if (_OPENMP>=201307) // OpenMP 4.0
         #pragma omp simd aligned(alpha,beta_i,beta_j,beta_k,rhs,Dinv,x_n,x_np1,RedBlack:BOX_ALIGN_JSTRIDE*sizeof(double))
         #endif
@@ -106,7 +106,7 @@ void smooth(level_type * level, int x_id, int rhs_id, const double a, const doub
       #else // fused IJ loop
       const int color000 = (level->my_boxes[box].low.i^level->my_boxes[box].low.j^level->my_boxes[box].low.k^jlo^klo^s)&1;  // is element 000 red or black on *THIS* sweep
       for(k=0;k<kdim;k++){
-        const double * __restrict__ RedBlack = level->RedBlack_FP + ghosts*(1+jStride) + jStride*((k^color000)&1);// exploit pencil symmetry (only need two pencils, not two planes == low cache pressure)
+        const real_t * __restrict__ RedBlack = level->RedBlack_FP + ghosts*(1+jStride) + jStride*((k^color000)&1);// exploit pencil symmetry (only need two pencils, not two planes == low cache pressure)
         #if (_OPENMP>=201307) // OpenMP 4.0
         #pragma omp simd aligned(alpha,beta_i,beta_j,beta_k,rhs,Dinv,x_n,x_np1,RedBlack:BOX_ALIGN_JSTRIDE*sizeof(double))
         #endif
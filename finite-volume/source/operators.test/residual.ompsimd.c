@@ -36,13 +36,13 @@ void residual(level_type * level, int res_id, int x_id, int rhs_id, double a, do
     //const int kStride = level->my_boxes[box].kStride;
 
     const int offset = ghosts*(1+jStride+kStride) + (jlo*jStride + klo*kStride); // offset from first ghost zone to first element this block operates on
-    const double * __restrict__ rhs      = level->my_boxes[box].vectors[       rhs_id] + offset;
-    const double * __restrict__ alpha    = level->my_boxes[box].vectors[VECTOR_ALPHA ] + offset;
-    const double * __restrict__ beta_i   = level->my_boxes[box].vectors[VECTOR_BETA_I] + offset;
-    const double * __restrict__ beta_j   = level->my_boxes[box].vectors[VECTOR_BETA_J] + offset;
-    const double * __restrict__ beta_k   = level->my_boxes[box].vectors[VECTOR_BETA_K] + offset;
-    const double * __restrict__ x        = level->my_boxes[box].vectors[         x_id] + offset;
-          double * __restrict__ res      = level->my_boxes[box].vectors[       res_id] + offset;
+    const real_t * __restrict__ rhs      = level->my_boxes[box].vectors[       rhs_id] + offset;
+    const real_t * __restrict__ alpha    = level->my_boxes[box].vectors[VECTOR_ALPHA ] + offset;
+    const real_t * __restrict__ beta_i   = level->my_boxes[box].vectors[VECTOR_BETA_I] + offset;
+    const real_t * __restrict__ beta_j   = level->my_boxes[box].vectors[VECTOR_BETA_J] + offset;
+    const real_t * __restrict__ beta_k   = level->my_boxes[box].vectors[VECTOR_BETA_K] + offset;
+    const real_t * __restrict__ x        = level->my_boxes[box].vectors[         x_id] + offset;
+          real_t * __restrict__ res      = level->my_boxes[box].vectors[       res_id] + offset;
 
     #ifdef __INTEL_COMPILER
     //__assume_aligned(rhs   ,BOX_ALIGN_JSTRIDE*sizeof(double));
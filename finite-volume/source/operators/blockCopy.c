@@ -21,8 +21,8 @@ static inline void CopyBlock(level_type *level, int id, blockCopy_type *block){
   int write_jStride = block->write.jStride;
   int write_kStride = block->write.kStride;
 
-  const double * __restrict__  read = block->read.ptr;
-        double * __restrict__ write = block->write.ptr;
+  const real_t * __restrict__  read = block->read.ptr;
+        real_t * __restrict__ write = block->write.ptr;
 
   if(block->read.box >=0){
      read_jStride = level->my_boxes[block->read.box ].jStride;
@@ -109,8 +109,8 @@ static inline void IncrementBlock(level_type *level, int id, double prescale, bl
   int write_jStride = block->write.jStride;
   int write_kStride = block->write.kStride;
 
-  const double * __restrict__  read = block->read.ptr;
-        double * __restrict__ write = block->write.ptr;
+  const real_t * __restrict__  read = block->read.ptr;
+        real_t * __restrict__ write = block->write.ptr;
 
   if(block->read.box >=0){
      read_jStride = level->my_boxes[block->read.box ].jStride;
@@ -50,7 +50,7 @@ void apply_BCs_v1(level_type * level, int x_id, int shape){
     // hard code for box to box BC's 
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
-    double * __restrict__  x = level->my_boxes[box].vectors[x_id] + level->box_ghosts*(1+jStride+kStride);
+    real_t * __restrict__  x = level->my_boxes[box].vectors[x_id] + level->box_ghosts*(1+jStride+kStride);
 
     // convert normal vector into pointer offsets...
     const int di = (((normal % 3)  )-1);
@@ -127,8 +127,8 @@ void apply_BCs_v2(level_type * level, int x_id, int shape){
     // hard code for box to box BC's 
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
-    const double * __restrict__ x  = level->my_boxes[box].vectors[x_id] + level->box_ghosts*(1+jStride+kStride);
-          double * __restrict__ xn = level->my_boxes[box].vectors[x_id] + level->box_ghosts*(1+jStride+kStride); // physically the same, but use different pointers for read/write
+    const real_t * __restrict__ x  = level->my_boxes[box].vectors[x_id] + level->box_ghosts*(1+jStride+kStride);
+          real_t * __restrict__ xn = level->my_boxes[box].vectors[x_id] + level->box_ghosts*(1+jStride+kStride); // physically the same, but use different pointers for read/write
 
     // zero out entire ghost region when not all points will be updated...
     if(box_ghosts>1){
@@ -290,8 +290,8 @@ void apply_BCs_v4(level_type * level, int x_id, int shape){
     // hard code for box to box BC's 
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
-    const double * __restrict__ x  = level->my_boxes[box].vectors[x_id] + level->box_ghosts*(1+jStride+kStride);
-          double * __restrict__ xn = level->my_boxes[box].vectors[x_id] + level->box_ghosts*(1+jStride+kStride); // physically the same, but use different pointers for read/write
+    const real_t * __restrict__ x  = level->my_boxes[box].vectors[x_id] + level->box_ghosts*(1+jStride+kStride);
+          real_t * __restrict__ xn = level->my_boxes[box].vectors[x_id] + level->box_ghosts*(1+jStride+kStride); // physically the same, but use different pointers for read/write
 
     double OneTwelfth = 1.0/12.0;
 
@@ -326,8 +326,8 @@ void apply_BCs_v4(level_type * level, int x_id, int shape){
       }
       // FIX... optimize for rStride==1 (unit-stride)
       // FIX... optimize for dt==+/-1
-      double * __restrict__  ghost0 = (double * __restrict__)(x   ); // convince the compiler that read (box) & write (ghost zone) are disjoint
-      double * __restrict__  ghost1 = (double * __restrict__)(x-dt); // convince the compiler that read (box) & write (ghost zone) are disjoint
+      real_t * __restrict__  ghost0 = (real_t * __restrict__)(x   ); // convince the compiler that read (box) & write (ghost zone) are disjoint
+      real_t * __restrict__  ghost1 = (real_t * __restrict__)(x-dt); // convince the compiler that read (box) & write (ghost zone) are disjoint
       for(s=0;s<dim_s;s++){
       for(r=0;r<dim_r;r++){
         int ijk = (r+rlo)*rStride + (s+slo)*sStride + (t)*tStride;
@@ -395,10 +395,10 @@ void apply_BCs_v4(level_type * level, int x_id, int shape){
       }
       // FIX... optimize for rStride==1 (unit-stride)
       // FIX... optimize for ds==+/-1
-      double * __restrict__  ghost00 = (double * __restrict__)(x      ); // convince the compiler that read (box) & write (ghost zone) are disjoint
-      double * __restrict__  ghost01 = (double * __restrict__)(x   -dt); // convince the compiler that read (box) & write (ghost zone) are disjoint
-      double * __restrict__  ghost10 = (double * __restrict__)(x-ds   ); // convince the compiler that read (box) & write (ghost zone) are disjoint
-      double * __restrict__  ghost11 = (double * __restrict__)(x-ds-dt); // convince the compiler that read (box) & write (ghost zone) are disjoint
+      real_t * __restrict__  ghost00 = (real_t * __restrict__)(x      ); // convince the compiler that read (box) & write (ghost zone) are disjoint
+      real_t * __restrict__  ghost01 = (real_t * __restrict__)(x   -dt); // convince the compiler that read (box) & write (ghost zone) are disjoint
+      real_t * __restrict__  ghost10 = (real_t * __restrict__)(x-ds   ); // convince the compiler that read (box) & write (ghost zone) are disjoint
+      real_t * __restrict__  ghost11 = (real_t * __restrict__)(x-ds-dt); // convince the compiler that read (box) & write (ghost zone) are disjoint
       for(r=0;r<dim_r;r++){
         int ijk = (r+rlo)*rStride + (s)*sStride + (t)*tStride;
         double x11 = x[ijk+  ds+  dt], x21 = x[ijk+2*ds+  dt], x31 = x[ijk+3*ds+  dt], x41 = x[ijk+4*ds+  dt];
@@ -603,9 +603,9 @@ void extrapolate_betas(level_type * level){
     // hard code for box to box BC's 
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
-    double * __restrict__  beta_i = level->my_boxes[box].vectors[VECTOR_BETA_I] + level->box_ghosts*(1+jStride+kStride);
-    double * __restrict__  beta_j = level->my_boxes[box].vectors[VECTOR_BETA_J] + level->box_ghosts*(1+jStride+kStride);
-    double * __restrict__  beta_k = level->my_boxes[box].vectors[VECTOR_BETA_K] + level->box_ghosts*(1+jStride+kStride);
+    real_t * __restrict__  beta_i = level->my_boxes[box].vectors[VECTOR_BETA_I] + level->box_ghosts*(1+jStride+kStride);
+    real_t * __restrict__  beta_j = level->my_boxes[box].vectors[VECTOR_BETA_J] + level->box_ghosts*(1+jStride+kStride);
+    real_t * __restrict__  beta_k = level->my_boxes[box].vectors[VECTOR_BETA_K] + level->box_ghosts*(1+jStride+kStride);
 
     // convert normal vector into pointer offsets...
     const int di = (((normal % 3)  )-1);
@@ -681,3 +681,59 @@ void extrapolate_betas(level_type * level){
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
+// Communication-avoiding smoothers (e.g. gsrb_ca) redundantly update their neighbors' cells and must therefore see the
+// neighbors' view of any coefficients in the first layer beyond a (non-periodic) domain boundary (e.g. beta_i on the domain
+// face or the extrapolated betas).  exchange_boundary() only copies a neighbor's interior and so leaves these tangential
+// ghost zones beyond the domain boundary unfilled (or filled with this box's own extrapolation).
+// This routine copies them from the box that owns that row/column by...
+//   1. shifting the layer beyond the domain boundary into the interior of VECTOR_TEMP
+//   2. exchanging VECTOR_TEMP
+//   3. shifting the exchanged values back out into the tangential ghost zones
+// Faces of the domain are processed first (3 passes) followed by edges (3 passes).  Corners are never needed.
+// NOTE, as this function is only called when building the operator, it has not been optimized for performance.
+void exchange_boundary_layer(level_type * level, int id){
+  if(level->boundary_condition.type == BC_PERIODIC)return; // no BC's and thus no layer beyond the domain !
+  if(level->box_dim<2)return; // low and high layers would collide when shifted into the interior
+
+  const int passes[6][3] = {{1,0,0},{0,1,0},{0,0,1},  {1,1,0},{1,0,1},{0,1,1}};
+  int pass,box,copyBack;
+  for(pass=0;pass<6;pass++){
+  for(copyBack=0;copyBack<2;copyBack++){
+    if(copyBack)exchange_boundary(level,VECTOR_TEMP,STENCIL_SHAPE_BOX);
+    for(box=0;box<level->num_my_boxes;box++){
+      int i,j,k;
+      const int     dim = level->my_boxes[box].dim;
+      const int  ghosts = level->my_boxes[box].ghosts;
+      const int jStride = level->my_boxes[box].jStride;
+      const int kStride = level->my_boxes[box].kStride;
+      const int   low[3] = {level->my_boxes[box].low.i,level->my_boxes[box].low.j,level->my_boxes[box].low.k};
+      const int domain[3] = {level->dim.i,level->dim.j,level->dim.k};
+      real_t * __restrict__    x = level->my_boxes[box].vectors[         id] + ghosts*(1+jStride+kStride);
+      real_t * __restrict__ temp = level->my_boxes[box].vectors[VECTOR_TEMP] + ghosts*(1+jStride+kStride);
+      for(k=-ghosts;k<dim+ghosts;k++){
+      for(j=-ghosts;j<dim+ghosts;j++){
+      for(i=-ghosts;i<dim+ghosts;i++){
+        const int ijk[3] = {i,j,k};
+        int d,shift=0,inLayer=1,inDomain=1;
+        for(d=0;d<3;d++){
+          const int stride = (d==0) ? 1 : (d==1) ? jStride : kStride;
+          const int global = low[d]+ijk[d];
+          if(passes[pass][d]){ // must be the first layer beyond the domain boundary
+                 if(global==        -1)shift+=stride; // low  boundary... shift up   into the interior
+            else if(global==domain[d])shift-=stride; // high boundary... shift down into the interior
+            else inLayer=0;
+          }else{ // must be within the domain (i.e. this box or an exchanged neighbor)
+            if( (global<0) || (global>=domain[d]) )inDomain=0;
+          }
+        }
+        if(inLayer && inDomain){
+          int ijk1 = i + j*jStride + k*kStride;
+          if(copyBack)x[ijk1] = temp[ijk1+shift];
+                 else temp[ijk1+shift] = x[ijk1];
+        }
+      }}}
+    }
+  }}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
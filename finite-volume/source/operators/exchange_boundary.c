@@ -9,8 +9,34 @@
 //  BC's are either the responsibility of a separate function or should be fused into the stencil
 // The argument shape indicates which of faces, edges, and corners on each box must be exchanged
 //  If the specified shape exceeds the range of defined shapes, the code will default to STENCIL_SHAPE_BOX (i.e. exchange faces, edges, and corners)
-void exchange_boundary(level_type * level, int id, int shape){
+// The exchange is split into two phases...
+//  exchange_boundary_begin() preposts the Irecv's, packs and Isend's the MPI buffers, and performs the local exchange
+//  exchange_boundary_end()   waits for MPI and unpacks the receive buffers
+// With -exchange persistent or neighbor, build_exchange_ghosts() has already bound the buffers to persistent requests or a
+//  distributed graph communicator and the Irecv's/Isend's are replaced by MPI_Startall's or a single MPI_Ineighbor_alltoallw
+// With -exchange shm, ghosts of boxes owned by other ranks on this node are copied directly by the local list (no pack/MPI/unpack)
+//  Only the ranks that read each other's boxes synchronize (pairwise through shm_sync()) rather than the whole node
+//  In between, the caller may read (or update) any cell that doesn't depend on the ghost zones (see exchange_boundary_phase())
+#if defined(USE_MPI) && (MPI_VERSION>=3)
+#include <sched.h>
+// -exchange shm... publish that I have reached epoch of (flag,shape) and wait until every rank in shared_ranks[] has too
+static void shm_sync(level_type * level, int shape, int flag, uint64_t epoch){
+  int n;
+  communicator_type *exchange = &level->exchange_ghosts[shape];
+  MPI_Win_sync(level->shared_vectors); // complete my writes (or reads) of the vectors before the epoch advances
+  MPI_Win_sync(level->shared_epochs);
+  level->node_epochs[level->node_rank[level->my_rank]][SHM_EPOCH(flag,shape)] = epoch;
+  MPI_Win_sync(level->shared_epochs);
+  for(n=0;n<exchange->num_shared_ranks;n++){
+    while(level->node_epochs[exchange->shared_ranks[n]][SHM_EPOCH(flag,shape)] < epoch){sched_yield();MPI_Win_sync(level->shared_epochs);} // yield in case ranks outnumber cores
+  }
+  MPI_Win_sync(level->shared_vectors); // see their writes of the vectors
+}
+#endif
+
+void exchange_boundary_begin(level_type * level, int id, int shape){
   double _timeCommunicationStart = getTime();
+  COUNTERS_START();
   double _timeStart,_timeEnd;
 
   if(shape>=STENCIL_MAX_SHAPES)shape=STENCIL_SHAPE_BOX;  // shape must be < STENCIL_MAX_SHAPES in order to safely index into exchange_ghosts[]
@@ -19,26 +45,29 @@ void exchange_boundary(level_type * level, int id, int shape){
   int n;
 
   #ifdef USE_MPI
-  int nMessages = level->exchange_ghosts[shape].num_recvs + level->exchange_ghosts[shape].num_sends;
   MPI_Request *recv_requests = level->exchange_ghosts[shape].requests;
   MPI_Request *send_requests = level->exchange_ghosts[shape].requests + level->exchange_ghosts[shape].num_recvs;
 
   // loop through packed list of MPI receives and prepost Irecv's...
-  if(level->exchange_ghosts[shape].num_recvs>0){
+  if( (level->exchange_ghosts[shape].num_recvs>0) && (level->exchange_ghosts[shape].neighbor_comm==MPI_COMM_NULL) ){
     _timeStart = getTime();
+    if(level->exchange_ghosts[shape].persistent_requests){
+    MPI_Startall(level->exchange_ghosts[shape].num_recvs,level->exchange_ghosts[shape].persistent_requests);
+    }else{
     #ifdef USE_MPI_THREAD_MULTIPLE
     #pragma omp parallel for schedule(dynamic,1)
     #endif
     for(n=0;n<level->exchange_ghosts[shape].num_recvs;n++){
       MPI_Irecv(level->exchange_ghosts[shape].recv_buffers[n],
                 level->exchange_ghosts[shape].recv_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level->exchange_ghosts[shape].recv_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
                 &recv_requests[n]
       );
     }
+    }
     _timeEnd = getTime();
     level->timers.ghostZone_recv += (_timeEnd-_timeStart);
   }
@@ -57,27 +86,53 @@ void exchange_boundary(level_type * level, int id, int shape){
 
  
   // loop through MPI send buffers and post Isend's...
+  #if MPI_VERSION>=3
+  if(level->exchange_ghosts[shape].neighbor_comm!=MPI_COMM_NULL){
+    _timeStart = getTime();
+    MPI_Ineighbor_alltoallw(MPI_BOTTOM,level->exchange_ghosts[shape].send_sizes,level->exchange_ghosts[shape].neighbor_displs+level->exchange_ghosts[shape].num_recvs,level->exchange_ghosts[shape].neighbor_types,
+                            MPI_BOTTOM,level->exchange_ghosts[shape].recv_sizes,level->exchange_ghosts[shape].neighbor_displs                                         ,level->exchange_ghosts[shape].neighbor_types,
+                            level->exchange_ghosts[shape].neighbor_comm,&level->exchange_ghosts[shape].neighbor_request);
+    _timeEnd = getTime();
+    level->timers.ghostZone_send += (_timeEnd-_timeStart);
+  }else
+  #endif
   if(level->exchange_ghosts[shape].num_sends>0){
     _timeStart = getTime();
+    if(level->exchange_ghosts[shape].persistent_requests){
+    MPI_Startall(level->exchange_ghosts[shape].num_sends,level->exchange_ghosts[shape].persistent_requests+level->exchange_ghosts[shape].num_recvs);
+    }else{
     #ifdef USE_MPI_THREAD_MULTIPLE
     #pragma omp parallel for schedule(dynamic,1)
     #endif
     for(n=0;n<level->exchange_ghosts[shape].num_sends;n++){
       MPI_Isend(level->exchange_ghosts[shape].send_buffers[n],
                 level->exchange_ghosts[shape].send_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level->exchange_ghosts[shape].send_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
                 &send_requests[n]
       ); 
     }
+    }
     _timeEnd = getTime();
     level->timers.ghostZone_send += (_timeEnd-_timeStart);
   }
   #endif
 
 
+  // -exchange shm... the local list also reads the boxes of other ranks on this node.  They must have finished writing id...
+  #if defined(USE_MPI) && (MPI_VERSION>=3)
+  if(level->exchange_ghosts[shape].num_shared_ranks>0){
+    _timeStart = getTime();
+    level->exchange_ghosts[shape].shared_epoch++;
+    shm_sync(level,shape,SHM_READY,level->exchange_ghosts[shape].shared_epoch);
+    _timeEnd = getTime();
+    level->timers.ghostZone_wait += (_timeEnd-_timeStart);
+  }
+  #endif
+
+
   // exchange locally... try and hide within Isend latency... 
   if(level->exchange_ghosts[shape].num_blocks[1]){
     _timeStart = getTime();
@@ -90,11 +145,42 @@ void exchange_boundary(level_type * level, int id, int shape){
   }
 
 
-  // wait for MPI to finish...
+  // ... and must not overwrite it until they have read their ghosts
+  #if defined(USE_MPI) && (MPI_VERSION>=3)
+  if(level->exchange_ghosts[shape].num_shared_ranks>0){
+    _timeStart = getTime();
+    shm_sync(level,shape,SHM_DONE,level->exchange_ghosts[shape].shared_epoch);
+    _timeEnd = getTime();
+    level->timers.ghostZone_wait += (_timeEnd-_timeStart);
+  }
+  #endif
+
+  level->timers.ghostZone_total += (double)(getTime()-_timeCommunicationStart);
+  COUNTERS_STOP(level,COUNTED_GHOSTZONE);
+}
+
+
+void exchange_boundary_end(level_type * level, int id, int shape){
   #ifdef USE_MPI 
+  double _timeCommunicationStart = getTime();
+  COUNTERS_START();
+  double _timeStart,_timeEnd;
+
+  if(shape>=STENCIL_MAX_SHAPES)shape=STENCIL_SHAPE_BOX;
+  int nMessages = level->exchange_ghosts[shape].num_recvs + level->exchange_ghosts[shape].num_sends;
+  int buffer=0;
+
+
+  // wait for MPI to finish...
+  if(level->exchange_ghosts[shape].neighbor_comm!=MPI_COMM_NULL){
+    _timeStart = getTime();
+    MPI_Wait(&level->exchange_ghosts[shape].neighbor_request,MPI_STATUS_IGNORE);
+    _timeEnd = getTime();
+    level->timers.ghostZone_wait += (_timeEnd-_timeStart);
+  }else
   if(nMessages){
     _timeStart = getTime();
-    MPI_Waitall(nMessages,level->exchange_ghosts[shape].requests,level->exchange_ghosts[shape].status);
+    MPI_Waitall(nMessages,level->exchange_ghosts[shape].persistent_requests ? level->exchange_ghosts[shape].persistent_requests : level->exchange_ghosts[shape].requests,level->exchange_ghosts[shape].status);
     _timeEnd = getTime();
     level->timers.ghostZone_wait += (_timeEnd-_timeStart);
   }
@@ -110,8 +196,40 @@ void exchange_boundary(level_type * level, int id, int shape){
     _timeEnd = getTime();
     level->timers.ghostZone_unpack += (_timeEnd-_timeStart);
   }
-  #endif
 
  
   level->timers.ghostZone_total += (double)(getTime()-_timeCommunicationStart);
+  COUNTERS_STOP(level,COUNTED_GHOSTZONE);
+  #endif
+}
+
+
+void exchange_boundary(level_type * level, int id, int shape){
+  exchange_boundary_begin(level,id,shape);
+  exchange_boundary_end(level,id,shape);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// kernels that read the ghost zones of x_id (e.g. residual, apply_op, gsrb) loop over phases 0 and 1 and compute the returned list of blocks...
+//  by default, phase 0 performs the exchange and BC's and returns my_blocks while phase 1 returns no blocks.
+//  if overlap_exchange, phase 0 begins the exchange and returns the interior of the boxes that need no BC's (computed while messages are in flight),
+//  and phase 1 finishes the exchange, applies the BC's, and returns the remaining shells and boundary boxes (see build_my_blocks())
+int exchange_boundary_phase(level_type * level, int x_id, int shape, int phase, blockCopy_type **blocks){
+  if(!overlap_exchange){
+    if(phase>0){*blocks=NULL;return(0);}
+    exchange_boundary(level,x_id,shape);
+            apply_BCs(level,x_id,shape);
+    *blocks = level->my_blocks;
+    return(level->num_my_blocks);
+  }
+  if(phase==0){
+    exchange_boundary_begin(level,x_id,shape);
+    *blocks = level->overlap_blocks[0];
+    return(level->num_overlap_blocks[0]);
+  }
+  exchange_boundary_end(level,x_id,shape);
+          apply_BCs(level,x_id,shape);
+  *blocks = level->overlap_blocks[1];
+  return(level->num_overlap_blocks[1]);
 }
@@ -0,0 +1,308 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Samuel Williams
+// SWWilliams@lbl.gov
+// Lawrence Berkeley National Lab
+//------------------------------------------------------------------------------------------------------------------------------
+// Hand vectorized GSRB, residual, and apply_op for the variable coefficient 4th order FV operator (operators.fv4.c)
+//  - selected at compile time... compiled only when the compiler targets AVX2 (e.g. -mavx2 -mfma or -march=native)
+//    AVX-512 (-mavx512f) uses 8 doubles per vector, AVX2 uses 4
+//  - each vector calculates Ax for VLEN consecutive cells in i (unaligned loads of each of the stencil's offsets)
+//  - rather than striding by 2, GSRB calculates both colors and uses a red/black lane mask to select which lanes are updated.
+//    As GSRB is out-of-place (GSRB_OOP), the remaining lanes simply copy x_n (so no separate copy loop is required)
+//  - the remainder of each pencil (dim.i not a multiple of VLEN) falls back to apply_op_ijk
+//  - operations are performed in the same order as apply_op_ijk (no FMA's) so that results are bitwise identical to the generic kernels
+//  - vectors must be stored in double precision (i.e. not -DUSE_MIXED_PRECISION)
+//------------------------------------------------------------------------------------------------------------------------------
+#include <immintrin.h>
+//------------------------------------------------------------------------------------------------------------------------------
+#ifdef __AVX512F__
+#define FV4_AVX_NAME "avx512"
+#define VLEN 8
+typedef __m512d  vec_t;
+typedef __mmask8 vmask_t;
+#define V_LOAD(p)          _mm512_loadu_pd(p)
+#define V_STORE(p,v)       _mm512_storeu_pd(p,v)
+#define V_SET1(s)          _mm512_set1_pd(s)
+#define V_ADD(u,v)         _mm512_add_pd(u,v)
+#define V_SUB(u,v)         _mm512_sub_pd(u,v)
+#define V_MUL(u,v)         _mm512_mul_pd(u,v)
+#define V_BLEND(m,u,v)     _mm512_mask_blend_pd(m,u,v)  // lanes of v where m is set, otherwise u
+#define V_MASK_EVEN        ((__mmask8)0x55)             // lanes 0,2,4,6
+#define V_MASK_ODD         ((__mmask8)0xAA)             // lanes 1,3,5,7
+#else
+#define FV4_AVX_NAME "avx2"
+#define VLEN 4
+typedef __m256d  vec_t;
+typedef __m256d  vmask_t;
+#define V_LOAD(p)          _mm256_loadu_pd(p)
+#define V_STORE(p,v)       _mm256_storeu_pd(p,v)
+#define V_SET1(s)          _mm256_set1_pd(s)
+#define V_ADD(u,v)         _mm256_add_pd(u,v)
+#define V_SUB(u,v)         _mm256_sub_pd(u,v)
+#define V_MUL(u,v)         _mm256_mul_pd(u,v)
+#define V_BLEND(m,u,v)     _mm256_blendv_pd(u,v,m)      // lanes of v where m is set, otherwise u
+#define V_MASK_EVEN        _mm256_castsi256_pd(_mm256_set_epi64x(0,-1,0,-1)) // lanes 0,2
+#define V_MASK_ODD         _mm256_castsi256_pd(_mm256_set_epi64x(-1,0,-1,0)) // lanes 1,3
+#endif
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// vector version of apply_op_ijk(x) for cells ijk..ijk+VLEN-1
+// n.b. va = a and vbh2inv = b*h2inv (Helmholtz) or -b*h2inv (Poisson) to mirror the order of operations in apply_op_ijk
+static inline vec_t fv4_avx_apply_op(const double * __restrict__ x, const double * __restrict__ alpha,
+                                     const double * __restrict__ beta_i, const double * __restrict__ beta_j, const double * __restrict__ beta_k,
+                                     int ijk, int jStride, int kStride, vec_t va, vec_t vbh2inv){
+  #define X(o)  V_LOAD(x     +ijk+(o))
+  #define BI(o) V_LOAD(beta_i+ijk+(o))
+  #define BJ(o) V_LOAD(beta_j+ijk+(o))
+  #define BK(o) V_LOAD(beta_k+ijk+(o))
+  const vec_t v15 = V_SET1(15.0);
+  const vec_t x0  = X(0);
+  // beta*( 15.0*(x[ijk-d]-x[ijk]) - (x[ijk-2d]-x[ijk+d]) )
+  #define FV4_FACE(beta,n1,n2,p1) V_MUL(beta,V_SUB(V_MUL(v15,V_SUB(X(n1),x0)),V_SUB(X(n2),X(p1))))
+  // (beta[+t]-beta[-t]) * (x[a]-x[b]-x[c]+x[d])
+  #define FV4_EDGE(bp,bm,xa,xb,xc,xd) V_MUL(V_SUB(bp,bm),V_ADD(V_SUB(V_SUB(X(xa),X(xb)),X(xc)),X(xd)))
+  const int i1=1,j1=jStride,k1=kStride;
+
+  vec_t faces =        FV4_FACE(BI(  0),-i1,-2*i1, i1);
+        faces = V_ADD(faces,FV4_FACE(BI( i1), i1, 2*i1,-i1));
+        faces = V_ADD(faces,FV4_FACE(BJ(  0),-j1,-2*j1, j1));
+        faces = V_ADD(faces,FV4_FACE(BJ( j1), j1, 2*j1,-j1));
+        faces = V_ADD(faces,FV4_FACE(BK(  0),-k1,-2*k1, k1));
+        faces = V_ADD(faces,FV4_FACE(BK( k1), k1, 2*k1,-k1));
+
+  vec_t edges =        FV4_EDGE(BI(   +j1),BI(   -j1),-i1+j1, j1,-i1-j1,-j1);
+        edges = V_ADD(edges,FV4_EDGE(BI(   +k1),BI(   -k1),-i1+k1, k1,-i1-k1,-k1));
+        edges = V_ADD(edges,FV4_EDGE(BJ(   +i1),BJ(   -i1),-j1+i1, i1,-j1-i1,-i1));
+        edges = V_ADD(edges,FV4_EDGE(BJ(   +k1),BJ(   -k1),-j1+k1, k1,-j1-k1,-k1));
+        edges = V_ADD(edges,FV4_EDGE(BK(   +i1),BK(   -i1),-k1+i1, i1,-k1-i1,-i1));
+        edges = V_ADD(edges,FV4_EDGE(BK(   +j1),BK(   -j1),-k1+j1, j1,-k1-j1,-j1));
+        edges = V_ADD(edges,FV4_EDGE(BI(i1+j1),BI(i1-j1), i1+j1, j1, i1-j1,-j1));
+        edges = V_ADD(edges,FV4_EDGE(BI(i1+k1),BI(i1-k1), i1+k1, k1, i1-k1,-k1));
+        edges = V_ADD(edges,FV4_EDGE(BJ(j1+i1),BJ(j1-i1), j1+i1, i1, j1-i1,-i1));
+        edges = V_ADD(edges,FV4_EDGE(BJ(j1+k1),BJ(j1-k1), j1+k1, k1, j1-k1,-k1));
+        edges = V_ADD(edges,FV4_EDGE(BK(k1+i1),BK(k1-i1), k1+i1, i1, k1-i1,-i1));
+        edges = V_ADD(edges,FV4_EDGE(BK(k1+j1),BK(k1-j1), k1+j1, j1, k1-j1,-j1));
+
+  vec_t div = V_ADD(V_MUL(V_SET1(STENCIL_TWELFTH),faces),V_MUL(V_SET1(0.25*STENCIL_TWELFTH),edges));
+  #ifdef USE_HELMHOLTZ
+  return( V_SUB(V_MUL(V_MUL(va,V_LOAD(alpha+ijk)),x0),V_MUL(vbh2inv,div)) );
+  #else
+  return( V_MUL(vbh2inv,div) );
+  #endif
+  #undef FV4_EDGE
+  #undef FV4_FACE
+  #undef BK
+  #undef BJ
+  #undef BI
+  #undef X
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+void smooth_gsrb_avx(level_type * level, int x_id, int rhs_id, double a, double b){
+  int block,s;
+  for(s=0;s<2*NUM_SMOOTHS;s++){ // there are two sweeps per GSRB smooth
+
+    // exchange the ghost zone (see exchange_boundary_phase())...
+    int x_n_id = ((s&1)==0) ? x_id : VECTOR_TEMP; // out-of-place GSRB ping pongs between x and VECTOR_TEMP
+    int phase;
+    for(phase=0;phase<2;phase++){
+    blockCopy_type *blocks;
+    int num_blocks = exchange_boundary_phase(level,x_n_id,stencil_get_shape(),phase,&blocks);
+
+    // apply the smoother...
+    double _timeStart = getTime();
+    COUNTERS_START();
+
+    // loop over the blocks/tiles of this phase...
+    PRAGMA_THREAD_ACROSS_BLOCKS(level,block,num_blocks)
+    for(block=0;block<num_blocks;block++){
+      const int box = blocks[block].read.box;
+      const int ilo = blocks[block].read.i;
+      const int jlo = blocks[block].read.j;
+      const int klo = blocks[block].read.k;
+      const int ihi = blocks[block].dim.i + ilo;
+      const int jhi = blocks[block].dim.j + jlo;
+      const int khi = blocks[block].dim.k + klo;
+
+      int i,j,k;
+      const double h2inv = 1.0/(level->h*level->h);
+      const int ghosts =  level->box_ghosts;
+      const int jStride = level->my_boxes[box].jStride;
+      const int kStride = level->my_boxes[box].kStride;
+      const int color000 = (level->my_boxes[box].low.i^level->my_boxes[box].low.j^level->my_boxes[box].low.k^s)&1;  // is element 000 red or black on *THIS* sweep
+
+      const double * __restrict__ rhs      = level->my_boxes[box].vectors[       rhs_id] + ghosts*(1+jStride+kStride);
+      const double * __restrict__ alpha    = level->my_boxes[box].vectors[VECTOR_ALPHA ] + ghosts*(1+jStride+kStride);
+      const double * __restrict__ beta_i   = level->my_boxes[box].vectors[VECTOR_BETA_I] + ghosts*(1+jStride+kStride);
+      const double * __restrict__ beta_j   = level->my_boxes[box].vectors[VECTOR_BETA_J] + ghosts*(1+jStride+kStride);
+      const double * __restrict__ beta_k   = level->my_boxes[box].vectors[VECTOR_BETA_K] + ghosts*(1+jStride+kStride);
+      const double * __restrict__ Dinv     = level->my_boxes[box].vectors[VECTOR_DINV  ] + ghosts*(1+jStride+kStride);
+      const double * __restrict__ x_n;
+            double * __restrict__ x_np1;
+                     if((s&1)==0){x_n      = level->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride);
+                                  x_np1    = level->my_boxes[box].vectors[VECTOR_TEMP  ] + ghosts*(1+jStride+kStride);}
+                             else{x_n      = level->my_boxes[box].vectors[VECTOR_TEMP  ] + ghosts*(1+jStride+kStride);
+                                  x_np1    = level->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride);}
+
+      const vec_t va      = V_SET1(a);
+      #ifdef USE_HELMHOLTZ
+      const vec_t vbh2inv = V_SET1( b*h2inv);
+      #else
+      const vec_t vbh2inv = V_SET1(-b*h2inv);
+      #endif
+      const vmask_t even  = V_MASK_EVEN;
+      const vmask_t odd   = V_MASK_ODD;
+
+      for(k=klo;k<khi;k++){
+      for(j=jlo;j<jhi;j++){
+        for(i=ilo;i<=ihi-VLEN;i+=VLEN){
+          int ijk = i + j*jStride + k*kStride;
+          vec_t Ax  = fv4_avx_apply_op(x_n,alpha,beta_i,beta_j,beta_k,ijk,jStride,kStride,va,vbh2inv);
+          vec_t xn  = V_LOAD(x_n+ijk);
+          vec_t xu  = V_ADD(xn,V_MUL(V_LOAD(Dinv+ijk),V_SUB(V_LOAD(rhs+ijk),Ax)));
+          // cell i+l is updated on this sweep if (i+l)^j^k^color000 is even (c.f. the stride-2 loop in gsrb.c)
+          V_STORE(x_np1+ijk,V_BLEND( ((i^j^k^color000)&1) ? odd : even ,xn,xu));
+        }
+        for(;i<ihi;i++){ // remainder
+          int ijk = i + j*jStride + k*kStride;
+          if((i^j^k^color000)&1){x_np1[ijk] = x_n[ijk];continue;}
+          double Ax     = apply_op_ijk(x_n);
+          x_np1[ijk] = x_n[ijk] + Dinv[ijk]*(rhs[ijk]-Ax);
+        }
+      }}
+    } // boxes
+    level->timers.smooth += (double)(getTime()-_timeStart);
+    COUNTERS_STOP(level,COUNTED_SMOOTH);
+    } // phase
+  } // s-loop
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+void residual_avx(level_type * level, int res_id, int x_id, int rhs_id, double a, double b){
+  // exchange the boundary for x in prep for Ax (phase 0 may overlap the exchange with the interior... see exchange_boundary_phase())
+  int block,phase;
+  for(phase=0;phase<2;phase++){
+  blockCopy_type *blocks;
+  int num_blocks = exchange_boundary_phase(level,x_id,stencil_get_shape(),phase,&blocks);
+
+  // now do residual proper...
+  double _timeStart = getTime();
+  COUNTERS_START();
+  PRAGMA_THREAD_ACROSS_BLOCKS(level,block,num_blocks)
+  for(block=0;block<num_blocks;block++){
+    const int box = blocks[block].read.box;
+    const int ilo = blocks[block].read.i;
+    const int jlo = blocks[block].read.j;
+    const int klo = blocks[block].read.k;
+    const int ihi = blocks[block].dim.i + ilo;
+    const int jhi = blocks[block].dim.j + jlo;
+    const int khi = blocks[block].dim.k + klo;
+    int i,j,k;
+    const int jStride = level->my_boxes[box].jStride;
+    const int kStride = level->my_boxes[box].kStride;
+    const int  ghosts = level->my_boxes[box].ghosts;
+    const double h2inv = 1.0/(level->h*level->h);
+    const double * __restrict__ x      = level->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+    const double * __restrict__ rhs    = level->my_boxes[box].vectors[       rhs_id] + ghosts*(1+jStride+kStride);
+    const double * __restrict__ alpha  = level->my_boxes[box].vectors[VECTOR_ALPHA ] + ghosts*(1+jStride+kStride);
+    const double * __restrict__ beta_i = level->my_boxes[box].vectors[VECTOR_BETA_I] + ghosts*(1+jStride+kStride);
+    const double * __restrict__ beta_j = level->my_boxes[box].vectors[VECTOR_BETA_J] + ghosts*(1+jStride+kStride);
+    const double * __restrict__ beta_k = level->my_boxes[box].vectors[VECTOR_BETA_K] + ghosts*(1+jStride+kStride);
+          double * __restrict__ res    = level->my_boxes[box].vectors[       res_id] + ghosts*(1+jStride+kStride);
+
+    const vec_t va      = V_SET1(a);
+    #ifdef USE_HELMHOLTZ
+    const vec_t vbh2inv = V_SET1( b*h2inv);
+    #else
+    const vec_t vbh2inv = V_SET1(-b*h2inv);
+    #endif
+
+    for(k=klo;k<khi;k++){
+    for(j=jlo;j<jhi;j++){
+      for(i=ilo;i<=ihi-VLEN;i+=VLEN){
+        int ijk = i + j*jStride + k*kStride;
+        vec_t Ax = fv4_avx_apply_op(x,alpha,beta_i,beta_j,beta_k,ijk,jStride,kStride,va,vbh2inv);
+        V_STORE(res+ijk,V_SUB(V_LOAD(rhs+ijk),Ax));
+      }
+      for(;i<ihi;i++){ // remainder
+        int ijk = i + j*jStride + k*kStride;
+        double Ax = apply_op_ijk(x);
+        res[ijk] = rhs[ijk]-Ax;
+      }
+    }}
+  }
+  level->timers.residual += (double)(getTime()-_timeStart);
+  COUNTERS_STOP(level,COUNTED_RESIDUAL);
+  } // phase
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+void apply_op_avx(level_type * level, int Ax_id, int x_id, double a, double b){
+  // exchange the boundary for x in prep for Ax (phase 0 may overlap the exchange with the interior... see exchange_boundary_phase())
+  int block,phase;
+  for(phase=0;phase<2;phase++){
+  blockCopy_type *blocks;
+  int num_blocks = exchange_boundary_phase(level,x_id,stencil_get_shape(),phase,&blocks);
+
+  // now do Ax proper...
+  double _timeStart = getTime();
+  COUNTERS_START();
+  PRAGMA_THREAD_ACROSS_BLOCKS(level,block,num_blocks)
+  for(block=0;block<num_blocks;block++){
+    const int box = blocks[block].read.box;
+    const int ilo = blocks[block].read.i;
+    const int jlo = blocks[block].read.j;
+    const int klo = blocks[block].read.k;
+    const int ihi = blocks[block].dim.i + ilo;
+    const int jhi = blocks[block].dim.j + jlo;
+    const int khi = blocks[block].dim.k + klo;
+    int i,j,k;
+    const int jStride = level->my_boxes[box].jStride;
+    const int kStride = level->my_boxes[box].kStride;
+    const int  ghosts = level->my_boxes[box].ghosts;
+    const double h2inv = 1.0/(level->h*level->h);
+    const double * __restrict__ x      = level->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+          double * __restrict__ Ax     = level->my_boxes[box].vectors[        Ax_id] + ghosts*(1+jStride+kStride);
+    const double * __restrict__ alpha  = level->my_boxes[box].vectors[VECTOR_ALPHA ] + ghosts*(1+jStride+kStride);
+    const double * __restrict__ beta_i = level->my_boxes[box].vectors[VECTOR_BETA_I] + ghosts*(1+jStride+kStride);
+    const double * __restrict__ beta_j = level->my_boxes[box].vectors[VECTOR_BETA_J] + ghosts*(1+jStride+kStride);
+    const double * __restrict__ beta_k = level->my_boxes[box].vectors[VECTOR_BETA_K] + ghosts*(1+jStride+kStride);
+
+    const vec_t va      = V_SET1(a);
+    #ifdef USE_HELMHOLTZ
+    const vec_t vbh2inv = V_SET1( b*h2inv);
+    #else
+    const vec_t vbh2inv = V_SET1(-b*h2inv);
+    #endif
+
+    for(k=klo;k<khi;k++){
+    for(j=jlo;j<jhi;j++){
+      for(i=ilo;i<=ihi-VLEN;i+=VLEN){
+        int ijk = i + j*jStride + k*kStride;
+        V_STORE(Ax+ijk,fv4_avx_apply_op(x,alpha,beta_i,beta_j,beta_k,ijk,jStride,kStride,va,vbh2inv));
+      }
+      for(;i<ihi;i++){ // remainder
+        int ijk = i + j*jStride + k*kStride;
+        Ax[ijk] = apply_op_ijk(x);
+      }
+    }}
+  }
+  level->timers.apply_op += (double)(getTime()-_timeStart);
+  COUNTERS_STOP(level,COUNTED_APPLY_OP);
+  } // phase
+}
+//------------------------------------------------------------------------------------------------------------------------------
+#undef V_MASK_ODD
+#undef V_MASK_EVEN
+#undef V_BLEND
+#undef V_MUL
+#undef V_SUB
+#undef V_ADD
+#undef V_SET1
+#undef V_STORE
+#undef V_LOAD
+#undef VLEN
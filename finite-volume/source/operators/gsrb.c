@@ -21,31 +21,36 @@
 #define GSRB_STRIDE2 // default implementation
 #endif
 //------------------------------------------------------------------------------------------------------------------------------
-void smooth(level_type * level, int x_id, int rhs_id, double a, double b){
+// apply sweeps s0..2*NUM_SMOOTHS-1 (s0>0 allows the first sweep to be fused with the interpolation... see gsrb_interpolation.c)
+static void gsrb_sweeps(level_type * level, int x_id, int rhs_id, double a, double b, int s0){
   int block,s;
-  for(s=0;s<2*NUM_SMOOTHS;s++){ // there are two sweeps per GSRB smooth
+  for(s=s0;s<2*NUM_SMOOTHS;s++){ // there are two sweeps per GSRB smooth
 
-    // exchange the ghost zone...
+    // exchange the ghost zone (see exchange_boundary_phase())...
     #ifdef GSRB_OOP // out-of-place GSRB ping pongs between x and VECTOR_TEMP
-    if((s&1)==0){exchange_boundary(level,       x_id,stencil_get_shape());apply_BCs(level,       x_id,stencil_get_shape());}
-            else{exchange_boundary(level,VECTOR_TEMP,stencil_get_shape());apply_BCs(level,VECTOR_TEMP,stencil_get_shape());}
+    int x_n_id = ((s&1)==0) ? x_id : VECTOR_TEMP;
     #else // in-place GSRB only operates on x
-                 exchange_boundary(level,       x_id,stencil_get_shape());apply_BCs(level,        x_id,stencil_get_shape());
+    int x_n_id = x_id;
     #endif
+    int phase;
+    for(phase=0;phase<2;phase++){
+    blockCopy_type *blocks;
+    int num_blocks = exchange_boundary_phase(level,x_n_id,stencil_get_shape(),phase,&blocks);
 
     // apply the smoother...
     double _timeStart = getTime();
-
-    // loop over all block/tiles this process owns...
-    PRAGMA_THREAD_ACROSS_BLOCKS(level,block,level->num_my_blocks)
-    for(block=0;block<level->num_my_blocks;block++){
-      const int box = level->my_blocks[block].read.box;
-      const int ilo = level->my_blocks[block].read.i;
-      const int jlo = level->my_blocks[block].read.j;
-      const int klo = level->my_blocks[block].read.k;
-      const int ihi = level->my_blocks[block].dim.i + ilo;
-      const int jhi = level->my_blocks[block].dim.j + jlo;
-      const int khi = level->my_blocks[block].dim.k + klo;
+    COUNTERS_START();
+
+    // loop over the blocks/tiles of this phase...
+    PRAGMA_THREAD_ACROSS_BLOCKS(level,block,num_blocks)
+    for(block=0;block<num_blocks;block++){
+      const int box = blocks[block].read.box;
+      const int ilo = blocks[block].read.i;
+      const int jlo = blocks[block].read.j;
+      const int klo = blocks[block].read.k;
+      const int ihi = blocks[block].dim.i + ilo;
+      const int jhi = blocks[block].dim.j + jlo;
+      const int khi = blocks[block].dim.k + klo;
 
       int i,j,k;
       const double h2inv = 1.0/(level->h*level->h);
@@ -54,27 +59,27 @@ void smooth(level_type * level, int x_id, int rhs_id, double a, double b){
       const int kStride = level->my_boxes[box].kStride;
       const int color000 = (level->my_boxes[box].low.i^level->my_boxes[box].low.j^level->my_boxes[box].low.k^s)&1;  // is element 000 red or black on *THIS* sweep
 
-      const double * __restrict__ rhs      = level->my_boxes[box].vectors[       rhs_id] + ghosts*(1+jStride+kStride);
-      const double * __restrict__ alpha    = level->my_boxes[box].vectors[VECTOR_ALPHA ] + ghosts*(1+jStride+kStride);
-      const double * __restrict__ beta_i   = level->my_boxes[box].vectors[VECTOR_BETA_I] + ghosts*(1+jStride+kStride);
-      const double * __restrict__ beta_j   = level->my_boxes[box].vectors[VECTOR_BETA_J] + ghosts*(1+jStride+kStride);
-      const double * __restrict__ beta_k   = level->my_boxes[box].vectors[VECTOR_BETA_K] + ghosts*(1+jStride+kStride);
-      const double * __restrict__ Dinv     = level->my_boxes[box].vectors[VECTOR_DINV  ] + ghosts*(1+jStride+kStride);
+      const real_t * __restrict__ rhs      = level->my_boxes[box].vectors[       rhs_id] + ghosts*(1+jStride+kStride);
+      const real_t * __restrict__ alpha    = level->my_boxes[box].vectors[VECTOR_ALPHA ] + ghosts*(1+jStride+kStride);
+      const real_t * __restrict__ beta_i   = level->my_boxes[box].vectors[VECTOR_BETA_I] + ghosts*(1+jStride+kStride);
+      const real_t * __restrict__ beta_j   = level->my_boxes[box].vectors[VECTOR_BETA_J] + ghosts*(1+jStride+kStride);
+      const real_t * __restrict__ beta_k   = level->my_boxes[box].vectors[VECTOR_BETA_K] + ghosts*(1+jStride+kStride);
+      const real_t * __restrict__ Dinv     = level->my_boxes[box].vectors[VECTOR_DINV  ] + ghosts*(1+jStride+kStride);
       #ifdef GSRB_OOP
-      const double * __restrict__ x_n;
-            double * __restrict__ x_np1;
+      const real_t * __restrict__ x_n;
+            real_t * __restrict__ x_np1;
                      if((s&1)==0){x_n      = level->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride);
                                   x_np1    = level->my_boxes[box].vectors[VECTOR_TEMP  ] + ghosts*(1+jStride+kStride);}
                              else{x_n      = level->my_boxes[box].vectors[VECTOR_TEMP  ] + ghosts*(1+jStride+kStride);
                                   x_np1    = level->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride);}
       #else
-      const double * __restrict__ x_n      = level->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
-            double * __restrict__ x_np1    = level->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+      const real_t * __restrict__ x_n      = level->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+            real_t * __restrict__ x_np1    = level->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
       #endif
           
 
       #if defined(GSRB_FP)
-      for(k=klo;k<khi;k++){const double * __restrict__ RedBlack = level->RedBlack_FP + ghosts*(1+jStride) + kStride*((k^color000)&0x1);
+      for(k=klo;k<khi;k++){const real_t * __restrict__ RedBlack = level->RedBlack_FP + ghosts*(1+jStride) + kStride*((k^color000)&0x1);
       for(j=jlo;j<jhi;j++){
       for(i=ilo;i<ihi;i++){
             int ij  = i + j*jStride;
@@ -126,8 +131,16 @@ void smooth(level_type * level, int x_id, int rhs_id, double a, double b){
 
     } // boxes
     level->timers.smooth += (double)(getTime()-_timeStart);
+    COUNTERS_STOP(level,COUNTED_SMOOTH);
+    } // phase
   } // s-loop
 }
 
 
+//------------------------------------------------------------------------------------------------------------------------------
+void smooth(level_type * level, int x_id, int rhs_id, double a, double b){
+  gsrb_sweeps(level,x_id,rhs_id,a,b,0);
+}
+
+
 //------------------------------------------------------------------------------------------------------------------------------
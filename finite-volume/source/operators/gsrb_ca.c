@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Samuel Williams
+// SWWilliams@lbl.gov
+// Lawrence Berkeley National Lab
+//------------------------------------------------------------------------------------------------------------------------------
+// This implements a communication-avoiding, temporally blocked (wavefront) GSRB smoother
+//  - with box_ghosts = S*stencil_get_radius(), one deep exchange (STENCIL_SHAPE_BOX) enables S red/black sweeps
+//  - each sweep redundantly updates a region that shrinks by the stencil radius (i.e. it consumes ghost zones)
+//  - boxes that don't touch a (non-periodic) domain boundary apply all S sweeps as a wavefront through k so that
+//    the working set of each sweep is a few planes of each array and remains cache-resident between sweeps
+//  - boxes on the domain boundary can't be extended beyond the domain and must reapply the BC's after every sweep
+//    These are swept one sweep at a time across the level (communication-avoiding, but not temporally blocked)
+// It assumes...
+//   out-of-place updates (x_id and VECTOR_TEMP ping pong, as in GSRB_OOP)
+//   alpha, beta_*, and Dinv have been exchanged with STENCIL_SHAPE_BOX (see rebuild_operator())
+// If box_ghosts == stencil_get_radius(), this degenerates to the conventional (one exchange per sweep) GSRB
+//------------------------------------------------------------------------------------------------------------------------------
+// apply one GSRB sweep (color s) to the k'th plane of [ilo,ihi) x [jlo,jhi) (relative to the first non ghost zone point)
+static inline void gsrb_ca_plane(level_type * level, int box, int x_n_id, int x_np1_id, int rhs_id, double a, double b, int s, int k, int ilo, int ihi, int jlo, int jhi){
+  int i,j;
+  const double h2inv = 1.0/(level->h*level->h);
+  const int ghosts =  level->box_ghosts;
+  const int jStride = level->my_boxes[box].jStride;
+  const int kStride = level->my_boxes[box].kStride;
+  const int color000 = (level->my_boxes[box].low.i^level->my_boxes[box].low.j^level->my_boxes[box].low.k^s)&1;  // is element 000 red or black on *THIS* sweep
+
+  const real_t * __restrict__ rhs      = level->my_boxes[box].vectors[       rhs_id] + ghosts*(1+jStride+kStride);
+  const real_t * __restrict__ alpha    = level->my_boxes[box].vectors[VECTOR_ALPHA ] + ghosts*(1+jStride+kStride);
+  const real_t * __restrict__ beta_i   = level->my_boxes[box].vectors[VECTOR_BETA_I] + ghosts*(1+jStride+kStride);
+  const real_t * __restrict__ beta_j   = level->my_boxes[box].vectors[VECTOR_BETA_J] + ghosts*(1+jStride+kStride);
+  const real_t * __restrict__ beta_k   = level->my_boxes[box].vectors[VECTOR_BETA_K] + ghosts*(1+jStride+kStride);
+  const real_t * __restrict__ Dinv     = level->my_boxes[box].vectors[VECTOR_DINV  ] + ghosts*(1+jStride+kStride);
+  const real_t * __restrict__ x_n      = level->my_boxes[box].vectors[       x_n_id] + ghosts*(1+jStride+kStride);
+        real_t * __restrict__ x_np1    = level->my_boxes[box].vectors[     x_np1_id] + ghosts*(1+jStride+kStride);
+
+  for(j=jlo;j<jhi;j++){
+    // out-of-place must copy old value...
+    for(i=ilo;i<ihi;i++){
+      int ijk = i + j*jStride + k*kStride;
+      x_np1[ijk] = x_n[ijk];
+    }
+    for(i=ilo+((ilo^j^k^color000)&1);i<ihi;i+=2){ // stride-2 GSRB (n.b. parity is correct for negative indices in two's complement)
+      int ijk = i + j*jStride + k*kStride;
+      double Ax     = apply_op_ijk(x_n);
+      x_np1[ijk] = x_n[ijk] + Dinv[ijk]*(rhs[ijk]-Ax);
+    }
+  }
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// calculate the region of a box updated by the t'th sweep after an exchange (relative to the first non ghost zone point)
+// returns 1 if the box touches a non-periodic domain boundary (region is clamped to the domain and the BC's must be reapplied)
+static inline int gsrb_ca_region(level_type * level, int box, int t, int *ilo, int *ihi, int *jlo, int *jhi, int *klo, int *khi){
+  const int  dim = level->my_boxes[box].dim;
+  const int  ext = level->box_ghosts - (t+1)*stencil_get_radius(); // ghost zones that remain valid after this sweep
+  int onBoundary = 0;
+  *ilo=-ext;*ihi=dim+ext;
+  *jlo=-ext;*jhi=dim+ext;
+  *klo=-ext;*khi=dim+ext;
+  if(level->boundary_condition.type != BC_PERIODIC){
+    if(level->my_boxes[box].low.i    ==0           ){*ilo=0;  onBoundary=1;}
+    if(level->my_boxes[box].low.j    ==0           ){*jlo=0;  onBoundary=1;}
+    if(level->my_boxes[box].low.k    ==0           ){*klo=0;  onBoundary=1;}
+    if(level->my_boxes[box].low.i+dim==level->dim.i){*ihi=dim;onBoundary=1;}
+    if(level->my_boxes[box].low.j+dim==level->dim.j){*jhi=dim;onBoundary=1;}
+    if(level->my_boxes[box].low.k+dim==level->dim.k){*khi=dim;onBoundary=1;}
+  }
+  return(onBoundary);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+void smooth(level_type * level, int x_id, int rhs_id, double a, double b){
+  int box,s,t;
+  int sweepsPerExchange = level->box_ghosts / stencil_get_radius();
+  if(level->box_dim < level->box_ghosts)sweepsPerExchange=1; // ghost zones deeper than a box can't be filled by an exchange with the nearest neighbors
+  int shape = (sweepsPerExchange>1) ? STENCIL_SHAPE_BOX : stencil_get_shape(); // redundant computation in the ghost zones requires edges and corners
+
+  // if communication-avoiding, need an updated RHS for the stencils in the ghost zones
+  if(sweepsPerExchange>1)exchange_boundary(level,rhs_id,STENCIL_SHAPE_BOX);
+
+  for(s=0;s<2*NUM_SMOOTHS;s+=sweepsPerExchange){ // there are two sweeps per GSRB smooth
+    int sweeps = (s+sweepsPerExchange > 2*NUM_SMOOTHS) ? 2*NUM_SMOOTHS-s : sweepsPerExchange;
+
+    // exchange the (deep) ghost zone... out-of-place GSRB ping pongs between x and VECTOR_TEMP
+    int x_n_id   = ((s&1)==0) ?        x_id : VECTOR_TEMP;
+    int x_np1_id = ((s&1)==0) ? VECTOR_TEMP :        x_id;
+    exchange_boundary(level,x_n_id,shape);
+            apply_BCs(level,x_n_id,shape);
+
+    // apply the smoother...
+    double _timeStart = getTime();
+    COUNTERS_START();
+
+    // boxes in the interior of the domain perform all sweeps as a wavefront in k...
+    //   sweep t lags sweep t-1 by stencil_get_radius() planes so that x_n(t) is complete through k+radius when sweep t reaches k.
+    //   as x_np1(t) aliases x_n(t-1), sweeps must be applied in ascending order within each step of the wavefront
+    PRAGMA_THREAD_ACROSS_BLOCKS(level,box,level->num_my_boxes)
+    for(box=0;box<level->num_my_boxes;box++){
+      int ilo,ihi,jlo,jhi,klo,khi,p,tt;
+      if(gsrb_ca_region(level,box,0,&ilo,&ihi,&jlo,&jhi,&klo,&khi))continue; // boundary boxes are handled below
+      int pend = khi; // the region shrinks by the lag, so the wavefront ends when sweep 0 passes the end of its region
+      for(p=klo;p<pend;p++){
+      for(tt=0;tt<sweeps;tt++){
+        int k = p - tt*stencil_get_radius();
+        gsrb_ca_region(level,box,tt,&ilo,&ihi,&jlo,&jhi,&klo,&khi);
+        if( (k>=klo) && (k<khi) ){
+          if((tt&1)==0)gsrb_ca_plane(level,box,  x_n_id,x_np1_id,rhs_id,a,b,s+tt,k,ilo,ihi,jlo,jhi);
+                  else gsrb_ca_plane(level,box,x_np1_id,  x_n_id,rhs_id,a,b,s+tt,k,ilo,ihi,jlo,jhi);
+        }
+      }}
+    }
+
+    // boxes on the domain boundary perform one sweep at a time, reapplying the BC's in between...
+    for(t=0;t<sweeps;t++){
+      int src_id = ((t&1)==0) ?   x_n_id : x_np1_id;
+      int dst_id = ((t&1)==0) ? x_np1_id :   x_n_id;
+      if(t>0){
+        level->timers.smooth += (double)(getTime()-_timeStart);
+        COUNTERS_STOP(level,COUNTED_SMOOTH);
+        apply_BCs(level,src_id,shape);
+        _timeStart = getTime();
+        COUNTERS_RESTART();
+      }
+      for(box=0;box<level->num_my_boxes;box++){
+        int ilo,ihi,jlo,jhi,klo,khi,k;
+        if(!gsrb_ca_region(level,box,t,&ilo,&ihi,&jlo,&jhi,&klo,&khi))continue; // interior boxes were handled above
+        PRAGMA_THREAD_ACROSS_BLOCKS(level,k,khi-klo)
+        for(k=klo;k<khi;k++){
+          gsrb_ca_plane(level,box,src_id,dst_id,rhs_id,a,b,s+t,k,ilo,ihi,jlo,jhi);
+        }
+      }
+    }
+
+    level->timers.smooth += (double)(getTime()-_timeStart);
+    COUNTERS_STOP(level,COUNTED_SMOOTH);
+  } // s-loop
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
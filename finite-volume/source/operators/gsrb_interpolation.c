@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Samuel Williams
+// SWWilliams@lbl.gov
+// Lawrence Berkeley National Lab
+//------------------------------------------------------------------------------------------------------------------------------
+// This fuses the v-cycle's prolongation (x += interpolation_v2 of the coarse grid correction) with the first GSRB sweep
+//  - x's ghost zones are still valid from the residual on the down-leg (nothing has touched x on this level since).
+//    Thus, rather than exchanging the interpolated x, each box interpolates the correction into its ghost zones as well.
+//  - boxes that don't touch a (non-periodic) domain boundary interpolate two fine grid planes at a time and immediately apply
+//    the first sweep to the planes that are complete through the stencil radius (a wavefront in k)
+//  - boxes on the domain boundary must reapply the BC's to the interpolated x before the first sweep
+// It assumes...
+//   out-of-place GSRB (GSRB_OOP) with the first sweep reading x and writing VECTOR_TEMP (see gsrb_ca_plane())
+//   the coarse grid correction is available locally (interpolation_is_local) and has at least two ghost zones
+//   the fine grid has at least two ghost zones and the stencil radius is no more than two (e.g. operators.fv4.c)
+// If any of these is not the case, this reverts to interpolation_vcycle() followed by smooth()
+//------------------------------------------------------------------------------------------------------------------------------
+// look up the coarse grid box containing the fine grid box (precomputed by build_interpolation) and set the blockCopy's read.i,j,k to the offset of the fine box within it
+static inline int gsrb_interpolation_coarse_box(level_type * level_f, int box, level_type * level_c, blockCopy_type *block){
+  int c = level_f->interpolation_coarse_box[box];
+  if(c<0)return(-1);
+  block->read.box = c;
+  block->read.i   = level_f->my_boxes[box].low.i/2 - level_c->my_boxes[c].low.i;
+  block->read.j   = level_f->my_boxes[box].low.j/2 - level_c->my_boxes[c].low.j;
+  block->read.k   = level_f->my_boxes[box].low.k/2 - level_c->my_boxes[c].low.k;
+  return(c);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// interpolate coarse planes [kklo,kkhi) (relative to the fine box's coarse region) into the fine box and one coarse cell (two fine cells) of its ghost zone
+static inline void gsrb_interpolation_planes(level_type * level_f, int box, int x_id, level_type * level_c, int e_id, blockCopy_type *region, int kklo, int kkhi){
+  blockCopy_type block = *region;
+  block.dim.i   = (level_f->box_dim>>1)+2;
+  block.dim.j   = (level_f->box_dim>>1)+2;
+  block.dim.k   = kkhi-kklo;
+  block.read.i  = region->read.i-1;
+  block.read.j  = region->read.j-1;
+  block.read.k  = region->read.k+kklo;
+  block.write.i = -2;
+  block.write.j = -2;
+  block.write.k = 2*kklo;
+  interpolation_v2_block(level_f,x_id,1.0,level_c,e_id,&block);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+void interpolation_smooth(level_type * level_f, int x_id, level_type * level_c, int e_id, int rhs_id, double a, double b){
+  int box;
+  if( (!level_f->interpolation_is_local) || (level_f->box_ghosts<2) || (level_c->box_ghosts<2) || (level_f->box_dim<4) || (stencil_get_radius()>2) ){
+    interpolation_vcycle(level_f,x_id,1.0,level_c,e_id);
+           gsrb_sweeps(level_f,x_id,rhs_id,a,b,0);
+    return;
+  }
+
+  // quadratic interpolation requires a full ghost zone exchange and boundary condition on the coarse grid (as in interpolation_v2)
+  exchange_boundary(level_c,e_id,STENCIL_SHAPE_BOX);
+       apply_BCs_v2(level_c,e_id,STENCIL_SHAPE_BOX);
+
+  double _timeStart = getTime();
+  COUNTERS_START();
+  const int cdim = level_f->box_dim>>1;
+
+  // interior boxes interpolate one coarse plane (two fine planes) at a time and sweep the fine planes that are now complete through k+radius
+  // boundary boxes are interpolated in their entirety (including their ghost zones)...
+  PRAGMA_THREAD_ACROSS_BLOCKS(level_f,box,level_f->num_my_boxes)
+  for(box=0;box<level_f->num_my_boxes;box++){
+    int ilo,ihi,jlo,jhi,klo,khi,kk,k;
+    blockCopy_type region;
+    region.subtype  = 0;
+    region.read.ptr = NULL;region.write.ptr = NULL;
+    region.write.box = box;
+    if(gsrb_interpolation_coarse_box(level_f,box,level_c,&region)<0){fprintf(stderr,"interpolation_smooth: no local coarse box for fine box %d\n",box);exit(0);}
+    if(gsrb_ca_region(level_f,box,0,&ilo,&ihi,&jlo,&jhi,&klo,&khi)){
+      gsrb_interpolation_planes(level_f,box,x_id,level_c,e_id,&region,-1,cdim+1);
+      continue;
+    }
+    for(kk=-1;kk<=cdim;kk++){
+      gsrb_interpolation_planes(level_f,box,x_id,level_c,e_id,&region,kk,kk+1);
+      for(k=2*kk-stencil_get_radius();k<2*kk+2-stencil_get_radius();k++){
+        if( (k>=0) && (k<level_f->box_dim) )gsrb_ca_plane(level_f,box,x_id,VECTOR_TEMP,rhs_id,a,b,0,k,0,level_f->box_dim,0,level_f->box_dim);
+      }
+    }
+  }
+
+  // boundary boxes must reapply the BC's to the interpolated x before the first sweep...
+  level_f->timers.smooth += (double)(getTime()-_timeStart);
+  COUNTERS_STOP(level_f,COUNTED_SMOOTH);
+  apply_BCs(level_f,x_id,stencil_get_shape());
+  _timeStart = getTime();
+  COUNTERS_RESTART();
+  for(box=0;box<level_f->num_my_boxes;box++){
+    int ilo,ihi,jlo,jhi,klo,khi,k;
+    if(!gsrb_ca_region(level_f,box,0,&ilo,&ihi,&jlo,&jhi,&klo,&khi))continue; // interior boxes were handled above
+    PRAGMA_THREAD_ACROSS_BLOCKS(level_f,k,level_f->box_dim)
+    for(k=0;k<level_f->box_dim;k++){
+      gsrb_ca_plane(level_f,box,x_id,VECTOR_TEMP,rhs_id,a,b,0,k,0,level_f->box_dim,0,level_f->box_dim);
+    }
+  }
+  level_f->timers.smooth += (double)(getTime()-_timeStart);
+  COUNTERS_STOP(level_f,COUNTED_SMOOTH);
+
+  // remaining sweeps are conventional...
+  gsrb_sweeps(level_f,x_id,rhs_id,a,b,1);
+}
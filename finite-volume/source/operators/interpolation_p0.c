@@ -21,8 +21,8 @@ static inline void interpolation_p0_block(level_type *level_f, int id_f, double
   int write_jStride = block->write.jStride;
   int write_kStride = block->write.kStride;
 
-  double * __restrict__  read = block->read.ptr;
-  double * __restrict__ write = block->write.ptr;
+  real_t * __restrict__  read = block->read.ptr;
+  real_t * __restrict__ write = block->write.ptr;
   if(block->read.box >=0){
      read = level_c->my_boxes[ block->read.box].vectors[id_c] + level_c->my_boxes[ block->read.box].ghosts*(1+level_c->my_boxes[ block->read.box].jStride+level_c->my_boxes[ block->read.box].kStride);
      read_jStride = level_c->my_boxes[block->read.box ].jStride;
@@ -51,6 +51,7 @@ static inline void interpolation_p0_block(level_type *level_f, int id_f, double
 // perform a (inter-level) piecewise constant interpolation
 void interpolation_p0(level_type * level_f, int id_f, double prescale_f, level_type *level_c, int id_c){
   double _timeCommunicationStart = getTime();
+  COUNTERS_START();
   double _timeStart,_timeEnd;
   int my_tag = (level_f->tag<<4) | 0x6;
   int buffer=0;
@@ -73,7 +74,7 @@ void interpolation_p0(level_type * level_f, int id_f, double prescale_f, level_t
     for(n=0;n<level_f->interpolation.num_recvs;n++){
       MPI_Irecv(level_f->interpolation.recv_buffers[n],
                 level_f->interpolation.recv_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level_f->interpolation.recv_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
@@ -107,7 +108,7 @@ void interpolation_p0(level_type * level_f, int id_f, double prescale_f, level_t
     for(n=0;n<level_c->interpolation.num_sends;n++){
       MPI_Isend(level_c->interpolation.send_buffers[n],
                 level_c->interpolation.send_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level_c->interpolation.send_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
@@ -156,4 +157,5 @@ void interpolation_p0(level_type * level_f, int id_f, double prescale_f, level_t
  
  
   level_f->timers.interpolation_total += (double)(getTime()-_timeCommunicationStart);
+  COUNTERS_STOP(level_f,COUNTED_INTERPOLATION);
 }
@@ -23,8 +23,8 @@ static inline void interpolation_p1_block(level_type *level_f, int id_f, double
   int write_jStride = block->write.jStride;
   int write_kStride = block->write.kStride;
 
-  const double * __restrict__  read = block->read.ptr;
-        double * __restrict__ write = block->write.ptr;
+  const real_t * __restrict__  read = block->read.ptr;
+        real_t * __restrict__ write = block->write.ptr;
 
   if(block->read.box >=0){
      read_jStride = level_c->my_boxes[block->read.box ].jStride;
@@ -72,6 +72,7 @@ void interpolation_p1(level_type * level_f, int id_f, double prescale_f, level_t
        apply_BCs_p1(level_c,id_c,STENCIL_SHAPE_BOX);
 
   double _timeCommunicationStart = getTime();
+  COUNTERS_START();
   double _timeStart,_timeEnd;
   int buffer=0;
   int n;
@@ -94,7 +95,7 @@ void interpolation_p1(level_type * level_f, int id_f, double prescale_f, level_t
     for(n=0;n<level_f->interpolation.num_recvs;n++){
       MPI_Irecv(level_f->interpolation.recv_buffers[n],
                 level_f->interpolation.recv_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level_f->interpolation.recv_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
@@ -128,7 +129,7 @@ void interpolation_p1(level_type * level_f, int id_f, double prescale_f, level_t
     for(n=0;n<level_c->interpolation.num_sends;n++){
       MPI_Isend(level_c->interpolation.send_buffers[n],
                 level_c->interpolation.send_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level_c->interpolation.send_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
@@ -177,4 +178,5 @@ void interpolation_p1(level_type * level_f, int id_f, double prescale_f, level_t
  
  
   level_f->timers.interpolation_total += (double)(getTime()-_timeCommunicationStart);
+  COUNTERS_STOP(level_f,COUNTED_INTERPOLATION);
 }
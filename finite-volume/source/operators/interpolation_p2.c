@@ -23,8 +23,8 @@ static inline void interpolation_p2_block(level_type *level_f, int id_f, double
   int write_jStride = block->write.jStride;
   int write_kStride = block->write.kStride;
 
-  const double * __restrict__  read = block->read.ptr;
-        double * __restrict__ write = block->write.ptr;
+  const real_t * __restrict__  read = block->read.ptr;
+        real_t * __restrict__ write = block->write.ptr;
 
   if(block->read.box >=0){
      read_jStride = level_c->my_boxes[block->read.box ].jStride;
@@ -94,10 +94,10 @@ static inline void interpolation_p2_block(level_type *level_f, int id_f, double
   for(k=0,kk=0;k<write_dim_k;k+=2,kk++){
   for(j=0,jj=0;j<write_dim_j;j+=2,jj++){
   // compiler cannot infer/speculate write[ijk+write_jStride] is disjoint from write[ijk], so create a unique restrict pointers for each nonliteral offset...
-  double * __restrict__ write00 = write + write_i + (write_j+j+0)*write_jStride + (write_k+k+0)*write_kStride;
-  double * __restrict__ write10 = write + write_i + (write_j+j+1)*write_jStride + (write_k+k+0)*write_kStride;
-  double * __restrict__ write01 = write + write_i + (write_j+j+0)*write_jStride + (write_k+k+1)*write_kStride;
-  double * __restrict__ write11 = write + write_i + (write_j+j+1)*write_jStride + (write_k+k+1)*write_kStride;
+  real_t * __restrict__ write00 = write + write_i + (write_j+j+0)*write_jStride + (write_k+k+0)*write_kStride;
+  real_t * __restrict__ write10 = write + write_i + (write_j+j+1)*write_jStride + (write_k+k+0)*write_kStride;
+  real_t * __restrict__ write01 = write + write_i + (write_j+j+0)*write_jStride + (write_k+k+1)*write_kStride;
+  real_t * __restrict__ write11 = write + write_i + (write_j+j+1)*write_jStride + (write_k+k+1)*write_kStride;
   for(i=0,ii=0;i<write_dim_i;i+=2,ii++){
     int write_ijk = ( i+write_i) + ( j+write_j)*write_jStride + ( k+write_k)*write_kStride;
     int  read_ijk = (ii+ read_i) + (jj+ read_j)* read_jStride + (kk+ read_k)* read_kStride;
@@ -230,6 +230,7 @@ void interpolation_p2(level_type * level_f, int id_f, double prescale_f, level_t
          apply_BCs_p2(level_c,id_c,STENCIL_SHAPE_BOX);
 
   double _timeCommunicationStart = getTime();
+  COUNTERS_START();
   double _timeStart,_timeEnd;
   int buffer=0;
   int n;
@@ -252,7 +253,7 @@ void interpolation_p2(level_type * level_f, int id_f, double prescale_f, level_t
     for(n=0;n<level_f->interpolation.num_recvs;n++){
       MPI_Irecv(level_f->interpolation.recv_buffers[n],
                 level_f->interpolation.recv_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level_f->interpolation.recv_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
@@ -286,7 +287,7 @@ void interpolation_p2(level_type * level_f, int id_f, double prescale_f, level_t
     for(n=0;n<level_c->interpolation.num_sends;n++){
       MPI_Isend(level_c->interpolation.send_buffers[n],
                 level_c->interpolation.send_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level_c->interpolation.send_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
@@ -335,4 +336,5 @@ void interpolation_p2(level_type * level_f, int id_f, double prescale_f, level_t
  
  
   level_f->timers.interpolation_total += (double)(getTime()-_timeCommunicationStart);
+  COUNTERS_STOP(level_f,COUNTED_INTERPOLATION);
 }
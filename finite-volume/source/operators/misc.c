@@ -31,7 +31,7 @@ void zero_vector(level_type * level, int id_a){
     if(jhi>=dim)jhi+=ghosts; 
     if(khi>=dim)khi+=ghosts; 
 
-    double * __restrict__ grid = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
 
     for(k=klo;k<khi;k++){
     for(j=jlo;j<jhi;j++){
@@ -73,7 +73,7 @@ void init_vector(level_type * level, int id_a, double scalar){
     if(jhi>=dim)jhi+=ghosts; 
     if(khi>=dim)khi+=ghosts; 
 
-    double * __restrict__ grid = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
 
     for(k=klo;k<khi;k++){
     for(j=jlo;j<jhi;j++){
@@ -109,9 +109,9 @@ void add_vectors(level_type * level, int id_c, double scale_a, int id_a, double
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
-    double * __restrict__ grid_c = level->my_boxes[box].vectors[id_c] + ghosts*(1+jStride+kStride);
-    double * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
-    double * __restrict__ grid_b = level->my_boxes[box].vectors[id_b] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_c = level->my_boxes[box].vectors[id_c] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_b = level->my_boxes[box].vectors[id_b] + ghosts*(1+jStride+kStride);
 
     for(k=klo;k<khi;k++){
     for(j=jlo;j<jhi;j++){
@@ -146,9 +146,9 @@ void mul_vectors(level_type * level, int id_c, double scale, int id_a, int id_b)
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
-    double * __restrict__ grid_c = level->my_boxes[box].vectors[id_c] + ghosts*(1+jStride+kStride);
-    double * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
-    double * __restrict__ grid_b = level->my_boxes[box].vectors[id_b] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_c = level->my_boxes[box].vectors[id_c] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_b = level->my_boxes[box].vectors[id_b] + ghosts*(1+jStride+kStride);
 
     for(k=klo;k<khi;k++){
     for(j=jlo;j<jhi;j++){
@@ -183,8 +183,8 @@ void invert_vector(level_type * level, int id_c, double scale_a, int id_a){
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
-    double * __restrict__ grid_c = level->my_boxes[box].vectors[id_c] + ghosts*(1+jStride+kStride);
-    double * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_c = level->my_boxes[box].vectors[id_c] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
 
     for(k=klo;k<khi;k++){
     for(j=jlo;j<jhi;j++){
@@ -219,8 +219,8 @@ void scale_vector(level_type * level, int id_c, double scale_a, int id_a){
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
-    double * __restrict__ grid_c = level->my_boxes[box].vectors[id_c] + ghosts*(1+jStride+kStride);
-    double * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_c = level->my_boxes[box].vectors[id_c] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride);
 
     for(k=klo;k<khi;k++){
     for(j=jlo;j<jhi;j++){
@@ -256,8 +256,8 @@ double dot(level_type * level, int id_a, int id_b){
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
-    double * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
-    double * __restrict__ grid_b = level->my_boxes[box].vectors[id_b] + ghosts*(1+jStride+kStride);
+    real_t * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+    real_t * __restrict__ grid_b = level->my_boxes[box].vectors[id_b] + ghosts*(1+jStride+kStride);
     double a_dot_b_block = 0.0;
 
     for(k=klo;k<khi;k++){
@@ -303,7 +303,7 @@ double norm(level_type * level, int id_a){ // implements the max norm
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
-    double * __restrict__ grid   = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+    real_t * __restrict__ grid   = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
     double block_norm = 0.0;
 
     for(k=klo;k<khi;k++){
@@ -353,7 +353,7 @@ double mean(level_type * level, int id_a){
     int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
-    double * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+    real_t * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
     double sum_block = 0.0;
 
     for(k=klo;k<khi;k++){
@@ -380,6 +380,142 @@ double mean(level_type * level, int id_a){
 }
 
 
+//------------------------------------------------------------------------------------------------------------------------------
+// split-phase (nonblocking) reductions...
+//   dots_start() calculates num_dots local dot products (id_a[d].id_b[d]) and optionally the local max norm of norm_id in one pass
+//   through the data and starts a single MPI_Iallreduce of all of them.  dots_finish() waits for it and returns the global
+//   values in reduction->value[0..num_dots-1] (and the max norm in reduction->value[num_dots]).
+//   Work placed between start and finish (e.g. apply_op) overlaps the latency of the allreduce.
+// note, only non ghost zone values are included in this calculation
+#ifdef USE_MPI
+// the max norm (if any) is the last element of the buffer.  MPI user ops don't take arguments, so the layout is passed through the datatype...
+static MPI_Datatype reduction_dots_type[REDUCTION_MAX_DOTS+2];
+static MPI_Op       reduction_sum_max_op = MPI_OP_NULL;
+static void reduction_sum_max(void *in, void *inout, int *len, MPI_Datatype *type){
+  int n,e,d;
+  for(n=1;n<=REDUCTION_MAX_DOTS+1;n++)if(*type==reduction_dots_type[n])break; // n = number of doubles per element
+  double *a = (double*)in;
+  double *b = (double*)inout;
+  for(e=0;e<*len;e++){
+    for(d=0;d<n-1;d++)b[e*n+d] += a[e*n+d];
+    if(a[e*n+n-1]>b[e*n+n-1])b[e*n+n-1]=a[e*n+n-1];
+  }
+}
+#endif
+
+void dots_start(level_type * level, reduction_type * reduction, int num_dots, const int *id_a, const int *id_b, int norm_id){
+  double _timeStart = getTime();
+  int block,d;
+  if(num_dots>REDUCTION_MAX_DOTS){fprintf(stderr,"dots_start() supports at most %d dot products\n",REDUCTION_MAX_DOTS);exit(0);}
+  reduction->num_dots = num_dots;
+  reduction->has_norm = (norm_id>=0);
+  for(d=0;d<=num_dots;d++)reduction->value[d]=0.0;
+
+  PRAGMA_THREAD_ACROSS_BLOCKS(level,block,level->num_my_blocks)
+  for(block=0;block<level->num_my_blocks;block++){
+    const int box = level->my_blocks[block].read.box;
+    const int ilo = level->my_blocks[block].read.i;
+    const int jlo = level->my_blocks[block].read.j;
+    const int klo = level->my_blocks[block].read.k;
+    const int ihi = level->my_blocks[block].dim.i + ilo;
+    const int jhi = level->my_blocks[block].dim.j + jlo;
+    const int khi = level->my_blocks[block].dim.k + klo;
+    int i,j,k,dd;
+    const int jStride = level->my_boxes[box].jStride;
+    const int kStride = level->my_boxes[box].kStride;
+    const int  ghosts = level->my_boxes[box].ghosts;
+    double block_sums[REDUCTION_MAX_DOTS+1];
+    for(dd=0;dd<=num_dots;dd++)block_sums[dd]=0.0;
+
+    for(dd=0;dd<num_dots;dd++){ // n.b. the block is small enough to remain in cache across the dot products
+      const real_t * __restrict__ grid_a = level->my_boxes[box].vectors[id_a[dd]] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+      const real_t * __restrict__ grid_b = level->my_boxes[box].vectors[id_b[dd]] + ghosts*(1+jStride+kStride);
+      double a_dot_b_block = 0.0;
+      for(k=klo;k<khi;k++){
+      for(j=jlo;j<jhi;j++){
+      for(i=ilo;i<ihi;i++){
+        int ijk = i + j*jStride + k*kStride;
+        a_dot_b_block += grid_a[ijk]*grid_b[ijk];
+      }}}
+      block_sums[dd] = a_dot_b_block;
+    }
+    if(norm_id>=0){
+      const real_t * __restrict__ grid = level->my_boxes[box].vectors[norm_id] + ghosts*(1+jStride+kStride);
+      double block_norm = 0.0;
+      for(k=klo;k<khi;k++){
+      for(j=jlo;j<jhi;j++){
+      for(i=ilo;i<ihi;i++){
+        int ijk = i + j*jStride + k*kStride;
+        double fabs_grid_ijk = fabs(grid[ijk]);
+        if(fabs_grid_ijk>block_norm){block_norm=fabs_grid_ijk;} // max norm
+      }}}
+      block_sums[num_dots] = block_norm;
+    }
+
+    #ifdef _OPENMP
+    #pragma omp critical (dots_start)
+    #endif
+    {
+      for(dd=0;dd<num_dots;dd++)reduction->value[dd]+=block_sums[dd];
+      if(block_sums[num_dots]>reduction->value[num_dots])reduction->value[num_dots]=block_sums[num_dots];
+    }
+  }
+  level->timers.blas1 += (double)(getTime()-_timeStart);
+
+  #ifdef USE_MPI
+  double _timeStartAllReduce = getTime();
+  int n = num_dots + reduction->has_norm;
+  for(d=0;d<n;d++)reduction->send[d]=reduction->value[d];
+  if(!reduction->has_norm){
+    #if (MPI_VERSION>=3)
+    MPI_Iallreduce(reduction->send,reduction->value,n,MPI_DOUBLE,MPI_SUM,level->MPI_COMM_ALLREDUCE,&reduction->request);
+    #else
+    MPI_Allreduce( reduction->send,reduction->value,n,MPI_DOUBLE,MPI_SUM,level->MPI_COMM_ALLREDUCE);
+    #endif
+  }else{
+    if(reduction_sum_max_op==MPI_OP_NULL){
+      for(d=1;d<=REDUCTION_MAX_DOTS+1;d++){MPI_Type_contiguous(d,MPI_DOUBLE,&reduction_dots_type[d]);MPI_Type_commit(&reduction_dots_type[d]);}
+      MPI_Op_create(reduction_sum_max,1,&reduction_sum_max_op);
+    }
+    #if (MPI_VERSION>=3)
+    MPI_Iallreduce(reduction->send,reduction->value,1,reduction_dots_type[n],reduction_sum_max_op,level->MPI_COMM_ALLREDUCE,&reduction->request);
+    #else
+    MPI_Allreduce( reduction->send,reduction->value,1,reduction_dots_type[n],reduction_sum_max_op,level->MPI_COMM_ALLREDUCE);
+    #endif
+  }
+  level->timers.collectives += (double)(getTime()-_timeStartAllReduce);
+  #endif
+}
+
+void dots_finish(level_type * level, reduction_type * reduction){
+  #if defined(USE_MPI) && (MPI_VERSION>=3)
+  double _timeStartWait = getTime();
+  MPI_Wait(&reduction->request,MPI_STATUS_IGNORE);
+  level->timers.collectives += (double)(getTime()-_timeStartWait);
+  #endif
+}
+
+// release the datatypes and op dots_start() creates on first use (they are recreated if dots_start() is called again)
+void dots_destroy(void){
+  #ifdef USE_MPI
+  int d;
+  if(reduction_sum_max_op==MPI_OP_NULL)return;
+  for(d=1;d<=REDUCTION_MAX_DOTS+1;d++)MPI_Type_free(&reduction_dots_type[d]);
+  MPI_Op_free(&reduction_sum_max_op); // n.b. resets it to MPI_OP_NULL
+  #endif
+}
+
+// split-phase version of dot()
+void dot_start(level_type * level, reduction_type * reduction, int id_a, int id_b){
+  dots_start(level,reduction,1,&id_a,&id_b,-1);
+}
+
+double dot_finish(level_type * level, reduction_type * reduction){
+  dots_finish(level,reduction);
+  return(reduction->value[0]);
+}
+
+
 //------------------------------------------------------------------------------------------------------------------------------
 // add the scalar value shift_a to each element of vector id_a and store the result in vector id_c
 // note, only non ghost zone values are included in this calculation
@@ -400,8 +536,8 @@ void shift_vector(level_type * level, int id_c, int id_a, double shift_a){
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
-    double * __restrict__ grid_c = level->my_boxes[box].vectors[id_c] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
-    double * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+    real_t * __restrict__ grid_c = level->my_boxes[box].vectors[id_c] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+    real_t * __restrict__ grid_a = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
 
 
     for(k=klo;k<khi;k++){
@@ -457,7 +593,7 @@ void color_vector(level_type * level, int id_a, int colors_in_each_dim, int icol
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
-    double * __restrict__ grid = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+    real_t * __restrict__ grid = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
     int i,j,k;
 
     for(k=klo;k<khi;k++){double sk=0.0;if( ((k+boxlowk+kcolor)%colors_in_each_dim) == 0 )sk=1.0; // if colors_in_each_dim==1 (don't color), all cells are set to 1.0
@@ -491,7 +627,7 @@ void random_vector(level_type * level, int id_a){
     const int jStride = level->my_boxes[box].jStride;
     const int kStride = level->my_boxes[box].kStride;
     const int  ghosts = level->my_boxes[box].ghosts;
-    double * __restrict__ grid = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+    real_t * __restrict__ grid = level->my_boxes[box].vectors[id_a] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
     int i,j,k;
 
     for(k=klo;k<khi;k++){
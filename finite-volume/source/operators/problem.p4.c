@@ -69,6 +69,15 @@ void evaluateU(double x, double y, double z, double *U, double *Ux, double *Uy,
 void initialize_problem(level_type * level, double hLevel, double a, double b){
   level->h = hLevel;
 
+  // a rectahedral domain is [0,Li]x[0,Lj]x[0,Lk] with its longest dimension 1 (see hpgmg-fv.c).  Map it onto the [0,1]^3 the problem is defined on...
+  int dim_max = level->dim.i;if(level->dim.j>dim_max)dim_max=level->dim.j;if(level->dim.k>dim_max)dim_max=level->dim.k;
+  const double Li = (double)level->dim.i/(double)dim_max;
+  const double Lj = (double)level->dim.j/(double)dim_max;
+  const double Lk = (double)level->dim.k/(double)dim_max;
+  const double hi = hLevel/Li; // i.e. the grid spacing on [0,1]^3
+  const double hj = hLevel/Lj;
+  const double hk = hLevel/Lk;
+
   int box;
   for(box=0;box<level->num_my_boxes;box++){
     int i,j,k;
@@ -86,9 +95,9 @@ void initialize_problem(level_type * level, double hLevel, double a, double b){
     for(i=0;i<=dim_i;i++){ // include high face
       //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
       int ijk = (i+ghosts) + (j+ghosts)*jStride + (k+ghosts)*kStride;
-      double x = hLevel*( (double)(i+level->my_boxes[box].low.i) + 0.5 ); // +0.5 to get to the center of cell
-      double y = hLevel*( (double)(j+level->my_boxes[box].low.j) + 0.5 );
-      double z = hLevel*( (double)(k+level->my_boxes[box].low.k) + 0.5 );
+      double x = hi*( (double)(i+level->my_boxes[box].low.i) + 0.5 ); // +0.5 to get to the center of cell
+      double y = hj*( (double)(j+level->my_boxes[box].low.j) + 0.5 );
+      double z = hk*( (double)(k+level->my_boxes[box].low.k) + 0.5 );
       double A,B,Bx,By,Bz,Bi,Bj,Bk;
       double U,Ux,Uy,Uz,Uxx,Uyy,Uzz;
       //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -101,13 +110,15 @@ void initialize_problem(level_type * level, double hLevel, double a, double b){
       Bj = 1.0;
       Bk = 1.0;
       #ifdef STENCIL_VARIABLE_COEFFICIENT // variable coefficient problem...
-      evaluateBeta(x-hLevel*0.5,y           ,z           ,&Bi,&Bx,&By,&Bz); // face-centered value of Beta for beta_i
-      evaluateBeta(x           ,y-hLevel*0.5,z           ,&Bj,&Bx,&By,&Bz); // face-centered value of Beta for beta_j
-      evaluateBeta(x           ,y           ,z-hLevel*0.5,&Bk,&Bx,&By,&Bz); // face-centered value of Beta for beta_k
+      evaluateBeta(x-hi*0.5    ,y           ,z           ,&Bi,&Bx,&By,&Bz); // face-centered value of Beta for beta_i
+      evaluateBeta(x           ,y-hj*0.5    ,z           ,&Bj,&Bx,&By,&Bz); // face-centered value of Beta for beta_j
+      evaluateBeta(x           ,y           ,z-hk*0.5    ,&Bk,&Bx,&By,&Bz); // face-centered value of Beta for beta_k
       evaluateBeta(x           ,y           ,z           ,&B ,&Bx,&By,&Bz); // cell-centered value of Beta
+      Bx/=Li;By/=Lj;Bz/=Lk; // chain rule (derivatives on [0,1]^3 -> on the domain)
       #endif
       //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
       evaluateU(x,y,z,&U,&Ux,&Uy,&Uz,&Uxx,&Uyy,&Uzz, (level->boundary_condition.type == BC_PERIODIC) );
+      Ux/=Li;Uy/=Lj;Uz/=Lk;Uxx/=(Li*Li);Uyy/=(Lj*Lj);Uzz/=(Lk*Lk);
       double F = a*A*U - b*( (Bx*Ux + By*Uy + Bz*Uz)  +  B*(Uxx + Uyy + Uzz) );
       //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
       level->my_boxes[box].vectors[VECTOR_BETA_I][ijk] = Bi;
@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Samuel Williams
+// SWWilliams@lbl.gov
+// Lawrence Berkeley National Lab
+//------------------------------------------------------------------------------------------------------------------------------
+// runtime selection of the smoother and residual/apply_op kernels...
+//  The operator file compiles every variant under a unique name (e.g. smooth_gsrb) and populates smoothers[] and op_kernels[].
+//  smooth(), interpolation_smooth(), residual(), residual_restriction(), and apply_op() then simply dispatch through the level so that each level may use a different kernel.
+//------------------------------------------------------------------------------------------------------------------------------
+int num_smoothers      = sizeof(smoothers )/sizeof(smoother_type  );
+int num_op_kernels     = sizeof(op_kernels)/sizeof(op_kernels_type);
+int default_smoother   = 0;
+int default_op_kernels = 0;
+int fuse_interpolation = 0;
+int overlap_exchange   = 0;
+int exchange_method    = EXCHANGE_P2P;
+const char *exchange_methods[] = {"p2p","persistent","neighbor","shm"}; // indexed by EXCHANGE_*
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+const char *smoother_default_name(void){ // the smoother chosen at compile time (if any)
+  #if   defined(USE_CHEBY)
+  return("cheby");
+  #elif defined(USE_JACOBI)
+  return("jacobi");
+  #elif defined(USE_L1JACOBI)
+  return("l1jacobi");
+  #elif defined(USE_SYMGS)
+  return("symgs");
+  #else
+  return("gsrb");
+  #endif
+}
+
+int smoother_lookup(const char *name){
+  int s;
+  const char *lookup = (name!=NULL) ? name : smoother_default_name();
+  for(s=0;s<num_smoothers;s++)if(strcmp(lookup,smoothers[s].name)==0)return(s);
+  if(name==NULL)return(0); // this operator doesn't register the compile time default... fall back to its own default (first entry)
+  return(-1);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+int op_kernels_lookup(const char *name){
+  int k;
+  if(name==NULL)return(0); // first entry is the operator's reference implementation
+  for(k=0;k<num_op_kernels;k++)if(strcmp(name,op_kernels[k].name)==0)return(k);
+  return(-1);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+int exchange_method_lookup(const char *name){
+  int m;
+  if(name==NULL)return(EXCHANGE_P2P);
+  for(m=0;m<=EXCHANGE_SHM;m++)if(strcmp(name,exchange_methods[m])==0)break;
+  if(m>EXCHANGE_SHM)return(-1);
+  #if defined(USE_MPI) && (MPI_VERSION<3)
+  if( (m==EXCHANGE_NEIGHBOR) || (m==EXCHANGE_SHM) )return(-1); // neighborhood collectives and shared windows require MPI-3
+  #endif
+  #if defined(USE_MPI) && defined(USE_VBKJI_LAYOUT)
+  if(m==EXCHANGE_SHM)return(-1); // shared windows are only carved into the [box][vector] layout
+  #endif
+  return(m);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+void smooth(level_type * level, int x_id, int rhs_id, double a, double b){
+  smoothers[level->smoother].smooth(level,x_id,rhs_id,a,b);
+}
+
+// use the smoother's fused interpolation (if requested and available), otherwise interpolate and then smooth
+void interpolation_smooth(level_type * level_f, int phi_id, level_type *level_c, int e_id, int rhs_id, double a, double b){
+  if( fuse_interpolation && (smoothers[level_f->smoother].interpolation_smooth!=NULL) ){
+    smoothers[level_f->smoother].interpolation_smooth(level_f,phi_id,level_c,e_id,rhs_id,a,b);
+  }else{
+    interpolation_vcycle(level_f,phi_id,1.0,level_c,e_id);
+                  smooth(level_f,phi_id,rhs_id,a,b);
+  }
+}
+
+void residual(level_type * level, int res_id, int x_id, int rhs_id, double a, double b){
+  op_kernels[level->op_kernels].residual(level,res_id,x_id,rhs_id,a,b);
+}
+
+// use the fused kernel if this level's op_kernels provides one, otherwise calculate the residual in VECTOR_TEMP and restrict it
+void residual_restriction(level_type * level_c, int R_id, level_type *level_f, int x_id, int rhs_id, double a, double b){
+  if(op_kernels[level_f->op_kernels].residual_restriction!=NULL){
+    op_kernels[level_f->op_kernels].residual_restriction(level_c,R_id,level_f,x_id,rhs_id,a,b);
+  }else{
+       residual(level_f,VECTOR_TEMP,x_id,rhs_id,a,b);
+    restriction(level_c,R_id,level_f,VECTOR_TEMP,RESTRICT_CELL);
+  }
+}
+
+void apply_op(level_type * level, int Ax_id, int x_id, double a, double b){
+  op_kernels[level->op_kernels].apply_op(level,Ax_id,x_id,a,b);
+}
+//------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,69 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Samuel Williams
+// SWWilliams@lbl.gov
+// Lawrence Berkeley National Lab
+//------------------------------------------------------------------------------------------------------------------------------
+// This calculates the residual res=rhs-A(x_hi+x_lo) where x_lo is the trailing part of a solution maintained by add_vector_pair()
+// With -DUSE_MIXED_PRECISION, vectors are stored in single precision and MGSolve/FMGSolve use iterative refinement.  As such,
+// the residual on the finest level must be calculated to (nearly) double precision...
+//  - each box's x_hi+x_lo (including ghost zones) is expanded into a double precision copy (one per thread, kept in level->pair_x)
+//  - the operator (apply_op_ijk) is then applied to that copy so that no arithmetic on x is performed in single precision
+// NOTE, x_hi_id and x_lo_id must be distinct from rhs_id and res_id
+//------------------------------------------------------------------------------------------------------------------------------
+#ifdef USE_MIXED_PRECISION
+void residual_pair(level_type * level, int res_id, int x_hi_id, int x_lo_id, int rhs_id, double a, double b){
+  // exchange the boundary for both parts of x in prep for Ax...
+  exchange_boundary(level,x_hi_id,stencil_get_shape());
+          apply_BCs(level,x_hi_id,stencil_get_shape());
+  exchange_boundary(level,x_lo_id,stencil_get_shape());
+          apply_BCs(level,x_lo_id,stencil_get_shape());
+
+  // one box worth of double precision scratch per thread, allocated on first use and reused by every subsequent call
+  if(level->pair_x==NULL){
+    level->pair_x = (double*)malloc((uint64_t)level->num_threads*level->box_volume*sizeof(double));
+    if(level->pair_x==NULL){fprintf(stderr,"malloc failed - residual_pair\n");exit(0);}
+  }
+
+  // now do residual proper...
+  double _timeStart = getTime();
+  COUNTERS_START();
+  int box;
+
+  PRAGMA_THREAD_ACROSS_BLOCKS(level,box,level->num_my_boxes)
+  for(box=0;box<level->num_my_boxes;box++){
+    int i,j,k,ijk;
+    const int     dim = level->my_boxes[box].dim;
+    const int jStride = level->my_boxes[box].jStride;
+    const int kStride = level->my_boxes[box].kStride;
+    const int  ghosts = level->my_boxes[box].ghosts;
+    const int  volume = level->my_boxes[box].volume;
+    const double h2inv = 1.0/(level->h*level->h);
+    const real_t * __restrict__ x_hi   = level->my_boxes[box].vectors[      x_hi_id];
+    const real_t * __restrict__ x_lo   = level->my_boxes[box].vectors[      x_lo_id];
+    const real_t * __restrict__ rhs    = level->my_boxes[box].vectors[       rhs_id] + ghosts*(1+jStride+kStride);
+    const real_t * __restrict__ alpha  = level->my_boxes[box].vectors[VECTOR_ALPHA ] + ghosts*(1+jStride+kStride);
+    const real_t * __restrict__ beta_i = level->my_boxes[box].vectors[VECTOR_BETA_I] + ghosts*(1+jStride+kStride);
+    const real_t * __restrict__ beta_j = level->my_boxes[box].vectors[VECTOR_BETA_J] + ghosts*(1+jStride+kStride);
+    const real_t * __restrict__ beta_k = level->my_boxes[box].vectors[VECTOR_BETA_K] + ghosts*(1+jStride+kStride);
+          real_t * __restrict__ res    = level->my_boxes[box].vectors[       res_id] + ghosts*(1+jStride+kStride);
+
+    #ifdef _OPENMP
+    double * __restrict__ x_base = level->pair_x + (uint64_t)omp_get_thread_num()*level->box_volume;
+    #else
+    double * __restrict__ x_base = level->pair_x;
+    #endif
+    for(ijk=0;ijk<volume;ijk++){x_base[ijk] = (double)x_hi[ijk] + (double)x_lo[ijk];}
+    const double * __restrict__ x = x_base + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+
+    for(k=0;k<dim;k++){
+    for(j=0;j<dim;j++){
+    for(i=0;i<dim;i++){
+      ijk = i + j*jStride + k*kStride;
+      double Ax = apply_op_ijk(x);
+      res[ijk] = rhs[ijk]-Ax;
+    }}}
+  }
+  level->timers.residual += (double)(getTime()-_timeStart);
+  COUNTERS_STOP(level,COUNTED_RESIDUAL);
+}
+#endif
@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Samuel Williams
+// SWWilliams@lbl.gov
+// Lawrence Berkeley National Lab
+//------------------------------------------------------------------------------------------------------------------------------
+// This fuses the v-cycle's residual (res=rhs-Ax) with the piecewise constant (cell averaged) restriction of that residual.
+// The residual is calculated on the fly for the 8 fine cells under each coarse cell and only their average is stored
+// either directly in the coarse box (local) or in an MPI send buffer (remote).  This eliminates the fine grid residual vector
+// (a full write and read of the fine grid).  It reuses the RESTRICT_CELL lists built by build_restriction().
+// NOTE, x_id must be distinct from rhs_id.  The sums are performed in the same order as residual() + restriction() so that
+// the results are bitwise identical (unless -DUSE_MIXED_PRECISION, where the fine grid residual is no longer rounded before restriction).
+//------------------------------------------------------------------------------------------------------------------------------
+static inline void residual_restriction_block(level_type *level_c, int R_id, level_type *level_f, int x_id, int rhs_id, double a, double b, blockCopy_type *block){
+  // calculate the residual of the fine box block->read.box and restrict it to write_i,j,k in write[]
+  int   dim_i       = block->dim.i; // calculate the dimensions of the resultant coarse block
+  int   dim_j       = block->dim.j;
+  int   dim_k       = block->dim.k;
+
+  int  read_i       = block->read.i; // n.b. read_i,j,k are in fine grid cells (read.scale==2)
+  int  read_j       = block->read.j;
+  int  read_k       = block->read.k;
+  int  box          = block->read.box; // always a local fine box
+  int  jStride      = level_f->my_boxes[box].jStride;
+  int  kStride      = level_f->my_boxes[box].kStride;
+  int  ghosts       = level_f->my_boxes[box].ghosts;
+
+  int write_i       = block->write.i;
+  int write_j       = block->write.j;
+  int write_k       = block->write.k;
+  int write_jStride = block->write.jStride;
+  int write_kStride = block->write.kStride;
+
+  real_t * __restrict__ write = block->write.ptr;
+  if(block->write.box>=0){
+    write_jStride = level_c->my_boxes[block->write.box].jStride;
+    write_kStride = level_c->my_boxes[block->write.box].kStride;
+    write = level_c->my_boxes[block->write.box].vectors[R_id] + level_c->my_boxes[block->write.box].ghosts*(1+write_jStride+write_kStride);
+  }
+
+  const double h2inv = 1.0/(level_f->h*level_f->h);
+  const real_t * __restrict__ x      = level_f->my_boxes[box].vectors[         x_id] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
+  const real_t * __restrict__ rhs    = level_f->my_boxes[box].vectors[       rhs_id] + ghosts*(1+jStride+kStride);
+  const real_t * __restrict__ alpha  = level_f->my_boxes[box].vectors[VECTOR_ALPHA ] + ghosts*(1+jStride+kStride);
+  const real_t * __restrict__ beta_i = level_f->my_boxes[box].vectors[VECTOR_BETA_I] + ghosts*(1+jStride+kStride);
+  const real_t * __restrict__ beta_j = level_f->my_boxes[box].vectors[VECTOR_BETA_J] + ghosts*(1+jStride+kStride);
+  const real_t * __restrict__ beta_k = level_f->my_boxes[box].vectors[VECTOR_BETA_K] + ghosts*(1+jStride+kStride);
+
+  int i,j,k;
+  for(k=0;k<dim_k;k++){
+  for(j=0;j<dim_j;j++){
+  for(i=0;i<dim_i;i++){
+    int write_ijk = (i+write_i) + (j+write_j)*write_jStride + (k+write_k)*write_kStride;
+    int  read_ijk = (2*i+read_i) + (2*j+read_j)*jStride + (2*k+read_k)*kStride;
+    int ijk;
+    double res;
+    ijk = read_ijk                  ;res =  rhs[ijk]-apply_op_ijk(x);
+    ijk = read_ijk+1                ;res += rhs[ijk]-apply_op_ijk(x);
+    ijk = read_ijk  +jStride        ;res += rhs[ijk]-apply_op_ijk(x);
+    ijk = read_ijk+1+jStride        ;res += rhs[ijk]-apply_op_ijk(x);
+    ijk = read_ijk          +kStride;res += rhs[ijk]-apply_op_ijk(x);
+    ijk = read_ijk+1        +kStride;res += rhs[ijk]-apply_op_ijk(x);
+    ijk = read_ijk  +jStride+kStride;res += rhs[ijk]-apply_op_ijk(x);
+    ijk = read_ijk+1+jStride+kStride;res += rhs[ijk]-apply_op_ijk(x);
+    write[write_ijk] = res*0.125;
+  }}}
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// calculate the residual of x_id on level_f and store its cell averaged restriction in R_id on level_c
+// communication mirrors restriction(RESTRICT_CELL)... pack remote coarse boxes, overlap local coarse boxes with MPI, then unpack
+void residual_restriction(level_type *level_c, int R_id, level_type *level_f, int x_id, int rhs_id, double a, double b){
+  // exchange the boundary for x in prep for Ax...
+  exchange_boundary(level_f,x_id,stencil_get_shape());
+          apply_BCs(level_f,x_id,stencil_get_shape());
+
+  double _timeCommunicationStart = getTime();
+  double _timeStart,_timeEnd;
+  double _timeResidual = 0.0;
+  int buffer=0;
+  int n;
+  int my_tag = (level_f->tag<<4) | 0x5;
+  communicator_type *restriction_f = &level_f->restriction[RESTRICT_CELL];
+
+
+  #ifdef USE_MPI
+  communicator_type *restriction_c = &level_c->restriction[RESTRICT_CELL];
+  // by convention, level_f allocates a combined array of requests for both level_f sends and level_c recvs...
+  int nMessages = restriction_c->num_recvs + restriction_f->num_sends;
+  MPI_Request *recv_requests = restriction_f->requests;
+  MPI_Request *send_requests = restriction_f->requests + restriction_c->num_recvs;
+
+
+  // loop through packed list of MPI receives and prepost Irecv's...
+  if(restriction_c->num_recvs>0){
+    _timeStart = getTime();
+    #ifdef USE_MPI_THREAD_MULTIPLE
+    #pragma omp parallel for schedule(dynamic,1)
+    #endif
+    for(n=0;n<restriction_c->num_recvs;n++){
+      MPI_Irecv(restriction_c->recv_buffers[n],
+                restriction_c->recv_sizes[n],
+                MPI_REAL_T,
+                restriction_c->recv_ranks[n],
+                my_tag,
+                MPI_COMM_WORLD,
+                &recv_requests[n]
+      );
+    }
+    _timeEnd = getTime();
+    level_f->timers.restriction_recv += (_timeEnd-_timeStart);
+  }
+
+
+  // calculate the residual of fine boxes whose coarse box is remote and restrict directly into the MPI send buffers...
+  if(restriction_f->num_blocks[0]>0){
+    _timeStart = getTime();
+    COUNTERS_START();
+    PRAGMA_THREAD_ACROSS_BLOCKS(level_f,buffer,restriction_f->num_blocks[0])
+    for(buffer=0;buffer<restriction_f->num_blocks[0];buffer++){
+      residual_restriction_block(level_c,R_id,level_f,x_id,rhs_id,a,b,&restriction_f->blocks[0][buffer]);
+    }
+    _timeEnd = getTime();
+    _timeResidual += (_timeEnd-_timeStart);
+    COUNTERS_STOP(level_f,COUNTED_RESIDUAL);
+  }
+
+
+  // loop through MPI send buffers and post Isend's...
+  if(restriction_f->num_sends>0){
+    _timeStart = getTime();
+    #ifdef USE_MPI_THREAD_MULTIPLE
+    #pragma omp parallel for schedule(dynamic,1)
+    #endif
+    for(n=0;n<restriction_f->num_sends;n++){
+      MPI_Isend(restriction_f->send_buffers[n],
+                restriction_f->send_sizes[n],
+                MPI_REAL_T,
+                restriction_f->send_ranks[n],
+                my_tag,
+                MPI_COMM_WORLD,
+                &send_requests[n]
+      );
+    }
+    _timeEnd = getTime();
+    level_f->timers.restriction_send += (_timeEnd-_timeStart);
+  }
+  #endif
+
+
+  // calculate the residual of fine boxes whose coarse box is local and restrict directly into that coarse box... try and hide within Isend latency...
+  if(restriction_f->num_blocks[1]>0){
+    _timeStart = getTime();
+    COUNTERS_START();
+    PRAGMA_THREAD_ACROSS_BLOCKS(level_f,buffer,restriction_f->num_blocks[1])
+    for(buffer=0;buffer<restriction_f->num_blocks[1];buffer++){
+      residual_restriction_block(level_c,R_id,level_f,x_id,rhs_id,a,b,&restriction_f->blocks[1][buffer]);
+    }
+    _timeEnd = getTime();
+    _timeResidual += (_timeEnd-_timeStart);
+    COUNTERS_STOP(level_f,COUNTED_RESIDUAL);
+  }
+
+
+  // wait for MPI to finish...
+  #ifdef USE_MPI
+  if(nMessages){
+    _timeStart = getTime();
+    MPI_Waitall(nMessages,restriction_f->requests,restriction_f->status);
+    _timeEnd = getTime();
+    level_f->timers.restriction_wait += (_timeEnd-_timeStart);
+  }
+
+
+  // unpack MPI receive buffers
+  if(restriction_c->num_blocks[2]>0){
+    _timeStart = getTime();
+    COUNTERS_START();
+    PRAGMA_THREAD_ACROSS_BLOCKS(level_f,buffer,restriction_c->num_blocks[2])
+    for(buffer=0;buffer<restriction_c->num_blocks[2];buffer++){
+      CopyBlock(level_c,R_id,&restriction_c->blocks[2][buffer]);
+    }
+    _timeEnd = getTime();
+    level_f->timers.restriction_unpack += (_timeEnd-_timeStart);
+    COUNTERS_STOP(level_f,COUNTED_RESTRICTION);
+  }
+  #endif
+
+
+  // the fused kernels are charged to the residual, the remainder to the restriction (only the unpack of which is counted)
+  level_f->timers.residual          += _timeResidual;
+  level_f->timers.restriction_total += (double)(getTime()-_timeCommunicationStart) - _timeResidual;
+}
@@ -21,8 +21,8 @@ static inline void restriction_pc_block(level_type *level_c, int id_c, level_typ
   int write_jStride = block->write.jStride;
   int write_kStride = block->write.kStride;
 
-  double * __restrict__  read = block->read.ptr;
-  double * __restrict__ write = block->write.ptr;
+  real_t * __restrict__  read = block->read.ptr;
+  real_t * __restrict__ write = block->write.ptr;
   if(block->read.box >=0){
      read_jStride = level_f->my_boxes[block->read.box ].jStride;
      read_kStride = level_f->my_boxes[block->read.box ].kStride;
@@ -97,6 +97,7 @@ static inline void restriction_pc_block(level_type *level_c, int id_c, level_typ
 // It does however attempt to overlap local restriction with MPI
 void restriction(level_type * level_c, int id_c, level_type *level_f, int id_f, int restrictionType){
   double _timeCommunicationStart = getTime();
+  COUNTERS_START();
   double _timeStart,_timeEnd;
   int buffer=0;
   int n;
@@ -121,7 +122,7 @@ void restriction(level_type * level_c, int id_c, level_type *level_f, int id_f,
     for(n=0;n<level_c->restriction[restrictionType].num_recvs;n++){
       MPI_Irecv(level_c->restriction[restrictionType].recv_buffers[n],
                 level_c->restriction[restrictionType].recv_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level_c->restriction[restrictionType].recv_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
@@ -154,7 +155,7 @@ void restriction(level_type * level_c, int id_c, level_type *level_f, int id_f,
     for(n=0;n<level_f->restriction[restrictionType].num_sends;n++){
       MPI_Isend(level_f->restriction[restrictionType].send_buffers[n],
                 level_f->restriction[restrictionType].send_sizes[n],
-                MPI_DOUBLE,
+                MPI_REAL_T,
                 level_f->restriction[restrictionType].send_ranks[n],
                 my_tag,
                 MPI_COMM_WORLD,
@@ -203,4 +204,5 @@ void restriction(level_type * level_c, int id_c, level_type *level_f, int id_f,
  
  
   level_f->timers.restriction_total += (double)(getTime()-_timeCommunicationStart);
+  COUNTERS_STOP(level_f,COUNTED_RESTRICTION);
 }
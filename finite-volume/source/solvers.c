@@ -13,16 +13,62 @@
 #include "defines.h"
 #include "level.h"
 #include "operators.h"
+#include "solvers.h"
 //------------------------------------------------------------------------------------------------------------------------------
-#ifdef USE_BICGSTAB
+// every bottom solver is compiled in so that it may be selected at runtime...
 #include "solvers/bicgstab.c"
-#elif  USE_CG
+#undef  KRYLOV_DIAGONAL_PRECONDITION
 #include "solvers/cg.c"
-#elif  USE_CABICGSTAB
+#undef  KRYLOV_DIAGONAL_PRECONDITION
+#include "solvers/pipecg.c"
+#undef  KRYLOV_DIAGONAL_PRECONDITION
+#include "solvers/pipebicgstab.c"
+#undef  KRYLOV_DIAGONAL_PRECONDITION
+#include "solvers/matmul.c"
 #include "solvers/cabicgstab.c"
-#elif  USE_CACG
 #include "solvers/cacg.c"
-#endif
+//------------------------------------------------------------------------------------------------------------------------------
+// in lieu of a Krylov solver, just do point relaxation via multiple smooth()'s
+void SmoothSolver(level_type * level, int u_id, int f_id, double a, double b, double desired_reduction_in_norm){
+  if(level->must_subtract_mean == 1){
+    double mean_of_u = mean(level,u_id);
+    shift_vector(level,u_id,u_id,-mean_of_u);
+  }
+  residual(level,VECTOR_TEMP,u_id,f_id,a,b);
+  //mul_vectors(level,VECTOR_TEMP,1.0,VECTOR_TEMP,VECTOR_DINV); //  Using ||D^{-1}(b-Ax)||_{inf} as convergence criteria...
+  double norm_of_r0 = norm(level,VECTOR_TEMP);
+  int s=0,maxSmoothsBottom=200,converged=0;
+  while( (s<maxSmoothsBottom) && !converged){
+    s++;
+    level->Krylov_iterations++;
+    smooth(level,u_id,f_id,a,b);
+    if(level->must_subtract_mean == 1){
+      double mean_of_u = mean(level,u_id);
+      shift_vector(level,u_id,u_id,-mean_of_u);
+    }
+    residual(level,VECTOR_TEMP,u_id,f_id,a,b);
+    //mul_vectors(level,VECTOR_TEMP,1.0,VECTOR_TEMP,VECTOR_DINV); //  Using ||D^{-1}(b-Ax)||_{inf} as convergence criteria...
+    double norm_of_r = norm(level,VECTOR_TEMP);
+    if(norm_of_r == 0.0){converged=1;break;}
+    if(norm_of_r < desired_reduction_in_norm*norm_of_r0){converged=1;break;}
+  }
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+bottom_solver_type bottom_solvers[] = {
+  {"bicgstab"  ,BiCGStab    ,8               }, // BiCGStab requires additional vectors r0,r,p,s,Ap,As
+  {"cg"        ,CG          ,5               }, // CG requires extra vectors r0,r,p,Ap,z
+  {"pipecg"    ,PipeCG      ,9               }, // PipeCG requires additional vectors r,u,w,m,n,p,s,q,z
+  {"pipebicgstab",PipeBiCGStab,11            }, // PipeBiCGStab requires additional vectors r0,r,w,t,p,s,z,v,q,y,dy
+  {"cabicgstab",CABiCGStab  ,4+4*CA_KRYLOV_S }, // CABiCGStab requires additional vectors rt,p,r,P[2s+1],R[2s].
+  {"cacg"      ,CACG        ,4+2*CA_KRYLOV_S }, // CACG requires additional vectors r0,p,r,P[s+1],R[s].
+  {"smooth"    ,SmoothSolver,0               }, // simply doing multiple smooths requires no extra vectors
+};
+int num_bottom_solvers    = sizeof(bottom_solvers)/sizeof(bottom_solver_type);
+int default_bottom_solver = 0;
+
+
 //------------------------------------------------------------------------------------------------------------------------------
 void IterativeSolver(level_type * level, int u_id, int f_id, double a, double b, double desired_reduction_in_norm){ 
   if(!level->active)return;
@@ -47,55 +93,39 @@ void IterativeSolver(level_type * level, int u_id, int f_id, double a, double b,
   }
   #endif
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-  #ifdef USE_BICGSTAB
-    BiCGStab(level,u_id,f_id,a,b,desired_reduction_in_norm);
-  #elif  USE_CG
-    CG(level,u_id,f_id,a,b,desired_reduction_in_norm);
-  #elif  USE_CABICGSTAB
-    CABiCGStab(level,u_id,f_id,a,b,desired_reduction_in_norm);
-  #elif  USE_CACG
-    CACG(level,u_id,f_id,a,b,desired_reduction_in_norm);
-  #else 
-    // just point relaxation via multiple smooth()'s
-    if(level->must_subtract_mean == 1){
-      double mean_of_u = mean(level,u_id);
-      shift_vector(level,u_id,u_id,-mean_of_u);
-    }
-    residual(level,VECTOR_TEMP,u_id,f_id,a,b);
-    //mul_vectors(level,VECTOR_TEMP,1.0,VECTOR_TEMP,VECTOR_DINV); //  Using ||D^{-1}(b-Ax)||_{inf} as convergence criteria...
-    double norm_of_r0 = norm(level,VECTOR_TEMP);
-    int s=0,maxSmoothsBottom=200,converged=0;
-    while( (s<maxSmoothsBottom) && !converged){
-      s++;
-      level->Krylov_iterations++;
-      smooth(level,u_id,f_id,a,b);
-      if(level->must_subtract_mean == 1){
-        double mean_of_u = mean(level,u_id);
-        shift_vector(level,u_id,u_id,-mean_of_u);
-      }
-      residual(level,VECTOR_TEMP,u_id,f_id,a,b);
-      //mul_vectors(level,VECTOR_TEMP,1.0,VECTOR_TEMP,VECTOR_DINV); //  Using ||D^{-1}(b-Ax)||_{inf} as convergence criteria...
-      double norm_of_r = norm(level,VECTOR_TEMP);
-      if(norm_of_r == 0.0){converged=1;break;}
-      if(norm_of_r < desired_reduction_in_norm*norm_of_r0){converged=1;break;}
-    }
-  #endif
+  bottom_solvers[level->bottom_solver].solve(level,u_id,f_id,a,b,desired_reduction_in_norm);
   //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 }
 
 
 //------------------------------------------------------------------------------------------------------------------------------
-int IterativeSolver_NumVectors(){
-  // additionally number of vectors required by an iterative solver...
-  #ifdef USE_BICGSTAB
-  return(8);                  // BiCGStab requires additional vectors r0,r,p,s,Ap,As
-  #elif  USE_CG
-  return(5);                  // CG requires extra vectors r0,r,p,Ap,z
-  #elif  USE_CABICGSTAB
-  return(4+4*CA_KRYLOV_S);    // CABiCGStab requires additional vectors rt,p,r,P[2s+1],R[2s].
-  #elif  USE_CACG
-  return(4+2*CA_KRYLOV_S);    // CACG requires additional vectors r0,p,r,P[s+1],R[s].
-  #endif
-  return(0);                  // simply doing multiple smooths requires no extra vectors
+int IterativeSolver_NumVectors(level_type * level){
+  // additionally number of vectors required by the iterative solver used on this level...
+  return(bottom_solvers[level->bottom_solver].num_vectors);
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+int IterativeSolver_Lookup(const char *name){
+  int s;
+  if(name==NULL){ // use the bottom solver chosen at compile time (if any)
+    #if   defined(USE_BICGSTAB)
+    name = "bicgstab";
+    #elif defined(USE_CG)
+    name = "cg";
+    #elif defined(USE_PIPECG)
+    name = "pipecg";
+    #elif defined(USE_PIPEBICGSTAB)
+    name = "pipebicgstab";
+    #elif defined(USE_CABICGSTAB)
+    name = "cabicgstab";
+    #elif defined(USE_CACG)
+    name = "cacg";
+    #else
+    name = "smooth";
+    #endif
+  }
+  for(s=0;s<num_bottom_solvers;s++)if(strcmp(name,bottom_solvers[s].name)==0)return(s);
+  return(-1);
 }
 //------------------------------------------------------------------------------------------------------------------------------
@@ -6,7 +6,20 @@
 #ifndef SOLVERS_H
 #define SOLVERS_H
 //------------------------------------------------------------------------------------------------------------------------------
+// every bottom solver is compiled in and registered in bottom_solvers[].  IterativeSolver() dispatches through level->bottom_solver
+typedef struct {
+  const char * name;
+  void (*solve)(level_type *level, int u_id, int f_id, double a, double b, double desired_reduction_in_norm);
+  int  num_vectors;                                         // additional vectors (beyond VECTORS_RESERVED) this solver requires
+} bottom_solver_type;
+
+extern bottom_solver_type bottom_solvers[];
+extern int            num_bottom_solvers;
+extern int        default_bottom_solver;                  // bottom solver assigned to newly created levels
+//------------------------------------------------------------------------------------------------------------------------------
+void SmoothSolver(level_type *level, int u_id, int f_id, double a, double b, double desired_reduction_in_norm); // the 'smooth' bottom solver (multiple smooth()'s)
 void IterativeSolver(level_type *level, int u_id, int f_id, double a, double b, double desired_reduction_in_norm);
-int  IterativeSolver_NumVectors();
+int  IterativeSolver_NumVectors(level_type *level);
+int  IterativeSolver_Lookup(const char *name);              // returns the index of name in bottom_solvers[] (NULL selects the compile time default) or -1 if not found
 //------------------------------------------------------------------------------------------------------------------------------
 #endif
@@ -13,31 +13,8 @@
 #define    CA_KRYLOV_S     4
 #endif
 //------------------------------------------------------------------------------------------------------------------------------
-#include "matmul.c"
+// matmul() and the small dense helpers (gemv, axpy, vdotv, zero) are in solvers/matmul.c
 //------------------------------------------------------------------------------------------------------------------------------
-// z[r] = alpha*A[r][c]*x[c]+beta*y[r]   // [row][col]
-// z[r] = alpha*A[r][c]*x[c]+beta*y[r]   // [row][col]
-#define gemv(z,alpha,A,x,beta,y,rows,cols)  {int r,c;double sum;for(r=0;r<(rows);r++){sum=0.0;for(c=0;c<(cols);c++){sum+=(A)[r][c]*(x)[c];}(z)[r]=(alpha)*sum+(beta)*(y)[r];}}
-static inline void axpy(double * z, double alpha, double * x, double beta, double * y, int n){ // z[n] = alpha*x[n]+beta*y[n]
-  int nn;
-  for(nn=0;nn<n;nn++){
-    z[nn] = alpha*x[nn] + beta*y[nn];
-  }
-}
-static inline double vdotv(double * x, double * y, int n){ // x[n].y[n]
-  int nn;
-  double sum = 0.0;
-  for(nn=0;nn<n;nn++){
-    sum += x[nn]*y[nn];
-  }
-  return(sum);
-}
-static inline void zero(double * z, int n){ // z[n] = 0.0
-  int nn;
-  for(nn=0;nn<n;nn++){
-    z[nn] = 0.0;
-  }
-}
 
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -3,62 +3,126 @@
 // SWWilliams@lbl.gov
 // Lawrence Berkeley National Lab
 //------------------------------------------------------------------------------------------------------------------------------
+// small dense linear algebra helpers shared by the CA Krylov solvers...
+// z[r] = alpha*A[r][c]*x[c]+beta*y[r]   // [row][col]
+#define gemv(z,alpha,A,x,beta,y,rows,cols)  {int r,c;double sum;for(r=0;r<(rows);r++){sum=0.0;for(c=0;c<(cols);c++){sum+=(A)[r][c]*(x)[c];}(z)[r]=(alpha)*sum+(beta)*(y)[r];}}
+static inline void axpy(double * z, double alpha, double * x, double beta, double * y, int n){ // z[n] = alpha*x[n]+beta*y[n]
+  int nn;
+  for(nn=0;nn<n;nn++){
+    z[nn] = alpha*x[nn] + beta*y[nn];
+  }
+}
+static inline double vdotv(double * x, double * y, int n){ // x[n].y[n]
+  int nn;
+  double sum = 0.0;
+  for(nn=0;nn<n;nn++){
+    sum += x[nn]*y[nn];
+  }
+  return(sum);
+}
+static inline void zero(double * z, int n){ // z[n] = 0.0
+  int nn;
+  for(nn=0;nn<n;nn++){
+    z[nn] = 0.0;
+  }
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// C[rows][cols] = dot(id_A[rows],id_B[cols])
+// *id_A = m vector_id's (conceptually pointers to the rows    of a m x level->num_my_boxes*volume matrix)
+// *id_B = n vector_id's (conceptually pointers to the columns of a level->num_my_boxes*volume matrix x n)
+// If A_equals_B_transpose (i.e. id_A[mm]==id_B[mm], the common case for s-step Krylov methods), C[][] is symmetric (modulo the extra
+// columns/rows) and only the upper triangle is calculated and reduced.  The entries are computed as a list of (a,b) pairs...
+//   - each of the level's blocks (a box tile) is read once and each pencil of every vector stays in cache while all pairs are accumulated
+//   - only the packed list of pairs is reduced (one MPI_Allreduce of ~rows*cols/2 doubles) and then mirrored back into C[][]
 void matmul(level_type * level, double *C, int * id_A, int * id_B, int rows, int cols, int A_equals_B_transpose){
-  // *id_A = m vector_id's (conceptually pointers to the rows    of a m x level->num_my_boxes*volume matrix)
-  // *id_B = n vector_id's (conceptually pointers to the columns of a level->num_my_boxes*volume matrix x n)
-  // *C is a mxn matrix where C[rows][cols] = dot(id_A[rows],id_B[cols])
+  int mm,nn,pair,block;
 
-  // FIX, id_A and id_B are likely the same and thus C[][] will be symmetric (modulo missing row?)
-  // if(A_equals_B_transpose && (cols>=rows)) then use id_B and only run for nn>=mm // common case for s-step Krylov methods
-  // C_is_symmetric && cols< rows (use id_A)
-  int mm,nn;
+  // enumerate the (upper triangular) pairs and record where each should be written in C[][]
+  int *pair_a    = (int*)malloc(rows*cols*sizeof(int));
+  int *pair_b    = (int*)malloc(rows*cols*sizeof(int));
+  int *pair_C    = (int*)malloc(rows*cols*sizeof(int)); // C[mm][nn]
+  int *pair_CT   = (int*)malloc(rows*cols*sizeof(int)); // C[nn][mm] or -1
+  double *sums   = (double*)malloc(rows*cols*sizeof(double));
+  if(!pair_a || !pair_b || !pair_C || !pair_CT || !sums){fprintf(stderr,"matmul() failed to allocate its pair list\n");exit(0);}
+  int num_pairs=0;
+  for(mm=0;mm<rows;mm++){
+  for(nn=0;nn<cols;nn++){
+    int upper  = (nn>=mm) || (mm>=cols);                           // (mm>=cols) has no mirror image and must be computed directly
+    int mirror = (nn> mm) && (nn<rows) && (mm<cols);
+    if(!A_equals_B_transpose || upper){
+      pair_a[num_pairs] = id_A[mm];
+      pair_b[num_pairs] = id_B[nn];
+      pair_C[num_pairs] = mm*cols + nn;
+      pair_CT[num_pairs] = (A_equals_B_transpose && mirror) ? nn*cols + mm : -1;
+      sums[num_pairs] = 0.0;
+      num_pairs++;
+    }
+  }}
 
 
   double _timeStart = getTime();
-  // FIX... rather than performing an all_reduce on the essentially symmetric [G,g], do the all_reduce on the upper triangle and then duplicate (saves BW)
   #ifdef _OPENMP
-  #pragma omp parallel for schedule(static,1) collapse(2)
+  #pragma omp parallel for private(block) if(level->num_my_blocks>1) schedule(static,1)
   #endif
-  for(mm=0;mm<rows;mm++){
-  for(nn=0;nn<cols;nn++){
-  if(nn>=mm){ // upper triangular
-    int box;
-    double a_dot_b_level =  0.0;
-    for(box=0;box<level->num_my_boxes;box++){
-      int i,j,k;
-      const int jStride = level->my_boxes[box].jStride;
-      const int kStride = level->my_boxes[box].kStride;
-      const int  ghosts = level->my_boxes[box].ghosts;
-      const int     dim = level->my_boxes[box].dim;
-      double * __restrict__ grid_a = level->my_boxes[box].vectors[id_A[mm]] + ghosts*(1+jStride+kStride); // i.e. [0] = first non ghost zone point
-      double * __restrict__ grid_b = level->my_boxes[box].vectors[id_B[nn]] + ghosts*(1+jStride+kStride); 
-      double a_dot_b_box = 0.0;
-      for(k=0;k<dim;k++){
-      for(j=0;j<dim;j++){
-      for(i=0;i<dim;i++){
-        int ijk = i + j*jStride + k*kStride;
-        a_dot_b_box += grid_a[ijk]*grid_b[ijk];
-      }}}
-      a_dot_b_level+=a_dot_b_box;
-    }
-                             C[mm*cols + nn] = a_dot_b_level; // C[mm][nn]
-    if((mm<cols)&&(nn<rows)){C[nn*cols + mm] = a_dot_b_level;}// C[nn][mm] 
+  for(block=0;block<level->num_my_blocks;block++){
+    const int box = level->my_blocks[block].read.box;
+    const int ilo = level->my_blocks[block].read.i;
+    const int jlo = level->my_blocks[block].read.j;
+    const int klo = level->my_blocks[block].read.k;
+    const int ihi = level->my_blocks[block].dim.i + ilo;
+    const int jhi = level->my_blocks[block].dim.j + jlo;
+    const int khi = level->my_blocks[block].dim.k + klo;
+    const int jStride = level->my_boxes[box].jStride;
+    const int kStride = level->my_boxes[box].kStride;
+    const int  ghosts = level->my_boxes[box].ghosts;
+    real_t ** __restrict__ vectors = level->my_boxes[box].vectors;
+    double block_sums[num_pairs];
+    int i,j,k,p;
+    for(p=0;p<num_pairs;p++)block_sums[p]=0.0;
+
+    for(k=klo;k<khi;k++){
+    for(j=jlo;j<jhi;j++){
+      const int offset = ghosts*(1+jStride+kStride) + j*jStride + k*kStride; // i.e. [0] = first non ghost zone point of this pencil
+      for(p=0;p<num_pairs;p++){ // n.b. a pencil of each vector remains in cache across all pairs
+        const real_t * __restrict__ grid_a = vectors[pair_a[p]] + offset;
+        const real_t * __restrict__ grid_b = vectors[pair_b[p]] + offset;
+        double a_dot_b = 0.0;
+        for(i=ilo;i<ihi;i++){
+          a_dot_b += grid_a[i]*grid_b[i];
+        }
+        block_sums[p] += a_dot_b;
+      }
+    }}
+
+    #ifdef _OPENMP
+    #pragma omp critical (matmul)
+    #endif
+    for(p=0;p<num_pairs;p++)sums[p]+=block_sums[p];
   }
-  }}
   level->timers.blas3 += (double)(getTime()-_timeStart);
 
+
   #ifdef USE_MPI
-  double *send_buffer = (double*)malloc(rows*cols*sizeof(double));
-  for(mm=0;mm<rows;mm++){
-  for(nn=0;nn<cols;nn++){
-    send_buffer[mm*cols + nn] = C[mm*cols + nn];
-  }}
+  double *send_buffer = (double*)malloc(num_pairs*sizeof(double));
+  for(pair=0;pair<num_pairs;pair++)send_buffer[pair]=sums[pair];
   double _timeStartAllReduce = getTime();
-  MPI_Allreduce(send_buffer,C,rows*cols,MPI_DOUBLE,MPI_SUM,level->MPI_COMM_ALLREDUCE);
+  MPI_Allreduce(send_buffer,sums,num_pairs,MPI_DOUBLE,MPI_SUM,level->MPI_COMM_ALLREDUCE);
   double _timeEndAllReduce = getTime();
   level->timers.collectives   += (double)(_timeEndAllReduce-_timeStartAllReduce);
   free(send_buffer);
   #endif
 
-}
 
+  // unpack the (reduced) pairs into C[][] and mirror the upper triangle
+  for(pair=0;pair<num_pairs;pair++){
+                          C[pair_C[ pair]] = sums[pair];
+    if(pair_CT[pair]>=0){C[pair_CT[pair]] = sums[pair];}
+  }
+  free(pair_a);
+  free(pair_b);
+  free(pair_C);
+  free(pair_CT);
+  free(sums);
+}
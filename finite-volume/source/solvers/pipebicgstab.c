@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Samuel Williams
+// SWWilliams@lbl.gov
+// Lawrence Berkeley National Lab
+//------------------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+//------------------------------------------------------------------------------------------------------------------------------
+#define KRYLOV_DIAGONAL_PRECONDITION
+//------------------------------------------------------------------------------------------------------------------------------
+// apply the right preconditioned operator... Ax[] = AM^{-1}(x)
+static inline void PipeBiCGStab_apply_op(level_type * level, int Ax_id, int x_id, double a, double b){
+  #ifdef KRYLOV_DIAGONAL_PRECONDITION
+  mul_vectors(level,VECTOR_TEMP,1.0,VECTOR_DINV,x_id);                          // VECTOR_TEMP = Dinv[]*x[]
+  apply_op(level,Ax_id,VECTOR_TEMP,a,b);                                        // Ax[] = A(VECTOR_TEMP)
+  #else
+  apply_op(level,Ax_id,x_id,a,b);
+  #endif
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Pipelined BiCGStab... Algorithm 3 in The communication-hiding pipelined BiCGStab method for the parallel solution of large
+// unsymmetric linear systems (Cools and Vanroose).  It is applied to the right preconditioned system AM^{-1}y=R with x = x0 + M^{-1}y.
+// BiCGStab requires two dependent reductions per iteration (one for omega and one for alpha/beta).  Each is fused into a single
+// nonblocking reduction (with the max norm used for convergence) and overlapped with an application of the operator.
+// If the mean must be subtracted (e.g. Poisson with periodic BC's), the recurrences can't absorb the shift and classic BiCGStab is used instead.
+void PipeBiCGStab(level_type * level, int x_id, int R_id, double a, double b, double desired_reduction_in_norm){
+  if(level->must_subtract_mean == 1){BiCGStab(level,x_id,R_id,a,b,desired_reduction_in_norm);return;}
+  int  r0_id = VECTORS_RESERVED+ 0;
+  int   r_id = VECTORS_RESERVED+ 1;
+  int   w_id = VECTORS_RESERVED+ 2; // w = AM^{-1}r
+  int   t_id = VECTORS_RESERVED+ 3; // t = AM^{-1}w
+  int   p_id = VECTORS_RESERVED+ 4;
+  int   s_id = VECTORS_RESERVED+ 5; // s = AM^{-1}p
+  int   z_id = VECTORS_RESERVED+ 6; // z = AM^{-1}s
+  int   v_id = VECTORS_RESERVED+ 7; // v = AM^{-1}z
+  int   q_id = VECTORS_RESERVED+ 8; // q = r - alpha*s      (intermediate residual)
+  int   y_id = VECTORS_RESERVED+ 9; // y = w - alpha*z      (= AM^{-1}q)
+  int  dy_id = VECTORS_RESERVED+10; // accumulated correction in the preconditioned space (x = x0 + M^{-1}dy)
+
+  int jMax=200;
+  int j=0;
+  int BiCGStabFailed    = 0;
+  int BiCGStabConverged = 0;
+  double alpha=0.0,beta=0.0,omega=0.0;
+  reduction_type reduction;
+  int dot_a[4],dot_b[4];
+  residual(level,r0_id,x_id,R_id,a,b);                                          // r0[] = R_id[] - A(x_id)
+  scale_vector(level,r_id,1.0,r0_id);                                           // r[] = r0[]
+  zero_vector(level,dy_id);                                                     // dy[] = 0
+  PipeBiCGStab_apply_op(level,w_id,r_id,a,b);                                   // w[] = AM^{-1}(r)
+  dot_a[0]=r0_id;dot_b[0]=r_id;                                                 //
+  dot_a[1]=r0_id;dot_b[1]=w_id;                                                 //
+  dots_start(level,&reduction,2,dot_a,dot_b,r_id);                              // start r_dot_r0 = dot(r,r0), w_dot_r0 = dot(w,r0), ||r||
+  PipeBiCGStab_apply_op(level,t_id,w_id,a,b);                                   // t[] = AM^{-1}(w)
+  dots_finish(level,&reduction);                                                // ... overlapped with AM^{-1}
+  double r_dot_r0   = reduction.value[0];                                       //
+  double w_dot_r0   = reduction.value[1];                                       //
+  double norm_of_r0 = reduction.value[2];                                       // the norm of the initial residual...
+  if(r_dot_r0   == 0.0){BiCGStabConverged=1;}                                   // entered BiCGStab with exact solution
+  if(norm_of_r0 == 0.0){BiCGStabConverged=1;}                                   // entered BiCGStab with exact solution
+  if(!BiCGStabConverged){                                                       //
+    if(w_dot_r0 == 0.0){BiCGStabFailed=1;}                                      // pivot breakdown ???
+                   else{alpha = r_dot_r0 / w_dot_r0;}                           // alpha = r_dot_r0 / w_dot_r0
+  }                                                                             //
+  while( (j<jMax) && (!BiCGStabFailed) && (!BiCGStabConverged) ){               // while(not done){
+    j++;level->Krylov_iterations++;                                             //
+    if(j==1){                                                                   //
+      scale_vector(level,p_id,1.0,r_id);                                        //   p[] = r[]
+      scale_vector(level,s_id,1.0,w_id);                                        //   s[] = w[]
+      scale_vector(level,z_id,1.0,t_id);                                        //   z[] = t[]
+    }else{                                                                      //
+      add_vectors(level,VECTOR_TEMP,1.0,p_id,-omega,s_id);                      //   p[] = r[] + beta*(p[]-omega*s[])
+      add_vectors(level,       p_id,1.0,r_id,  beta,VECTOR_TEMP);               //
+      add_vectors(level,VECTOR_TEMP,1.0,s_id,-omega,z_id);                      //   s[] = w[] + beta*(s[]-omega*z[])
+      add_vectors(level,       s_id,1.0,w_id,  beta,VECTOR_TEMP);               //
+      add_vectors(level,VECTOR_TEMP,1.0,z_id,-omega,v_id);                      //   z[] = t[] + beta*(z[]-omega*v[])
+      add_vectors(level,       z_id,1.0,t_id,  beta,VECTOR_TEMP);               //
+    }                                                                           //
+    add_vectors(level,q_id,1.0,r_id,-alpha,s_id);                               //   q[] = r[] - alpha*s[]
+    add_vectors(level,y_id,1.0,w_id,-alpha,z_id);                               //   y[] = w[] - alpha*z[]
+    dot_a[0]=q_id;dot_b[0]=y_id;                                                //
+    dot_a[1]=y_id;dot_b[1]=y_id;                                                //
+    dots_start(level,&reduction,2,dot_a,dot_b,q_id);                            //   start q_dot_y = dot(q,y), y_dot_y = dot(y,y), ||q||
+    PipeBiCGStab_apply_op(level,v_id,z_id,a,b);                                 //   v[] = AM^{-1}(z)
+    dots_finish(level,&reduction);                                              //   ... overlapped with AM^{-1}
+    double q_dot_y   = reduction.value[0];                                      //
+    double y_dot_y   = reduction.value[1];                                      //
+    double norm_of_q = reduction.value[2];                                      //
+    if( (norm_of_q == 0.0) || (norm_of_q < desired_reduction_in_norm*norm_of_r0) ){
+      add_vectors(level,dy_id,1.0,dy_id,alpha,p_id);                            //   dy[] = dy[] + alpha*p[]
+      BiCGStabConverged=1;break;                                                //
+    }                                                                           //
+    if(y_dot_y == 0.0){BiCGStabConverged=1;break;}                              //   converged ?
+    omega = q_dot_y / y_dot_y;                                                  //   omega = q_dot_y / y_dot_y
+    if(omega == 0.0){BiCGStabFailed=3;break;}                                   //   stabilization breakdown ???
+    if(isinf(omega)){BiCGStabFailed=4;break;}                                   //   stabilization breakdown ???
+    add_vectors(level,dy_id,1.0,dy_id,alpha,p_id);                              //   dy[] = dy[] + alpha*p[] + omega*q[]
+    add_vectors(level,dy_id,1.0,dy_id,omega,q_id);                              //
+    add_vectors(level, r_id,1.0, q_id,-omega,y_id);                             //   r[] = q[] - omega*y[]
+    add_vectors(level, w_id,1.0, y_id,-omega,t_id);                             //   w[] = y[] - omega*(t[]-alpha*v[])
+    add_vectors(level, w_id,1.0, w_id,omega*alpha,v_id);                        //
+    dot_a[0]=r0_id;dot_b[0]=r_id;                                               //
+    dot_a[1]=r0_id;dot_b[1]=w_id;                                               //
+    dot_a[2]=r0_id;dot_b[2]=s_id;                                               //
+    dot_a[3]=r0_id;dot_b[3]=z_id;                                               //
+    dots_start(level,&reduction,4,dot_a,dot_b,r_id);                            //   start dot(r,r0), dot(w,r0), dot(s,r0), dot(z,r0), ||r||
+    PipeBiCGStab_apply_op(level,t_id,w_id,a,b);                                 //   t[] = AM^{-1}(w)
+    dots_finish(level,&reduction);                                              //   ... overlapped with AM^{-1}
+    double r_dot_r0_new = reduction.value[0];                                   //
+    double w_dot_r0_new = reduction.value[1];                                   //
+    double s_dot_r0     = reduction.value[2];                                   //
+    double z_dot_r0     = reduction.value[3];                                   //
+    double norm_of_r    = reduction.value[4];                                   //   norm of recursively computed residual
+    if(norm_of_r == 0.0){BiCGStabConverged=1;break;}                            //
+    if(norm_of_r < desired_reduction_in_norm*norm_of_r0){BiCGStabConverged=1;break;}
+    if(r_dot_r0_new == 0.0){BiCGStabFailed=5;break;}                            //   Lanczos breakdown ???
+    beta = (r_dot_r0_new/r_dot_r0) * (alpha/omega);                             //   beta = (r_dot_r0_new/r_dot_r0) * (alpha/omega)
+    if(isinf(beta)){BiCGStabFailed=6;break;}                                    //   ???
+    double denominator = w_dot_r0_new + beta*s_dot_r0 - beta*omega*z_dot_r0;    //
+    if(denominator == 0.0){BiCGStabFailed=1;break;}                             //   pivot breakdown ???
+    alpha = r_dot_r0_new / denominator;                                         //   alpha = r_dot_r0_new / dot(r0,w+beta*s-beta*omega*z)
+    if(isinf(alpha)){BiCGStabFailed=2;break;}                                   //   pivot breakdown ???
+    r_dot_r0 = r_dot_r0_new;                                                    //   r_dot_r0 = r_dot_r0_new   (save old r_dot_r0)
+  }                                                                             // }
+  #ifdef KRYLOV_DIAGONAL_PRECONDITION                                           //
+  mul_vectors(level,VECTOR_TEMP,1.0,VECTOR_DINV,dy_id);                         // x_id[] = x_id[] + Dinv[]*dy[]
+  add_vectors(level,x_id,1.0,x_id,1.0,VECTOR_TEMP);                             //
+  #else                                                                         //
+  add_vectors(level,x_id,1.0,x_id,1.0,dy_id);                                   // x_id[] = x_id[] + dy[]
+  #endif                                                                        //
+}
@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Samuel Williams
+// SWWilliams@lbl.gov
+// Lawrence Berkeley National Lab
+//------------------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+//------------------------------------------------------------------------------------------------------------------------------
+#define KRYLOV_DIAGONAL_PRECONDITION
+//------------------------------------------------------------------------------------------------------------------------------
+// Pipelined (preconditioned) CG... Algorithm 4 in Hiding global synchronization latency in the preconditioned Conjugate Gradient algorithm (Ghysels and Vanroose)
+// Each iteration performs a single (fused) reduction of dot(r,u), dot(w,u), and ||r||max which is overlapped with the
+// preconditioner and the operator (m=Dinv*w, n=A(m)).  This trades additional vector updates (and vectors) for latency.
+// If the mean must be subtracted (e.g. Poisson with periodic BC's), the recurrences can't absorb the shift and classic CG is used instead.
+void PipeCG(level_type * level, int x_id, int R_id, double a, double b, double desired_reduction_in_norm){
+  if(level->must_subtract_mean == 1){CG(level,x_id,R_id,a,b,desired_reduction_in_norm);return;}
+  int   r_id = VECTORS_RESERVED+0;
+  int   u_id = VECTORS_RESERVED+1; // u = M^{-1}r
+  int   w_id = VECTORS_RESERVED+2; // w = Au
+  int   m_id = VECTORS_RESERVED+3; // m = M^{-1}w
+  int   n_id = VECTORS_RESERVED+4; // n = Am
+  int   p_id = VECTORS_RESERVED+5;
+  int   s_id = VECTORS_RESERVED+6; // s = Ap
+  int   q_id = VECTORS_RESERVED+7; // q = M^{-1}s
+  int   z_id = VECTORS_RESERVED+8; // z = Aq
+
+  int jMax=200;
+  int j=0;
+  int CGFailed    = 0;
+  int CGConverged = 0;
+  double gamma_old=0.0,alpha=0.0,norm_of_r0=0.0;
+  reduction_type reduction;
+  int dot_a[2],dot_b[2];
+  residual(level,r_id,x_id,R_id,a,b);                                           // r[] = R_id[] - A(x_id)
+  #ifdef KRYLOV_DIAGONAL_PRECONDITION                                           //
+  mul_vectors(level,u_id,1.0,VECTOR_DINV,r_id);                                 // u[] = Dinv[]*r[]
+  #else                                                                         //
+  scale_vector(level,u_id,1.0,r_id);                                            // u[] = I*r[]
+  #endif                                                                        //
+  apply_op(level,w_id,u_id,a,b);                                                // w[] = A(u)
+  while( (j<jMax) && (!CGFailed) && (!CGConverged) ){                           // while(not done){
+    dot_a[0]=r_id;dot_b[0]=u_id;                                                //
+    dot_a[1]=w_id;dot_b[1]=u_id;                                                //
+    dots_start(level,&reduction,2,dot_a,dot_b,r_id);                            //   start gamma = dot(r,u), delta = dot(w,u), ||r||
+    #ifdef KRYLOV_DIAGONAL_PRECONDITION                                         //
+    mul_vectors(level,m_id,1.0,VECTOR_DINV,w_id);                               //   m[] = Dinv[]*w[]
+    #else                                                                       //
+    scale_vector(level,m_id,1.0,w_id);                                          //   m[] = I*w[]
+    #endif                                                                      //
+    apply_op(level,n_id,m_id,a,b);                                              //   n[] = A(m)
+    dots_finish(level,&reduction);                                              //   ... overlapped with M^{-1} and A
+    double gamma     = reduction.value[0];                                      //
+    double delta     = reduction.value[1];                                      //
+    double norm_of_r = reduction.value[2];                                      //
+    if(j==0)norm_of_r0 = norm_of_r;                                             //   the norm of the initial residual...
+    if(norm_of_r == 0.0){CGConverged=1;break;}                                  //
+    if(norm_of_r < desired_reduction_in_norm*norm_of_r0){CGConverged=1;break;}  //
+    j++;level->Krylov_iterations++;                                             //
+    double beta;                                                                //
+    if(j==1){                                                                   //
+      beta  = 0.0;                                                              //
+      if(delta == 0.0){CGFailed=1;break;}                                       //   pivot breakdown ???
+      alpha = gamma / delta;                                                    //
+    }else{                                                                      //
+      if(gamma_old == 0.0){CGFailed=1;break;}                                   //   Lanczos breakdown ???
+      beta  = gamma / gamma_old;                                                //
+      double denominator = delta - beta*gamma/alpha;                            //
+      if(denominator == 0.0){CGFailed=1;break;}                                 //   pivot breakdown ???
+      alpha = gamma / denominator;                                              //
+    }                                                                           //
+    if(isinf(alpha)||isinf(beta)){CGFailed=1;break;}                            //   ???
+    if(j==1){                                                                   //
+      scale_vector(level,z_id,1.0,n_id);                                        //   z[] = n[]
+      scale_vector(level,q_id,1.0,m_id);                                        //   q[] = m[]
+      scale_vector(level,s_id,1.0,w_id);                                        //   s[] = w[]
+      scale_vector(level,p_id,1.0,u_id);                                        //   p[] = u[]
+    }else{                                                                      //
+      add_vectors(level,z_id,1.0,n_id,beta,z_id);                               //   z[] = n[] + beta*z[]
+      add_vectors(level,q_id,1.0,m_id,beta,q_id);                               //   q[] = m[] + beta*q[]
+      add_vectors(level,s_id,1.0,w_id,beta,s_id);                               //   s[] = w[] + beta*s[]
+      add_vectors(level,p_id,1.0,u_id,beta,p_id);                               //   p[] = u[] + beta*p[]
+    }                                                                           //
+    add_vectors(level,x_id,1.0,x_id, alpha,p_id);                               //   x_id[] = x_id[] + alpha*p[]
+    add_vectors(level,r_id,1.0,r_id,-alpha,s_id);                               //   r[]    = r[]    - alpha*s[]
+    add_vectors(level,u_id,1.0,u_id,-alpha,q_id);                               //   u[]    = u[]    - alpha*q[]
+    add_vectors(level,w_id,1.0,w_id,-alpha,z_id);                               //   w[]    = w[]    - alpha*z[]
+    gamma_old = gamma;                                                          //
+  }                                                                             // }
+}
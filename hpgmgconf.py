@@ -36,8 +36,9 @@ def main():
     fv.add_argument('--no-fv-mpi', action='store_false', dest='fv_mpi', help='Use MPI')
     fv.add_argument('--fv-cycle', help='Multigrid cycle type', choices=['V','F','U'], default='F')
     fv.add_argument('--no-fv-subcomm', action='store_false', dest='fv_subcomm', help='Build a subcommunicator for each level in the MG v-cycle to minimize the scope of MPI_AllReduce()')
-    fv.add_argument('--fv-coarse-solver', help='Use BiCGStab as a bottom (coarse grid) solver', choices=['bicgstab','cabicgstab','cg','cacg'], default='bicgstab')
-    fv.add_argument('--fv-smoother', help='Multigrid smoother', choices=['cheby','gsrb','jacobi','l1jacobi'], default='gsrb')
+    fv.add_argument('--fv-coarse-solver', help='Default bottom (coarse grid) solver (may be overridden at runtime with -bottom)', choices=['bicgstab','cabicgstab','cg','cacg'], default='bicgstab')
+    fv.add_argument('--fv-smoother', help='Default multigrid smoother (may be overridden at runtime with -smoother)', choices=['cheby','gsrb','jacobi','l1jacobi'], default='gsrb')
+    fv.add_argument('--fv-perf-counters', action='store_true', dest='fv_perf_counters', help='Attribute Linux perf_event_open hardware counters to each kernel on each level')
     args = parser.parse_args()
     if args.arch is None:
         args.arch = args.petsc_arch
@@ -119,6 +120,8 @@ def hpgmg_fv_cflags(args):
         defines.append('USE_SUBCOMM')
     defines.append('USE_%sCYCLES' % args.fv_cycle.upper())
     defines.append('USE_%s' % args.fv_smoother.upper())
+    if args.fv_perf_counters:
+        defines.append('USE_PERF_COUNTERS')
     #defines.append('STENCIL_FUSE_DINV') # generally only good on compute-intensive architectures with good compilers
     #defines.append('STENCIL_FUSE_BC')
     return ' '.join('-D%s=1'%d for d in defines)